@@ -0,0 +1,138 @@
+#include "memory.h"
+#include "atomic.h"
+
+#if defined(MEM_ACCOUNTING)
+static struct {
+	atomic_i64 heap_live;
+	atomic_i64 heap_peak;
+	atomic_i64 heap_allocations;
+
+	Spinlock lock;
+	ArenaStats* arenas;
+} mem_accounting = {0};
+#endif
+
+static inline
+void mem_account_heap(isize delta){
+#if defined(MEM_ACCOUNTING)
+	i64 live = atomic_fetch_add_explicit(&mem_accounting.heap_live, delta, memory_order_relaxed) + delta;
+	if(delta > 0){
+		atomic_fetch_add_explicit(&mem_accounting.heap_allocations, 1, memory_order_relaxed);
+	}
+
+	i64 peak = atomic_load_explicit(&mem_accounting.heap_peak, memory_order_relaxed);
+	while(live > peak){
+		if(atomic_compare_exchange_weak_explicit(&mem_accounting.heap_peak, &peak, live, memory_order_relaxed, memory_order_relaxed)){
+			break;
+		}
+	}
+#else
+	(void)delta;
+#endif
+}
+
+static inline
+void mem_accounting_register(ArenaStats* st){
+#if defined(MEM_ACCOUNTING)
+	spinlock_aquire(&mem_accounting.lock);
+	st->next = mem_accounting.arenas;
+	mem_accounting.arenas = st;
+	spinlock_release(&mem_accounting.lock);
+#else
+	(void)st;
+#endif
+}
+
+HeapStats heap_stats(){
+	HeapStats hs = {0};
+#if defined(MEM_ACCOUNTING)
+	hs.live_bytes = atomic_load(&mem_accounting.heap_live);
+	hs.peak_bytes = atomic_load(&mem_accounting.heap_peak);
+	hs.allocation_count = atomic_load(&mem_accounting.heap_allocations);
+#endif
+	return hs;
+}
+
+#if defined(MEM_ACCOUNTING)
+typedef struct {
+	f64 value;
+	char const* unit;
+} MemHumanSize;
+
+static inline
+MemHumanSize mem_human_size(i64 n){
+	if(n >= mem_gigabyte){ return (MemHumanSize){ (f64)n / mem_gigabyte, "GiB" }; }
+	if(n >= mem_megabyte){ return (MemHumanSize){ (f64)n / mem_megabyte, "MiB" }; }
+	if(n >= mem_kilobyte){ return (MemHumanSize){ (f64)n / mem_kilobyte, "KiB" }; }
+	return (MemHumanSize){ (f64)n, "B" };
+}
+
+static inline
+bool mem_tag_equals(char const* a, char const* b){
+	if(a == b){ return true; }
+	if(a == NULL || b == NULL){ return false; }
+	for(; *a != 0 && *a == *b; a += 1, b += 1){}
+	return *a == *b;
+}
+
+#define MEM_SIZE_FMT "%8.1f %-3s"
+#define mem_size_fmt(N) mem_human_size(N).value, mem_human_size(N).unit
+#endif
+
+void mem_accounting_report(){
+#if defined(MEM_ACCOUNTING)
+	spinlock_aquire(&mem_accounting.lock);
+
+	printf("Memory report\n");
+	printf("  %-12s %6s %12s %12s %12s %7s %9s %12s %9s %9s\n",
+		"Arena", "Count", "Peak (max)", "Peak (sum)", "Capacity", "Blocks", "Allocs", "Padding", "Resized", "Copied");
+
+	for(ArenaStats* st = mem_accounting.arenas; st != NULL; st = st->next){
+		/* Aggregate every arena sharing a tag into the first one with it */
+		bool seen = false;
+		for(ArenaStats* prev = mem_accounting.arenas; prev != st; prev = prev->next){
+			if(mem_tag_equals(prev->tag, st->tag)){ seen = true; break; }
+		}
+		if(seen){ continue; }
+
+		ArenaStats total = { .tag = st->tag };
+		i64 count = 0;
+		i64 peak_max = 0;
+		for(ArenaStats* it = st; it != NULL; it = it->next){
+			if(!mem_tag_equals(it->tag, st->tag)){ continue; }
+			count += 1;
+			peak_max = max(peak_max, it->peak_in_use);
+			total.peak_in_use      += it->peak_in_use;
+			total.capacity         += it->capacity;
+			total.block_count      += it->block_count;
+			total.allocation_count += it->allocation_count;
+			total.padding          += it->padding;
+			total.realloc_in_place += it->realloc_in_place;
+			total.realloc_copies   += it->realloc_copies;
+		}
+
+		printf("  %-12s %6lld " MEM_SIZE_FMT " " MEM_SIZE_FMT " " MEM_SIZE_FMT " %7lld %9lld " MEM_SIZE_FMT " %9lld %9lld\n",
+			total.tag != NULL ? total.tag : "(untagged)",
+			(long long)count,
+			mem_size_fmt(peak_max),
+			mem_size_fmt(total.peak_in_use),
+			mem_size_fmt(total.capacity),
+			(long long)total.block_count,
+			(long long)total.allocation_count,
+			mem_size_fmt(total.padding),
+			(long long)total.realloc_in_place,
+			(long long)total.realloc_copies);
+	}
+
+	HeapStats hs = heap_stats();
+	printf("Heap: " MEM_SIZE_FMT " live, " MEM_SIZE_FMT " peak, %lld allocations\n",
+		mem_size_fmt(hs.live_bytes), mem_size_fmt(hs.peak_bytes), (long long)hs.allocation_count);
+
+	spinlock_release(&mem_accounting.lock);
+#endif
+}
+
+#if defined(MEM_ACCOUNTING)
+#undef MEM_SIZE_FMT
+#undef mem_size_fmt
+#endif
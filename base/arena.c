@@ -7,6 +7,9 @@ Arena arena_create_buffer(byte* buf, isize buf_size){
 		.offset = 0,
 		.capacity = buf_size,
 		.last_allocation = NULL,
+		.next = NULL,
+		.current = NULL,
+		.stats = NULL,
 		.region_count = 0,
 		.dynamic = false,
 	};
@@ -20,7 +23,59 @@ Arena arena_create_dynamic(byte* buf, isize buf_size){
 
 #define ARENA_COMMIT_SIZE (1024 * 16)
 
-void* arena_alloc(Arena* a, isize size, isize align){
+#define ARENA_BLOCK_ALIGNMENT 4096
+
+static inline
+void arena_account_usage(Arena* a, isize delta){
+#if defined(MEM_ACCOUNTING)
+	ArenaStats* st = a->stats;
+	if(st == NULL){ return; }
+	st->in_use += delta;
+	st->peak_in_use = max(st->peak_in_use, st->in_use);
+#else
+	(void)a; (void)delta;
+#endif
+}
+
+static inline
+void arena_account_allocation(Arena* a, isize padding){
+#if defined(MEM_ACCOUNTING)
+	ArenaStats* st = a->stats;
+	if(st == NULL){ return; }
+	st->allocation_count += 1;
+	st->padding += padding;
+#else
+	(void)a; (void)padding;
+#endif
+}
+
+static inline
+void arena_account_block(Arena* a, isize capacity){
+#if defined(MEM_ACCOUNTING)
+	ArenaStats* st = a->stats;
+	if(st == NULL){ return; }
+	st->block_count += 1;
+	st->capacity += capacity;
+#else
+	(void)a; (void)capacity;
+#endif
+}
+
+static inline
+void arena_account_realloc(Arena* a, bool in_place){
+#if defined(MEM_ACCOUNTING)
+	ArenaStats* st = a->stats;
+	if(st == NULL){ return; }
+	st->realloc_in_place += in_place;
+	st->realloc_copies += !in_place;
+#else
+	(void)a; (void)in_place;
+#endif
+}
+
+/* Bump allocates from this block only */
+static
+void* arena_block_alloc(Arena* a, isize size, isize align){
 	uintptr base = (uintptr)a->data;
 	uintptr current = base + (uintptr)a->offset;
 
@@ -31,27 +86,7 @@ void* arena_alloc(Arena* a, isize size, isize align){
 	isize required  = padding + size;
 
 	if(required > available){
-		if(a->dynamic){
-			return NULL; /* Out of memory */
-		}
-		else {
-			if(a->next != NULL){
-				return arena_alloc(a->next, size, align);
-			}
-
-			Arena* new_arena = heap_alloc(sizeof(Arena), alignof(Arena));
-			if(new_arena == NULL){
-				return NULL; /* VERY out of memory */
-			}
-			isize new_arena_size = mem_align_forward_size(size, 1024);
-			byte* new_arena_buf = heap_alloc(new_arena_size, max(align, (isize)alignof(void*) * 2));
-			if(new_arena_buf == NULL){
-				heap_free(new_arena);
-				return NULL; /* VERY out of memory */
-			}
-			*new_arena = arena_create_dynamic(new_arena_buf, new_arena_size);
-			return arena_alloc(new_arena, size, align);
-		}
+		return NULL;
 	}
 
 	a->offset += required;
@@ -59,9 +94,37 @@ void* arena_alloc(Arena* a, isize size, isize align){
 	a->last_allocation = allocation;
 	mem_set(allocation, 0, size);
 
+	arena_account_usage(a, required);
+	arena_account_allocation(a, padding);
+
 	return allocation;
 }
 
+void* arena_alloc(Arena* a, isize size, isize align){
+	/* Blocks are filled in order, so a region only has to remember the block it started in */
+	Arena* block = a->current != NULL ? a->current : a;
+	for(;;){
+		void* allocation = arena_block_alloc(block, size, align);
+		if(allocation != NULL || !a->dynamic){
+			return allocation; /* Null when out of memory */
+		}
+
+		if(block->next == NULL){
+			Arena* next = heap_alloc(sizeof(Arena), alignof(Arena));
+			/* Blocks double in size so the chain stays short */
+			isize block_size = mem_align_forward_size(max(block->capacity * 2, size + align), ARENA_BLOCK_ALIGNMENT);
+			byte* block_buf = heap_alloc(block_size, max(align, (isize)alignof(void*) * 2));
+
+			*next = arena_create_dynamic(block_buf, block_size);
+			next->stats = a->stats;
+			block->next = next;
+			arena_account_block(a, block_size);
+		}
+		block = block->next;
+		a->current = block;
+	}
+}
+
 void* arena_realloc(Arena* a, void* ptr, isize old_size, isize new_size, isize align){
 	ensure(old_size > 0 && new_size > 0, "Invalid sizes");
 
@@ -70,6 +133,7 @@ void* arena_realloc(Arena* a, void* ptr, isize old_size, isize new_size, isize a
 	}
 
 	bool in_place = arena_resize_in_place(a, ptr, new_size);
+	arena_account_realloc(a, in_place);
 	if(in_place){
 		return ptr;
 	}
@@ -88,7 +152,10 @@ bool arena_resize_in_place(Arena* a, void* ptr, isize new_size){
 	uintptr current = base + (uintptr)a->offset;
 	uintptr limit   = base + a->capacity;
 
-	ensure((uintptr)ptr >= base && (uintptr)ptr < limit, "Pointer is not owned by arena");
+	if((uintptr)ptr < base || (uintptr)ptr >= limit){
+		ensure(a->next != NULL, "Pointer is not owned by arena");
+		return arena_resize_in_place(a->next, ptr, new_size);
+	}
 
 	if(ptr == a->last_allocation){
 		isize last_allocation_size = current - (uintptr)a->last_allocation;
@@ -97,6 +164,7 @@ bool arena_resize_in_place(Arena* a, void* ptr, isize new_size){
 		}
 
 		a->offset += new_size - last_allocation_size;
+		arena_account_usage(a, new_size - last_allocation_size);
 		return true;
 	}
 
@@ -105,24 +173,80 @@ bool arena_resize_in_place(Arena* a, void* ptr, isize new_size){
 
 void arena_reset(Arena* arena){
 	ensure(arena->region_count == 0, "Arena has dangling regions");
-	arena->offset = 0;
-	arena->last_allocation = NULL;
+	for(Arena* a = arena; a != NULL; a = a->next){
+		arena_account_usage(arena, -a->offset);
+		a->offset = 0;
+		a->last_allocation = NULL;
+	}
+	arena->current = NULL;
+}
+
+void arena_destroy(Arena* arena){
+	ensure(arena->region_count == 0, "Arena has dangling regions");
+	Arena* block = arena->next;
+	while(block != NULL){
+		Arena* next = block->next;
+		arena_account_usage(arena, -block->offset);
+		heap_free(block->data);
+		heap_free(block);
+		block = next;
+	}
+	arena->next = NULL;
+	arena->current = NULL;
 }
 
 ArenaRegion arena_region_begin(Arena* a){
+	Arena* block = a->current != NULL ? a->current : a;
 	ArenaRegion reg = {
 		.arena = a,
-		.offset = a->offset,
+		.block = block,
+		.offset = block->offset,
+		.last_allocation = block->last_allocation,
 	};
 	a->region_count += 1;
 	return reg;
 }
 
 void arena_region_end(ArenaRegion reg){
-	ensure(reg.arena->region_count > 0, "Arena has a improper region counter");
-	ensure(reg.arena->offset >= reg.offset, "Arena has a lower offset than region");
+	Arena* a = reg.arena;
+	ensure(a->region_count > 0, "Arena has a improper region counter");
+	ensure(reg.block->offset >= reg.offset, "Arena has a lower offset than region");
+
+	arena_account_usage(a, reg.offset - reg.block->offset);
+	reg.block->offset = reg.offset;
+	reg.block->last_allocation = reg.last_allocation;
+
+	/* Blocks after the one the region started in were empty at the time */
+	for(Arena* block = reg.block->next; block != NULL; block = block->next){
+		arena_account_usage(a, -block->offset);
+		block->offset = 0;
+		block->last_allocation = NULL;
+	}
+	a->current = reg.block != a ? reg.block : NULL;
+	a->region_count -= 1;
+}
 
-	reg.arena->offset = reg.offset;
-	reg.arena->region_count -= 1;
+void arena_set_tag(Arena* a, char const* tag){
+#if defined(MEM_ACCOUNTING)
+	if(a->stats == NULL){
+		ArenaStats* st = heap_alloc(sizeof(ArenaStats), alignof(ArenaStats));
+		st->block_count = 1;
+		st->capacity = a->capacity;
+		st->in_use = a->offset;
+		st->peak_in_use = a->offset;
+		for(Arena* block = a->next; block != NULL; block = block->next){
+			st->block_count += 1;
+			st->capacity += block->capacity;
+			st->in_use += block->offset;
+			block->stats = st;
+		}
+		a->stats = st;
+		mem_accounting_register(st);
+	}
+	a->stats->tag = tag;
+#else
+	(void)a; (void)tag;
+#endif
 }
 
+#undef ARENA_BLOCK_ALIGNMENT
@@ -0,0 +1,58 @@
+#include "array.h"
+#include "ensure.h"
+
+void dyn_grow(void** v, isize* cap, isize min_cap, isize elem_size, isize align, Arena* arena){
+	ensure(arena != NULL, "Dynamic arrays need an arena");
+	isize new_cap = max(max(*cap * 2, min_cap), (isize)8);
+	void* p = *cap == 0
+		? arena_alloc(arena, new_cap * elem_size, align)
+		: arena_realloc(arena, *v, *cap * elem_size, new_cap * elem_size, align);
+	ensure(p != NULL, "Failed to grow dynamic array");
+	*v = p;
+	*cap = new_cap;
+}
+
+SegArray seg_array_create(isize elem_size, isize align, isize first_capacity, Arena* arena){
+	ensure(elem_size > 0 && arena != NULL, "Invalid segmented array");
+	i32 shift = 0;
+	while(((isize)1 << shift) < first_capacity){
+		shift += 1;
+	}
+	return (SegArray){
+		.elem_size = elem_size,
+		.align = align,
+		.first_shift = shift,
+		.arena = arena,
+	};
+}
+
+void* seg_array_push(SegArray* s){
+	isize segment_len = s->segment_count > 0 ? (isize)1 << (s->first_shift + s->segment_count - 1) : 0;
+	if(s->len == s->cap){
+		ensure(s->segment_count < SEG_ARRAY_MAX_SEGMENTS, "Segmented array is full");
+		segment_len = (isize)1 << (s->first_shift + s->segment_count);
+		byte* segment = arena_alloc(s->arena, segment_len * s->elem_size, s->align);
+		ensure(segment != NULL, "Failed to allocate array segment");
+		s->segments[s->segment_count] = segment;
+		s->segment_count += 1;
+		s->cap += segment_len;
+	}
+
+	/* The last segment ends at `cap` */
+	isize offset = s->len - (s->cap - segment_len);
+	s->len += 1;
+	return s->segments[s->segment_count - 1] + offset * s->elem_size;
+}
+
+void* seg_array_flatten(SegArray const* s, Arena* arena){
+	byte* out = arena_alloc(arena, max(s->len * s->elem_size, (isize)1), s->align);
+	ensure(out != NULL, "Failed to allocate flattened array");
+
+	isize copied = 0;
+	for(i32 k = 0; k < s->segment_count && copied < s->len; k += 1){
+		isize count = min((isize)1 << (s->first_shift + k), s->len - copied);
+		mem_copy_no_overlap(out + copied * s->elem_size, s->segments[k], count * s->elem_size);
+		copied += count;
+	}
+	return out;
+}
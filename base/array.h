@@ -0,0 +1,70 @@
+#pragma once
+#include "types.h"
+#include "memory.h"
+#include "bits.h"
+
+//// Dynamic array
+/* Growable array of `Type` on an arena. Growth goes through `arena_realloc`, so an array that is
+   still the arena's last allocation is extended in place instead of copied. Declare the concrete
+   type once with a typedef, anonymous structs are not compatible with each other:
+
+       typedef DynArray(Token) TokenList;
+       TokenList list = { .arena = arena };
+       dyn_push(&list, tk); */
+#define DynArray(Type) struct { Type* v; isize len; isize cap; Arena* arena; }
+
+// Grows `*v` to hold at least `min_cap` elements, `*cap` is updated
+void dyn_grow(void** v, isize* cap, isize min_cap, isize elem_size, isize align, Arena* arena);
+
+// Room for `Count` more elements
+#define dyn_reserve(A, Count) \
+	((A)->len + (Count) <= (A)->cap ? (void)0 : \
+		dyn_grow((void**)&(A)->v, &(A)->cap, (A)->len + (Count), sizeof(*(A)->v), alignof(typeof(*(A)->v)), (A)->arena))
+
+#define dyn_push(A, X) \
+	(dyn_reserve((A), 1), (A)->v[(A)->len++] = (X))
+
+// Appends `Count` elements copied from `Items`
+#define dyn_append(A, Items, Count) \
+	(dyn_reserve((A), (Count)), mem_copy_no_overlap((A)->v + (A)->len, (Items), (Count) * sizeof(*(A)->v)), (A)->len += (Count))
+
+#define dyn_pop(A) ((A)->v[--(A)->len])
+
+//// Segmented array
+/* Elements never move: storage is a list of segments, each twice the size of the one before,
+   and growing only allocates the next segment. Indexing costs a bit scan. */
+
+#define SEG_ARRAY_MAX_SEGMENTS 48
+
+typedef struct {
+	byte* segments[SEG_ARRAY_MAX_SEGMENTS];
+	isize len;
+	isize cap;         /* Elements in the allocated segments */
+	isize elem_size;
+	isize align;
+	i32 first_shift;   /* Segment k holds 1 << (first_shift + k) elements */
+	i32 segment_count;
+	Arena* arena;
+} SegArray;
+
+// The first segment holds `first_capacity` elements, rounded up to a power of two
+SegArray seg_array_create(isize elem_size, isize align, isize first_capacity, Arena* arena);
+
+#define seg_array_make(Type, FirstCapacity, A) seg_array_create(sizeof(Type), alignof(Type), (FirstCapacity), (A))
+
+// Pointer to a new zeroed element at the end
+void* seg_array_push(SegArray* s);
+
+// Copies the elements into one contiguous block
+void* seg_array_flatten(SegArray const* s, Arena* arena);
+
+static inline
+void* seg_array_at(SegArray const* s, isize index){
+	ensure(index >= 0 && index < s->len, "Index out of bounds");
+	u64 biased = (u64)index + ((u64)1 << s->first_shift);
+	i32 top = bit_log2_64(biased);
+	isize offset = (isize)(biased - ((u64)1 << top));
+	return s->segments[top - s->first_shift] + offset * s->elem_size;
+}
+
+#define seg_at(S, Type, Index) ((Type*)seg_array_at((S), (Index)))
@@ -1,10 +1,27 @@
 /* Main base translation unit, shall be compiled ONCE per project */
 #include "build_context.h"
 #include "memory.c"
+#include "accounting.c"
 #include "arena.c"
 #include "heap.c"
+#include "cpu.c"
 
 #include "utf8.c"
 #include "string.c"
 #include "format.c"
+#include "hash.c"
+#include "map.c"
+#include "array.c"
+#include "file.c"
 
+#if defined(OS_LINUX)
+	#include "memory_posix.c"
+	#include "clock_posix.c"
+	#include "thread_posix.c"
+	#include "file_posix.c"
+#elif defined(OS_WINDOWS)
+	#include "memory_windows.c"
+	#include "clock_windows.c"
+	#include "thread_windows.c"
+	#include "file_windows.c"
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include "types.h"
+
+#if defined(COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+static inline
+i32 bit_popcount32(u32 x){
+#if defined(COMPILER_MSVC)
+	return (i32)__popcnt(x);
+#else
+	return __builtin_popcount(x);
+#endif
+}
+
+// Index of the lowest set bit, `x` must not be 0
+static inline
+i32 bit_ctz32(u32 x){
+#if defined(COMPILER_MSVC)
+	unsigned long index = 0;
+	_BitScanForward(&index, x);
+	return (i32)index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+
+// Index of the highest set bit, `x` must not be 0
+static inline
+i32 bit_log2_64(u64 x){
+#if defined(COMPILER_MSVC)
+	unsigned long index = 0;
+	_BitScanReverse64(&index, x);
+	return (i32)index;
+#else
+	return 63 - __builtin_clzll(x);
+#endif
+}
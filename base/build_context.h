@@ -19,3 +19,9 @@
 #else
 	#error "Unsupported operating system"
 #endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define ARCH_X64 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define ARCH_ARM64 1
+#endif
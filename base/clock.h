@@ -0,0 +1,10 @@
+#pragma once
+#include "types.h"
+
+#define clock_nanosecond  (1ll)
+#define clock_microsecond (1000ll)
+#define clock_millisecond (1000ll * 1000ll)
+#define clock_second      (1000ll * 1000ll * 1000ll)
+
+// Monotonic time in nanoseconds, only meaningful when compared to another `clock_now()`
+i64 clock_now();
@@ -0,0 +1,8 @@
+#include "clock.h"
+#include <time.h>
+
+i64 clock_now(){
+	struct timespec ts = {0};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((i64)ts.tv_sec * clock_second) + (i64)ts.tv_nsec;
+}
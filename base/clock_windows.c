@@ -0,0 +1,20 @@
+#include "clock.h"
+
+#define WIN32_MEAN_AND_LEAN
+#include <windows.h>
+
+i64 clock_now(){
+	static i64 frequency = 0;
+	if(frequency == 0){
+		LARGE_INTEGER f;
+		QueryPerformanceFrequency(&f);
+		frequency = f.QuadPart;
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	i64 seconds = counter.QuadPart / frequency;
+	i64 rest    = counter.QuadPart % frequency;
+	return (seconds * clock_second) + ((rest * clock_second) / frequency);
+}
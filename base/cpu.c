@@ -0,0 +1,35 @@
+#include "cpu.h"
+
+#if defined(ARCH_X64) && defined(COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+static
+CpuFeatures cpu_detect(){
+	CpuFeatures f = {0};
+#if defined(ARCH_X64)
+	#if defined(COMPILER_MSVC)
+	int regs[4] = {0};
+	__cpuid(regs, 1);
+	f.sse41 = (regs[2] & (1 << 19)) != 0;
+	bool os_avx = (regs[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	__cpuidex(regs, 7, 0);
+	f.avx2 = os_avx && (regs[1] & (1 << 5)) != 0;
+	#else
+	__builtin_cpu_init();
+	f.sse41 = __builtin_cpu_supports("sse4.1");
+	f.avx2 = __builtin_cpu_supports("avx2");
+	#endif
+#endif
+	return f;
+}
+
+CpuFeatures cpu_features(){
+	static CpuFeatures features;
+	static atomic_bool detected = false;
+	if(!atomic_load_explicit(&detected, memory_order_acquire)){
+		features = cpu_detect();
+		atomic_store_explicit(&detected, true, memory_order_release);
+	}
+	return features;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "types.h"
+
+typedef struct {
+	bool sse41;
+	bool avx2;
+} CpuFeatures;
+
+// Instruction set extensions available at runtime, detected once
+CpuFeatures cpu_features();
@@ -0,0 +1,22 @@
+#include "file.h"
+#include <stdio.h>
+
+bool file_read_all(char const* path, Arena* arena, String* out){
+	*out = (String){0};
+	FILE* f = fopen(path, "rb");
+	if(f == NULL){ return false; }
+
+	bool ok = fseek(f, 0, SEEK_END) == 0;
+	long size = ok ? ftell(f) : -1;
+	ok = ok && size >= 0 && fseek(f, 0, SEEK_SET) == 0;
+
+	byte* buf = ok ? arena_alloc(arena, (isize)size + 1, 1) : NULL;
+	ok = buf != NULL && fread(buf, 1, (size_t)size, f) == (size_t)size;
+	fclose(f);
+
+	if(ok){
+		buf[size] = 0;
+		*out = (String){ .v = buf, .len = (isize)size };
+	}
+	return ok;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "types.h"
+#include "memory.h"
+
+typedef struct {
+	byte* data;
+	isize size;
+	void* handle; /* Platform specific */
+} FileMapping;
+
+// Maps a whole file copy-on-write, writes to `data` never reach the file. Returns false if the
+// file cannot be opened or mapped.
+bool file_map(char const* path, FileMapping* out);
+
+void file_unmap(FileMapping* m);
+
+// Writes a temporary file next to `path` and renames it over `path`, readers never observe a
+// partially written file
+bool file_write_atomic(char const* path, void const* data, isize size);
+
+// Lets the owner, group and others run the file, always succeeds where there is no such bit
+bool file_make_executable(char const* path);
+
+// Succeeds if the directory exists afterwards
+bool file_make_dir(char const* path);
+
+// Reads a whole file into `arena`, the contents are NUL terminated
+bool file_read_all(char const* path, Arena* arena, String* out);
+
+typedef struct {
+	String name;
+	bool is_dir;
+} DirEntry;
+
+typedef struct {
+	DirEntry* v;
+	isize len;
+} DirEntryArray;
+
+// Lists a directory in no particular order, without "." and "..". Names are NUL terminated and
+// allocated in `arena`.
+bool file_list_dir(char const* path, Arena* arena, DirEntryArray* out);
+
+bool file_is_dir(char const* path);
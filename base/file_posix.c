@@ -0,0 +1,119 @@
+#include "file.h"
+#include "memory.h"
+#include "string.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+bool file_map(char const* path, FileMapping* out){
+	*out = (FileMapping){0};
+	int fd = open(path, O_RDONLY);
+	if(fd < 0){ return false; }
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size <= 0){
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd); /* The mapping keeps the file alive */
+	if(data == MAP_FAILED){ return false; }
+
+	out->data = data;
+	out->size = (isize)st.st_size;
+	return true;
+}
+
+void file_unmap(FileMapping* m){
+	if(m->data != NULL){
+		munmap(m->data, (size_t)m->size);
+	}
+	*m = (FileMapping){0};
+}
+
+bool file_write_atomic(char const* path, void const* data, isize size){
+	char tmp[4096];
+	int n = snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+	if(n < 0 || n >= (int)sizeof(tmp)){ return false; }
+
+	int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0){ return false; }
+
+	byte const* p = data;
+	isize written = 0;
+	while(written < size){
+		ssize_t w = write(fd, p + written, (size_t)(size - written));
+		if(w < 0){
+			if(errno == EINTR){ continue; }
+			break;
+		}
+		written += w;
+	}
+
+	bool ok = (written == size) && (close(fd) == 0);
+	if(ok){
+		ok = rename(tmp, path) == 0;
+	}
+	if(!ok){
+		unlink(tmp);
+	}
+	return ok;
+}
+
+bool file_make_executable(char const* path){
+	return chmod(path, 0755) == 0;
+}
+
+bool file_make_dir(char const* path){
+	if(mkdir(path, 0755) == 0){ return true; }
+	struct stat st;
+	return errno == EEXIST && stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool file_list_dir(char const* path, Arena* arena, DirEntryArray* out){
+	*out = (DirEntryArray){0};
+	DIR* dir = opendir(path);
+	if(dir == NULL){ return false; }
+
+	isize cap = 0;
+	bool ok = true;
+	for(struct dirent* ent = readdir(dir); ent != NULL && ok; ent = readdir(dir)){
+		char const* name = ent->d_name;
+		if(name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))){
+			continue;
+		}
+
+		if(out->len == cap){
+			isize new_cap = max(cap * 2, (isize)16);
+			DirEntry* v = cap == 0
+				? arena_make(arena, DirEntry, new_cap)
+				: arena_realloc(arena, out->v, cap * (isize)sizeof(DirEntry), new_cap * (isize)sizeof(DirEntry), alignof(DirEntry));
+			if(v == NULL){ ok = false; break; }
+			out->v = v;
+			cap = new_cap;
+		}
+
+		String copy = str_format(arena, "%s", name);
+		bool is_dir = ent->d_type == DT_DIR;
+		if(ent->d_type == DT_UNKNOWN || ent->d_type == DT_LNK){
+			struct stat st;
+			char const* full = (char const*)str_format(arena, "%s/%s", path, name).v;
+			is_dir = stat(full, &st) == 0 && S_ISDIR(st.st_mode);
+		}
+		out->v[out->len] = (DirEntry){ .name = copy, .is_dir = is_dir };
+		out->len += 1;
+	}
+	closedir(dir);
+	return ok;
+}
+
+bool file_is_dir(char const* path){
+	struct stat st;
+	return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
@@ -0,0 +1,122 @@
+#include "file.h"
+#include "memory.h"
+#include "string.h"
+
+#define WIN32_MEAN_AND_LEAN
+#include <windows.h>
+#include <stdio.h>
+
+bool file_map(char const* path, FileMapping* out){
+	*out = (FileMapping){0};
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){ return false; }
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart <= 0){
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if(mapping == NULL){ return false; }
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if(data == NULL){
+		CloseHandle(mapping);
+		return false;
+	}
+
+	out->data = data;
+	out->size = (isize)size.QuadPart;
+	out->handle = mapping;
+	return true;
+}
+
+void file_unmap(FileMapping* m){
+	if(m->data != NULL){
+		UnmapViewOfFile(m->data);
+		CloseHandle(m->handle);
+	}
+	*m = (FileMapping){0};
+}
+
+bool file_write_atomic(char const* path, void const* data, isize size){
+	char tmp[MAX_PATH + 64];
+	int n = snprintf(tmp, sizeof(tmp), "%s.%lu.tmp", path, (unsigned long)GetCurrentProcessId());
+	if(n < 0 || n >= (int)sizeof(tmp)){ return false; }
+
+	HANDLE file = CreateFileA(tmp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){ return false; }
+
+	byte const* p = data;
+	isize written = 0;
+	while(written < size){
+		DWORD chunk = (DWORD)min(size - written, (isize)(1 << 30));
+		DWORD w = 0;
+		if(!WriteFile(file, p + written, chunk, &w, NULL)){ break; }
+		written += w;
+	}
+	CloseHandle(file);
+
+	bool ok = (written == size) && MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING);
+	if(!ok){
+		DeleteFileA(tmp);
+	}
+	return ok;
+}
+
+bool file_make_executable(char const* path){
+	(void)path;
+	return true;
+}
+
+bool file_make_dir(char const* path){
+	if(CreateDirectoryA(path, NULL)){ return true; }
+	DWORD err = GetLastError();
+	DWORD attrs = GetFileAttributesA(path);
+	return err == ERROR_ALREADY_EXISTS && attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+bool file_list_dir(char const* path, Arena* arena, DirEntryArray* out){
+	*out = (DirEntryArray){0};
+	char pattern[MAX_PATH + 4];
+	int n = snprintf(pattern, sizeof(pattern), "%s\\*", path);
+	if(n < 0 || n >= (int)sizeof(pattern)){ return false; }
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA(pattern, &data);
+	if(find == INVALID_HANDLE_VALUE){ return false; }
+
+	isize cap = 0;
+	bool ok = true;
+	do {
+		char const* name = data.cFileName;
+		if(name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))){
+			continue;
+		}
+
+		if(out->len == cap){
+			isize new_cap = max(cap * 2, (isize)16);
+			DirEntry* v = cap == 0
+				? arena_make(arena, DirEntry, new_cap)
+				: arena_realloc(arena, out->v, cap * (isize)sizeof(DirEntry), new_cap * (isize)sizeof(DirEntry), alignof(DirEntry));
+			if(v == NULL){ ok = false; break; }
+			out->v = v;
+			cap = new_cap;
+		}
+
+		out->v[out->len] = (DirEntry){
+			.name = str_format(arena, "%s", name),
+			.is_dir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0,
+		};
+		out->len += 1;
+	} while(FindNextFileA(find, &data));
+	FindClose(find);
+	return ok;
+}
+
+bool file_is_dir(char const* path){
+	DWORD attrs = GetFileAttributesA(path);
+	return attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY);
+}
@@ -6,12 +6,17 @@
 
 
 String str_vformat(Arena* arena, char const * restrict fmt, va_list argp){
-	char* ptr = arena->data + arena->offset;
-	isize len = arena->capacity - arena->offset;
-	isize n = 1;
+	va_list measure;
+	va_copy(measure, argp);
+	isize n = stbsp_vsnprintf(NULL, 0, fmt, measure);
+	va_end(measure);
 
-	n = stbsp_vsnprintf(ptr, len, fmt, argp);
-	arena->offset += n;
+	/* Allocated through the arena so chained blocks and accounting see it */
+	char* ptr = arena_alloc(arena, n + 1, 1);
+	if(ptr == NULL){
+		return (String){0};
+	}
+	stbsp_vsnprintf(ptr, n + 1, fmt, argp);
 
 	String s = {
 		.v = (byte const*)ptr,
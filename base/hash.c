@@ -0,0 +1,59 @@
+#include "hash.h"
+#include "memory.h"
+
+#if defined(COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+/* Folded 64x64->128 multiply, the core of wyhash style hashes */
+static inline
+u64 hash_mix(u64 a, u64 b){
+#if defined(COMPILER_MSVC)
+	u64 hi = 0;
+	u64 lo = _umul128(a, b, &hi);
+	return lo ^ hi;
+#else
+	__uint128_t r = (__uint128_t)a * (__uint128_t)b;
+	return (u64)r ^ (u64)(r >> 64);
+#endif
+}
+
+static inline
+u64 hash_read64(byte const* p){
+	u64 v;
+	mem_copy_no_overlap(&v, p, 8);
+	return v;
+}
+
+#define HASH_P0 0xa0761d6478bd642full
+#define HASH_P1 0xe7037ed1a0b428dbull
+#define HASH_P2 0x8ebc6af09c88c6e3ull
+#define HASH_P3 0x589965cc75374cc3ull
+
+u64 hash_bytes(void const* data, isize len, u64 seed){
+	byte const* p = data;
+	u64 s0 = seed ^ HASH_P0;
+	u64 s1 = seed ^ HASH_P1;
+
+	/* Two independent lanes keep both multipliers busy */
+	isize i = 0;
+	for(; i + 32 <= len; i += 32){
+		s0 = hash_mix(hash_read64(p + i) ^ HASH_P1, hash_read64(p + i + 8) ^ s0);
+		s1 = hash_mix(hash_read64(p + i + 16) ^ HASH_P2, hash_read64(p + i + 24) ^ s1);
+	}
+
+	u64 h = s0 ^ s1;
+	for(; i + 8 <= len; i += 8){
+		h = hash_mix(hash_read64(p + i) ^ HASH_P1, h ^ HASH_P0);
+	}
+
+	u64 tail = 0;
+	mem_copy_no_overlap(&tail, p + i, len - i);
+	h = hash_mix(tail ^ HASH_P2, h ^ HASH_P3 ^ (u64)len);
+	return hash_mix(h ^ HASH_P0, h ^ HASH_P1);
+}
+
+#undef HASH_P0
+#undef HASH_P1
+#undef HASH_P2
+#undef HASH_P3
@@ -0,0 +1,5 @@
+#pragma once
+#include "types.h"
+
+// Fast non-cryptographic 64-bit hash, stable across runs on the same byte order
+u64 hash_bytes(void const* data, isize len, u64 seed);
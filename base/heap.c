@@ -1,15 +1,17 @@
 #include "memory.h"
 #include <stdlib.h>
 
+/* Layout: [ padding | size | original pointer | aligned memory ... ] */
 void* heap_alloc(isize size, isize align){
 	ensure(mem_valid_alignment(align), "Invalid alignment");
 	align = max(align, (isize)alignof(void*));
 
-	isize space = align - 1 + sizeof(void*) + size;
+	isize header = sizeof(void*) * 2;
+	isize space = align - 1 + header + size;
 	void* allocated_mem = calloc(space, 1);
 
 	ensure(allocated_mem != NULL, "Heap allocation failed");
-	void* aligned_mem = (void*)((uintptr)allocated_mem + sizeof(void*));
+	void* aligned_mem = (void*)((uintptr)allocated_mem + header);
 
 	/* Align the pointer by rounding down */ {
 		uintptr aligned_ptr = 0;
@@ -20,17 +22,21 @@ void* heap_alloc(isize size, isize align){
 		aligned_mem = (void*)aligned_ptr;
 	};
 
-	/* Store actual memory address before the aligned one */ {
+	/* Store actual memory address and size before the aligned one */ {
 		void** ptr_loc = ((void**)aligned_mem) - 1;
 		*ptr_loc = allocated_mem;
+		isize* size_loc = ((isize*)aligned_mem) - 2;
+		*size_loc = size;
 	}
 
+	mem_account_heap(size);
 	return aligned_mem;
 }
 
 void heap_free(void* ptr){
+	if(ptr == NULL){ return; }
 	void** pointer_array = (void**)ptr;
 	void* actual_memory = pointer_array[-1];
+	mem_account_heap(-((isize*)ptr)[-2]);
 	free(actual_memory);
 }
-
@@ -0,0 +1,221 @@
+#include "map.h"
+#include "hash.h"
+#include "bits.h"
+#include "string.h"
+#include "ensure.h"
+
+#define MAP_EMPTY ((u8)0x80)
+
+typedef struct {
+	u32 match; /* Slots whose control byte equals the one searched for */
+	u32 empty;
+} MapGroup;
+
+#if defined(ARCH_X64)
+#include <emmintrin.h>
+
+static inline
+MapGroup map_group(u8 const* ctrl, u8 h2){
+	__m128i g = _mm_loadu_si128((__m128i const*)ctrl);
+	return (MapGroup){
+		.match = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2))),
+		.empty = (u32)_mm_movemask_epi8(g), /* Only MAP_EMPTY has the high bit set */
+	};
+}
+#else
+static inline
+MapGroup map_group(u8 const* ctrl, u8 h2){
+	MapGroup g = {0};
+	for(u32 i = 0; i < MAP_GROUP_WIDTH; i += 1){
+		g.match |= (u32)(ctrl[i] == h2) << i;
+		g.empty |= (u32)(ctrl[i] == MAP_EMPTY) << i;
+	}
+	return g;
+}
+#endif
+
+static inline
+u64 map_hash(HashMap const* m, void const* key){
+	return m->hash != NULL ? m->hash(key) : hash_bytes(key, m->key_size, 0);
+}
+
+static inline
+bool map_key_equal(HashMap const* m, void const* a, void const* b){
+	return m->equal != NULL ? m->equal(a, b) : mem_compare(a, b, m->key_size) == 0;
+}
+
+static inline
+isize map_home(HashMap const* m, u64 hash){
+	return (isize)(hash >> 7) & (m->cap - 1);
+}
+
+static inline
+void map_set_ctrl(HashMap* m, isize slot, u8 c){
+	m->ctrl[slot] = c;
+	if(slot < MAP_GROUP_WIDTH){
+		m->ctrl[m->cap + slot] = c; /* Lets a group load run past the end without wrapping */
+	}
+}
+
+/* Keys, values and control bytes share one allocation */
+static
+void map_alloc_storage(HashMap* m, isize cap){
+	isize keys_size = mem_align_forward_size(cap * m->key_size, 16);
+	isize values_size = mem_align_forward_size(cap * m->value_size, 16);
+	isize total = keys_size + values_size + cap + MAP_GROUP_WIDTH;
+
+	byte* mem = m->arena != NULL ? arena_alloc(m->arena, total, 16) : heap_alloc(total, 16);
+	ensure(mem != NULL, "Failed to allocate hash map");
+
+	m->keys = mem;
+	m->values = mem + keys_size;
+	m->ctrl = mem + keys_size + values_size;
+	m->cap = cap;
+	mem_set(m->ctrl, MAP_EMPTY, cap + MAP_GROUP_WIDTH);
+}
+
+HashMap map_create(isize key_size, isize value_size, isize capacity, Arena* arena){
+	ensure(key_size > 0 && value_size >= 0, "Invalid hash map element sizes");
+	isize cap = MAP_GROUP_WIDTH;
+	while(cap * 3 < capacity * 4){ cap *= 2; }
+
+	HashMap m = {
+		.key_size = key_size,
+		.value_size = value_size,
+		.arena = arena,
+	};
+	map_alloc_storage(&m, cap);
+	return m;
+}
+
+/* Linear probe for `key`, a group is only searched up to its first empty slot */
+static
+isize map_find(HashMap const* m, void const* key, u64 hash){
+	u8 h2 = (u8)(hash & 0x7f);
+	isize mask = m->cap - 1;
+	for(isize pos = map_home(m, hash);; pos = (pos + MAP_GROUP_WIDTH) & mask){
+		MapGroup g = map_group(m->ctrl + pos, h2);
+		u32 before_empty = g.empty != 0 ? (g.empty & (0u - g.empty)) - 1 : 0xffffffffu;
+		for(u32 match = g.match & before_empty; match != 0; match &= match - 1){
+			isize slot = (pos + bit_ctz32(match)) & mask;
+			if(map_key_equal(m, map_key_at(m, slot), key)){
+				return slot;
+			}
+		}
+		if(g.empty != 0){
+			return -1;
+		}
+	}
+}
+
+static
+isize map_find_empty(HashMap const* m, u64 hash){
+	isize mask = m->cap - 1;
+	for(isize pos = map_home(m, hash);; pos = (pos + MAP_GROUP_WIDTH) & mask){
+		MapGroup g = map_group(m->ctrl + pos, MAP_EMPTY);
+		if(g.empty != 0){
+			return (pos + bit_ctz32(g.empty)) & mask;
+		}
+	}
+}
+
+static
+void map_grow(HashMap* m){
+	HashMap old = *m;
+	map_alloc_storage(m, old.cap * 2);
+
+	for(isize slot = map_next(&old, -1); slot >= 0; slot = map_next(&old, slot)){
+		void const* key = map_key_at(&old, slot);
+		u64 hash = map_hash(m, key);
+		isize dst = map_find_empty(m, hash);
+		map_set_ctrl(m, dst, (u8)(hash & 0x7f));
+		mem_copy_no_overlap(map_key_at(m, dst), key, m->key_size);
+		mem_copy_no_overlap(map_value_at(m, dst), map_value_at(&old, slot), m->value_size);
+	}
+
+	if(old.arena == NULL){
+		heap_free(old.keys);
+	}
+}
+
+void* map_get(HashMap const* m, void const* key){
+	isize slot = map_find(m, key, map_hash(m, key));
+	return slot >= 0 ? map_value_at(m, slot) : NULL;
+}
+
+void* map_put(HashMap* m, void const* key, bool* inserted){
+	u64 hash = map_hash(m, key);
+	isize slot = map_find(m, key, hash);
+	if(inserted != NULL){
+		*inserted = slot < 0;
+	}
+	if(slot >= 0){
+		return map_value_at(m, slot);
+	}
+
+	/* At most three quarters full, linear probes stay within a group or two */
+	if((m->len + 1) * 4 > m->cap * 3){
+		map_grow(m);
+	}
+	slot = map_find_empty(m, hash);
+	map_set_ctrl(m, slot, (u8)(hash & 0x7f));
+	mem_copy_no_overlap(map_key_at(m, slot), key, m->key_size);
+	mem_set(map_value_at(m, slot), 0, m->value_size);
+	m->len += 1;
+	return map_value_at(m, slot);
+}
+
+bool map_remove(HashMap* m, void const* key){
+	isize hole = map_find(m, key, map_hash(m, key));
+	if(hole < 0){
+		return false;
+	}
+
+	/* Backward shift: pull each later entry of the run into the hole unless that would move
+	   it before its home slot */
+	isize mask = m->cap - 1;
+	for(isize j = (hole + 1) & mask; m->ctrl[j] != MAP_EMPTY; j = (j + 1) & mask){
+		isize home = map_home(m, map_hash(m, map_key_at(m, j)));
+		if(((j - home) & mask) >= ((j - hole) & mask)){
+			map_set_ctrl(m, hole, m->ctrl[j]);
+			mem_copy_no_overlap(map_key_at(m, hole), map_key_at(m, j), m->key_size);
+			mem_copy_no_overlap(map_value_at(m, hole), map_value_at(m, j), m->value_size);
+			hole = j;
+		}
+	}
+	map_set_ctrl(m, hole, MAP_EMPTY);
+	m->len -= 1;
+	return true;
+}
+
+void map_clear(HashMap* m){
+	mem_set(m->ctrl, MAP_EMPTY, m->cap + MAP_GROUP_WIDTH);
+	m->len = 0;
+}
+
+void map_destroy(HashMap* m){
+	if(m->arena == NULL){
+		heap_free(m->keys);
+	}
+	*m = (HashMap){0};
+}
+
+isize map_next(HashMap const* m, isize slot){
+	for(isize i = slot + 1; i < m->cap; i += 1){
+		if(m->ctrl[i] != MAP_EMPTY){
+			return i;
+		}
+	}
+	return -1;
+}
+
+u64 map_hash_string(void const* key){
+	String const* s = key;
+	return hash_bytes(s->v, s->len, 0);
+}
+
+bool map_equal_string(void const* a, void const* b){
+	return str_equals(*(String const*)a, *(String const*)b);
+}
+
+#undef MAP_EMPTY
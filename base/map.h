@@ -0,0 +1,64 @@
+#pragma once
+#include "types.h"
+#include "memory.h"
+
+//// Hash map
+/* Open addressing with one control byte per slot, either MAP_EMPTY or the low 7 bits of the
+   key's hash. A probe compares MAP_GROUP_WIDTH control bytes at once and only touches keys
+   whose control byte matches. Probing is linear, so deletion shifts later entries back
+   instead of leaving tombstones. */
+
+#define MAP_GROUP_WIDTH 16
+
+typedef u64 (*MapHashFunc)(void const* key);
+
+typedef bool (*MapEqualFunc)(void const* a, void const* b);
+
+typedef struct {
+	u8* ctrl;     /* `cap` bytes followed by a copy of the first MAP_GROUP_WIDTH */
+	byte* keys;
+	byte* values;
+	isize len;
+	isize cap;    /* Power of two */
+	isize key_size;
+	isize value_size;
+
+	MapHashFunc hash;   /* The key bytes are hashed and compared when null */
+	MapEqualFunc equal;
+	Arena* arena;       /* Heap backed when null, arena backed maps abandon their old storage on growth */
+} HashMap;
+
+// Room for `capacity` entries before the first growth
+HashMap map_create(isize key_size, isize value_size, isize capacity, Arena* arena);
+
+#define map_make(Key, Value, Capacity, A) map_create(sizeof(Key), sizeof(Value), (Capacity), (A))
+
+// Value stored under `key` or null. Pointers into the map are invalidated by `map_put` and `map_remove`.
+void* map_get(HashMap const* m, void const* key);
+
+// Value stored under `key`, inserting a zeroed one first if there is none
+void* map_put(HashMap* m, void const* key, bool* inserted);
+
+bool map_remove(HashMap* m, void const* key);
+
+void map_clear(HashMap* m);
+
+void map_destroy(HashMap* m);
+
+// First occupied slot after `slot`, -1 at the end. Iterate from -1.
+isize map_next(HashMap const* m, isize slot);
+
+static inline
+void* map_key_at(HashMap const* m, isize slot){
+	return m->keys + slot * m->key_size;
+}
+
+static inline
+void* map_value_at(HashMap const* m, isize slot){
+	return m->values + slot * m->value_size;
+}
+
+// Hash and equality for `String` keys, the bytes are not copied
+u64 map_hash_string(void const* key);
+
+bool map_equal_string(void const* a, void const* b);
@@ -35,3 +35,36 @@ int mem_compare(void const* left, void const* right, isize count){
 }
 #endif
 
+
+#if defined(ARCH_X64)
+#include <emmintrin.h>
+#include "bits.h"
+
+isize mem_find_byte2(void const* buf, isize count, byte a, byte b){
+	byte const* p = buf;
+	isize i = 0;
+
+	const __m128i va = _mm_set1_epi8((char)a);
+	const __m128i vb = _mm_set1_epi8((char)b);
+	for(; i + 16 <= count; i += 16){
+		__m128i v = _mm_loadu_si128((__m128i const*)(p + i));
+		u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)));
+		if(mask != 0){
+			return i + bit_ctz32(mask);
+		}
+	}
+
+	for(; i < count; i += 1){
+		if(p[i] == a || p[i] == b){ return i; }
+	}
+	return -1;
+}
+#else
+isize mem_find_byte2(void const* buf, isize count, byte a, byte b){
+	byte const* p = buf;
+	for(isize i = 0; i < count; i += 1){
+		if(p[i] == a || p[i] == b){ return i; }
+	}
+	return -1;
+}
+#endif
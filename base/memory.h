@@ -16,6 +16,9 @@ void mem_set(void* dest, byte val, isize count);
 
 int mem_compare(void const* left, void const* right, isize count);
 
+// Index of the first byte equal to `a` or `b`, -1 if there is none
+isize mem_find_byte2(void const* buf, isize count, byte a, byte b);
+
 static inline
 bool mem_valid_alignment(usize a){
 	return ((a & (a - 1)) == 0) && a > 0;
@@ -41,6 +44,41 @@ isize mem_align_forward_size(isize p, isize a){
 	return p;
 }
 
+//// Virtual memory
+typedef enum {
+	MemProtect_None,
+	MemProtect_ReadWrite,
+	MemProtect_ReadExecute,
+} MemProtect;
+
+// Granularity of the functions below
+isize mem_page_size();
+
+// Zeroed read-write pages, `size` is rounded up to whole pages. Returns null on failure.
+void* mem_virtual_alloc(isize size);
+
+// Changes the access of whole pages within one allocation
+bool mem_virtual_protect(void* ptr, isize size, MemProtect prot);
+
+void mem_virtual_free(void* ptr, isize size);
+
+//// Memory accounting
+// Only collected when built with MEM_ACCOUNTING defined, otherwise every hook is a no-op.
+typedef struct ArenaStats ArenaStats;
+
+struct ArenaStats {
+	char const* tag;
+	isize in_use;
+	isize peak_in_use;
+	isize capacity;         /* Total ever reserved, including chained blocks */
+	isize block_count;
+	isize allocation_count;
+	isize padding;          /* Bytes lost to alignment */
+	isize realloc_in_place;
+	isize realloc_copies;
+	ArenaStats* next;
+};
+
 //// Arena allocator
 typedef struct Arena Arena;
 
@@ -51,13 +89,19 @@ struct Arena {
 
 	void* last_allocation;
 	Arena* next; /* Always null for non-dynamic arenas */
+	Arena* current; /* Block taking new allocations, null while it is this one */
+	ArenaStats* stats; /* Null unless tagged with accounting enabled */
 	i32 region_count;
 	bool dynamic;
 };
 
+// Everything allocated after `arena_region_begin` is released by `arena_region_end`, including
+// the chained blocks of a dynamic arena
 typedef struct {
 	Arena* arena;
+	Arena* block;
 	isize offset;
+	void* last_allocation;
 } ArenaRegion;
 
 #define arena_make(A, Type, Count) \
@@ -79,8 +123,25 @@ void arena_region_end(ArenaRegion reg);
 
 void* arena_realloc(Arena* a, void* ptr, isize old_size, isize new_size, isize align);
 
+// Frees the extra blocks allocated by a dynamic arena, the initial buffer belongs to the caller
+void arena_destroy(Arena* a);
+
+// Names the arena in the memory report, the tag must outlive the program
+void arena_set_tag(Arena* a, char const* tag);
+
 //// Heap allocator
 void* heap_alloc(isize size, isize align);
 
 void heap_free(void* ptr);
 
+//// Accounting report
+typedef struct {
+	i64 live_bytes;
+	i64 peak_bytes;
+	i64 allocation_count;
+} HeapStats;
+
+HeapStats heap_stats();
+
+void mem_accounting_report();
+
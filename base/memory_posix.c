@@ -0,0 +1,33 @@
+#include "memory.h"
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+isize mem_page_size(){
+	static isize size = 0;
+	if(size == 0){
+		size = (isize)sysconf(_SC_PAGESIZE);
+	}
+	return size;
+}
+
+void* mem_virtual_alloc(isize size){
+	size = mem_align_forward_size(size, mem_page_size());
+	void* ptr = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+bool mem_virtual_protect(void* ptr, isize size, MemProtect prot){
+	static int const flags[] = {
+		[MemProtect_None]        = PROT_NONE,
+		[MemProtect_ReadWrite]   = PROT_READ | PROT_WRITE,
+		[MemProtect_ReadExecute] = PROT_READ | PROT_EXEC,
+	};
+	return mprotect(ptr, (size_t)mem_align_forward_size(size, mem_page_size()), flags[prot]) == 0;
+}
+
+void mem_virtual_free(void* ptr, isize size){
+	if(ptr != NULL){
+		munmap(ptr, (size_t)mem_align_forward_size(size, mem_page_size()));
+	}
+}
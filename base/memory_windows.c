@@ -0,0 +1,35 @@
+#include "memory.h"
+
+#define WIN32_MEAN_AND_LEAN
+#include <windows.h>
+
+isize mem_page_size(){
+	static isize size = 0;
+	if(size == 0){
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		size = (isize)info.dwPageSize;
+	}
+	return size;
+}
+
+void* mem_virtual_alloc(isize size){
+	return VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+bool mem_virtual_protect(void* ptr, isize size, MemProtect prot){
+	static DWORD const flags[] = {
+		[MemProtect_None]        = PAGE_NOACCESS,
+		[MemProtect_ReadWrite]   = PAGE_READWRITE,
+		[MemProtect_ReadExecute] = PAGE_EXECUTE_READ,
+	};
+	DWORD old;
+	return VirtualProtect(ptr, (SIZE_T)size, flags[prot], &old) != 0;
+}
+
+void mem_virtual_free(void* ptr, isize size){
+	(void)size;
+	if(ptr != NULL){
+		VirtualFree(ptr, 0, MEM_RELEASE);
+	}
+}
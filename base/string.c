@@ -38,16 +38,6 @@ String str_sub(String s, isize start, isize end){
 
 #define STRCONV_TEMP_BUFFER_SIZE 128
 
-static inline
-i64 str_ipow10(int exponent){
-	ensure(exponent >= 0, "Invalid exponent");
-	i64 n = 1;
-	for(int i = 0; i < exponent; i++){
-		n *= 10;
-	}
-	return n;
-}
-
 static inline
 int str_digit_value(char c, int base){
 	int val = -1;
@@ -89,34 +79,35 @@ bool str_parse_i64(String s, u32 base, i64* out){
 		s = str_sub(s, 1, s.len);
 	}
 
-	i64 n = 0;
+	u64 n = 0;
 	*out = 0;
 
 	int digit_count = 0;
-	for(isize i = s.len - 1; i >= 0; i -= 1){
+	for(isize i = 0; i < s.len; i += 1){
 		char c = s.v[i];
 		if(c == '_'){ continue; }
 
-		i64 dig = str_digit_value(c, 16);
+		int dig = str_digit_value(c, base);
 		if(dig < 0){
 			return false;
 		}
-
-		switch(base){
-		case 2:  n |= dig << digit_count; break;
-		case 8:  n |= dig << (digit_count * 3); break;
-		case 16: n |= dig << (digit_count * 4); break;
-		case 10: n += dig * str_ipow10(digit_count); break;
+		if(n > (UINT64_MAX - (u64)dig) / base){
+			return false; /* Overflow */
 		}
-
+		n = (n * base) + (u64)dig;
 		digit_count += 1;
 	}
 
-	if(negate){
-		n = -n;
+	if(digit_count == 0){
+		return false;
+	}
+
+	/* Decimal must fit in an i64, other bases may use all 64 bits as a pattern */
+	if(base == 10 && n > (u64)INT64_MAX + (negate ? 1 : 0)){
+		return false;
 	}
 
-	*out = n;
+	*out = negate ? (i64)(0 - n) : (i64)n;
 	return true;
 }
 
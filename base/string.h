@@ -20,6 +20,16 @@ typedef struct {
 	i32  len;
 } UTF8Decoded;
 
+typedef struct {
+	rune const* v;
+	isize len;
+} UTF32String;
+
+typedef struct {
+	u16 const* v;
+	isize len;
+} UTF16String;
+
 static inline
 bool utf8_is_continuation_byte(rune c){
 	static const rune CONTINUATION1 = 0x80;
@@ -33,6 +43,46 @@ UTF8Encoded utf8_encode(rune r);
 
 UTF8Decoded utf8_decode(byte const* buf, isize n);
 
+// Checks a whole buffer for well-formed UTF-8 (no overlongs, surrogates or runes past U+10FFFF),
+// on failure `error_offset` receives the offset of the first invalid sequence.
+bool utf8_validate(byte const* buf, isize n, isize* error_offset);
+
+// Bulk transcoding into arena memory, invalid sequences become U+FFFD
+UTF32String utf8_to_utf32(Arena* arena, String s);
+
+UTF16String utf8_to_utf16(Arena* arena, String s);
+
+// Number of runes in valid UTF-8
+isize utf8_count_runes(String s);
+
+// Number of UTF-16 code units needed to encode valid UTF-8, the UTF-16 column of a byte offset
+// is `utf8_count_utf16(str_sub(line, 0, offset))`
+isize utf8_count_utf16(String s);
+
+// Unicode identifier properties (UAX #31), '_' is not XID_Start
+bool unicode_is_xid_start(rune c);
+
+bool unicode_is_xid_continue(rune c);
+
+// Decodes a rune from a buffer that already passed `utf8_validate`, no checks are performed
+static inline
+UTF8Decoded utf8_decode_unchecked(byte const* buf){
+	byte first = buf[0];
+	if(first < 0x80){
+		return (UTF8Decoded){ .codepoint = first, .len = 1 };
+	}
+	if(first < 0xe0){
+		return (UTF8Decoded){ .codepoint = ((first & 0x1f) << 6) | (buf[1] & 0x3f), .len = 2 };
+	}
+	if(first < 0xf0){
+		return (UTF8Decoded){ .codepoint = ((first & 0x0f) << 12) | ((buf[1] & 0x3f) << 6) | (buf[2] & 0x3f), .len = 3 };
+	}
+	return (UTF8Decoded){
+		.codepoint = ((first & 0x07) << 18) | ((buf[1] & 0x3f) << 12) | ((buf[2] & 0x3f) << 6) | (buf[3] & 0x3f),
+		.len = 4,
+	};
+}
+
 String str_format(Arena* arena, char const * restrict fmt, ...) str_attribute_format(2, 3);
 
 String str_vformat(Arena* arena, char const * restrict fmt, va_list argp);
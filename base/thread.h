@@ -13,4 +13,7 @@ void thread_terminate(Thread* t);
 
 void thread_destroy(Thread* t);
 
+// Number of logical processors available to the process, at least 1
+i32 thread_hardware_count();
+
 
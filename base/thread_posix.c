@@ -1,5 +1,6 @@
 #define _XOPEN_SOURCE 800
 #include <pthread.h>
+#include <unistd.h>
 #include "memory.h"
 #include "thread.h"
 #include "atomic.h"
@@ -33,7 +34,7 @@ Thread* thread_create(ThreadFunc f, void* arg){
 
 	int mutex_status = pthread_mutex_init(&t->mutex, NULL);
 	int thread_status = pthread_create( &t->handle, NULL, thread_pthread_wrapper, t);
-	ensure(thread_status >= 0 && mutex_status >= mutex_status, "Failed to create thread");
+	ensure(thread_status == 0 && mutex_status == 0, "Failed to create thread");
 	return t;
 }
 
@@ -74,3 +75,7 @@ void thread_destroy(Thread* t){
 	heap_free(t);
 }
 
+i32 thread_hardware_count(){
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (i32)n : 1;
+}
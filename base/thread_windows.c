@@ -36,3 +36,9 @@ void thread_destroy(Thread* t){
 void thread_terminate(Thread* t){
 	TerminateThread(t->handle, 1);
 }
+
+i32 thread_hardware_count(){
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (i32)info.dwNumberOfProcessors : 1;
+}
@@ -14,7 +14,14 @@
 	#define force_inline __attribute__((always_inline)) inline
 #endif
 
-#define static_assert(Pred, Msg) _Static_assert((Pred), (Msg))
+// Allows a single function to use an instruction set extension, callers must check `cpu_features()` first
+#if defined(COMPILER_MSVC)
+	#define target_feature(F)
+#else
+	#define target_feature(F) __attribute__((target(F)))
+#endif
+
+#define static_assert(Pred, Msg) _Static_assert((Pred), Msg)
 
 #define min(A, B) (((A) < (B)) ? (A) : (B))
 
@@ -1,4 +1,7 @@
 #include "string.h"
+#include "cpu.h"
+#include "bits.h"
+#include "xid_tables.h"
 
 #define UTF8_RANGE1 ((i32)0x7f)
 #define UTF8_RANGE2 ((i32)0x7ff)
@@ -37,7 +40,7 @@ i32 utf8_rune_size(rune c){
 UTF8Encoded utf8_encode(rune c){
 	UTF8Encoded res = {};
 
-	if(utf8_is_continuation_byte(c) ||
+	if((c < 0) ||
 	   (c >= UTF16_SURROGATE1 && c <= UTF16_SURROGATE2) ||
 	   (c > UTF8_RANGE4))
 	{
@@ -106,6 +109,9 @@ UTF8Decoded utf8_decode(byte const* buf, isize len){
 	if(res.codepoint >= UTF16_SURROGATE1 && res.codepoint <= UTF16_SURROGATE2){
 		return UTF8_DECODE_ERROR;
 	}
+	if(res.codepoint > UTF8_RANGE4 || utf8_rune_size(res.codepoint) != res.len){
+		return UTF8_DECODE_ERROR; /* Out of range or overlong encoding */
+	}
 	if(res.len > 1 && !utf8_is_continuation_byte(buf[1])){
 		return UTF8_DECODE_ERROR;
 	}
@@ -119,6 +125,495 @@ UTF8Decoded utf8_decode(byte const* buf, isize len){
 	return res;
 }
 
+//// Validation
+/* Scalar validation following the well-formed byte sequences table of the Unicode standard (Table 3-7) */
+static
+isize utf8_validate_scalar(byte const* buf, isize len, isize start){
+	isize i = start;
+	while(i < len){
+		/* ASCII fast path, 8 bytes at a time */
+		if(i + 8 <= len){
+			u64 chunk = 0;
+			mem_copy_no_overlap(&chunk, buf + i, 8);
+			if((chunk & 0x8080808080808080ull) == 0){
+				i += 8;
+				continue;
+			}
+		}
+
+		byte lead = buf[i];
+		if(lead < 0x80){
+			i += 1;
+			continue;
+		}
+
+		isize size = 0;
+		byte lo = 0x80, hi = 0xbf; /* Valid range of the second byte */
+		if(lead >= 0xc2 && lead <= 0xdf){ size = 2; }
+		else if(lead == 0xe0){ size = 3; lo = 0xa0; }
+		else if(lead >= 0xe1 && lead <= 0xec){ size = 3; }
+		else if(lead == 0xed){ size = 3; hi = 0x9f; }
+		else if(lead >= 0xee && lead <= 0xef){ size = 3; }
+		else if(lead == 0xf0){ size = 4; lo = 0x90; }
+		else if(lead >= 0xf1 && lead <= 0xf3){ size = 4; }
+		else if(lead == 0xf4){ size = 4; hi = 0x8f; }
+		else {
+			return i;
+		}
+
+		if(i + size > len){ return i; }
+		if(buf[i + 1] < lo || buf[i + 1] > hi){ return i; }
+		for(isize k = 2; k < size; k += 1){
+			if(!utf8_is_continuation_byte(buf[i + k])){ return i; }
+		}
+		i += size;
+	}
+	return -1;
+}
+
+/* Backs up from `pos` to the lead byte of the rune it is part of */
+static inline
+isize utf8_rune_start(byte const* buf, isize pos, isize lower_bound){
+	isize limit = max(lower_bound, pos - 3);
+	while(pos > limit && utf8_is_continuation_byte(buf[pos])){
+		pos -= 1;
+	}
+	return pos;
+}
+
+/* Resumes validation at `pos` with the scalar path, including a sequence that may straddle it */
+static inline
+isize utf8_validate_from(byte const* buf, isize len, isize pos){
+	isize start = pos > 0 ? utf8_rune_start(buf, pos - 1, 0) : 0;
+	return utf8_validate_scalar(buf, len, start);
+}
+
+#define UTF8_VALIDATE_CHUNK 64
+
+#if defined(ARCH_X64)
+#include <immintrin.h>
+
+/* Error classes of the lookup algorithm (Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte").
+   Every pair of consecutive bytes is classified through three 16 entry tables indexed by nibbles, an error
+   remains when a class bit survives in all three lookups. */
+#define UTF8_TOO_SHORT      (1 << 0)
+#define UTF8_TOO_LONG       (1 << 1)
+#define UTF8_OVERLONG_3     (1 << 2)
+#define UTF8_TOO_LARGE      (1 << 3)
+#define UTF8_SURROGATE      (1 << 4)
+#define UTF8_OVERLONG_2     (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4     (1 << 6)
+#define UTF8_TWO_CONTS      (1 << 7)
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define UTF8_BYTE_1_HIGH \
+	UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+	UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+	UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, \
+	UTF8_TOO_SHORT | UTF8_OVERLONG_2, \
+	UTF8_TOO_SHORT, \
+	UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE, \
+	UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+#define UTF8_BYTE_1_LOW \
+	UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, \
+	UTF8_CARRY | UTF8_OVERLONG_2, \
+	UTF8_CARRY, \
+	UTF8_CARRY, \
+	UTF8_CARRY | UTF8_TOO_LARGE, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+
+#define UTF8_BYTE_2_HIGH \
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE, \
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE, \
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+target_feature("sse4.1")
+static inline
+__m128i utf8_check_block_sse(__m128i input, __m128i prev_input){
+	const __m128i byte_1_high_tbl = _mm_setr_epi8(UTF8_BYTE_1_HIGH);
+	const __m128i byte_1_low_tbl  = _mm_setr_epi8(UTF8_BYTE_1_LOW);
+	const __m128i byte_2_high_tbl = _mm_setr_epi8(UTF8_BYTE_2_HIGH);
+	const __m128i low_nibble = _mm_set1_epi8(0x0f);
+
+	__m128i prev1 = _mm_alignr_epi8(input, prev_input, 16 - 1);
+	__m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_tbl, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+	__m128i byte_1_low  = _mm_shuffle_epi8(byte_1_low_tbl, _mm_and_si128(prev1, low_nibble));
+	__m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_tbl, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+	__m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+	/* Third and fourth bytes of a sequence must be continuations, which the table above cannot see */
+	__m128i prev2 = _mm_alignr_epi8(input, prev_input, 16 - 2);
+	__m128i prev3 = _mm_alignr_epi8(input, prev_input, 16 - 3);
+	__m128i is_third_byte  = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xe0 - 0x80)));
+	__m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xf0 - 0x80)));
+	__m128i must23_80 = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8((char)0x80));
+
+	return _mm_xor_si128(must23_80, special_cases);
+}
+
+/* Non zero when the block ends in the middle of a multi byte sequence */
+target_feature("sse4.1")
+static inline
+__m128i utf8_incomplete_sse(__m128i input){
+	const __m128i max_value = _mm_setr_epi8(
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		(char)(0xf0 - 1), (char)(0xe0 - 1), (char)(0xc0 - 1));
+	return _mm_subs_epu8(input, max_value);
+}
+
+target_feature("sse4.1")
+static
+isize utf8_validate_sse(byte const* buf, isize len){
+	__m128i prev_input = _mm_setzero_si128();
+	__m128i prev_incomplete = _mm_setzero_si128();
+
+	isize i = 0;
+	for(; i + UTF8_VALIDATE_CHUNK <= len; i += UTF8_VALIDATE_CHUNK){
+		__m128i blocks[4];
+		for(int k = 0; k < 4; k += 1){
+			blocks[k] = _mm_loadu_si128((__m128i const*)(buf + i + (k * 16)));
+		}
+		__m128i error = _mm_setzero_si128();
+
+		__m128i any = _mm_or_si128(_mm_or_si128(blocks[0], blocks[1]), _mm_or_si128(blocks[2], blocks[3]));
+		if(_mm_movemask_epi8(any) == 0){
+			error = prev_incomplete;
+			prev_incomplete = _mm_setzero_si128();
+		}
+		else {
+			error = utf8_check_block_sse(blocks[0], prev_input);
+			for(int k = 1; k < 4; k += 1){
+				error = _mm_or_si128(error, utf8_check_block_sse(blocks[k], blocks[k - 1]));
+			}
+			prev_incomplete = utf8_incomplete_sse(blocks[3]);
+		}
+		prev_input = blocks[3];
+
+		if(!_mm_testz_si128(error, error)){
+			return utf8_validate_from(buf, len, i);
+		}
+	}
+
+	return utf8_validate_from(buf, len, i);
+}
+
+target_feature("avx2")
+static inline
+__m256i utf8_check_block_avx2(__m256i input, __m256i prev_input){
+	const __m256i byte_1_high_tbl = _mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH);
+	const __m256i byte_1_low_tbl  = _mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW);
+	const __m256i byte_2_high_tbl = _mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH);
+	const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+
+	/* Lanes are independent in AVX2 shuffles, build the shifted vectors through the crossing permute */
+	__m256i shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+	__m256i prev1 = _mm256_alignr_epi8(input, shifted, 16 - 1);
+	__m256i prev2 = _mm256_alignr_epi8(input, shifted, 16 - 2);
+	__m256i prev3 = _mm256_alignr_epi8(input, shifted, 16 - 3);
+
+	__m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_tbl, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+	__m256i byte_1_low  = _mm256_shuffle_epi8(byte_1_low_tbl, _mm256_and_si256(prev1, low_nibble));
+	__m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_tbl, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+	__m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+	__m256i is_third_byte  = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xe0 - 0x80)));
+	__m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xf0 - 0x80)));
+	__m256i must23_80 = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8((char)0x80));
+
+	return _mm256_xor_si256(must23_80, special_cases);
+}
+
+target_feature("avx2")
+static inline
+__m256i utf8_incomplete_avx2(__m256i input){
+	const __m256i max_value = _mm256_setr_epi8(
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		(char)(0xf0 - 1), (char)(0xe0 - 1), (char)(0xc0 - 1));
+	return _mm256_subs_epu8(input, max_value);
+}
+
+target_feature("avx2")
+static
+isize utf8_validate_avx2(byte const* buf, isize len){
+	__m256i prev_input = _mm256_setzero_si256();
+	__m256i prev_incomplete = _mm256_setzero_si256();
+
+	isize i = 0;
+	for(; i + UTF8_VALIDATE_CHUNK <= len; i += UTF8_VALIDATE_CHUNK){
+		__m256i lo = _mm256_loadu_si256((__m256i const*)(buf + i));
+		__m256i hi = _mm256_loadu_si256((__m256i const*)(buf + i + 32));
+		__m256i error;
+
+		if(_mm256_movemask_epi8(_mm256_or_si256(lo, hi)) == 0){
+			error = prev_incomplete;
+			prev_incomplete = _mm256_setzero_si256();
+		}
+		else {
+			error = _mm256_or_si256(utf8_check_block_avx2(lo, prev_input), utf8_check_block_avx2(hi, lo));
+			prev_incomplete = utf8_incomplete_avx2(hi);
+		}
+		prev_input = hi;
+
+		if(!_mm256_testz_si256(error, error)){
+			break;
+		}
+	}
+
+	/* Leave the upper halves clean, legacy SSE code running after this (the hash map probe) pays for
+	   every state transition otherwise */
+	_mm256_zeroupper();
+	return utf8_validate_from(buf, len, i);
+}
+
+#undef UTF8_TOO_SHORT
+#undef UTF8_TOO_LONG
+#undef UTF8_OVERLONG_3
+#undef UTF8_TOO_LARGE
+#undef UTF8_SURROGATE
+#undef UTF8_OVERLONG_2
+#undef UTF8_TOO_LARGE_1000
+#undef UTF8_OVERLONG_4
+#undef UTF8_TWO_CONTS
+#undef UTF8_CARRY
+#undef UTF8_BYTE_1_HIGH
+#undef UTF8_BYTE_1_LOW
+#undef UTF8_BYTE_2_HIGH
+#endif
+
+bool utf8_validate(byte const* buf, isize len, isize* error_offset){
+	isize bad = -1;
+	CpuFeatures cpu = cpu_features();
+	(void)cpu;
+
+#if defined(ARCH_X64)
+	if(cpu.avx2){
+		bad = utf8_validate_avx2(buf, len);
+	}
+	else if(cpu.sse41){
+		bad = utf8_validate_sse(buf, len);
+	}
+	else
+#endif
+	{
+		bad = utf8_validate_scalar(buf, len, 0);
+	}
+
+	if(error_offset != NULL){
+		*error_offset = bad;
+	}
+	return bad < 0;
+}
+
+#undef UTF8_VALIDATE_CHUNK
+
+//// Transcoding
+#if defined(ARCH_X64)
+#include <emmintrin.h>
+#define UTF8_BLOCK 16
+#else
+#define UTF8_BLOCK 8
+#endif
+
+/* True when the next UTF8_BLOCK bytes are all ASCII */
+static inline
+bool utf8_block_is_ascii(byte const* p){
+#if defined(ARCH_X64)
+	return _mm_movemask_epi8(_mm_loadu_si128((__m128i const*)p)) == 0;
+#else
+	u64 chunk = 0;
+	mem_copy_no_overlap(&chunk, p, 8);
+	return (chunk & 0x8080808080808080ull) == 0;
+#endif
+}
+
+static inline
+void utf8_widen_ascii_32(rune* out, byte const* p){
+#if defined(ARCH_X64)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i v = _mm_loadu_si128((__m128i const*)p);
+	__m128i lo16 = _mm_unpacklo_epi8(v, zero);
+	__m128i hi16 = _mm_unpackhi_epi8(v, zero);
+	_mm_storeu_si128((__m128i*)(out + 0),  _mm_unpacklo_epi16(lo16, zero));
+	_mm_storeu_si128((__m128i*)(out + 4),  _mm_unpackhi_epi16(lo16, zero));
+	_mm_storeu_si128((__m128i*)(out + 8),  _mm_unpacklo_epi16(hi16, zero));
+	_mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi16(hi16, zero));
+#else
+	for(isize i = 0; i < UTF8_BLOCK; i += 1){ out[i] = p[i]; }
+#endif
+}
+
+static inline
+void utf8_widen_ascii_16(u16* out, byte const* p){
+#if defined(ARCH_X64)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i v = _mm_loadu_si128((__m128i const*)p);
+	_mm_storeu_si128((__m128i*)(out + 0), _mm_unpacklo_epi8(v, zero));
+	_mm_storeu_si128((__m128i*)(out + 8), _mm_unpackhi_epi8(v, zero));
+#else
+	for(isize i = 0; i < UTF8_BLOCK; i += 1){ out[i] = p[i]; }
+#endif
+}
+
+/* Shrinks the output buffer when it is still the arena's last allocation */
+static inline
+void utf8_shrink_output(Arena* arena, void* buf, isize used_bytes){
+	if(buf != NULL && used_bytes > 0){
+		arena_resize_in_place(arena, buf, used_bytes);
+	}
+}
+
+UTF32String utf8_to_utf32(Arena* arena, String s){
+	if(s.len == 0){ return (UTF32String){0}; }
+
+	/* Every rune takes at least one byte */
+	rune* out = arena_make(arena, rune, s.len);
+	if(out == NULL){ return (UTF32String){0}; }
+
+	isize n = 0;
+	isize i = 0;
+	while(i < s.len){
+		if(i + UTF8_BLOCK <= s.len && utf8_block_is_ascii(s.v + i)){
+			utf8_widen_ascii_32(out + n, s.v + i);
+			i += UTF8_BLOCK;
+			n += UTF8_BLOCK;
+			continue;
+		}
+		if(s.v[i] < 0x80){
+			out[n] = s.v[i];
+			n += 1;
+			i += 1;
+			continue;
+		}
+		UTF8Decoded dec = utf8_decode(s.v + i, s.len - i);
+		out[n] = dec.codepoint;
+		n += 1;
+		i += dec.len;
+	}
+
+	utf8_shrink_output(arena, out, n * (isize)sizeof(rune));
+	return (UTF32String){ .v = out, .len = n };
+}
+
+UTF16String utf8_to_utf16(Arena* arena, String s){
+	if(s.len == 0){ return (UTF16String){0}; }
+
+	/* Runes outside the BMP take 4 bytes and 2 code units, so the byte count is an upper bound */
+	u16* out = arena_make(arena, u16, s.len);
+	if(out == NULL){ return (UTF16String){0}; }
+
+	isize n = 0;
+	isize i = 0;
+	while(i < s.len){
+		if(i + UTF8_BLOCK <= s.len && utf8_block_is_ascii(s.v + i)){
+			utf8_widen_ascii_16(out + n, s.v + i);
+			i += UTF8_BLOCK;
+			n += UTF8_BLOCK;
+			continue;
+		}
+		if(s.v[i] < 0x80){
+			out[n] = s.v[i];
+			n += 1;
+			i += 1;
+			continue;
+		}
+		UTF8Decoded dec = utf8_decode(s.v + i, s.len - i);
+		rune c = dec.codepoint;
+		if(c > UTF8_RANGE3){
+			c -= 0x10000;
+			out[n + 0] = (u16)(UTF16_SURROGATE1 + (c >> 10));
+			out[n + 1] = (u16)(0xdc00 + (c & 0x3ff));
+			n += 2;
+		}
+		else {
+			out[n] = (u16)c;
+			n += 1;
+		}
+		i += dec.len;
+	}
+
+	utf8_shrink_output(arena, out, n * (isize)sizeof(u16));
+	return (UTF16String){ .v = out, .len = n };
+}
+
+/* Counts lead bytes, and with `count_wide` also adds the extra surrogate of 4 byte sequences */
+static inline
+isize utf8_count_leads(String s, bool count_wide){
+	isize count = 0;
+	isize i = 0;
+
+#if defined(ARCH_X64)
+	const __m128i continuation_max = _mm_set1_epi8((char)0xbf);
+	const __m128i wide_min = _mm_set1_epi8((char)(0xf0 - 1));
+	for(; i + 16 <= s.len; i += 16){
+		__m128i v = _mm_loadu_si128((__m128i const*)(s.v + i));
+		/* Signed compare: continuation bytes are 0x80..0xbf, the smallest signed values */
+		u32 leads = (u32)_mm_movemask_epi8(_mm_cmpgt_epi8(v, continuation_max));
+		count += bit_popcount32(leads);
+		if(count_wide){
+			__m128i wide = _mm_cmpeq_epi8(_mm_subs_epu8(v, wide_min), _mm_setzero_si128());
+			count += 16 - bit_popcount32((u32)_mm_movemask_epi8(wide));
+		}
+	}
+#endif
+
+	for(; i < s.len; i += 1){
+		byte b = s.v[i];
+		count += !utf8_is_continuation_byte(b);
+		count += count_wide && b >= 0xf0;
+	}
+	return count;
+}
+
+isize utf8_count_runes(String s){
+	return utf8_count_leads(s, false);
+}
+
+isize utf8_count_utf16(String s){
+	return utf8_count_leads(s, true);
+}
+
+#undef UTF8_BLOCK
+
+//// Identifier properties
+static inline
+u32 unicode_xid_flags(rune c){
+	if(c < 0){ return 0; }
+	if(c < XID_TABLE_LIMIT){
+		u8 block = xid_index[c >> XID_BLOCK_SHIFT];
+		u32 bits = xid_blocks[block][(c & ((1 << XID_BLOCK_SHIFT) - 1)) >> 2];
+		return (bits >> ((c & 3) * 2)) & 3;
+	}
+	for(isize i = 0; i < (isize)(sizeof(xid_continue_tail) / sizeof(xid_continue_tail[0])); i += 1){
+		if(c >= xid_continue_tail[i].lo && c <= xid_continue_tail[i].hi){ return 2; }
+	}
+	return 0;
+}
+
+bool unicode_is_xid_start(rune c){
+	return (unicode_xid_flags(c) & 1) != 0;
+}
+
+bool unicode_is_xid_continue(rune c){
+	return (unicode_xid_flags(c) & 2) != 0;
+}
+
 #undef UTF8_RANGE1
 #undef UTF8_RANGE2
 #undef UTF8_RANGE3
@@ -0,0 +1,375 @@
+#include "benchmark.h"
+#include "base/map.h"
+#include "base/array.h"
+
+#define BASE_BENCH_BATCH 1024
+
+static
+void bench_utf8_decode(void* ctx){
+	String* s = ctx;
+	i64 sum = 0;
+	for(isize i = 0; i < s->len;){
+		UTF8Decoded dec = utf8_decode(s->v + i, s->len - i);
+		sum += dec.codepoint;
+		i += dec.len;
+	}
+	bench_sink = sum;
+}
+
+static
+void bench_utf8_validate(void* ctx){
+	String* s = ctx;
+	isize offset = 0;
+	bench_sink = utf8_validate(s->v, s->len, &offset);
+}
+
+typedef struct {
+	String source;
+	Arena* arena;
+} TranscodeBench;
+
+static
+void bench_utf8_to_utf32(void* ctx){
+	TranscodeBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+	bench_sink = utf8_to_utf32(b->arena, b->source).len;
+	arena_region_end(reg);
+}
+
+static
+void bench_utf8_to_utf16(void* ctx){
+	TranscodeBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+	bench_sink = utf8_to_utf16(b->arena, b->source).len;
+	arena_region_end(reg);
+}
+
+static
+void bench_hash_bytes(void* ctx){
+	String* s = ctx;
+	bench_sink = (i64)hash_bytes(s->v, s->len, 0);
+}
+
+static
+void bench_utf8_count_runes(void* ctx){
+	String* s = ctx;
+	bench_sink = utf8_count_runes(*s);
+}
+
+typedef struct {
+	String* v;
+	u32* base;
+	isize len;
+} ParseBench;
+
+static
+void bench_str_parse_i64(void* ctx){
+	ParseBench* b = ctx;
+	i64 sum = 0;
+	for(isize i = 0; i < b->len; i += 1){
+		i64 val = 0;
+		str_parse_i64(b->v[i], b->base[i], &val);
+		sum += val;
+	}
+	bench_sink = sum;
+}
+
+static
+void bench_str_parse_f64(void* ctx){
+	ParseBench* b = ctx;
+	f64 sum = 0;
+	for(isize i = 0; i < b->len; i += 1){
+		f64 val = 0;
+		str_parse_f64(b->v[i], &val);
+		sum += val;
+	}
+	bench_sink = (i64)sum;
+}
+
+static
+void bench_arena_alloc(void* ctx){
+	Arena* arena = ctx;
+	for(isize i = 0; i < BASE_BENCH_BATCH; i += 1){
+		void* p = arena_alloc(arena, 16 + (i & 63), 8);
+		bench_sink = (i64)(uintptr)p;
+	}
+	arena_reset(arena);
+}
+
+static
+void bench_heap_alloc(void* ctx){
+	void** ptrs = ctx;
+	for(isize i = 0; i < BASE_BENCH_BATCH; i += 1){
+		ptrs[i] = heap_alloc(16 + (i & 255), 16);
+	}
+	for(isize i = 0; i < BASE_BENCH_BATCH; i += 1){
+		heap_free(ptrs[i]);
+	}
+}
+
+/* Appending to the arena's last allocation grows in place, segments never copy */
+#define ARRAY_BENCH_LEN (64 * 1024)
+
+typedef DynArray(u64) BenchU64List;
+
+static
+void bench_dyn_array_push(void* ctx){
+	Arena* arena = ctx;
+	BenchU64List list = { .arena = arena };
+	for(isize i = 0; i < ARRAY_BENCH_LEN; i += 1){
+		dyn_push(&list, (u64)i);
+	}
+	bench_sink = (i64)list.v[list.len - 1];
+	arena_reset(arena);
+}
+
+static
+void bench_seg_array_push(void* ctx){
+	Arena* arena = ctx;
+	SegArray s = seg_array_make(u64, 64, arena);
+	for(isize i = 0; i < ARRAY_BENCH_LEN; i += 1){
+		*(u64*)seg_array_push(&s) = (u64)i;
+	}
+	bench_sink = (i64)*seg_at(&s, u64, s.len - 1);
+	arena_reset(arena);
+}
+
+static
+void bench_seg_array_at(void* ctx){
+	SegArray const* s = ctx;
+	u64 sum = 0;
+	for(isize i = 0; i < s->len; i += 1){
+		sum += *seg_at(s, u64, i);
+	}
+	bench_sink = (i64)sum;
+}
+
+/* Identifier-like keys, half of them are looked up as misses */
+#define MAP_BENCH_KEYS 4096
+
+/* The baseline the Swiss-style map is measured against: linear probing over the keys themselves */
+typedef struct {
+	String* keys; /* Empty slots have a null `v` */
+	i32* values;
+	isize mask;
+} LinearMap;
+
+typedef struct {
+	String* keys;
+	String* misses;
+	HashMap map;
+	LinearMap linear;
+	Arena* arena;
+} MapBench;
+
+static
+LinearMap linear_map_create(Arena* arena, isize cap){
+	return (LinearMap){
+		.keys = arena_make(arena, String, cap),
+		.values = arena_make(arena, i32, cap),
+		.mask = cap - 1,
+	};
+}
+
+static
+i32* linear_map_put(LinearMap* m, String key){
+	isize i = (isize)hash_bytes(key.v, key.len, 0) & m->mask;
+	while(m->keys[i].v != NULL && !str_equals(m->keys[i], key)){ i = (i + 1) & m->mask; }
+	m->keys[i] = key;
+	return &m->values[i];
+}
+
+static
+i32* linear_map_get(LinearMap const* m, String key){
+	for(isize i = (isize)hash_bytes(key.v, key.len, 0) & m->mask; m->keys[i].v != NULL; i = (i + 1) & m->mask){
+		if(str_equals(m->keys[i], key)){ return &m->values[i]; }
+	}
+	return NULL;
+}
+
+static
+isize map_bench_cap(){
+	isize cap = 16;
+	while(cap * 3 < MAP_BENCH_KEYS * 4){ cap *= 2; }
+	return cap;
+}
+
+static
+void bench_map_insert(void* ctx){
+	MapBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+	HashMap m = map_make(String, i32, MAP_BENCH_KEYS, b->arena);
+	m.hash = map_hash_string;
+	m.equal = map_equal_string;
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 1){
+		*(i32*)map_put(&m, &b->keys[i], NULL) = (i32)i;
+	}
+	bench_sink = m.len;
+	arena_region_end(reg);
+}
+
+static
+void bench_map_lookup(void* ctx){
+	MapBench* b = ctx;
+	i64 sum = 0;
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 1){
+		i32* hit = map_get(&b->map, &b->keys[i]);
+		i32* miss = map_get(&b->map, &b->misses[i]);
+		sum += (hit != NULL ? *hit : 0) + (miss != NULL);
+	}
+	bench_sink = sum;
+}
+
+static
+void bench_map_remove_insert(void* ctx){
+	MapBench* b = ctx;
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 16){
+		map_remove(&b->map, &b->keys[i]);
+	}
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 16){
+		*(i32*)map_put(&b->map, &b->keys[i], NULL) = (i32)i;
+	}
+	bench_sink = b->map.len;
+}
+
+static
+void bench_linear_map_insert(void* ctx){
+	MapBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+	/* Sized up front, the baseline does not grow */
+	LinearMap m = linear_map_create(b->arena, map_bench_cap());
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 1){
+		*linear_map_put(&m, b->keys[i]) = (i32)i;
+	}
+	bench_sink = (i64)m.mask;
+	arena_region_end(reg);
+}
+
+static
+void bench_linear_map_lookup(void* ctx){
+	MapBench* b = ctx;
+	LinearMap* m = &b->linear;
+	i64 sum = 0;
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 1){
+		i32* hit = linear_map_get(m, b->keys[i]);
+		i32* miss = linear_map_get(m, b->misses[i]);
+		sum += (hit != NULL ? *hit : 0) + (miss != NULL);
+	}
+	bench_sink = sum;
+}
+
+static
+void map_bench_keys(Arena* arena, String* out, isize count, char const* prefix){
+	static char const* parts[] = { "node", "index", "buffer", "len", "parent", "value", "state", "kind", "mask", "tmp" };
+	u64 rng = 0x2545f4914f6cdd1dull;
+	for(isize i = 0; i < count; i += 1){
+		rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+		out[i] = str_format(arena, "%s%s_%s%lld", prefix, parts[rng % 10], parts[(rng >> 8) % 10], (long long)i);
+	}
+}
+
+static
+ParseBench parse_bench_create(Arena* arena, bool reals){
+	static char const* integers[] = { "0", "42", "1_000_000", "9223372036854775807", "123456789", "7" };
+	static char const* hex[] = { "DEAD_BEEF", "ff", "7fff_ffff", "1" };
+	static char const* floats[] = { "3.141592", "1e-3", "6.02e23", "0.5", "1_000.25", "2.718281828" };
+
+	ParseBench b = {
+		.v = arena_make(arena, String, BASE_BENCH_BATCH),
+		.base = arena_make(arena, u32, BASE_BENCH_BATCH),
+		.len = BASE_BENCH_BATCH,
+	};
+
+	for(isize i = 0; i < b.len; i += 1){
+		char const* s = NULL;
+		if(reals){
+			s = floats[i % (sizeof(floats) / sizeof(floats[0]))];
+			b.base[i] = 10;
+		}
+		else if(i % 4 == 3){
+			s = hex[i % (sizeof(hex) / sizeof(hex[0]))];
+			b.base[i] = 16;
+		}
+		else {
+			s = integers[i % (sizeof(integers) / sizeof(integers[0]))];
+			b.base[i] = 10;
+		}
+		b.v[i] = (String){ .v = (byte const*)s, .len = (isize)__builtin_strlen(s) };
+	}
+	return b;
+}
+
+static
+i64 parse_bench_bytes(ParseBench b){
+	i64 n = 0;
+	for(isize i = 0; i < b.len; i += 1){ n += b.v[i].len; }
+	return n;
+}
+
+void bench_base(Arena* arena, isize corpus_size){
+	ArenaRegion reg = arena_region_begin(arena);
+
+	String unicode = corpus_generate(arena, Corpus_Unicode, corpus_size);
+	bench_run("utf8_decode", bench_utf8_decode, &unicode, unicode.len);
+	bench_run("utf8_validate", bench_utf8_validate, &unicode, unicode.len);
+	bench_run("utf8_count_runes", bench_utf8_count_runes, &unicode, unicode.len);
+	bench_run("hash_bytes", bench_hash_bytes, &unicode, unicode.len);
+
+	TranscodeBench transcode = { .source = unicode, .arena = arena };
+	bench_run("utf8_to_utf32", bench_utf8_to_utf32, &transcode, unicode.len);
+	bench_run("utf8_to_utf16", bench_utf8_to_utf16, &transcode, unicode.len);
+
+	ParseBench ints = parse_bench_create(arena, false);
+	bench_run("str_parse_i64/x1024", bench_str_parse_i64, &ints, parse_bench_bytes(ints));
+
+	ParseBench reals = parse_bench_create(arena, true);
+	bench_run("str_parse_f64/x1024", bench_str_parse_f64, &reals, parse_bench_bytes(reals));
+
+	isize scratch_size = 256 * mem_kilobyte;
+	Arena scratch = arena_create_buffer(arena_alloc(arena, scratch_size, 64), scratch_size);
+	bench_run("arena_alloc/x1024", bench_arena_alloc, &scratch, 0);
+
+	void** ptrs = arena_make(arena, void*, BASE_BENCH_BATCH);
+	bench_run("heap_alloc/x1024", bench_heap_alloc, ptrs, 0);
+
+	isize array_size = 4 * ARRAY_BENCH_LEN * (isize)sizeof(u64);
+	Arena array_arena = arena_create_buffer(arena_alloc(arena, array_size, 64), array_size);
+	bench_run("dyn_array/push/x65536", bench_dyn_array_push, &array_arena, 0);
+	bench_run("seg_array/push/x65536", bench_seg_array_push, &array_arena, 0);
+
+	SegArray seg = seg_array_make(u64, 64, arena);
+	for(isize i = 0; i < ARRAY_BENCH_LEN; i += 1){
+		*(u64*)seg_array_push(&seg) = (u64)i;
+	}
+	bench_run("seg_array/at/x65536", bench_seg_array_at, &seg, 0);
+
+	MapBench* maps = arena_make(arena, MapBench, 1);
+	*maps = (MapBench){
+		.keys = arena_make(arena, String, MAP_BENCH_KEYS),
+		.misses = arena_make(arena, String, MAP_BENCH_KEYS),
+		.arena = arena,
+	};
+	map_bench_keys(arena, maps->keys, MAP_BENCH_KEYS, "");
+	map_bench_keys(arena, maps->misses, MAP_BENCH_KEYS, "m_");
+
+	maps->map = map_make(String, i32, MAP_BENCH_KEYS, arena);
+	maps->map.hash = map_hash_string;
+	maps->map.equal = map_equal_string;
+	maps->linear = linear_map_create(arena, map_bench_cap());
+	for(isize i = 0; i < MAP_BENCH_KEYS; i += 1){
+		*(i32*)map_put(&maps->map, &maps->keys[i], NULL) = (i32)i;
+		*linear_map_put(&maps->linear, maps->keys[i]) = (i32)i;
+	}
+
+	bench_run("map/insert/x4096", bench_map_insert, maps, 0);
+	bench_run("map/lookup/x4096", bench_map_lookup, maps, 0);
+	bench_run("map/remove_insert/x256", bench_map_remove_insert, maps, 0);
+	bench_run("linear_map/insert/x4096", bench_linear_map_insert, maps, 0);
+	bench_run("linear_map/lookup/x4096", bench_linear_map_lookup, maps, 0);
+
+	arena_region_end(reg);
+}
+
+#undef BASE_BENCH_BATCH
+#undef MAP_BENCH_KEYS
+#undef ARRAY_BENCH_LEN
@@ -0,0 +1,111 @@
+#include "base/types.h"
+#include "base/memory.h"
+#include "base/string.h"
+#include "kielo.h"
+#include "errors.c"
+#include "tokens.c"
+#include "lexer.c"
+#include "parser.c"
+#include "checker.c"
+#include "ir.c"
+#include "opt.c"
+#include "bytecode.c"
+#include "vm.c"
+#include "native.c"
+#include "cache.c"
+
+#include "benchmark.h"
+#include "corpus.c"
+#include "lexer_bench.c"
+#include "parser_bench.c"
+#include "checker_bench.c"
+#include "ir_bench.c"
+#include "vm_bench.c"
+#include "native_bench.c"
+#include "base_bench.c"
+
+static
+void bench_usage(){
+	printf(
+		"Usage: bench.exe [options]\n"
+		"  --filter SUBSTR      Only run benchmarks whose name contains SUBSTR\n"
+		"  --time MS            Minimum measuring time per benchmark (default: 250)\n"
+		"  --size KB            Size of each generated corpus (default: 4096)\n"
+		"  --out FILE           Write results as JSON to FILE\n"
+		"  --compare FILE       Compare results against a JSON baseline\n"
+		"  --threshold PERCENT  Slowdown reported as a regression (default: 5)\n");
+}
+
+int main(int argc, char const** argv){
+	char const* out_path = NULL;
+	char const* baseline_path = NULL;
+	f64 threshold = 5.0;
+	isize corpus_size = 4 * mem_megabyte;
+
+	for(int i = 1; i < argc; i += 1){
+		String arg = { .v = (byte const*)argv[i], .len = (isize)__builtin_strlen(argv[i]) };
+		bool has_value = i + 1 < argc;
+
+		if(str_equals(arg, str_lit("--filter")) && has_value){
+			bench_state.filter = argv[++i];
+		}
+		else if(str_equals(arg, str_lit("--time")) && has_value){
+			bench_state.min_time = atoll(argv[++i]) * clock_millisecond;
+		}
+		else if(str_equals(arg, str_lit("--size")) && has_value){
+			corpus_size = atoll(argv[++i]) * mem_kilobyte;
+		}
+		else if(str_equals(arg, str_lit("--out")) && has_value){
+			out_path = argv[++i];
+		}
+		else if(str_equals(arg, str_lit("--compare")) && has_value){
+			baseline_path = argv[++i];
+		}
+		else if(str_equals(arg, str_lit("--threshold")) && has_value){
+			threshold = strtod(argv[++i], NULL);
+		}
+		else {
+			bench_usage();
+			return 2;
+		}
+	}
+
+	/* Tokens and AST take several times the size of the source */
+	isize arena_size = (corpus_size * 32) + (64 * mem_megabyte);
+	byte* arena_mem = heap_alloc(arena_size, 4096);
+	Arena arena = arena_create_buffer(arena_mem, arena_size);
+
+	bench_lexer(&arena, corpus_size);
+	bench_parser(&arena, corpus_size);
+	bench_checker(&arena, corpus_size);
+	bench_ir(&arena);
+	bench_vm(&arena);
+	bench_native(&arena);
+	bench_base(&arena, corpus_size);
+
+	int status = 0;
+
+	if(out_path != NULL){
+		FILE* out = fopen(out_path, "wb");
+		if(out == NULL){
+			printf("Could not open '%s' for writing\n", out_path);
+			status = 2;
+		} else {
+			bench_write_json(out);
+			fclose(out);
+		}
+	}
+
+	if(baseline_path != NULL){
+		i32 regressions = bench_compare(baseline_path, threshold);
+		if(regressions < 0){
+			status = 2;
+		} else if(regressions > 0){
+			printf("%d benchmark(s) regressed by more than %.1f%%\n", regressions, threshold);
+			status = 1;
+		}
+	}
+
+	heap_free(arena_mem);
+	return status;
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include "base/types.h"
+#include "base/ensure.h"
+#include "base/memory.h"
+#include "base/string.h"
+#include "base/clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef void (*BenchFunc)(void* ctx);
+
+struct BenchResult {
+	char const* name;
+	i64 iterations;
+	f64 ns_per_op;
+	i64 bytes_per_op;
+};
+
+#define BENCH_MAX_RESULTS 256
+
+struct BenchState {
+	struct BenchResult results[BENCH_MAX_RESULTS];
+	i32 count;
+	i64 min_time;
+	char const* filter;
+};
+
+static struct BenchState bench_state = {
+	.min_time = 250 * clock_millisecond,
+};
+
+/* Written to by benchmarks so the optimizer cannot discard their work */
+static volatile i64 bench_sink = 0;
+
+static inline
+bool bench_selected(char const* name){
+	if(bench_state.filter == NULL){ return true; }
+	String n = { .v = (byte const*)name, .len = (isize)__builtin_strlen(name) };
+	String f = { .v = (byte const*)bench_state.filter, .len = (isize)__builtin_strlen(bench_state.filter) };
+	for(isize i = 0; i + f.len <= n.len; i += 1){
+		if(str_starts_with(str_sub(n, i, n.len), f)){ return true; }
+	}
+	return false;
+}
+
+static inline
+f64 bench_mb_per_s(struct BenchResult r){
+	if(r.bytes_per_op <= 0 || r.ns_per_op <= 0){ return 0; }
+	return ((f64)r.bytes_per_op / (1024.0 * 1024.0)) / (r.ns_per_op / (f64)clock_second);
+}
+
+static
+void bench_display(struct BenchResult r){
+	printf("[ %-28s ] %14.2f ns/op", r.name, r.ns_per_op);
+	if(r.bytes_per_op > 0){
+		printf(" %10.2f MB/s", bench_mb_per_s(r));
+	}
+	printf("  (%lld iterations)\n", (long long)r.iterations);
+}
+
+/* Runs `f` in growing batches until a batch takes at least `min_time` */
+static
+void bench_run(char const* name, BenchFunc f, void* ctx, i64 bytes_per_op){
+	if(!bench_selected(name)){ return; }
+	ensure(bench_state.count < BENCH_MAX_RESULTS, "Too many benchmarks");
+
+	f(ctx); /* Warm up */
+
+	i64 iterations = 1;
+	i64 elapsed = 0;
+	for(;;){
+		i64 begin = clock_now();
+		for(i64 i = 0; i < iterations; i += 1){
+			f(ctx);
+		}
+		elapsed = clock_now() - begin;
+
+		if(elapsed >= bench_state.min_time){ break; }
+
+		i64 grow = elapsed > 0 ? (bench_state.min_time * 12 / 10) / elapsed : 100;
+		iterations *= clamp(2, grow, 100);
+	}
+
+	struct BenchResult r = {
+		.name = name,
+		.iterations = iterations,
+		.ns_per_op = (f64)elapsed / (f64)iterations,
+		.bytes_per_op = bytes_per_op,
+	};
+	bench_state.results[bench_state.count] = r;
+	bench_state.count += 1;
+	bench_display(r);
+}
+
+static
+void bench_write_json(FILE* out){
+	fprintf(out, "{\n\t\"benchmarks\": [\n");
+	for(i32 i = 0; i < bench_state.count; i += 1){
+		struct BenchResult r = bench_state.results[i];
+		fprintf(out, "\t\t{\"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.3f, \"bytes_per_op\": %lld, \"mb_per_s\": %.3f}%s\n",
+			r.name, (long long)r.iterations, r.ns_per_op, (long long)r.bytes_per_op, bench_mb_per_s(r),
+			(i + 1 < bench_state.count) ? "," : "");
+	}
+	fprintf(out, "\t]\n}\n");
+}
+
+/* Finds `"key": ` after `from` and returns a pointer to its value, NULL if absent */
+static inline
+char const* bench_json_find_key(char const* from, char const* end, char const* key){
+	isize key_len = (isize)__builtin_strlen(key);
+	for(char const* p = from; p + key_len + 2 < end; p += 1){
+		if(p[0] == '"' && mem_compare(p + 1, key, key_len) == 0 && p[key_len + 1] == '"'){
+			p += key_len + 2;
+			while(p < end && (*p == ':' || *p == ' ' || *p == '\t')){ p += 1; }
+			return p;
+		}
+	}
+	return NULL;
+}
+
+/* Compares the current results with a baseline written by `bench_write_json`.
+   Returns the number of benchmarks that got slower by more than `threshold` percent. */
+static
+i32 bench_compare(char const* baseline_path, f64 threshold){
+	FILE* f = fopen(baseline_path, "rb");
+	if(f == NULL){
+		printf("Could not open baseline '%s'\n", baseline_path);
+		return -1;
+	}
+	fseek(f, 0, SEEK_END);
+	isize size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	char* data = heap_alloc(size + 1, 1);
+	isize read = fread(data, 1, size, f);
+	fclose(f);
+	char const* end = data + read;
+
+	i32 regressions = 0;
+	printf("\nComparing against %s (threshold: %.1f%%)\n", baseline_path, threshold);
+
+	for(i32 i = 0; i < bench_state.count; i += 1){
+		struct BenchResult r = bench_state.results[i];
+		isize name_len = (isize)__builtin_strlen(r.name);
+
+		f64 base_ns = -1;
+		for(char const* p = data; (p = bench_json_find_key(p, end, "name")) != NULL;){
+			if(*p != '"'){ continue; }
+			p += 1;
+			if(p + name_len < end && mem_compare(p, r.name, name_len) == 0 && p[name_len] == '"'){
+				char const* v = bench_json_find_key(p, end, "ns_per_op");
+				if(v != NULL){ base_ns = strtod(v, NULL); }
+				break;
+			}
+		}
+
+		if(base_ns <= 0){
+			printf("  %-28s %14s\n", r.name, "(new)");
+			continue;
+		}
+
+		f64 delta = ((r.ns_per_op - base_ns) / base_ns) * 100.0;
+		bool regressed = delta > threshold;
+		regressions += regressed;
+		printf("  %-28s %14.2f -> %14.2f ns/op %+8.2f%% %s\n", r.name, base_ns, r.ns_per_op, delta,
+			regressed ? "REGRESSION" : "");
+	}
+
+	heap_free(data);
+	return regressions;
+}
@@ -0,0 +1,45 @@
+#include "benchmark.h"
+
+typedef struct {
+	String source;
+	TokenArray tokens;
+	Ast ast;
+	u32 file;
+	Arena* arena;
+	Arena* scope_arena;
+} CheckerBench;
+
+static
+void bench_checker_check_file(void* ctx){
+	CheckerBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	Checker c = checker_create(&b->ast, b->tokens, b->source, b->arena, b->scope_arena, b->arena);
+	checker_check_file(&c, b->file);
+	bench_sink = c.symbols.len;
+
+	arena_region_end(reg);
+}
+
+void bench_checker(Arena* arena, isize corpus_size){
+	ArenaRegion reg = arena_region_begin(arena);
+
+	byte scope_mem[16 * mem_kilobyte];
+	Arena scope_arena = arena_create_dynamic(scope_mem, sizeof(scope_mem));
+
+	CheckerBench b = {
+		.source = corpus_generate(arena, Corpus_Functions, corpus_size),
+		.arena = arena,
+		.scope_arena = &scope_arena,
+	};
+	Lexer lex = lexer_create(b.source, arena);
+	b.tokens = lexer_tokenize(&lex, arena);
+	Parser p = parser_create(b.source, b.tokens, arena, arena);
+	b.file = parser_parse_file(&p);
+	b.ast = p.ast;
+
+	bench_run("checker/check_file", bench_checker_check_file, &b, b.source.len);
+
+	arena_destroy(&scope_arena);
+	arena_region_end(reg);
+}
@@ -0,0 +1,181 @@
+#include "benchmark.h"
+
+typedef enum {
+	Corpus_Identifiers,
+	Corpus_Numbers,
+	Corpus_Comments,
+	Corpus_Unicode,
+	Corpus_Strings,
+	Corpus_Functions,
+
+	Corpus__len,
+} CorpusKind;
+
+static char const* corpus_names[Corpus__len] = {
+	[Corpus_Identifiers] = "identifiers",
+	[Corpus_Numbers]     = "numbers",
+	[Corpus_Comments]    = "comments",
+	[Corpus_Unicode]     = "unicode",
+	[Corpus_Strings]     = "strings",
+	[Corpus_Functions]   = "functions",
+};
+
+typedef struct {
+	u64 state;
+} CorpusRng;
+
+static inline
+u64 corpus_rng_next(CorpusRng* rng){
+	u64 x = rng->state;
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	rng->state = x;
+	return x;
+}
+
+static inline
+char const* corpus_pick(CorpusRng* rng, char const* const* list, isize n){
+	return list[corpus_rng_next(rng) % (u64)n];
+}
+
+typedef struct {
+	byte* v;
+	isize len;
+	isize cap;
+} CorpusBuilder;
+
+static inline
+void corpus_push(CorpusBuilder* b, char const* s){
+	isize n = (isize)__builtin_strlen(s);
+	n = min(n, b->cap - b->len);
+	mem_copy_no_overlap(b->v + b->len, s, n);
+	b->len += n;
+}
+
+static char const* corpus_words[] = {
+	"count", "index", "buffer_len", "_tmp", "node", "parent_node", "value2", "result",
+	"offset", "lexer_state", "x", "y", "acc", "total_size", "i", "kind_mask",
+};
+
+static char const* corpus_keywords[] = { "let", "if", "for", "return", "fn", "else" };
+
+static char const* corpus_operators[] = { "+", "-", "*", "/", "==", "!=", "<<", ">>", "&&", "||", "<=" };
+
+static char const* corpus_numbers[] = {
+	"0xDEAD_BEEF", "0b1011_0110", "0o777", "1_000_000", "42", "3.141592", "1e-3", "6.02e23", "0xff", "1024",
+};
+
+static char const* corpus_text[] = {
+	"the", "lexer", "should", "skip", "this", "comment", "quickly", "because", "nobody", "reads", "it",
+};
+
+static char const* corpus_unicode_text[] = {
+	"äiti", "öljy", "ñandú", "日本語", "テキスト", "Ελληνικά", "кириллица", "🦊", "emoji🎉", "Ω", "∀x∈ℝ",
+};
+
+/* Generates roughly `size` bytes of deterministic Kielo-like source, always NUL terminated */
+String corpus_generate(Arena* arena, CorpusKind kind, isize size){
+	CorpusBuilder b = {
+		.v = arena_alloc(arena, size + 1, 1),
+		.len = 0,
+		.cap = size,
+	};
+	ensure(b.v != NULL, "Failed to allocate corpus");
+
+	CorpusRng rng = { .state = 0x9e3779b97f4a7c15ull ^ (u64)(kind + 1) };
+
+	#define PICK(List) corpus_pick(&rng, (List), sizeof(List) / sizeof(List[0]))
+
+	while(b.len < b.cap - 128){
+		switch(kind){
+		case Corpus_Identifiers: {
+			corpus_push(&b, PICK(corpus_keywords));
+			corpus_push(&b, " ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, " = ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, " ");
+			corpus_push(&b, PICK(corpus_operators));
+			corpus_push(&b, " ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, "(");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, ", ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, ");\n");
+		} break;
+
+		case Corpus_Numbers: {
+			corpus_push(&b, "let n = ");
+			for(int i = 0; i < 6; i += 1){
+				corpus_push(&b, PICK(corpus_numbers));
+				corpus_push(&b, " ");
+				corpus_push(&b, PICK(corpus_operators));
+				corpus_push(&b, " ");
+			}
+			corpus_push(&b, PICK(corpus_numbers));
+			corpus_push(&b, " ;\n");
+		} break;
+
+		case Corpus_Comments: {
+			corpus_push(&b, "//");
+			for(int i = 0; i < 12; i += 1){
+				corpus_push(&b, " ");
+				corpus_push(&b, PICK(corpus_text));
+			}
+			corpus_push(&b, "\n");
+			if(corpus_rng_next(&rng) % 4 == 0){
+				corpus_push(&b, "let x = y;\n");
+			}
+		} break;
+
+		case Corpus_Unicode: {
+			corpus_push(&b, "// ");
+			for(int i = 0; i < 6; i += 1){
+				corpus_push(&b, PICK(corpus_unicode_text));
+				corpus_push(&b, " ");
+			}
+			corpus_push(&b, "\nlet ");
+			corpus_push(&b, PICK(corpus_unicode_text));
+			corpus_push(&b, " = ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, ";\n");
+		} break;
+
+		case Corpus_Strings: {
+			corpus_push(&b, "let entry = \"");
+			for(int i = 0; i < 24; i += 1){
+				corpus_push(&b, PICK(corpus_text));
+				corpus_push(&b, (corpus_rng_next(&rng) % 16 == 0) ? "\\n" : " ");
+			}
+			corpus_push(&b, "\";\n");
+		} break;
+
+		case Corpus_Functions: {
+			corpus_push(&b, "fn ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, "(a: Int, b: Int) -> Int {\n\tlet ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, " = a ");
+			corpus_push(&b, PICK(corpus_operators));
+			corpus_push(&b, " (b + ");
+			corpus_push(&b, PICK(corpus_numbers));
+			corpus_push(&b, ");\n\tif a < b {\n\t\tb = ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, "(a, b[1]) * 2;\n\t} else {\n\t\treturn -a;\n\t}\n\tfor a < 100 {\n\t\ta += ");
+			corpus_push(&b, PICK(corpus_words));
+			corpus_push(&b, ".len;\n\t}\n\treturn a ");
+			corpus_push(&b, PICK(corpus_operators));
+			corpus_push(&b, " b;\n}\n\n");
+		} break;
+
+		case Corpus__len: break;
+		}
+	}
+
+	#undef PICK
+
+	b.v[b.len] = 0;
+	return (String){ .v = b.v, .len = b.len };
+}
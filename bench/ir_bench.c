@@ -0,0 +1,109 @@
+#include "benchmark.h"
+
+typedef struct {
+	Checker* checker;
+	u32 file;
+	isize source_len;
+	Arena* arena;
+} IrBench;
+
+/* Checks a benchmark program, which must be valid. Also used by the interpreter and native code
+   benchmarks through ir_bench_lower. */
+static
+Checker* ir_bench_check(Arena* arena, String source, u32* file){
+	Lexer lex = lexer_create(source, arena);
+	TokenArray tokens = lexer_tokenize(&lex, arena);
+	Parser p = parser_create(source, tokens, arena, arena);
+	*file = parser_parse_file(&p);
+
+	byte scope_mem[16 * mem_kilobyte];
+	Arena scope_arena = arena_create_dynamic(scope_mem, sizeof(scope_mem));
+	Ast* ast = arena_make(arena, Ast, 1);
+	*ast = p.ast;
+	Checker* c = arena_make(arena, Checker, 1);
+	*c = checker_create(ast, tokens, source, arena, &scope_arena, arena);
+	checker_check_file(c, *file);
+	arena_destroy(&scope_arena);
+	ensure(p.error_count == 0 && c->error_count == 0, "Benchmark program does not check");
+	return c;
+}
+
+static
+IrModule* ir_bench_lower(Arena* arena, String source){
+	u32 file = 0;
+	Checker* c = ir_bench_check(arena, source, &file);
+	IrBuilder builder = ir_builder_create(c, arena);
+	IrModule* m = arena_make(arena, IrModule, 1);
+	*m = ir_build_file(&builder, file);
+	ensure(builder.error_count == 0, "Benchmark program does not lower to IR");
+	return m;
+}
+
+static
+void bench_ir_build_file(void* ctx){
+	IrBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	IrBuilder builder = ir_builder_create(b->checker, b->arena);
+	IrModule m = ir_build_file(&builder, b->file);
+	bench_sink = m.functions[0].insts.len;
+
+	arena_region_end(reg);
+}
+
+/* Building is included, the passes change the module in place */
+static
+void bench_ir_optimize(void* ctx){
+	IrBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	IrBuilder builder = ir_builder_create(b->checker, b->arena);
+	IrModule m = ir_build_file(&builder, b->file);
+	IrOptStats stats = ir_optimize_module(&m, &(IrOptOptions){ .inline_budget = IR_DEFAULT_INLINE_BUDGET });
+	bench_sink = stats.removed;
+
+	arena_region_end(reg);
+}
+
+/* Functions with loops, branches and variables reassigned on several paths */
+static
+String ir_bench_source(Arena* arena, i32 function_count){
+	DynArray(byte) out = { .arena = arena };
+	for(i32 i = 0; i < function_count; i += 1){
+		ArenaRegion reg = arena_region_begin(arena);
+		String fn = str_format(arena,
+			"fn f%d(n: Int, k: Int) -> Int {\n"
+			"	let acc = 0;\n"
+			"	let i = 0;\n"
+			"	for i < n {\n"
+			"		let t = i * k;\n"
+			"		if t %% 3 == 0 { acc += t; } else if t %% 3 == 1 { acc -= i; } else { acc = acc ~ t; }\n"
+			"		if acc > 1000 && k != 0 || acc < -1000 { acc = acc / 2; }\n"
+			"		i += 1;\n"
+			"	}\n"
+			"	return acc + %s;\n"
+			"}\n",
+			i, i > 0 ? (char const*)str_format(arena, "f%d(n - 1, k)", i - 1).v : "0");
+		byte tmp[1024];
+		ensure(fn.len <= (isize)sizeof(tmp), "Benchmark function too long");
+		mem_copy_no_overlap(tmp, fn.v, fn.len);
+		isize len = fn.len;
+		arena_region_end(reg);
+		dyn_append(&out, tmp, len);
+	}
+	return (String){ .v = out.v, .len = out.len };
+}
+
+void bench_ir(Arena* arena){
+	ArenaRegion reg = arena_region_begin(arena);
+
+	String source = ir_bench_source(arena, 2000);
+	u32 file = 0;
+	Checker* c = ir_bench_check(arena, source, &file);
+
+	IrBench b = { .checker = c, .file = file, .source_len = source.len, .arena = arena };
+	bench_run("ir/build_file", bench_ir_build_file, &b, source.len);
+	bench_run("ir/build_and_optimize", bench_ir_optimize, &b, source.len);
+
+	arena_region_end(reg);
+}
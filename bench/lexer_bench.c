@@ -0,0 +1,40 @@
+#include "benchmark.h"
+
+typedef struct {
+	String source;
+	Arena* error_arena;
+} LexerBench;
+
+static
+void bench_lexer_next_token(void* ctx){
+	LexerBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->error_arena);
+
+	Lexer lex = lexer_create(b->source, b->error_arena);
+	i64 count = 0;
+	for(;;){
+		Token tk = lexer_next_token(&lex);
+		if(tk.kind == TokenKind_EndOfFile){ break; }
+		count += 1;
+	}
+	bench_sink = count;
+
+	arena_region_end(reg);
+}
+
+void bench_lexer(Arena* arena, isize corpus_size){
+	static char names[Corpus__len][64];
+
+	for(int kind = 0; kind < Corpus__len; kind += 1){
+		ArenaRegion reg = arena_region_begin(arena);
+
+		LexerBench b = {
+			.source = corpus_generate(arena, kind, corpus_size),
+			.error_arena = arena,
+		};
+		snprintf(names[kind], sizeof(names[kind]), "lexer/%s", corpus_names[kind]);
+		bench_run(names[kind], bench_lexer_next_token, &b, b.source.len);
+
+		arena_region_end(reg);
+	}
+}
@@ -0,0 +1,54 @@
+#include "benchmark.h"
+
+typedef struct {
+	IrModule const* module;
+	Arena* arena;
+} NativeBench;
+
+static
+void bench_native_emit_module(void* ctx){
+	NativeBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	NativeProgram p = native_emit_module(b->module, b->arena);
+	bench_sink = p.code_len;
+
+	arena_region_end(reg);
+}
+
+static
+void bench_native_jit_run(void* ctx){
+	NativeJit* jit = ctx;
+	Value result = {0};
+	bool ok = native_jit_run_main(jit, &result);
+	ensure(ok, "Benchmark program failed");
+	bench_sink = result.value.integer;
+}
+
+void bench_native(Arena* arena){
+	ArenaRegion reg = arena_region_begin(arena);
+
+	/* Same functions as the IR benchmark */
+	String source = ir_bench_source(arena, 2000);
+	NativeBench b = { .module = ir_bench_lower(arena, source), .arena = arena };
+	bench_run("native/emit_module", bench_native_emit_module, &b, source.len);
+
+	/* The interpreter's programs, compiled once and run in process */
+	for(u32 i = 0; i < VM_BENCH_PROGRAM_COUNT; i += 1){
+		for(int optimize = 0; optimize < 2; optimize += 1){
+			IrModule* m = ir_bench_lower(arena, str_format(arena, "%s", vm_bench_programs[i].source));
+			if(optimize){
+				ir_optimize_module(m, &(IrOptOptions){ .inline_budget = IR_DEFAULT_INLINE_BUDGET });
+			}
+			NativeProgram* p = arena_make(arena, NativeProgram, 1);
+			*p = native_emit_module(m, arena);
+			NativeJit jit = native_jit_create(p, NATIVE_JIT_DEFAULT_STACK, arena);
+			ensure(jit.error == NULL, "Benchmark program could not be mapped");
+			char const* name = optimize ? vm_bench_programs[i].jit_opt_name : vm_bench_programs[i].jit_name;
+			bench_run(name, bench_native_jit_run, &jit, 0);
+			native_jit_destroy(&jit);
+		}
+	}
+
+	arena_region_end(reg);
+}
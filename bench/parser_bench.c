@@ -0,0 +1,119 @@
+#include "benchmark.h"
+
+typedef struct {
+	String source;
+	TokenArray tokens;
+	i32 thread_count;
+	Arena* arena;
+} ParserBench;
+
+static
+void bench_parser_tokenize(void* ctx){
+	ParserBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	Lexer lex = lexer_create(b->source, b->arena);
+	TokenArray tokens = lexer_tokenize(&lex, b->arena);
+	bench_sink = tokens.len;
+
+	arena_region_end(reg);
+}
+
+static
+void bench_parser_tokenize_packed(void* ctx){
+	ParserBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	Lexer lex = lexer_create(b->source, b->arena);
+	PackedTokenArray tokens = lexer_tokenize_packed(&lex, b->arena);
+	bench_sink = tokens.len;
+
+	arena_region_end(reg);
+}
+
+static
+void bench_parser_parse_file(void* ctx){
+	ParserBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	Parser p = parser_create(b->source, b->tokens, b->arena, b->arena);
+	parser_parse_file(&p);
+	bench_sink = p.ast.len;
+
+	arena_region_end(reg);
+}
+
+static
+void bench_parser_parse_file_parallel(void* ctx){
+	ParserBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	Parser p = parser_create(b->source, b->tokens, b->arena, b->arena);
+	parser_parse_file_parallel(&p, b->thread_count);
+	bench_sink = p.ast.len;
+
+	arena_region_end(reg);
+}
+
+static
+void bench_parser_parse_file_lazy(void* ctx){
+	ParserBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	Parser p = parser_create(b->source, b->tokens, b->arena, b->arena);
+	p.defer_bodies = true;
+	parser_parse_file(&p);
+	bench_sink = p.ast.len;
+
+	arena_region_end(reg);
+}
+
+#define BENCH_CACHE_DIR "kielo_bench_cache"
+
+static
+void bench_parser_cache_hit(void* ctx){
+	ParserBench* b = ctx;
+	ArenaRegion reg = arena_region_begin(b->arena);
+
+	CacheEntry entry;
+	bool hit = cache_load(str_lit(BENCH_CACHE_DIR), b->source, b->arena, &entry);
+	ensure(hit, "Benchmark cache entry is missing");
+	bench_sink = entry.ast.len;
+	cache_release(&entry);
+
+	arena_region_end(reg);
+}
+
+void bench_parser(Arena* arena, isize corpus_size){
+	ArenaRegion reg = arena_region_begin(arena);
+
+	ParserBench b = {
+		.source = corpus_generate(arena, Corpus_Functions, corpus_size),
+		.thread_count = thread_hardware_count(),
+		.arena = arena,
+	};
+	Lexer lex = lexer_create(b.source, arena);
+	b.tokens = lexer_tokenize(&lex, arena);
+
+	bench_run("parser/tokenize", bench_parser_tokenize, &b, b.source.len);
+	bench_run("parser/tokenize_packed", bench_parser_tokenize_packed, &b, b.source.len);
+	bench_run("parser/parse_file", bench_parser_parse_file, &b, b.source.len);
+	bench_run("parser/parse_file_lazy", bench_parser_parse_file_lazy, &b, b.source.len);
+	bench_run("parser/parse_file_parallel", bench_parser_parse_file_parallel, &b, b.source.len);
+
+	if(bench_selected("parser/cache_hit")){
+		Parser p = parser_create(b.source, b.tokens, arena, arena);
+		u32 file = parser_parse_file(&p);
+		PackedTokenArray packed = token_pack(b.tokens, b.source, arena);
+		if(cache_store(str_lit(BENCH_CACHE_DIR), b.source, &packed, &p.ast, file, arena)){
+			bench_run("parser/cache_hit", bench_parser_cache_hit, &b, b.source.len);
+			char const* path = (char const*)str_format(arena, BENCH_CACHE_DIR "/%016llx.klc", (unsigned long long)cache_key(b.source)).v;
+			remove(path);
+			remove(BENCH_CACHE_DIR);
+		}
+	}
+
+	arena_region_end(reg);
+}
+
+#undef BENCH_CACHE_DIR
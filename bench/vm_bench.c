@@ -0,0 +1,101 @@
+#include "benchmark.h"
+
+typedef struct {
+	BcProgram program;
+	Vm vm;
+} VmBench;
+
+static
+void bench_vm_run(void* ctx){
+	VmBench* b = ctx;
+	Value result = {0};
+	bool ok = vm_run_main(&b->vm, &result);
+	ensure(ok, "Benchmark program failed");
+	bench_sink = result.value.integer;
+}
+
+static
+VmBench* vm_bench_compile(Arena* arena, String source, bool optimize){
+	IrModule* m = ir_bench_lower(arena, source);
+	if(optimize){
+		ir_optimize_module(m, &(IrOptOptions){ .inline_budget = IR_DEFAULT_INLINE_BUDGET });
+	}
+
+	VmBench* b = arena_make(arena, VmBench, 1);
+	Emitter e = emitter_create(m, str_lit("bench.kl"), arena);
+	b->program = emitter_emit_module(&e);
+	ensure(e.error_count == 0, "Benchmark program does not compile");
+	b->vm = vm_create(&b->program, VM_DEFAULT_STACK, VM_DEFAULT_FRAMES, arena);
+	return b;
+}
+
+/* Also run by the JIT benchmark, each back end with and without the IR passes */
+static struct {
+	char const* vm_name;
+	char const* vm_opt_name;
+	char const* jit_name;
+	char const* jit_opt_name;
+	char const* source;
+} const vm_bench_programs[] = {
+	{ "vm/loop/x1000000", "vm_opt/loop/x1000000",
+		"jit/loop/x1000000", "jit_opt/loop/x1000000",
+		"fn main() -> Int {\n"
+		"	let sum = 0;\n"
+		"	let i = 0;\n"
+		"	for i < 1000000 {\n"
+		"		sum += i & 255;\n"
+		"		i += 1;\n"
+		"	}\n"
+		"	return sum;\n"
+		"}\n" },
+	{ "vm/nested_loops/1000x1000", "vm_opt/nested_loops/1000x1000",
+		"jit/nested_loops/1000x1000", "jit_opt/nested_loops/1000x1000",
+		"fn main() -> Int {\n"
+		"	let count = 0;\n"
+		"	let i = 0;\n"
+		"	for i < 1000 {\n"
+		"		let j = 0;\n"
+		"		for j < 1000 {\n"
+		"			if (i ~ j) % 3 == 0 { count += 1; }\n"
+		"			j += 1;\n"
+		"		}\n"
+		"		i += 1;\n"
+		"	}\n"
+		"	return count;\n"
+		"}\n" },
+	{ "vm/fib/25", "vm_opt/fib/25",
+		"jit/fib/25", "jit_opt/fib/25",
+		"fn fib(n: Int) -> Int {\n"
+		"	if n < 2 { return n; }\n"
+		"	return fib(n - 1) + fib(n - 2);\n"
+		"}\n"
+		"fn main() -> Int { return fib(25); }\n" },
+	{ "vm/calls/x300000", "vm_opt/calls/x300000",
+		"jit/calls/x300000", "jit_opt/calls/x300000",
+		"fn clamp(x: Int, lo: Int, hi: Int) -> Int {\n"
+		"	if x < lo { return lo; }\n"
+		"	if x > hi { return hi; }\n"
+		"	return x;\n"
+		"}\n"
+		"fn main() -> Int {\n"
+		"	let sum = 0;\n"
+		"	let i = 0;\n"
+		"	for i < 300000 {\n"
+		"		sum += clamp(i % 1000, 100, 900);\n"
+		"		i += 1;\n"
+		"	}\n"
+		"	return sum;\n"
+		"}\n" },
+};
+#define VM_BENCH_PROGRAM_COUNT 4
+
+void bench_vm(Arena* arena){
+	ArenaRegion reg = arena_region_begin(arena);
+	for(u32 i = 0; i < VM_BENCH_PROGRAM_COUNT; i += 1){
+		for(int optimize = 0; optimize < 2; optimize += 1){
+			VmBench* b = vm_bench_compile(arena, str_format(arena, "%s", vm_bench_programs[i].source), optimize);
+			bench_run(optimize ? vm_bench_programs[i].vm_opt_name : vm_bench_programs[i].vm_name, bench_vm_run, b, 0);
+		}
+	}
+	arena_region_end(reg);
+}
@@ -4,6 +4,11 @@ REM clang Build version (recommended)
 clang -Os -std=c17 -Wall -Wextra -fno-strict-aliasing -fwrapv -Werror=return-type -o kielo.exe main.c base\base.c
 if %errorlevel% neq 0 exit /b %errorlevel%
 
+if "%1"=="bench" (
+	clang -O2 -std=c17 -Wall -Wextra -fno-strict-aliasing -fwrapv -Werror=return-type -I. -o bench.exe bench\bench.c base\base.c
+	if %errorlevel% neq 0 exit /b %errorlevel%
+)
+
 REM cl Build version
 REM cl /nologo /std:c17 /experimental:c11atomics /Os /EHsc /GR /W4 /Fekielo.exe main.c base\base.c 
 if %errorlevel% neq 0 exit /b %errorlevel%
@@ -2,10 +2,21 @@
 
 cc=gcc
 cflags='-O0 -std=c17 -Wall -Wextra -Werror=return-type -fPIC -fno-strict-aliasing -fwrapv -g'
-ldflags=''
+bench_cflags='-O2 -std=c17 -Wall -Wextra -Werror=return-type -fno-strict-aliasing -fwrapv -g'
+ldflags='-pthread'
+
+# Extra flags, e.g. CFLAGS=-DMEM_ACCOUNTING ./build.sh
+cflags="$cflags ${CFLAGS:-}"
+bench_cflags="$bench_cflags ${CFLAGS:-}"
 
 Run(){ echo "$@"; $@; }
 
 set -eu
-Run $cc $cflags -o kielo.exe main.c base/base.c $ldflags
+target="${1:-kielo}"
 
+case "$target" in
+	kielo) Run $cc $cflags -o kielo.exe main.c base/base.c $ldflags ;;
+	test)  Run $cc $cflags -I. -o test.exe tests/test.c base/base.c $ldflags && ./test.exe ;;
+	bench) Run $cc $bench_cflags -I. -o bench.exe bench/bench.c base/base.c $ldflags ;;
+	*) echo "Unknown target: $target (expected: kielo, test, bench)"; exit 1 ;;
+esac
@@ -0,0 +1,791 @@
+#include "kielo.h"
+
+typedef struct {
+	u32 at;
+	u32 block;
+} EmitterJump;
+
+typedef struct {
+	u8 dst;
+	u8 src;
+} EmitterMove;
+
+#define EMITTER_NO_REGISTER BC_MAX_REGISTERS
+
+/* Function being emitted */
+typedef struct {
+	IrFunction const* fn;
+	IrLiveness live;
+	u32* use_count;   /* Of each value */
+	u8* reg;          /* Of each value with a result, EMITTER_NO_REGISTER until it has one */
+	u8* call_base;    /* Of each call, its arguments and then its result go there */
+	u8* skip;         /* Constants never read from a register: AddI immediates and unused ones */
+	u32* block_code;  /* First instruction of each block */
+	DynArray(EmitterJump) jumps;
+	DynArray(EmitterMove) moves;
+	u32 top;          /* Registers below may hold values */
+	u32 register_count;
+	bool overflow;    /* Ran out of registers, reported once */
+} EmitterFunction;
+
+/* Registers holding a live value at some point of a block, and which value */
+typedef struct {
+	u32 taken[8];
+	u32 value[BC_MAX_REGISTERS];
+} EmitterRegisters;
+
+//// Encoding
+static inline
+Instr instr_abc(BcOp op, u32 a, u32 b, u32 c){
+	return (Instr)op | (a << 8) | (b << 16) | (c << 24);
+}
+
+static inline
+Instr instr_abx(BcOp op, u32 a, u32 bx){
+	return (Instr)op | (a << 8) | (bx << 16);
+}
+
+Emitter emitter_create(IrModule const* module, String filename, Arena* arena){
+	return (Emitter){
+		.module = module,
+		.filename = filename,
+		.code = { .arena = arena },
+		.offsets = { .arena = arena },
+		.constants = { .arena = arena },
+		.functions = { .arena = arena },
+		.arena = arena,
+		.max_errors = LEXER_DEFAULT_MAX_ERRORS,
+	};
+}
+
+void emitter_emit_error(Emitter* e, EmitterError type, u32 offset, char const* fmt, ...){
+	e->error_count += 1;
+	if(e->error_count > e->max_errors + 1){
+		return;
+	}
+
+	CompilerError* err = arena_make(e->arena, CompilerError, 1);
+	err->stage = CompilerStage_Emmit;
+	err->offset = offset;
+	err->filename = e->filename;
+
+	if(e->error_count > e->max_errors){
+		err->type = EmitterError_TooManyErrors;
+		err->message = str_format(e->arena, "Too many errors (limit is %d), further errors in this file are not reported", e->max_errors);
+	}
+	else {
+		va_list argp;
+		va_start(argp, fmt);
+		err->type = (u32)type;
+		err->message = str_vformat(e->arena, fmt, argp);
+		va_end(argp);
+	}
+
+	compiler_error_insert(&e->error, &e->error_tail, err);
+}
+
+/* Index of the instruction */
+static
+u32 emit(Emitter* e, Instr instr, u32 offset){
+	dyn_push(&e->code, instr);
+	dyn_push(&e->offsets, offset);
+	return (u32)e->code.len - 1;
+}
+
+static
+u32 emitter_here(Emitter const* e){
+	return (u32)e->code.len;
+}
+
+/* Points the jump at `at` to `target` */
+static
+void emitter_patch(Emitter* e, u32 at, u32 target, u32 offset){
+	i64 distance = (i64)target - (i64)(at + 1);
+	Instr* instr = &e->code.v[at];
+	if(INSTR_OP(*instr) == BcOp_Jmp){
+		if(distance < -0x800000 || distance >= 0x800000){
+			emitter_emit_error(e, EmitterError_TooLarge, offset, "Jump is too long");
+			return;
+		}
+		*instr = BcOp_Jmp | ((u32)(distance + 0x800000) << 8);
+	}
+	else {
+		if(distance < -0x8000 || distance >= 0x8000){
+			emitter_emit_error(e, EmitterError_TooLarge, offset, "Conditional jump is too long, split the function");
+			return;
+		}
+		*instr = instr_abx(INSTR_OP(*instr), INSTR_A(*instr), (u32)(distance + 0x8000));
+	}
+}
+
+static
+u32 emitter_constant(Emitter* e, Value v){
+	for(isize i = 0; i < e->constants.len; i += 1){
+		Value k = e->constants.v[i];
+		if(k.kind == v.kind && k.value.integer == v.value.integer){
+			return (u32)i;
+		}
+	}
+	dyn_push(&e->constants, v);
+	return (u32)e->constants.len - 1;
+}
+
+static
+void emitter_load_constant(Emitter* e, Constant k, u32 dst, u32 offset){
+	switch(k.kind){
+	case ConstKind_Int:
+		if(k.value.integer >= -0x8000 && k.value.integer < 0x8000){
+			emit(e, instr_abx(BcOp_LoadI, dst, (u32)(k.value.integer + 0x8000)), offset);
+			return;
+		}
+		break;
+	case ConstKind_Bool:
+		emit(e, instr_abc(BcOp_LoadBool, dst, k.value.boolean, 0), offset);
+		return;
+	default: break;
+	}
+	u32 index = emitter_constant(e, k);
+	if(index > 0xffff){
+		emitter_emit_error(e, EmitterError_TooLarge, offset, "Too many constants in one file");
+		return;
+	}
+	emit(e, instr_abx(BcOp_LoadK, dst, index), offset);
+}
+
+/* Operand of an Add or Sub small enough for the immediate of an AddI, IR_NONE if neither is */
+static
+u32 emitter_immediate(IrFunction const* f, IrInst const* inst){
+	if(inst->op != IrOp_Add && inst->op != IrOp_Sub){
+		return IR_NONE;
+	}
+	u32 candidates = inst->op == IrOp_Add ? 2 : 1;
+	for(u32 k = 0; k < candidates; k += 1){
+		u32 v = k == 0 ? inst->b : inst->a;
+		IrInst const* operand = &f->insts.v[v];
+		if(operand->op == IrOp_Const && operand->type == ConstKind_Int){
+			i64 n = ir_const_value(operand).value.integer;
+			if(n >= -127 && n <= 127){ return v; }
+		}
+	}
+	return IR_NONE;
+}
+
+//// Register allocation
+static
+void emitter_out_of_registers(Emitter* e, EmitterFunction* ef, u32 offset){
+	if(!ef->overflow){
+		emitter_emit_error(e, EmitterError_TooManyRegisters, offset, "Function needs more than %d registers", BC_MAX_REGISTERS);
+	}
+	ef->overflow = true;
+}
+
+static inline
+bool emitter_is_taken(EmitterRegisters const* r, u32 reg){
+	return (r->taken[reg / 32] >> (reg % 32)) & 1;
+}
+
+static inline
+void emitter_take(EmitterRegisters* r, u32 reg, u32 value){
+	r->taken[reg / 32] |= 1u << (reg % 32);
+	r->value[reg] = value;
+}
+
+static inline
+void emitter_release(EmitterRegisters* r, u32 reg){
+	if(reg != EMITTER_NO_REGISTER){
+		r->taken[reg / 32] &= ~(1u << (reg % 32));
+	}
+}
+
+/* One past the highest register taken */
+static
+u32 emitter_taken_top(EmitterRegisters const* r){
+	for(u32 w = 8; w > 0; w -= 1){
+		if(r->taken[w - 1] != 0){
+			return 32 * (w - 1) + (u32)bit_log2_64(r->taken[w - 1]) + 1;
+		}
+	}
+	return 0;
+}
+
+/* `hint` when it is free, the lowest free register otherwise, EMITTER_NO_REGISTER if all are taken */
+static
+u32 emitter_pick(EmitterRegisters const* r, u32 hint){
+	if(hint < BC_MAX_REGISTERS && !emitter_is_taken(r, hint)){
+		return hint;
+	}
+	for(u32 w = 0; w < 8; w += 1){
+		if(r->taken[w] != 0xffffffff){
+			return min(32 * w + (u32)bit_ctz32(~r->taken[w]), (u32)EMITTER_NO_REGISTER);
+		}
+	}
+	return EMITTER_NO_REGISTER;
+}
+
+/* Where the value is going: a phi takes the register of a value flowing in, a value flowing into
+   an allocated phi takes the phi's, and the only argument of a call later in the block goes
+   where the call will want it. `dies` is valid for the values live in the block. */
+static
+u32 emitter_hint(EmitterFunction const* ef, EmitterRegisters const* r, u32 value, u32 const* phi_of, u32 const* call_of, u32 const* dies){
+	IrFunction const* f = ef->fn;
+	IrInst const* inst = &f->insts.v[value];
+	if(inst->op == IrOp_Call){
+		return ef->call_base[value];
+	}
+	if(inst->op == IrOp_Phi){
+		for(u32 k = 0; k < inst->b; k += 1){
+			u32 reg = ef->reg[f->operands.v[inst->a + k]];
+			if(reg != EMITTER_NO_REGISTER && !emitter_is_taken(r, reg)){ return reg; }
+		}
+		return EMITTER_NO_REGISTER;
+	}
+	if(phi_of[value] != IR_NONE && ef->reg[phi_of[value]] != EMITTER_NO_REGISTER){
+		return ef->reg[phi_of[value]];
+	}
+
+	u32 call = call_of[value];
+	if(call == IR_NONE){
+		return EMITTER_NO_REGISTER;
+	}
+	/* Above what is still live after the call, as far as the values live now tell */
+	u32 base = 0;
+	for(u32 reg = 0; reg < BC_MAX_REGISTERS; reg += 1){
+		u32 v = r->value[reg];
+		if(emitter_is_taken(r, reg) && (dies[v] == IR_NONE || dies[v] > call)){
+			base = reg + 1;
+		}
+	}
+	IrInst const* c = &f->insts.v[call];
+	for(u32 k = 0; k < c->c; k += 1){
+		if(f->operands.v[c->b + k] == value){ return base + k; }
+	}
+	return EMITTER_NO_REGISTER;
+}
+
+/* SSA values are colored a block at a time in layout order, which reaches a definition before
+   every use it dominates. The registers taken at any point are those of the values live there,
+   so a function needs as many registers as it has values live at once and nothing is spilled;
+   more than a frame holds is an error. A register is free again once its value is read for the
+   last time, by an instruction that may write its result there: the interpreter reads operands
+   before it writes. A call's arguments go above every register live after it, where the
+   callee's frame starts, and the result comes back in the first one. */
+static
+void emitter_allocate(Emitter* e, EmitterFunction* ef){
+	IrFunction const* f = ef->fn;
+	Arena* arena = e->arena;
+	u32 inst_count = (u32)f->insts.len;
+	u32 words = ef->live.words;
+	u32* live = arena_make(arena, u32, words);
+	u32* dies = arena_make(arena, u32, max(inst_count, 1u));    /* Last read in the block, IR_NONE past its end */
+	u32* phi_of = arena_make(arena, u32, max(inst_count, 1u));  /* A phi the value flows into */
+	u32* call_of = arena_make(arena, u32, max(inst_count, 1u)); /* The call reading a value nothing else reads */
+	EmitterRegisters* regs = arena_make(arena, EmitterRegisters, 1);
+	ensure(live && dies && phi_of && call_of && regs, "Failed to allocate emitter scratch");
+
+	for(u32 i = 0; i < inst_count; i += 1){
+		ef->reg[i] = EMITTER_NO_REGISTER;
+		phi_of[i] = IR_NONE;
+		call_of[i] = IR_NONE;
+	}
+	for(u32 i = 0; i < inst_count; i += 1){
+		IrInst const* inst = &f->insts.v[i];
+		if(inst->op == IrOp_Phi){
+			for(u32 k = 0; k < inst->b; k += 1){ phi_of[f->operands.v[inst->a + k]] = i; }
+		}
+		if(inst->op == IrOp_Call){
+			for(u32 k = 0; k < inst->c; k += 1){
+				u32 arg = f->operands.v[inst->b + k];
+				if(ef->use_count[arg] == 1){ call_of[arg] = i; }
+			}
+		}
+	}
+	ef->top = f->param_count;
+
+	for(u32 b = 0; b < f->blocks.len; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		u32 first = blk->first;
+		u32 end = blk->first + blk->count;
+
+		/* Backwards from what leaves the block, where each value is read for the last time */
+		mem_copy_no_overlap(live, &ef->live.live_out[b * words], words * sizeof(u32));
+		for(u32 w = 0; w < words; w += 1){
+			for(u32 bits = live[w]; bits != 0; bits &= bits - 1){
+				dies[32 * w + (u32)bit_ctz32(bits)] = IR_NONE;
+			}
+		}
+		for(u32 i = end; i-- > first;){
+			IrInst* inst = &f->insts.v[i];
+			if(!ir_live_has(live, i)){ dies[i] = i; }
+			live[i / 32] &= ~(1u << (i % 32));
+			if(inst->op == IrOp_Phi){ continue; }
+			IrUses uses = ir_uses((IrFunction*)f, inst);
+			for(u32 k = 0; k < uses.len; k += 1){
+				u32 u = uses.v[k];
+				if(!ir_live_has(live, u)){
+					live[u / 32] |= 1u << (u % 32);
+					dies[u] = i;
+				}
+			}
+		}
+
+		/* Forwards from what enters it */
+		mem_set(regs->taken, 0, sizeof(regs->taken));
+		u32 const* in = &ef->live.live_in[b * words];
+		for(u32 w = 0; w < words; w += 1){
+			for(u32 bits = in[w]; bits != 0; bits &= bits - 1){
+				u32 v = 32 * w + (u32)bit_ctz32(bits);
+				if(ef->reg[v] != EMITTER_NO_REGISTER){ emitter_take(regs, ef->reg[v], v); }
+			}
+		}
+		/* Parameters are where the caller put the arguments */
+		for(u32 i = first; b == 0 && i < end; i += 1){
+			IrInst const* inst = &f->insts.v[i];
+			if(inst->op == IrOp_Param){
+				ef->reg[i] = (u8)inst->a;
+				emitter_take(regs, inst->a, i);
+			}
+		}
+
+		u32 phi_end = first;
+		for(u32 i = first; i < end; i += 1){
+			IrInst* inst = &f->insts.v[i];
+			if(inst->op != IrOp_Phi){
+				/* Phis are written together by the edge, dead ones are only free past them */
+				for(; phi_end < i; phi_end += 1){
+					if(dies[phi_end] == phi_end){ emitter_release(regs, ef->reg[phi_end]); }
+				}
+				IrUses uses = ir_uses((IrFunction*)f, inst);
+				for(u32 k = 0; k < uses.len; k += 1){
+					if(dies[uses.v[k]] == i){ emitter_release(regs, ef->reg[uses.v[k]]); }
+				}
+			}
+
+			if(inst->op == IrOp_Call){
+				u32 base = emitter_taken_top(regs);
+				if(base + max(inst->c, 1u) > BC_MAX_REGISTERS){
+					emitter_out_of_registers(e, ef, inst->offset);
+					base = 0;
+				}
+				ef->call_base[i] = (u8)base;
+				ef->top = max(ef->top, base + max(inst->c, 1u));
+			}
+			if(inst->type == ConstKind_None || inst->op == IrOp_Param || ef->skip[i]){
+				continue;
+			}
+
+			u32 reg = emitter_pick(regs, emitter_hint(ef, regs, i, phi_of, call_of, dies));
+			if(reg == EMITTER_NO_REGISTER){
+				emitter_out_of_registers(e, ef, inst->offset);
+				continue;
+			}
+			ef->reg[i] = (u8)reg;
+			ef->top = max(ef->top, reg + 1);
+			emitter_take(regs, reg, i);
+			if(dies[i] == i && inst->op != IrOp_Phi){
+				emitter_release(regs, reg);
+			}
+		}
+	}
+	ef->register_count = max(ef->top, 1u);
+}
+
+//// Moves
+/* Performs `ef->moves` as if all at once. A move waits while its destination is still to be
+   read, a cycle of waiting moves is broken by copying one source to `swap`. */
+static
+void emitter_parallel_move(Emitter* e, EmitterFunction* ef, u32 swap, u32 offset){
+	EmitterMove* moves = ef->moves.v;
+	u32 count = (u32)ef->moves.len;
+	for(u32 i = 0; i < count;){
+		if(moves[i].dst == moves[i].src){
+			moves[i] = moves[--count];
+		}
+		else { i += 1; }
+	}
+
+	while(count > 0){
+		bool progress = false;
+		for(u32 i = 0; i < count;){
+			bool blocked = false;
+			for(u32 j = 0; j < count && !blocked; j += 1){
+				blocked = j != i && moves[j].src == moves[i].dst;
+			}
+			if(blocked){
+				i += 1;
+				continue;
+			}
+			emit(e, instr_abc(BcOp_Move, moves[i].dst, moves[i].src, 0), offset);
+			moves[i] = moves[--count];
+			progress = true;
+		}
+		if(!progress){
+			if(swap >= BC_MAX_REGISTERS){
+				emitter_out_of_registers(e, ef, offset);
+				break;
+			}
+			ef->register_count = max(ef->register_count, swap + 1);
+			u8 src = moves[0].src;
+			emit(e, instr_abc(BcOp_Move, swap, src, 0), offset);
+			for(u32 j = 0; j < count; j += 1){
+				if(moves[j].src == src){ moves[j].src = (u8)swap; }
+			}
+		}
+	}
+	ef->moves.len = 0;
+}
+
+/* Whether an edge needs any move, the phis of `to` and what `from` passes them may share registers */
+static
+bool emitter_edge_has_moves(EmitterFunction const* ef, u32 from, u32 to){
+	IrFunction const* f = ef->fn;
+	IrBlock const* blk = &f->blocks.v[to];
+	for(u32 i = blk->first; i < blk->first + blk->count && f->insts.v[i].op == IrOp_Phi; i += 1){
+		IrInst const* phi = &f->insts.v[i];
+		for(u32 k = 0; k < phi->b; k += 1){
+			if(f->operands.v[phi->a + phi->b + k] == from && ef->reg[f->operands.v[phi->a + k]] != ef->reg[i]){
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* Moves the values `from` passes to the phis of `to` */
+static
+void emitter_edge_moves(Emitter* e, EmitterFunction* ef, u32 from, u32 to, u32 offset){
+	IrFunction const* f = ef->fn;
+	IrBlock const* blk = &f->blocks.v[to];
+	for(u32 i = blk->first; i < blk->first + blk->count && f->insts.v[i].op == IrOp_Phi; i += 1){
+		IrInst const* phi = &f->insts.v[i];
+		for(u32 k = 0; k < phi->b; k += 1){
+			if(f->operands.v[phi->a + phi->b + k] == from){
+				u32 v = f->operands.v[phi->a + k];
+				dyn_push(&ef->moves, ((EmitterMove){ .dst = ef->reg[i], .src = ef->reg[v] }));
+				break;
+			}
+		}
+	}
+	emitter_parallel_move(e, ef, ef->top, offset);
+}
+
+//// Control flow
+/* Jump to `block` patched once every block has its code, `cond` is ignored by Jmp */
+static
+void emitter_jump(Emitter* e, EmitterFunction* ef, BcOp op, u32 cond, u32 block, u32 offset){
+	u32 at = emit(e, op == BcOp_Jmp ? (Instr)BcOp_Jmp : instr_abc(op, cond, 0, 0), offset);
+	dyn_push(&ef->jumps, ((EmitterJump){ .at = at, .block = block }));
+}
+
+/* Unless `block` comes next */
+static
+void emitter_goto(Emitter* e, EmitterFunction* ef, u32 block, u32 next, u32 offset){
+	if(block != next){
+		emitter_jump(e, ef, BcOp_Jmp, 0, block, offset);
+	}
+}
+
+static
+void emitter_branch(Emitter* e, EmitterFunction* ef, u32 block, IrInst const* inst){
+	u32 next = block + 1;
+	u32 cond = ef->reg[inst->a];
+	u32 then_block = inst->b;
+	u32 else_block = inst->c;
+	if(then_block == else_block){
+		emitter_edge_moves(e, ef, block, then_block, inst->offset);
+		emitter_goto(e, ef, then_block, next, inst->offset);
+		return;
+	}
+
+	/* The condition is read before an edge's moves can write its register */
+	bool then_moves = emitter_edge_has_moves(ef, block, then_block);
+	bool else_moves = emitter_edge_has_moves(ef, block, else_block);
+	if(!then_moves && !else_moves && then_block == next){
+		emitter_jump(e, ef, BcOp_JmpFalse, cond, else_block, inst->offset);
+	}
+	else if(!then_moves){
+		emitter_jump(e, ef, BcOp_JmpTrue, cond, then_block, inst->offset);
+		emitter_edge_moves(e, ef, block, else_block, inst->offset);
+		emitter_goto(e, ef, else_block, next, inst->offset);
+	}
+	else if(!else_moves){
+		emitter_jump(e, ef, BcOp_JmpFalse, cond, else_block, inst->offset);
+		emitter_edge_moves(e, ef, block, then_block, inst->offset);
+		emitter_goto(e, ef, then_block, next, inst->offset);
+	}
+	else {
+		u32 other = emit(e, instr_abc(BcOp_JmpFalse, cond, 0, 0), inst->offset);
+		emitter_edge_moves(e, ef, block, then_block, inst->offset);
+		emitter_goto(e, ef, then_block, IR_NONE, inst->offset);
+		emitter_patch(e, other, emitter_here(e), inst->offset);
+		emitter_edge_moves(e, ef, block, else_block, inst->offset);
+		emitter_goto(e, ef, else_block, next, inst->offset);
+	}
+}
+
+//// Instructions
+static
+BcOp emitter_binary_op(IrOp op){
+	switch(op){
+	case IrOp_Add: return BcOp_Add;
+	case IrOp_Sub: return BcOp_Sub;
+	case IrOp_Mul: return BcOp_Mul;
+	case IrOp_Div: return BcOp_Div;
+	case IrOp_Mod: return BcOp_Mod;
+	case IrOp_Shl: return BcOp_Shl;
+	case IrOp_Shr: return BcOp_Shr;
+	case IrOp_And: return BcOp_BitAnd;
+	case IrOp_Or:  return BcOp_BitOr;
+	case IrOp_Xor: return BcOp_BitXor;
+	case IrOp_Eq:  return BcOp_Eq;
+	case IrOp_Ne:  return BcOp_Ne;
+	case IrOp_Lt:  return BcOp_Lt;
+	case IrOp_Le:  return BcOp_Le;
+	case IrOp_Neg: return BcOp_Neg;
+	case IrOp_BitNot: return BcOp_BitNot;
+	case IrOp_Not: return BcOp_Not;
+	default: return BcOp__len;
+	}
+}
+
+static
+void emitter_call(Emitter* e, EmitterFunction* ef, u32 value, IrInst const* inst){
+	IrFunction const* f = ef->fn;
+	u32 base = ef->call_base[value];
+	for(u32 k = 0; k < inst->c; k += 1){
+		u32 arg = f->operands.v[inst->b + k];
+		dyn_push(&ef->moves, ((EmitterMove){ .dst = (u8)(base + k), .src = ef->reg[arg] }));
+	}
+	emitter_parallel_move(e, ef, max(ef->top, base + inst->c), inst->offset);
+	emit(e, instr_abx(BcOp_Call, base, inst->a), inst->offset);
+	if(inst->type != ConstKind_None && ef->reg[value] != base){
+		emit(e, instr_abc(BcOp_Move, ef->reg[value], base, 0), inst->offset);
+	}
+}
+
+static
+void emitter_instruction(Emitter* e, EmitterFunction* ef, u32 block, u32 value){
+	IrFunction const* f = ef->fn;
+	IrInst const* inst = &f->insts.v[value];
+	u32 dst = ef->reg[value];
+	switch((IrOp)inst->op){
+	case IrOp_Nop: case IrOp_Param: case IrOp_Phi:
+		break;
+
+	case IrOp_Const:
+		if(!ef->skip[value]){
+			emitter_load_constant(e, ir_const_value(inst), dst, inst->offset);
+		}
+		break;
+
+	case IrOp_Undef:
+		/* Zero, as native code reads it */
+		emitter_load_constant(e, (Constant){ .kind = inst->type }, dst, inst->offset);
+		break;
+
+	case IrOp_GetGlobal:
+		emit(e, instr_abx(BcOp_GetGlobal, dst, inst->a), inst->offset);
+		break;
+
+	case IrOp_SetGlobal:
+		emit(e, instr_abx(BcOp_SetGlobal, ef->reg[inst->b], inst->a), inst->offset);
+		break;
+
+	case IrOp_Add: case IrOp_Sub: case IrOp_Mul: case IrOp_Div: case IrOp_Mod:
+	case IrOp_Shl: case IrOp_Shr: case IrOp_And: case IrOp_Or: case IrOp_Xor:
+	case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le: {
+		u32 imm = emitter_immediate(f, inst);
+		if(imm != IR_NONE){
+			i64 n = ir_const_value(&f->insts.v[imm]).value.integer;
+			u32 other = imm == inst->b ? inst->a : inst->b;
+			i32 add = (i32)(inst->op == IrOp_Sub ? -n : n);
+			emit(e, instr_abc(BcOp_AddI, dst, ef->reg[other], (u32)(u8)(i8)add), inst->offset);
+		}
+		else {
+			emit(e, instr_abc(emitter_binary_op(inst->op), dst, ef->reg[inst->a], ef->reg[inst->b]), inst->offset);
+		}
+	} break;
+
+	case IrOp_Neg: case IrOp_BitNot: case IrOp_Not:
+		emit(e, instr_abc(emitter_binary_op(inst->op), dst, ef->reg[inst->a], 0), inst->offset);
+		break;
+
+	case IrOp_Call:
+		emitter_call(e, ef, value, inst);
+		break;
+
+	case IrOp_Jump:
+		emitter_edge_moves(e, ef, block, inst->a, inst->offset);
+		emitter_goto(e, ef, inst->a, block + 1, inst->offset);
+		break;
+
+	case IrOp_Branch:
+		emitter_branch(e, ef, block, inst);
+		break;
+
+	case IrOp_Return:
+		if(inst->a == IR_NONE){
+			emit(e, BcOp_RetNil, inst->offset);
+		}
+		else {
+			emit(e, instr_abc(BcOp_Ret, ef->reg[inst->a], 0, 0), inst->offset);
+		}
+		break;
+
+	default:
+		panic("Unexpected IR instruction in bytecode");
+	}
+}
+
+//// Functions
+static
+void emitter_emit_function(Emitter* e, u32 index){
+	IrModule const* m = e->module;
+	IrFunction const* f = &m->functions[index];
+	Arena* arena = e->arena;
+	u32 inst_count = (u32)f->insts.len;
+	u32 block_count = (u32)f->blocks.len;
+	u32 fn_offset = inst_count > 0 ? f->insts.v[0].offset : 0;
+
+	BcFunction fn = {
+		.name = f->name,
+		.code_start = emitter_here(e),
+		.param_count = (u8)min(f->param_count, (u32)BC_MAX_REGISTERS),
+	};
+	if(f->param_count > BC_MAX_REGISTERS){
+		emitter_emit_error(e, EmitterError_TooManyRegisters, fn_offset, "Functions take at most %d parameters", BC_MAX_REGISTERS);
+		dyn_push(&e->functions, fn);
+		return;
+	}
+
+	EmitterFunction ef = {
+		.fn = f,
+		.live = ir_liveness(f, arena),
+		.use_count = arena_make(arena, u32, max(inst_count, 1u)),
+		.reg = arena_make(arena, u8, max(inst_count, 1u)),
+		.call_base = arena_make(arena, u8, max(inst_count, 1u)),
+		.skip = arena_make(arena, u8, max(inst_count, 1u)),
+		.block_code = arena_make(arena, u32, max(block_count, 1u)),
+		.jumps = { .arena = arena },
+		.moves = { .arena = arena },
+	};
+	u32* immediate_uses = arena_make(arena, u32, max(inst_count, 1u));
+	ensure(ef.use_count && ef.reg && ef.call_base && ef.skip && ef.block_code && immediate_uses, "Failed to allocate emitter scratch");
+
+	/* Constants only read as AddI immediates, or not at all, need no register */
+	for(u32 i = 0; i < inst_count; i += 1){
+		IrInst* inst = &((IrFunction*)f)->insts.v[i];
+		IrUses uses = ir_uses((IrFunction*)f, inst);
+		for(u32 k = 0; k < uses.len; k += 1){
+			ef.use_count[uses.v[k]] += 1;
+		}
+		u32 imm = emitter_immediate(f, inst);
+		if(imm != IR_NONE){ immediate_uses[imm] += 1; }
+	}
+	for(u32 i = 0; i < inst_count; i += 1){
+		ef.skip[i] = f->insts.v[i].op == IrOp_Const && immediate_uses[i] == ef.use_count[i];
+	}
+	emitter_allocate(e, &ef);
+
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		ef.block_code[b] = emitter_here(e);
+		for(u32 i = blk->first; i < blk->first + blk->count; i += 1){
+			emitter_instruction(e, &ef, b, i);
+		}
+	}
+	for(isize j = 0; j < ef.jumps.len; j += 1){
+		EmitterJump jump = ef.jumps.v[j];
+		emitter_patch(e, jump.at, ef.block_code[jump.block], e->offsets.v[jump.at]);
+	}
+
+	fn.code_len = emitter_here(e) - fn.code_start;
+	fn.register_count = (u8)min(ef.register_count, (u32)BC_MAX_REGISTERS);
+	dyn_push(&e->functions, fn);
+}
+
+BcProgram emitter_emit_module(Emitter* e){
+	IrModule const* m = e->module;
+	for(u32 f = 0; f < m->function_count; f += 1){
+		emitter_emit_function(e, f);
+	}
+
+	return (BcProgram){
+		.code = e->code.v,
+		.offsets = e->offsets.v,
+		.code_len = (u32)e->code.len,
+		.constants = e->constants.v,
+		.constant_count = (u32)e->constants.len,
+		.functions = e->functions.v,
+		.function_count = (u32)e->functions.len,
+		.global_types = m->global_types,
+		.global_count = m->global_count,
+		.init = m->init,
+		.main = m->main == IR_NONE ? BC_NO_FUNCTION : m->main,
+	};
+}
+
+//// Listing
+static
+String bytecode_op_name(BcOp op){
+	switch(op){
+	#define X(Name) case BcOp_##Name: return str_lit(#Name);
+	BYTECODE_OPS
+	#undef X
+	case BcOp__len: break;
+	}
+	return str_lit("<INVALID OP>");
+}
+
+String bytecode_format_value(Value v, Arena* arena){
+	switch(v.kind){
+	case ConstKind_Int:  return str_format(arena, "%lld", (long long)v.value.integer);
+	case ConstKind_Real: return str_format(arena, "%g", v.value.real);
+	case ConstKind_Bool: return v.value.boolean ? str_lit("true") : str_lit("false");
+	default: return str_lit("nil");
+	}
+}
+
+String bytecode_dump(BcProgram const* program, Arena* arena){
+	String out = str_lit("");
+	for(u32 f = 0; f < program->function_count; f += 1){
+		BcFunction const* fn = &program->functions[f];
+		out = str_format(arena, "%.*sfn %.*s (params %u, registers %u)\n", str_fmt(out), str_fmt(fn->name), fn->param_count, fn->register_count);
+
+		for(u32 pc = fn->code_start; pc < fn->code_start + fn->code_len; pc += 1){
+			Instr i = program->code[pc];
+			BcOp op = INSTR_OP(i);
+			String name = bytecode_op_name(op);
+			String operands = {0};
+			switch(op){
+			case BcOp_LoadK:
+				operands = str_format(arena, "r%u %.*s", INSTR_A(i), str_fmt(bytecode_format_value(program->constants[INSTR_BX(i)], arena)));
+				break;
+			case BcOp_LoadI:     operands = str_format(arena, "r%u %d", INSTR_A(i), INSTR_SBX(i)); break;
+			case BcOp_LoadBool:  operands = str_format(arena, "r%u %s", INSTR_A(i), INSTR_B(i) ? "true" : "false"); break;
+			case BcOp_LoadNil: case BcOp_Ret:
+				operands = str_format(arena, "r%u", INSTR_A(i));
+				break;
+			case BcOp_GetGlobal: case BcOp_SetGlobal:
+				operands = str_format(arena, "r%u g%u", INSTR_A(i), INSTR_BX(i));
+				break;
+			case BcOp_Move: case BcOp_Neg: case BcOp_BitNot: case BcOp_Not:
+				operands = str_format(arena, "r%u r%u", INSTR_A(i), INSTR_B(i));
+				break;
+			case BcOp_AddI:      operands = str_format(arena, "r%u r%u %d", INSTR_A(i), INSTR_B(i), INSTR_SC(i)); break;
+			case BcOp_Jmp:       operands = str_format(arena, "-> %d", (i32)pc + 1 + INSTR_SJ(i) - (i32)fn->code_start); break;
+			case BcOp_JmpFalse: case BcOp_JmpTrue:
+				operands = str_format(arena, "r%u -> %d", INSTR_A(i), (i32)pc + 1 + INSTR_SBX(i) - (i32)fn->code_start);
+				break;
+			case BcOp_Call:
+				operands = str_format(arena, "r%u %.*s", INSTR_A(i), str_fmt(program->functions[INSTR_BX(i)].name));
+				break;
+			case BcOp_RetNil: operands = str_lit(""); break;
+			default:
+				operands = str_format(arena, "r%u r%u r%u", INSTR_A(i), INSTR_B(i), INSTR_C(i));
+				break;
+			}
+			out = str_format(arena, "%.*s  %4u %.*s %.*s\n", str_fmt(out), pc - fn->code_start, str_fmt(name), str_fmt(operands));
+		}
+	}
+	return out;
+}
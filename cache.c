@@ -0,0 +1,173 @@
+#include "kielo.h"
+#include "base/hash.h"
+
+typedef struct {
+	u32 magic;
+	u32 format_version;
+	u64 compiler_hash;
+	u64 content_hash;
+	u64 source_len;
+	u64 total_size;
+	u64 body_hash; /* Of everything after the header, the indices in it are trusted once it matches */
+
+	u32 token_count;
+	u32 literal_count;
+	u32 node_count;
+	u32 extra_count;
+	u32 root;
+	u32 _pad;
+
+	/* Offsets from the start of the file, all 8 byte aligned */
+	u64 tokens;
+	u64 literals;
+	u64 kind;
+	u64 token;
+	u64 lhs;
+	u64 rhs;
+	u64 extra;
+} CacheHeader;
+
+/* Anything that changes how tokens or nodes are encoded must change this hash */
+static
+u64 cache_compiler_hash(){
+	static char const version[] = KIELO_VERSION;
+	u64 layout[] = { CACHE_FORMAT_VERSION, TokenKind__len, AstKind__len, sizeof(PackedToken), sizeof(PackedLiteral) };
+	return hash_bytes(layout, sizeof(layout), hash_bytes(version, sizeof(version) - 1, 0));
+}
+
+u64 cache_key(String source){
+	return hash_bytes(source.v, source.len, cache_compiler_hash());
+}
+
+static
+char const* cache_path(String dir, u64 key, Arena* arena){
+	String path = str_format(arena, "%.*s/%016llx.klc", str_fmt(dir), (unsigned long long)key);
+	return (char const*)path.v;
+}
+
+static
+u64 cache_body_hash(byte const* data, u64 total_size, u64 key){
+	return hash_bytes(data + sizeof(CacheHeader), (isize)(total_size - sizeof(CacheHeader)), key);
+}
+
+static inline
+bool cache_section_ok(CacheHeader const* h, u64 offset, u64 size){
+	return (offset % 8) == 0 && offset >= sizeof(CacheHeader) && offset <= h->total_size && size <= h->total_size - offset;
+}
+
+bool cache_load(String dir, String source, Arena* scratch, CacheEntry* out){
+	*out = (CacheEntry){0};
+	u64 key = cache_key(source);
+
+	ArenaRegion reg = arena_region_begin(scratch);
+	char const* path = cache_path(dir, key, scratch);
+	FileMapping m;
+	bool mapped = file_map(path, &m);
+	arena_region_end(reg);
+	if(!mapped){ return false; }
+
+	CacheHeader const* h = (CacheHeader const*)m.data;
+	bool ok = m.size >= (isize)sizeof(CacheHeader)
+		&& h->magic == CACHE_MAGIC
+		&& h->format_version == CACHE_FORMAT_VERSION
+		&& h->compiler_hash == cache_compiler_hash()
+		&& h->content_hash == key
+		&& h->source_len == (u64)source.len
+		&& h->total_size == (u64)m.size
+		&& h->token_count > 0
+		&& h->root < h->node_count
+		&& cache_section_ok(h, h->tokens, (u64)h->token_count * sizeof(PackedToken))
+		&& cache_section_ok(h, h->literals, (u64)h->literal_count * sizeof(PackedLiteral))
+		&& cache_section_ok(h, h->kind, h->node_count)
+		&& cache_section_ok(h, h->token, (u64)h->node_count * sizeof(u32))
+		&& cache_section_ok(h, h->lhs, (u64)h->node_count * sizeof(u32))
+		&& cache_section_ok(h, h->rhs, (u64)h->node_count * sizeof(u32))
+		&& cache_section_ok(h, h->extra, (u64)h->extra_count * sizeof(u32))
+		&& h->body_hash == cache_body_hash(m.data, h->total_size, key);
+	if(!ok){
+		file_unmap(&m);
+		return false;
+	}
+
+	out->mapping = m;
+	out->root = h->root;
+	out->tokens = (PackedTokenArray){
+		.v = (PackedToken*)(m.data + h->tokens),
+		.len = h->token_count,
+		.literals = (PackedLiteral*)(m.data + h->literals),
+		.literal_len = h->literal_count,
+		.source = source,
+	};
+	out->ast = (Ast){
+		.kind  = m.data + h->kind,
+		.token = (u32*)(m.data + h->token),
+		.lhs   = (u32*)(m.data + h->lhs),
+		.rhs   = (u32*)(m.data + h->rhs),
+		.len = h->node_count,
+		.cap = h->node_count,
+		.extra = (u32*)(m.data + h->extra),
+		.extra_len = h->extra_count,
+		.extra_cap = h->extra_count,
+		.arena = NULL,
+	};
+	return true;
+}
+
+static inline
+u64 cache_place(u64* cursor, u64 size){
+	u64 offset = *cursor;
+	*cursor = (u64)mem_align_forward_size((isize)(offset + size), 8);
+	return offset;
+}
+
+bool cache_store(String dir, String source, PackedTokenArray const* tokens, Ast const* ast, u32 root, Arena* scratch){
+	ArenaRegion reg = arena_region_begin(scratch);
+
+	u64 key = cache_key(source);
+	u64 cursor = sizeof(CacheHeader);
+	CacheHeader h = {
+		.magic = CACHE_MAGIC,
+		.format_version = CACHE_FORMAT_VERSION,
+		.compiler_hash = cache_compiler_hash(),
+		.content_hash = key,
+		.source_len = (u64)source.len,
+		.token_count = tokens->len,
+		.literal_count = tokens->literal_len,
+		.node_count = ast->len,
+		.extra_count = ast->extra_len,
+		.root = root,
+	};
+	h.tokens   = cache_place(&cursor, (u64)h.token_count * sizeof(PackedToken));
+	h.literals = cache_place(&cursor, (u64)h.literal_count * sizeof(PackedLiteral));
+	h.kind     = cache_place(&cursor, h.node_count);
+	h.token    = cache_place(&cursor, (u64)h.node_count * sizeof(u32));
+	h.lhs      = cache_place(&cursor, (u64)h.node_count * sizeof(u32));
+	h.rhs      = cache_place(&cursor, (u64)h.node_count * sizeof(u32));
+	h.extra    = cache_place(&cursor, (u64)h.extra_count * sizeof(u32));
+	h.total_size = cursor;
+
+	byte* buf = arena_alloc(scratch, (isize)h.total_size, 8);
+	bool ok = buf != NULL;
+	if(ok){
+		mem_copy_no_overlap(buf, &h, sizeof(h));
+		mem_copy_no_overlap(buf + h.tokens, tokens->v, (isize)h.token_count * sizeof(PackedToken));
+		mem_copy_no_overlap(buf + h.literals, tokens->literals, (isize)h.literal_count * sizeof(PackedLiteral));
+		mem_copy_no_overlap(buf + h.kind, ast->kind, h.node_count);
+		mem_copy_no_overlap(buf + h.token, ast->token, (isize)h.node_count * sizeof(u32));
+		mem_copy_no_overlap(buf + h.lhs, ast->lhs, (isize)h.node_count * sizeof(u32));
+		mem_copy_no_overlap(buf + h.rhs, ast->rhs, (isize)h.node_count * sizeof(u32));
+		mem_copy_no_overlap(buf + h.extra, ast->extra, (isize)h.extra_count * sizeof(u32));
+		((CacheHeader*)buf)->body_hash = cache_body_hash(buf, h.total_size, key);
+
+		char const* dir_path = (char const*)str_format(scratch, "%.*s", str_fmt(dir)).v;
+		ok = file_make_dir(dir_path) && file_write_atomic(cache_path(dir, key, scratch), buf, (isize)h.total_size);
+	}
+
+	arena_region_end(reg);
+	return ok;
+}
+
+void cache_release(CacheEntry* entry){
+	file_unmap(&entry->mapping);
+	*entry = (CacheEntry){0};
+}
@@ -0,0 +1,571 @@
+#include "kielo.h"
+#include "base/hash.h"
+
+//// Interning
+InternTable intern_create(Arena* arena, u32 capacity){
+	capacity = max(capacity, 16u);
+	u32 slot_count = 32;
+	while(slot_count < capacity * 2){ slot_count *= 2; }
+
+	InternTable t = {
+		.names = arena_make(arena, String, capacity),
+		.hashes = arena_make(arena, u32, capacity),
+		.cap = capacity,
+		.slots = arena_make(arena, u32, slot_count),
+		.slot_mask = slot_count - 1,
+		.arena = arena,
+	};
+	ensure(t.names && t.hashes && t.slots, "Failed to allocate intern table");
+	return t;
+}
+
+/* Keeps the load factor at or below one half */
+static
+void intern_grow(InternTable* t){
+	u32 new_cap = t->cap * 2;
+	t->names = arena_realloc(t->arena, t->names, t->cap * sizeof(String), new_cap * sizeof(String), alignof(String));
+	t->hashes = arena_realloc(t->arena, t->hashes, t->cap * sizeof(u32), new_cap * sizeof(u32), alignof(u32));
+	t->cap = new_cap;
+
+	u32 slot_count = (t->slot_mask + 1) * 2;
+	t->slots = arena_make(t->arena, u32, slot_count);
+	t->slot_mask = slot_count - 1;
+	ensure(t->names && t->hashes && t->slots, "Failed to grow intern table");
+
+	for(u32 id = 0; id < t->len; id += 1){
+		u32 i = t->hashes[id] & t->slot_mask;
+		while(t->slots[i] != 0){ i = (i + 1) & t->slot_mask; }
+		t->slots[i] = id + 1;
+	}
+}
+
+u32 intern(InternTable* t, String name){
+	u32 hash = (u32)hash_bytes(name.v, name.len, 0);
+	u32 i = hash & t->slot_mask;
+	for(; t->slots[i] != 0; i = (i + 1) & t->slot_mask){
+		u32 id = t->slots[i] - 1;
+		if(t->hashes[id] == hash && str_equals(t->names[id], name)){
+			return id;
+		}
+	}
+
+	if(t->len == t->cap){
+		intern_grow(t);
+		i = hash & t->slot_mask;
+		while(t->slots[i] != 0){ i = (i + 1) & t->slot_mask; }
+	}
+
+	u32 id = t->len;
+	t->names[id] = name;
+	t->hashes[id] = hash;
+	t->slots[i] = id + 1;
+	t->len += 1;
+	return id;
+}
+
+String intern_name(InternTable const* t, u32 id){
+	ensure(id < t->len, "Invalid interned id");
+	return t->names[id];
+}
+
+//// Symbols
+#define SCOPE_INITIAL_SLOTS 8
+
+/* Ids are dense and sequential, a multiplicative hash spreads them over the table */
+static inline
+u32 scope_slot(u32 name, u32 mask){
+	return (u32)(((u64)(name + 1) * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+}
+
+SymbolTable symbol_table_create(Arena* arena, Arena* scope_arena, u32 symbol_capacity){
+	symbol_capacity = max(symbol_capacity, 16u);
+	SymbolTable t = {
+		.v = arena_make(arena, Symbol, symbol_capacity),
+		.cap = symbol_capacity,
+		.scopes = arena_make(arena, Scope, 16),
+		.scope_cap = 16,
+		.arena = arena,
+		.scope_arena = scope_arena,
+	};
+	ensure(t.v && t.scopes, "Failed to allocate symbol table");
+	return t;
+}
+
+static
+void scope_alloc(Scope* s, Arena* arena, u32 slot_count){
+	s->keys = arena_make(arena, u32, slot_count);
+	s->values = arena_make(arena, u32, slot_count);
+	s->mask = slot_count - 1;
+	ensure(s->keys && s->values, "Failed to allocate scope");
+}
+
+void symbol_scope_push(SymbolTable* t){
+	if(t->depth == t->scope_cap){
+		u32 new_cap = t->scope_cap * 2;
+		t->scopes = arena_realloc(t->arena, t->scopes, t->scope_cap * sizeof(Scope), new_cap * sizeof(Scope), alignof(Scope));
+		ensure(t->scopes != NULL, "Failed to grow scope stack");
+		t->scope_cap = new_cap;
+	}
+
+	Scope* s = &t->scopes[t->depth];
+	*s = (Scope){ .region = arena_region_begin(t->scope_arena) };
+	scope_alloc(s, t->scope_arena, SCOPE_INITIAL_SLOTS);
+	t->depth += 1;
+}
+
+void symbol_scope_pop(SymbolTable* t){
+	ensure(t->depth > 0, "No scope to pop");
+	t->depth -= 1;
+	arena_region_end(t->scopes[t->depth].region);
+}
+
+static
+u32 scope_find(Scope const* s, u32 name){
+	for(u32 i = scope_slot(name, s->mask); s->keys[i] != 0; i = (i + 1) & s->mask){
+		if(s->keys[i] == name + 1){
+			return s->values[i];
+		}
+	}
+	return SYMBOL_NONE;
+}
+
+static
+void scope_insert(Scope* s, u32 name, u32 symbol){
+	u32 i = scope_slot(name, s->mask);
+	while(s->keys[i] != 0){ i = (i + 1) & s->mask; }
+	s->keys[i] = name + 1;
+	s->values[i] = symbol;
+	s->len += 1;
+}
+
+u32 symbol_declare(SymbolTable* t, Symbol sym, u32* existing){
+	ensure(t->depth > 0, "No open scope");
+	Scope* s = &t->scopes[t->depth - 1];
+
+	u32 found = scope_find(s, sym.name);
+	if(found != SYMBOL_NONE){
+		*existing = found;
+		return SYMBOL_NONE;
+	}
+
+	if(t->len == t->cap){
+		u32 new_cap = t->cap * 2;
+		t->v = arena_realloc(t->arena, t->v, t->cap * sizeof(Symbol), new_cap * sizeof(Symbol), alignof(Symbol));
+		ensure(t->v != NULL, "Failed to grow symbol table");
+		t->cap = new_cap;
+	}
+	u32 index = t->len;
+	t->v[index] = sym;
+	t->len += 1;
+
+	/* Only the innermost scope grows, so the old map is simply abandoned in its region */
+	if((s->len + 1) * 2 > s->mask + 1){
+		Scope old = *s;
+		scope_alloc(s, t->scope_arena, (old.mask + 1) * 2);
+		for(u32 i = 0; i <= old.mask; i += 1){
+			if(old.keys[i] != 0){
+				scope_insert(s, old.keys[i] - 1, old.values[i]);
+			}
+		}
+	}
+	scope_insert(s, sym.name, index);
+	return index;
+}
+
+u32 symbol_lookup(SymbolTable const* t, u32 name){
+	for(u32 d = t->depth; d > 0; d -= 1){
+		u32 found = scope_find(&t->scopes[d - 1], name);
+		if(found != SYMBOL_NONE){
+			return found;
+		}
+	}
+	return SYMBOL_NONE;
+}
+
+#undef SCOPE_INITIAL_SLOTS
+
+//// Constant folding
+static
+Constant const_int(i64 v){
+	return (Constant){ .kind = ConstKind_Int, .value.integer = v };
+}
+
+static
+Constant const_real(f64 v){
+	return (Constant){ .kind = ConstKind_Real, .value.real = v };
+}
+
+static
+Constant const_bool(bool v){
+	return (Constant){ .kind = ConstKind_Bool, .value.boolean = v };
+}
+
+static
+ConstFoldResult const_fold_int(TokenKind op, i64 l, i64 r, Constant* out){
+	/* Computed on u64 so wrapping is defined, then checked against the exact result */
+	switch(op){
+	case TokenKind_Plus: {
+		i64 v = (i64)((u64)l + (u64)r);
+		if((r > 0 && v < l) || (r < 0 && v > l)){ return ConstFold_Overflow; }
+		*out = const_int(v);
+	} break;
+
+	case TokenKind_Minus: {
+		i64 v = (i64)((u64)l - (u64)r);
+		if((r > 0 && v > l) || (r < 0 && v < l)){ return ConstFold_Overflow; }
+		*out = const_int(v);
+	} break;
+
+	case TokenKind_Star: {
+		if((l == -1 && r == INT64_MIN) || (r == -1 && l == INT64_MIN)){ return ConstFold_Overflow; }
+		i64 v = (i64)((u64)l * (u64)r);
+		if(l != 0 && v / l != r){ return ConstFold_Overflow; }
+		*out = const_int(v);
+	} break;
+
+	case TokenKind_Slash: case TokenKind_Modulo:
+		if(r == 0){ return ConstFold_DivisionByZero; }
+		if(r == -1){
+			/* INT64_MIN / -1 does not fit and traps on x86, the remainder is always 0 */
+			if(op == TokenKind_Slash && l == INT64_MIN){ return ConstFold_Overflow; }
+			*out = const_int(op == TokenKind_Slash ? (i64)(0 - (u64)l) : 0);
+		}
+		else {
+			*out = const_int(op == TokenKind_Slash ? l / r : l % r);
+		}
+		break;
+
+	case TokenKind_ShiftLeft: case TokenKind_ShiftRight:
+		if(r < 0 || r > 63){ return ConstFold_ShiftRange; }
+		*out = const_int(op == TokenKind_ShiftLeft ? (i64)((u64)l << r) : l >> r);
+		break;
+
+	case TokenKind_And:   *out = const_int(l & r); break;
+	case TokenKind_Or:    *out = const_int(l | r); break;
+	case TokenKind_Tilde: *out = const_int(l ^ r); break;
+
+	case TokenKind_Equal:        *out = const_bool(l == r); break;
+	case TokenKind_NotEqual:     *out = const_bool(l != r); break;
+	case TokenKind_Greater:      *out = const_bool(l > r); break;
+	case TokenKind_Less:         *out = const_bool(l < r); break;
+	case TokenKind_GreaterEqual: *out = const_bool(l >= r); break;
+	case TokenKind_LessEqual:    *out = const_bool(l <= r); break;
+
+	default: return ConstFold_NotConstant;
+	}
+	return ConstFold_Ok;
+}
+
+static
+ConstFoldResult const_fold_real(TokenKind op, f64 l, f64 r, Constant* out){
+	switch(op){
+	case TokenKind_Plus:  *out = const_real(l + r); break;
+	case TokenKind_Minus: *out = const_real(l - r); break;
+	case TokenKind_Star:  *out = const_real(l * r); break;
+	case TokenKind_Slash: *out = const_real(l / r); break;
+
+	case TokenKind_Equal:        *out = const_bool(l == r); break;
+	case TokenKind_NotEqual:     *out = const_bool(l != r); break;
+	case TokenKind_Greater:      *out = const_bool(l > r); break;
+	case TokenKind_Less:         *out = const_bool(l < r); break;
+	case TokenKind_GreaterEqual: *out = const_bool(l >= r); break;
+	case TokenKind_LessEqual:    *out = const_bool(l <= r); break;
+
+	default: return ConstFold_NotConstant;
+	}
+	return ConstFold_Ok;
+}
+
+static
+ConstFoldResult const_fold_bool(TokenKind op, bool l, bool r, Constant* out){
+	switch(op){
+	case TokenKind_Equal:    *out = const_bool(l == r); break;
+	case TokenKind_NotEqual: *out = const_bool(l != r); break;
+	case TokenKind_LogicAnd: *out = const_bool(l && r); break;
+	case TokenKind_LogicOr:  *out = const_bool(l || r); break;
+	default: return ConstFold_NotConstant;
+	}
+	return ConstFold_Ok;
+}
+
+ConstFoldResult const_fold_binary(TokenKind op, Constant lhs, Constant rhs, Constant* out){
+	/* No implicit conversions, mixed operands are a type error reported elsewhere */
+	if(lhs.kind == ConstKind_None || lhs.kind != rhs.kind){
+		return ConstFold_NotConstant;
+	}
+	switch((ConstKind)lhs.kind){
+	case ConstKind_Int:  return const_fold_int(op, lhs.value.integer, rhs.value.integer, out);
+	case ConstKind_Real: return const_fold_real(op, lhs.value.real, rhs.value.real, out);
+	case ConstKind_Bool: return const_fold_bool(op, lhs.value.boolean, rhs.value.boolean, out);
+	default: return ConstFold_NotConstant;
+	}
+}
+
+ConstFoldResult const_fold_unary(TokenKind op, Constant operand, Constant* out){
+	switch(operand.kind){
+	case ConstKind_Int:
+		if(op == TokenKind_Minus){
+			if(operand.value.integer == INT64_MIN){ return ConstFold_Overflow; }
+			*out = const_int(-operand.value.integer);
+			return ConstFold_Ok;
+		}
+		if(op == TokenKind_Tilde){
+			*out = const_int(~operand.value.integer);
+			return ConstFold_Ok;
+		}
+		break;
+
+	case ConstKind_Real:
+		if(op == TokenKind_Minus){
+			*out = const_real(-operand.value.real);
+			return ConstFold_Ok;
+		}
+		break;
+
+	case ConstKind_Bool:
+		if(op == TokenKind_LogicNot){
+			*out = const_bool(!operand.value.boolean);
+			return ConstFold_Ok;
+		}
+		break;
+	}
+	return ConstFold_NotConstant;
+}
+
+//// Checker
+Checker checker_create(Ast const* ast, TokenArray tokens, String source, Arena* arena, Arena* scope_arena, Arena* error_arena){
+	ensure(arena != scope_arena && error_arena != scope_arena, "The scope arena is rewound as scopes close");
+
+	u32 decl_count = 0;
+	for(u32 n = 0; n < ast->len; n += 1){
+		AstKind k = ast->kind[n];
+		decl_count += (k == AstKind_Fn || k == AstKind_Let || k == AstKind_Param);
+	}
+
+	Checker c = {
+		.ast = ast,
+		.tokens = tokens,
+		.source = source,
+		.names = intern_create(arena, decl_count * 2),
+		.symbols = symbol_table_create(arena, scope_arena, decl_count),
+		.resolved = arena_make(arena, u32, max(ast->len, 1u)),
+		.constants = arena_make(arena, Constant, max(ast->len, 1u)),
+		.error_arena = error_arena,
+		.max_errors = LEXER_DEFAULT_MAX_ERRORS,
+	};
+	ensure(c.resolved != NULL && c.constants != NULL, "Failed to allocate checker results");
+	mem_set(c.resolved, 0xff, max(ast->len, 1u) * sizeof(u32));
+	return c;
+}
+
+void checker_emit_error(Checker* c, CheckerError type, u32 token, char const* fmt, ...){
+	c->error_count += 1;
+	if(c->error_count > c->max_errors + 1){
+		return;
+	}
+
+	CompilerError* err = arena_make(c->error_arena, CompilerError, 1);
+	err->stage = CompilerStage_Check;
+	err->offset = (u64)(c->tokens.v[token].lexeme.v - c->source.v);
+	err->filename = c->filename;
+
+	if(c->error_count > c->max_errors){
+		err->type = CheckerError_TooManyErrors;
+		err->message = str_format(c->error_arena, "Too many errors (limit is %d), further errors in this file are not reported", c->max_errors);
+	}
+	else {
+		va_list argp;
+		va_start(argp, fmt);
+		err->type = (u32)type;
+		err->message = str_vformat(c->error_arena, fmt, argp);
+		va_end(argp);
+	}
+
+	compiler_error_insert(&c->error, &c->error_tail, err);
+}
+
+/* Token naming what `node` declares, or 0 if the parser recovered from a missing name */
+static
+u32 checker_decl_token(Checker const* c, u32 node){
+	Ast const* ast = c->ast;
+	u32 tk = 0;
+	switch((AstKind)ast->kind[node]){
+	case AstKind_Fn:    tk = ast->token[ast->lhs[node]]; break;
+	case AstKind_Let:   tk = ast->token[node] + 1; break;
+	case AstKind_Param: tk = ast->token[node]; break;
+	default: break;
+	}
+	return c->tokens.v[tk].kind == TokenKind_Identifier ? tk : 0;
+}
+
+static
+void checker_declare(Checker* c, u32 node, SymbolKind kind){
+	u32 tk = checker_decl_token(c, node);
+	if(tk == 0){ return; }
+
+	String name = c->tokens.v[tk].lexeme;
+	Symbol sym = { .name = intern(&c->names, name), .node = node, .kind = (u8)kind };
+	u32 existing = SYMBOL_NONE;
+	if(symbol_declare(&c->symbols, sym, &existing) == SYMBOL_NONE){
+		checker_emit_error(c, CheckerError_Redeclared, tk, "'%.*s' is already declared in this scope", str_fmt(name));
+	}
+}
+
+/* Operands are checked, and so folded, before the node itself */
+static
+void checker_fold(Checker* c, u32 node){
+	Ast const* ast = c->ast;
+	Token const* tk = &c->tokens.v[ast->token[node]];
+	Constant* out = &c->constants[node];
+
+	ConstFoldResult res = ConstFold_NotConstant;
+	switch((AstKind)ast->kind[node]){
+	case AstKind_Integer: *out = const_int(tk->value.integer); return;
+	case AstKind_Real:    *out = const_real(tk->value.real); return;
+	case AstKind_Unary:
+		res = const_fold_unary(tk->kind, c->constants[ast->lhs[node]], out);
+		break;
+	case AstKind_Binary:
+		res = const_fold_binary(tk->kind, c->constants[ast->lhs[node]], c->constants[ast->rhs[node]], out);
+		break;
+	default: return;
+	}
+
+	/* Failed folds leave the node non constant so one bad operation is reported once */
+	switch(res){
+	case ConstFold_Overflow:
+		checker_emit_error(c, CheckerError_ConstantOverflow, ast->token[node], "Integer overflow in constant expression");
+		break;
+	case ConstFold_DivisionByZero:
+		checker_emit_error(c, CheckerError_DivisionByZero, ast->token[node], "Division by zero in constant expression");
+		break;
+	case ConstFold_ShiftRange:
+		checker_emit_error(c, CheckerError_ShiftRange, ast->token[node], "Shift amount %lld is out of range, it must be between 0 and 63",
+			(long long)c->constants[ast->rhs[node]].value.integer);
+		break;
+	default: break;
+	}
+}
+
+static
+void checker_check_node(Checker* c, u32 node);
+
+static
+void checker_check_list(Checker* c, u32 start, u32 count){
+	for(u32 i = 0; i < count; i += 1){
+		checker_check_node(c, c->ast->extra[start + i]);
+	}
+}
+
+static
+void checker_check_fn(Checker* c, u32 fn){
+	Ast const* ast = c->ast;
+	u32 proto = ast->lhs[fn];
+	u32 params = ast->lhs[proto];
+	u32 count = ast->rhs[proto];
+
+	/* Parameters live in their own scope so the body may shadow them */
+	symbol_scope_push(&c->symbols);
+	for(u32 i = 0; i < count; i += 1){
+		checker_declare(c, ast->extra[params + i], SymbolKind_Param);
+	}
+	checker_check_node(c, ast->rhs[fn]);
+	symbol_scope_pop(&c->symbols);
+}
+
+static
+void checker_check_node(Checker* c, u32 node){
+	Ast const* ast = c->ast;
+	u32 lhs = ast->lhs[node];
+	u32 rhs = ast->rhs[node];
+
+	switch((AstKind)ast->kind[node]){
+	case AstKind_Block:
+		symbol_scope_push(&c->symbols);
+		checker_check_list(c, lhs, rhs);
+		symbol_scope_pop(&c->symbols);
+		break;
+
+	case AstKind_Let:
+		/* The initializer cannot see the name it initializes */
+		checker_check_node(c, rhs);
+		checker_declare(c, node, SymbolKind_Let);
+		break;
+
+	case AstKind_Fn:
+		/* Nested functions are not parsed, top-level ones are declared by the file */
+		checker_check_fn(c, node);
+		break;
+
+	case AstKind_If:
+		checker_check_node(c, lhs);
+		checker_check_node(c, ast->extra[rhs]);
+		checker_check_node(c, ast->extra[rhs + 1]);
+		break;
+
+	case AstKind_Call:
+		checker_check_node(c, lhs);
+		checker_check_list(c, rhs + 1, ast->extra[rhs]);
+		break;
+
+	case AstKind_Return: case AstKind_ExprStmt: case AstKind_Member:
+		checker_check_node(c, lhs);
+		break;
+
+	case AstKind_For: case AstKind_Assign: case AstKind_Index:
+		checker_check_node(c, lhs);
+		checker_check_node(c, rhs);
+		break;
+
+	case AstKind_Unary:
+		checker_check_node(c, lhs);
+		checker_fold(c, node);
+		break;
+
+	case AstKind_Binary:
+		checker_check_node(c, lhs);
+		checker_check_node(c, rhs);
+		checker_fold(c, node);
+		break;
+
+	case AstKind_Integer: case AstKind_Real:
+		checker_fold(c, node);
+		break;
+
+	case AstKind_Ident: {
+		u32 tk = ast->token[node];
+		String name = c->tokens.v[tk].lexeme;
+		u32 sym = symbol_lookup(&c->symbols, intern(&c->names, name));
+		if(sym == SYMBOL_NONE){
+			checker_emit_error(c, CheckerError_Undeclared, tk, "Undeclared name '%.*s'", str_fmt(name));
+		}
+		c->resolved[node] = sym;
+	} break;
+
+	default: break;
+	}
+}
+
+void checker_check_file(Checker* c, u32 file){
+	Ast const* ast = c->ast;
+	u32 decls = ast->lhs[file];
+	u32 count = ast->rhs[file];
+
+	symbol_scope_push(&c->symbols);
+	for(u32 i = 0; i < count; i += 1){
+		u32 decl = ast->extra[decls + i];
+		AstKind k = ast->kind[decl];
+		if(k == AstKind_Fn || k == AstKind_Let){
+			checker_declare(c, decl, k == AstKind_Fn ? SymbolKind_Fn : SymbolKind_Let);
+		}
+	}
+	for(u32 i = 0; i < count; i += 1){
+		u32 decl = ast->extra[decls + i];
+		switch((AstKind)ast->kind[decl]){
+		case AstKind_Fn:  checker_check_fn(c, decl); break;
+		case AstKind_Let: checker_check_node(c, ast->rhs[decl]); break;
+		default: break;
+		}
+	}
+	symbol_scope_pop(&c->symbols);
+}
@@ -0,0 +1,578 @@
+#include "kielo.h"
+#include "base/clock.h"
+#include "base/thread.h"
+
+#include <stdlib.h>
+
+String driver_phase_name(DriverPhase phase){
+	switch(phase){
+	case DriverPhase_Read:  return str_lit("read");
+	case DriverPhase_Cache: return str_lit("cache");
+	case DriverPhase_Lex:   return str_lit("lex");
+	case DriverPhase_Parse: return str_lit("parse");
+	case DriverPhase_Check: return str_lit("check");
+	default: return str_lit("<INVALID PHASE>");
+	}
+}
+
+void print_compiler_error(FILE* out, CompilerError const* err){
+	fprintf(out, TERM_COLOR_RED "error" TERM_COLOR_RESET " (%.*s:%lld) %.*s\n",
+		str_fmt(err->filename),
+		(long long)err->offset,
+		str_fmt(err->message));
+}
+
+static
+void unit_take_errors(CompilationUnit* unit, CompilerError* list, i32 count, String filename){
+	CompilerError* tail = unit->errors;
+	while(tail != NULL && tail->next != NULL){ tail = tail->next; }
+
+	for(CompilerError* err = list; err != NULL;){
+		CompilerError* next = err->next;
+		err->filename = filename;
+		compiler_error_insert(&unit->errors, &tail, err);
+		err = next;
+	}
+	unit->error_count += count;
+}
+
+/* Name resolution, only for files that parsed cleanly since recovered trees would mostly add noise */
+static
+void unit_check(CompilationUnit* unit, Arena* arena){
+	if(unit->error_count > 0){
+		return;
+	}
+	i64 start = clock_now();
+
+	byte scope_mem[16 * mem_kilobyte];
+	Arena scope_arena = arena_create_dynamic(scope_mem, sizeof(scope_mem));
+	arena_set_tag(&scope_arena, "checker scopes");
+
+	Checker c = checker_create(&unit->ast, unit->tokens, unit->source, arena, &scope_arena, arena);
+	c.filename = unit->path;
+	checker_check_file(&c, unit->root);
+	arena_destroy(&scope_arena);
+
+	unit->names = c.names;
+	unit->symbols = c.symbols;
+	unit->resolved = c.resolved;
+	unit->constants = c.constants;
+	unit_take_errors(unit, c.error, c.error_count, unit->path);
+	unit->phase_time[DriverPhase_Check] = clock_now() - start;
+}
+
+bool unit_compile(CompilationUnit* unit, String path, String cache_dir, Arena* arena){
+	*unit = (CompilationUnit){ .path = path };
+
+	/* `path` may not be NUL terminated */
+	i64 start = clock_now();
+	char const* cpath = (char const*)str_format(arena, "%.*s", str_fmt(path)).v;
+	bool read = file_read_all(cpath, arena, &unit->source);
+	unit->phase_time[DriverPhase_Read] = clock_now() - start;
+	if(!read){
+		return false;
+	}
+
+	if(cache_dir.len > 0){
+		start = clock_now();
+		unit->from_cache = cache_load(cache_dir, unit->source, arena, &unit->cache);
+		if(unit->from_cache){
+			unit->tokens = token_unpack(&unit->cache.tokens, arena);
+			unit->ast = unit->cache.ast;
+			unit->root = unit->cache.root;
+		}
+		unit->phase_time[DriverPhase_Cache] = clock_now() - start;
+		if(unit->from_cache){
+			unit_check(unit, arena);
+			return true;
+		}
+	}
+
+	start = clock_now();
+	Lexer lex = lexer_create(unit->source, arena);
+	lex.filename = path;
+	if(!lex.validated){
+		unit_take_errors(unit, lex.error, lex.error_count, path);
+		unit->phase_time[DriverPhase_Lex] = clock_now() - start;
+		return true; /* Lexing invalid UTF-8 would only add noise */
+	}
+	unit->tokens = lexer_tokenize(&lex, arena);
+	unit->phase_time[DriverPhase_Lex] = clock_now() - start;
+
+	start = clock_now();
+	Parser p = parser_create(unit->source, unit->tokens, arena, arena);
+	p.filename = path;
+	unit->root = parser_parse_file(&p);
+	unit->ast = p.ast;
+	unit->phase_time[DriverPhase_Parse] = clock_now() - start;
+
+	unit_take_errors(unit, lex.error, lex.error_count, path);
+	unit_take_errors(unit, p.error, p.error_count, path);
+
+	if(cache_dir.len > 0 && unit->error_count == 0){
+		start = clock_now();
+		PackedTokenArray packed = token_pack(unit->tokens, unit->source, arena);
+		cache_store(cache_dir, unit->source, &packed, &unit->ast, unit->root, arena);
+		unit->phase_time[DriverPhase_Cache] += clock_now() - start;
+	}
+	unit_check(unit, arena);
+	return true;
+}
+
+void unit_release(CompilationUnit* unit){
+	if(unit->from_cache){
+		cache_release(&unit->cache);
+	}
+	*unit = (CompilationUnit){0};
+}
+
+static
+String driver_arg(char const* arg){
+	return (String){ .v = (byte const*)arg, .len = (isize)__builtin_strlen(arg) };
+}
+
+static
+String driver_resolve_path(DriverContext const* ctx, String path){
+	if(ctx->cwd.len == 0 || (path.len > 0 && path.v[0] == '/')){
+		return path;
+	}
+	return str_format(ctx->scratch, "%.*s/%.*s", str_fmt(ctx->cwd), str_fmt(path));
+}
+
+typedef DynArray(String) DriverFileList;
+
+/* `dir` must be NUL terminated */
+static
+void driver_collect_dir(DriverFileList* list, Arena* arena, String dir){
+	DirEntryArray entries;
+	if(!file_list_dir((char const*)dir.v, arena, &entries)){
+		return;
+	}
+	for(isize i = 0; i < entries.len; i += 1){
+		DirEntry e = entries.v[i];
+		String child = str_format(arena, "%.*s/%.*s", str_fmt(dir), str_fmt(e.name));
+		if(e.is_dir){
+			driver_collect_dir(list, arena, child);
+		}
+		else if(str_ends_with(e.name, str_lit(".kl"))){
+			dyn_push(list, child);
+		}
+	}
+}
+
+/* Byte-wise, so the order does not depend on the directory listing or the locale */
+static
+int driver_path_order(void const* a, void const* b){
+	String const* l = a;
+	String const* r = b;
+	int cmp = mem_compare(l->v, r->v, min(l->len, r->len));
+	if(cmp != 0){
+		return cmp;
+	}
+	return (l->len > r->len) - (l->len < r->len);
+}
+
+typedef struct {
+	String const* files;
+	CompilationUnit* units;
+	bool* compiled;
+	i32 file_count;
+	String cache_dir;
+	atomic_int next;
+} DriverQueue;
+
+typedef struct {
+	DriverQueue* queue;
+	Thread* thread;
+	Arena arena; /* Holds the units this worker compiled until the invocation ends */
+	byte* arena_mem;
+} DriverWorker;
+
+static
+void driver_run_worker(void* arg){
+	DriverWorker* w = arg;
+	DriverQueue* q = w->queue;
+	for(;;){
+		i32 i = atomic_fetch_add(&q->next, 1);
+		if(i >= q->file_count){ break; }
+		q->compiled[i] = unit_compile(&q->units[i], q->files[i], q->cache_dir, &w->arena);
+	}
+}
+
+/* What the later stages need from the checker, rebuilt from a unit */
+static
+Checker driver_checked(CompilationUnit* unit){
+	return (Checker){
+		.ast = &unit->ast,
+		.tokens = unit->tokens,
+		.source = unit->source,
+		.filename = unit->path,
+		.names = unit->names,
+		.symbols = unit->symbols,
+		.resolved = unit->resolved,
+		.constants = unit->constants,
+	};
+}
+
+/* Lowers a unit that checked cleanly to SSA and optimizes it if asked, false after printing its
+   errors */
+static
+bool driver_lower(DriverContext* ctx, CompilationUnit* unit, FILE* out, IrModule* module){
+	Checker c = driver_checked(unit);
+	IrBuilder b = ir_builder_create(&c, ctx->scratch);
+	*module = ir_build_file(&b, unit->root);
+	for(CompilerError* err = b.error; err != NULL; err = err->next){
+		print_compiler_error(out, err);
+	}
+	if(b.error_count > 0){
+		return false;
+	}
+	if(!ctx->optimize){
+		return true;
+	}
+
+	IrOptStats* stats = arena_make(ctx->scratch, IrOptStats, max(module->function_count, 1u));
+	IrInlinedCallArray inlined = { .arena = ctx->scratch };
+	ensure(stats != NULL, "Failed to allocate optimization stats");
+	IrOptOptions options = {
+		.inline_budget = ctx->inline_budget < 0 ? 0 : ctx->inline_budget > 0 ? (u32)ctx->inline_budget : IR_DEFAULT_INLINE_BUDGET,
+		.inlined = ctx->inline_report ? &inlined : NULL,
+		.function_stats = stats,
+	};
+	ir_optimize_module(module, &options);
+
+	for(isize i = 0; i < inlined.len; i += 1){
+		IrInlinedCall const* call = &inlined.v[i];
+		fprintf(out, "%.*s:%u: inlined '%.*s' into '%.*s'\n", str_fmt(unit->path), call->offset,
+			str_fmt(module->functions[call->callee].name), str_fmt(module->functions[call->caller].name));
+	}
+	for(u32 i = 0; ctx->opt_report && i < module->function_count; i += 1){
+		IrOptStats const* s = &stats[i];
+		if(s->removed > 0 || s->inlined > 0){
+			fprintf(out, "%.*s: '%.*s' removed %u instructions (%u folded, %u branches, %u blocks merged, %u calls inlined)\n",
+				str_fmt(unit->path), str_fmt(module->functions[i].name), s->removed, s->folded, s->branches, s->merged, s->inlined);
+		}
+	}
+	return true;
+}
+
+static
+void driver_dump_ir(DriverContext* ctx, IrModule const* module, FILE* out){
+	String dump = ir_dump(module, ctx->scratch);
+	fprintf(out, "%.*s", str_fmt(dump));
+}
+
+static
+bool driver_write_native(DriverContext* ctx, CompilationUnit* unit, IrModule const* module, FILE* out){
+	NativeProgram program = native_emit_module(module, ctx->scratch);
+	char const* path = (char const*)str_format(ctx->scratch, "%.*s", str_fmt(ctx->output)).v;
+	String error = {0};
+	if(!native_write_executable(&program, unit->path, path, ctx->scratch, &error)){
+		fprintf(out, TERM_COLOR_RED "error" TERM_COLOR_RESET " (%.*s) %.*s\n", str_fmt(unit->path), str_fmt(error));
+		return false;
+	}
+	return true;
+}
+
+/* Runs `main` of a unit that checked cleanly as native code in this process */
+static
+bool driver_run_jit(DriverContext* ctx, CompilationUnit* unit, IrModule const* module, FILE* out){
+	NativeProgram program = native_emit_module(module, ctx->scratch);
+	NativeJit jit = native_jit_create(&program, NATIVE_JIT_DEFAULT_STACK, ctx->scratch);
+	jit.filename = unit->path;
+	Value result = {0};
+	bool ok = jit.error == NULL && native_jit_run_main(&jit, &result);
+	native_jit_destroy(&jit);
+	if(!ok){
+		jit.error->filename = unit->path; /* Mapping errors come before the name is set */
+		print_compiler_error(out, jit.error);
+		return false;
+	}
+	if(result.kind != ConstKind_None){
+		String value = bytecode_format_value(result, ctx->scratch);
+		fprintf(out, "%.*s\n", str_fmt(value));
+	}
+	return true;
+}
+
+/* Compiles the IR of a unit to bytecode, then lists or runs it */
+static
+bool driver_execute(DriverContext* ctx, CompilationUnit* unit, IrModule const* module, FILE* out){
+	Emitter e = emitter_create(module, unit->path, ctx->scratch);
+	BcProgram program = emitter_emit_module(&e);
+	for(CompilerError* err = e.error; err != NULL; err = err->next){
+		print_compiler_error(out, err);
+	}
+	if(e.error_count > 0){
+		return false;
+	}
+
+	if(ctx->dump_bytecode){
+		String dump = bytecode_dump(&program, ctx->scratch);
+		fprintf(out, "%.*s", str_fmt(dump));
+	}
+	if(!ctx->run || ctx->jit){
+		return true;
+	}
+
+	Vm vm = vm_create(&program, VM_DEFAULT_STACK, VM_DEFAULT_FRAMES, ctx->scratch);
+	vm.filename = unit->path;
+	Value result = {0};
+	if(!vm_run_main(&vm, &result)){
+		print_compiler_error(out, vm.error);
+		return false;
+	}
+	if(result.kind != ConstKind_None){
+		String value = bytecode_format_value(result, ctx->scratch);
+		fprintf(out, "%.*s\n", str_fmt(value));
+	}
+	return true;
+}
+
+static
+void driver_usage(FILE* out){
+	fprintf(out,
+		"Usage: kielo.exe [options] FILE|DIR...\n"
+		"  --dump-ast         Print the syntax tree of each file\n"
+		"  --dump-ir          Print the SSA form of each file\n"
+		"  --dump-bytecode    Print the bytecode of each file\n"
+		"  --run              Run the 'main' function of each file and print its result\n"
+		"  --jit              With --run, run x86-64 code in memory instead of interpreting\n"
+		"  -O, --optimize     Optimize the SSA form every back end starts from\n"
+		"  --opt-report       Optimize and print what was removed from each function\n"
+		"  --inline-budget N  Inline callees of up to N instructions when optimizing, 0 for none\n"
+		"  --inline-report    Optimize and print every inlined call\n"
+		"  -o, --output FILE  Write an x86-64 Linux executable of the only source file\n"
+		"  --cache DIR        Reuse tokens and syntax trees cached in DIR\n"
+		"  --time             Print the time spent in each phase\n"
+		"  -j, --jobs N       Compile with N threads, defaults to one per processor\n"
+		"  --server SOCKET    Run a compile server listening on SOCKET\n"
+		"  --client SOCKET    Forward the remaining arguments to a compile server\n"
+		"  --shutdown         Stop the server, only valid after --client\n");
+}
+
+int driver_run(DriverContext* ctx, int argc, char const** args, FILE* out){
+	i64 start = clock_now();
+	DriverFileList files = { .arena = ctx->scratch };
+
+	for(int i = 0; i < argc; i += 1){
+		String arg = driver_arg(args[i]);
+		bool has_value = i + 1 < argc;
+
+		if(str_equals(arg, str_lit("--dump-ast"))){
+			ctx->dump_ast = true;
+		}
+		else if(str_equals(arg, str_lit("--dump-ir"))){
+			ctx->dump_ir = true;
+		}
+		else if(str_equals(arg, str_lit("--dump-bytecode"))){
+			ctx->dump_bytecode = true;
+		}
+		else if(str_equals(arg, str_lit("--run"))){
+			ctx->run = true;
+		}
+		else if(str_equals(arg, str_lit("--jit"))){
+			ctx->jit = true;
+		}
+		else if(str_equals(arg, str_lit("--optimize")) || str_equals(arg, str_lit("-O"))){
+			ctx->optimize = true;
+		}
+		else if(str_equals(arg, str_lit("--opt-report"))){
+			ctx->optimize = true;
+			ctx->opt_report = true;
+		}
+		else if(str_equals(arg, str_lit("--inline-report"))){
+			ctx->optimize = true;
+			ctx->inline_report = true;
+		}
+		else if(str_equals(arg, str_lit("--inline-budget")) && has_value){
+			i += 1;
+			i64 budget = 0;
+			if(!str_parse_i64(driver_arg(args[i]), 10, &budget) || budget < 0 || budget > 100000){
+				fprintf(out, "Invalid inline budget '%s'\n", args[i]);
+				return 2;
+			}
+			ctx->inline_budget = budget == 0 ? -1 : (i32)budget;
+		}
+		else if(str_equals(arg, str_lit("--time"))){
+			ctx->time = true;
+		}
+		else if((str_equals(arg, str_lit("--output")) || str_equals(arg, str_lit("-o"))) && has_value){
+			i += 1;
+			ctx->output = driver_resolve_path(ctx, driver_arg(args[i]));
+		}
+		else if(str_equals(arg, str_lit("--cache")) && has_value){
+			i += 1;
+			ctx->cache_dir = driver_resolve_path(ctx, driver_arg(args[i]));
+		}
+		else if((str_equals(arg, str_lit("--jobs")) || str_equals(arg, str_lit("-j"))) && has_value){
+			i += 1;
+			i64 jobs = 0;
+			if(!str_parse_i64(driver_arg(args[i]), 10, &jobs) || jobs < 1 || jobs > 1024){
+				fprintf(out, "Invalid job count '%s'\n", args[i]);
+				return 2;
+			}
+			ctx->jobs = (i32)jobs;
+		}
+		else if(arg.len > 1 && arg.v[0] == '-'){
+			fprintf(out, "Unknown option '%.*s'\n", str_fmt(arg));
+			driver_usage(out);
+			return 2;
+		}
+		else {
+			String path = driver_resolve_path(ctx, arg);
+			if(file_is_dir((char const*)str_format(ctx->scratch, "%.*s", str_fmt(path)).v)){
+				driver_collect_dir(&files, ctx->scratch, path);
+			}
+			else {
+				dyn_push(&files, path);
+			}
+		}
+	}
+
+	if(files.len == 0){
+		driver_usage(out);
+		return 2;
+	}
+	if(ctx->output.len > 0 && files.len != 1){
+		fprintf(out, "--output needs exactly one source file, %d given\n", (int)files.len);
+		return 2;
+	}
+	qsort(files.v, (size_t)files.len, sizeof(String), driver_path_order);
+
+	CompilationUnit** units = arena_make(ctx->scratch, CompilationUnit*, files.len);
+	ensure(units != NULL, "Failed to allocate compilation units");
+
+	DriverWorker* workers = NULL;
+	i32 worker_count = 0;
+	if(ctx->provide_unit != NULL){
+		for(i32 i = 0; i < files.len; i += 1){
+			units[i] = ctx->provide_unit(ctx, files.v[i]);
+		}
+	}
+	else {
+		DriverQueue queue = {
+			.files = files.v,
+			.units = arena_make(ctx->scratch, CompilationUnit, files.len),
+			.compiled = arena_make(ctx->scratch, bool, files.len),
+			.file_count = files.len,
+			.cache_dir = ctx->cache_dir,
+		};
+		i32 jobs = ctx->jobs > 0 ? ctx->jobs : thread_hardware_count();
+		worker_count = clamp(1, jobs, files.len);
+		workers = arena_make(ctx->scratch, DriverWorker, worker_count);
+		ensure(queue.units && queue.compiled && workers, "Failed to allocate compile jobs");
+
+		for(i32 w = 0; w < worker_count; w += 1){
+			isize arena_size = 16 * mem_megabyte;
+			workers[w].queue = &queue;
+			workers[w].arena_mem = heap_alloc(arena_size, 4096);
+			workers[w].arena = arena_create_dynamic(workers[w].arena_mem, arena_size);
+			arena_set_tag(&workers[w].arena, "driver worker");
+		}
+		/* The calling thread is the first worker */
+		for(i32 w = 1; w < worker_count; w += 1){
+			workers[w].thread = thread_create(driver_run_worker, &workers[w]);
+		}
+		driver_run_worker(&workers[0]);
+		for(i32 w = 1; w < worker_count; w += 1){
+			thread_join(workers[w].thread);
+			thread_destroy(workers[w].thread);
+		}
+
+		for(i32 i = 0; i < files.len; i += 1){
+			units[i] = queue.compiled[i] ? &queue.units[i] : NULL;
+		}
+	}
+
+	/* Files are sorted and each unit's errors are ordered by offset, so walking the units in
+	   order merges the error lists by file and offset */
+	int status = 0;
+	i64 phase_time[DriverPhase__len] = {0};
+	for(i32 i = 0; i < files.len; i += 1){
+		CompilationUnit* unit = units[i];
+		if(unit == NULL){
+			fprintf(out, TERM_COLOR_RED "error" TERM_COLOR_RESET " could not read '%.*s'\n", str_fmt(files.v[i]));
+			status = 1;
+			continue;
+		}
+
+		for(CompilerError* err = unit->errors; err != NULL; err = err->next){
+			print_compiler_error(out, err);
+		}
+		if(unit->error_count > 0){
+			status = 1;
+		}
+
+		if(ctx->dump_ast && unit->tokens.len > 0){
+			String dump = ast_dump(&unit->ast, unit->tokens, unit->root, ctx->scratch);
+			fprintf(out, "%.*s\n", str_fmt(dump));
+		}
+		/* The IR is built once for everything that needs it: its lowering does the type checks and
+		   every back end, the bytecode emitter included, starts from it */
+		IrModule module = {0};
+		bool wants_ir = ctx->dump_ir || ctx->dump_bytecode || ctx->run || ctx->output.len > 0;
+		bool lowered = wants_ir && unit->error_count == 0 && driver_lower(ctx, unit, out, &module);
+		if(wants_ir && unit->error_count == 0 && !lowered){
+			status = 1;
+		}
+		if(ctx->dump_ir && lowered){
+			driver_dump_ir(ctx, &module, out);
+		}
+		if((ctx->dump_bytecode || (ctx->run && !ctx->jit)) && lowered && !driver_execute(ctx, unit, &module, out)){
+			status = 1;
+		}
+		if(ctx->run && ctx->jit && lowered && !driver_run_jit(ctx, unit, &module, out)){
+			status = 1;
+		}
+		if(ctx->output.len > 0 && lowered && !driver_write_native(ctx, unit, &module, out)){
+			status = 1;
+		}
+
+		for(i32 p = 0; p < DriverPhase__len; p += 1){
+			phase_time[p] += unit->phase_time[p];
+		}
+		if(ctx->provide_unit == NULL){
+			unit_release(unit);
+		}
+	}
+
+	for(i32 w = 0; w < worker_count; w += 1){
+		arena_destroy(&workers[w].arena);
+		heap_free(workers[w].arena_mem);
+	}
+
+	if(ctx->time){
+		/* Phases are summed over all threads, wall is the time of the whole invocation */
+		for(i32 p = 0; p < DriverPhase__len; p += 1){
+			String name = driver_phase_name(p);
+			fprintf(out, "%-6.*s %10.3f ms\n", str_fmt(name), (f64)phase_time[p] / clock_millisecond);
+		}
+		fprintf(out, "%-6s %10.3f ms (%d files, %d threads)\n", "wall",
+			(f64)(clock_now() - start) / clock_millisecond, (int)files.len, max(worker_count, 1));
+	}
+	return status;
+}
+
+int driver_main(int argc, char const** argv){
+	if(argc >= 3 && __builtin_strcmp(argv[1], "--server") == 0){
+		return server_run(argv[2]);
+	}
+	if(argc >= 3 && __builtin_strcmp(argv[1], "--client") == 0){
+		return client_run(argv[2], argc - 3, argv + 3);
+	}
+
+	isize arena_size = 64 * mem_megabyte;
+	byte* arena_mem = heap_alloc(arena_size, 4096);
+	Arena arena = arena_create_dynamic(arena_mem, arena_size);
+	arena_set_tag(&arena, "driver");
+
+	DriverContext ctx = {
+		.scratch = &arena,
+	};
+	int status = driver_run(&ctx, argc - 1, argv + 1, stdout);
+
+	arena_destroy(&arena);
+	heap_free(arena_mem);
+	return status;
+}
@@ -0,0 +1,25 @@
+#include "kielo.h"
+
+void compiler_error_insert(CompilerError** head, CompilerError** tail, CompilerError* err){
+	err->next = NULL;
+	if(*head == NULL){
+		*head = err;
+		*tail = err;
+	}
+	else if((*tail)->offset <= err->offset){
+		(*tail)->next = err;
+		*tail = err;
+	}
+	else if(err->offset < (*head)->offset){
+		err->next = *head;
+		*head = err;
+	}
+	else {
+		CompilerError* prev = *head;
+		while(prev->next != NULL && prev->next->offset <= err->offset){
+			prev = prev->next;
+		}
+		err->next = prev->next;
+		prev->next = err;
+	}
+}
@@ -0,0 +1,1596 @@
+#include "kielo.h"
+
+/* Where `continue` and `break` jump to */
+typedef struct IrLoop IrLoop;
+
+struct IrLoop {
+	u32 header;
+	u32 exit;
+	IrLoop* outer;
+};
+
+/* Slots of top-level lets have this bit set, the rest is the global index */
+#define IR_GLOBAL_SLOT 0x80000000u
+
+//// Instructions
+IrUses ir_uses(IrFunction* f, IrInst* inst){
+	switch((IrOp)inst->op){
+	case IrOp_SetVar: case IrOp_SetGlobal:
+		return (IrUses){ inst->args + 1, 1 };
+
+	case IrOp_Phi:
+		return (IrUses){ f->operands.v + inst->a, inst->b };
+
+	case IrOp_Call:
+		return (IrUses){ f->operands.v + inst->b, inst->c };
+
+	case IrOp_Add: case IrOp_Sub: case IrOp_Mul: case IrOp_Div: case IrOp_Mod:
+	case IrOp_Shl: case IrOp_Shr: case IrOp_And: case IrOp_Or: case IrOp_Xor:
+	case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le:
+		return (IrUses){ inst->args, 2 };
+
+	case IrOp_Neg: case IrOp_BitNot: case IrOp_Not: case IrOp_Branch:
+		return (IrUses){ inst->args, 1 };
+
+	case IrOp_Return:
+		return (IrUses){ inst->args, inst->a != IR_NONE };
+
+	default:
+		return (IrUses){ inst->args, 0 };
+	}
+}
+
+u32 ir_successors(IrInst const* inst, u32 out[2]){
+	switch(inst->op){
+	case IrOp_Jump:
+		out[0] = inst->a;
+		return 1;
+	case IrOp_Branch:
+		out[0] = inst->b;
+		out[1] = inst->c;
+		return inst->b == inst->c ? 1 : 2;
+	default:
+		return 0;
+	}
+}
+
+Constant ir_const_value(IrInst const* inst){
+	Constant k = { .kind = inst->type };
+	if(inst->type == ConstKind_Bool){
+		k.value.boolean = inst->a != 0;
+	}
+	else {
+		k.value.integer = (i64)((u64)inst->a | ((u64)inst->b << 32));
+	}
+	return k;
+}
+
+String ir_type_name(u8 type){
+	switch(type){
+	case ConstKind_Int:  return str_lit("Int");
+	case ConstKind_Real: return str_lit("Real");
+	case ConstKind_Bool: return str_lit("Bool");
+	default: return str_lit("nil");
+	}
+}
+
+static
+u32* ir_temp(Arena* arena, u32 count, u32 fill){
+	u32* v = arena_make(arena, u32, max(count, 1u));
+	ensure(v != NULL, "Failed to allocate IR scratch");
+	if(fill != 0){
+		for(u32 i = 0; i < count; i += 1){ v[i] = fill; }
+	}
+	return v;
+}
+
+//// Control flow
+void ir_compute_cfg(IrFunction* f){
+	IrBlock* blocks = f->blocks.v;
+	u32 block_count = (u32)f->blocks.len;
+	for(u32 b = 0; b < block_count; b += 1){
+		blocks[b].pred_count = 0;
+	}
+
+	u32 succ[2];
+	for(u32 b = 0; b < block_count; b += 1){
+		if(blocks[b].count == 0){ continue; }
+		u32 n = ir_successors(&f->insts.v[blocks[b].first + blocks[b].count - 1], succ);
+		for(u32 s = 0; s < n; s += 1){
+			blocks[succ[s]].pred_count += 1;
+		}
+	}
+
+	u32 total = 0;
+	for(u32 b = 0; b < block_count; b += 1){
+		blocks[b].pred_start = total;
+		total += blocks[b].pred_count;
+		blocks[b].pred_count = 0;
+	}
+	f->preds.len = 0;
+	dyn_reserve(&f->preds, total);
+	f->preds.len = total;
+
+	for(u32 b = 0; b < block_count; b += 1){
+		if(blocks[b].count == 0){ continue; }
+		u32 n = ir_successors(&f->insts.v[blocks[b].first + blocks[b].count - 1], succ);
+		for(u32 s = 0; s < n; s += 1){
+			IrBlock* to = &blocks[succ[s]];
+			f->preds.v[to->pred_start + to->pred_count] = b;
+			to->pred_count += 1;
+		}
+	}
+}
+
+/* Blocks reachable from the entry in reverse postorder, returns how many */
+static
+u32 ir_reverse_postorder(IrFunction const* f, u32* order){
+	Arena* arena = f->insts.arena;
+	u32 block_count = (u32)f->blocks.len;
+	if(block_count == 0){ return 0; }
+
+	u32* stack = ir_temp(arena, block_count, 0);
+	u32* edge = ir_temp(arena, block_count, 0); /* Next successor to visit of each stack entry */
+	u8* seen = arena_make(arena, u8, block_count);
+	ensure(seen != NULL, "Failed to allocate IR scratch");
+
+	u32 post_len = 0;
+	u32 depth = 1;
+	stack[0] = 0;
+	seen[0] = 1;
+	while(depth > 0){
+		u32 b = stack[depth - 1];
+		IrBlock const* blk = &f->blocks.v[b];
+		u32 succ[2];
+		u32 n = blk->count > 0 ? ir_successors(&f->insts.v[blk->first + blk->count - 1], succ) : 0;
+		if(edge[depth - 1] < n){
+			/* Last successor first, so the first one comes next in the order: then before else,
+			   loop bodies before what follows the loop */
+			u32 s = succ[n - 1 - edge[depth - 1]];
+			edge[depth - 1] += 1;
+			if(!seen[s]){
+				seen[s] = 1;
+				stack[depth] = s;
+				edge[depth] = 0;
+				depth += 1;
+			}
+		}
+		else {
+			order[post_len] = b;
+			post_len += 1;
+			depth -= 1;
+		}
+	}
+
+	for(u32 i = 0; i < post_len / 2; i += 1){
+		u32 t = order[i];
+		order[i] = order[post_len - 1 - i];
+		order[post_len - 1 - i] = t;
+	}
+	return post_len;
+}
+
+/* Walks both fingers up the tree until they meet, `index` is the reverse postorder position */
+static inline
+u32 ir_intersect(IrBlock const* blocks, u32 const* index, u32 a, u32 b){
+	while(a != b){
+		while(index[a] > index[b]){ a = blocks[a].idom; }
+		while(index[b] > index[a]){ b = blocks[b].idom; }
+	}
+	return a;
+}
+
+void ir_compute_dominators(IrFunction* f){
+	Arena* arena = f->insts.arena;
+	u32 block_count = (u32)f->blocks.len;
+	IrBlock* blocks = f->blocks.v;
+	if(block_count == 0){ return; }
+
+	u32* order = ir_temp(arena, block_count, 0);
+	u32 count = ir_reverse_postorder(f, order);
+	u32* index = ir_temp(arena, block_count, IR_NONE);
+	for(u32 i = 0; i < count; i += 1){
+		index[order[i]] = i;
+	}
+	for(u32 b = 0; b < block_count; b += 1){
+		blocks[b].idom = IR_NONE;
+	}
+	blocks[0].idom = 0;
+
+	/* Converges in two passes unless the graph has irreducible loops */
+	for(bool changed = true; changed;){
+		changed = false;
+		for(u32 i = 1; i < count; i += 1){
+			u32 b = order[i];
+			u32 idom = IR_NONE;
+			for(u32 p = 0; p < blocks[b].pred_count; p += 1){
+				u32 pred = f->preds.v[blocks[b].pred_start + p];
+				if(blocks[pred].idom == IR_NONE){ continue; }
+				idom = idom == IR_NONE ? pred : ir_intersect(blocks, index, pred, idom);
+			}
+			if(blocks[b].idom != idom){
+				blocks[b].idom = idom;
+				changed = true;
+			}
+		}
+	}
+}
+
+bool ir_dominates(IrFunction const* f, u32 a, u32 b){
+	for(;;){
+		if(b == a){ return true; }
+		u32 idom = f->blocks.v[b].idom;
+		if(idom == IR_NONE || idom == b){ return false; }
+		b = idom;
+	}
+}
+
+//// Layout
+static inline
+u32 ir_resolve(u32 const* replace, u32 v){
+	if(replace != NULL && v != IR_NONE){
+		while(replace[v] != IR_NONE){ v = replace[v]; }
+	}
+	return v;
+}
+
+static
+bool ir_has_successor(IrFunction const* f, u32 block, u32 succ){
+	IrBlock const* blk = &f->blocks.v[block];
+	if(blk->count == 0){ return false; }
+	u32 out[2];
+	u32 n = ir_successors(&f->insts.v[blk->first + blk->count - 1], out);
+	return (n > 0 && out[0] == succ) || (n > 1 && out[1] == succ);
+}
+
+/* Block that continues `block` in the layout: the target of its jump when that one is merged */
+static inline
+u32 ir_chain_next(IrFunction const* f, u8 const* merged, u32 block){
+	IrBlock const* blk = &f->blocks.v[block];
+	if(merged == NULL || blk->count == 0){ return IR_NONE; }
+	IrInst const* term = &f->insts.v[blk->first + blk->count - 1];
+	return term->op == IrOp_Jump && merged[term->a] ? term->a : IR_NONE;
+}
+
+/* Blocks flagged in `merged` have a single predecessor ending in a jump to them and no phis left,
+   they are appended to it in place of the jump. Phi operands coming from blocks that no longer
+   branch to the phi's block are dropped. */
+void ir_relayout(IrFunction* f, u32 const* phi_head, u32 const* phi_next, u32 const* replace, u8 const* merged){
+	Arena* arena = f->insts.arena;
+	u32 block_count = (u32)f->blocks.len;
+	u32 inst_count = (u32)f->insts.len;
+
+	u32* order = ir_temp(arena, block_count, 0);
+	u32 count = ir_reverse_postorder(f, order);
+	u32* block_map = ir_temp(arena, block_count, IR_NONE);
+	u32 new_count = 0;
+	for(u32 i = 0; i < count; i += 1){
+		u32 b = order[i];
+		/* The predecessor comes first in reverse postorder and is already numbered */
+		block_map[b] = merged != NULL && merged[b] ? block_map[f->preds.v[f->blocks.v[b].pred_start]] : new_count++;
+	}
+
+	u32* value_map = ir_temp(arena, inst_count, IR_NONE);
+	u32 value_count = 0;
+	for(u32 i = 0; i < count; i += 1){
+		if(merged != NULL && merged[order[i]]){ continue; }
+		for(u32 b = order[i]; b != IR_NONE; b = ir_chain_next(f, merged, b)){
+			IrBlock const* blk = &f->blocks.v[b];
+			for(u32 p = phi_head != NULL ? phi_head[b] : IR_NONE; p != IR_NONE; p = phi_next[p]){
+				value_map[p] = value_count++;
+			}
+			u32 end = blk->first + blk->count - (ir_chain_next(f, merged, b) != IR_NONE);
+			for(u32 v = blk->first; v < end; v += 1){
+				if(f->insts.v[v].op != IrOp_Nop){
+					value_map[v] = value_count++;
+				}
+			}
+		}
+	}
+
+	IrInst* insts = arena_make(arena, IrInst, max(value_count, 1u));
+	IrBlock* blocks = arena_make(arena, IrBlock, max(new_count, 1u));
+	ensure(insts != NULL && blocks != NULL, "Failed to allocate IR");
+	typeof(f->operands) operands = { .arena = arena };
+	dyn_reserve(&operands, f->operands.len);
+
+	#define IR_MAP(V) ((V) == IR_NONE ? IR_NONE : value_map[ir_resolve(replace, (V))])
+
+	u32 out = 0;
+	for(u32 i = 0; i < count; i += 1){
+		if(merged != NULL && merged[order[i]]){ continue; }
+		u32 nb = block_map[order[i]];
+		blocks[nb] = (IrBlock){ .first = out, .idom = IR_NONE };
+
+		for(u32 b = order[i]; b != IR_NONE; b = ir_chain_next(f, merged, b)){
+			IrBlock const* blk = &f->blocks.v[b];
+			u32 chain = phi_head != NULL ? phi_head[b] : IR_NONE;
+			u32 end = blk->first + blk->count - (ir_chain_next(f, merged, b) != IR_NONE);
+			u32 v = blk->first;
+			for(;;){
+				u32 src;
+				if(chain != IR_NONE){
+					src = chain;
+					chain = phi_next[chain];
+				}
+				else if(v < end){
+					src = v;
+					v += 1;
+					if(f->insts.v[src].op == IrOp_Nop){ continue; }
+				}
+				else { break; }
+
+				IrInst inst = f->insts.v[src];
+				switch((IrOp)inst.op){
+				case IrOp_Phi: {
+					/* Values first then blocks, only for edges that still exist */
+					u32 n = inst.b;
+					u32 start = (u32)operands.len;
+					u32 kept = 0;
+					for(u32 k = 0; k < n; k += 1){
+						u32 pred = f->operands.v[inst.a + n + k];
+						if(block_map[pred] != IR_NONE && ir_has_successor(f, pred, b)){
+							dyn_push(&operands, IR_MAP(f->operands.v[inst.a + k]));
+							kept += 1;
+						}
+					}
+					for(u32 k = 0; k < n; k += 1){
+						u32 pred = f->operands.v[inst.a + n + k];
+						if(block_map[pred] != IR_NONE && ir_has_successor(f, pred, b)){
+							dyn_push(&operands, block_map[pred]);
+						}
+					}
+					inst.a = start;
+					inst.b = kept;
+				} break;
+
+				case IrOp_Call: {
+					u32 start = (u32)operands.len;
+					for(u32 k = 0; k < inst.c; k += 1){
+						dyn_push(&operands, IR_MAP(f->operands.v[inst.b + k]));
+					}
+					inst.b = start;
+				} break;
+
+				case IrOp_Jump:
+					inst.a = block_map[inst.a];
+					break;
+
+				case IrOp_Branch:
+					inst.a = IR_MAP(inst.a);
+					inst.b = block_map[inst.b];
+					inst.c = block_map[inst.c];
+					break;
+
+				default: {
+					IrUses uses = ir_uses(f, &inst);
+					for(u32 k = 0; k < uses.len; k += 1){
+						uses.v[k] = IR_MAP(uses.v[k]);
+					}
+				} break;
+				}
+				insts[out] = inst;
+				out += 1;
+			}
+		}
+		blocks[nb].count = out - blocks[nb].first;
+	}
+	#undef IR_MAP
+
+	f->insts.v = insts;
+	f->insts.len = f->insts.cap = value_count;
+	f->blocks.v = blocks;
+	f->blocks.len = f->blocks.cap = new_count;
+	f->operands = operands;
+	ir_compute_cfg(f);
+	ir_compute_dominators(f);
+}
+
+void ir_compact(IrFunction* f){
+	ir_relayout(f, NULL, NULL, NULL, NULL);
+}
+
+u32 ir_merge_blocks(IrFunction* f){
+	Arena* arena = f->insts.arena;
+	u32 block_count = (u32)f->blocks.len;
+	u8* merged = arena_make(arena, u8, max(block_count, 1u));
+	u32* replace = ir_temp(arena, (u32)f->insts.len, IR_NONE);
+	ensure(merged != NULL, "Failed to allocate IR scratch");
+
+	u32 count = 0;
+	for(u32 b = 1; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		if(blk->pred_count != 1){ continue; }
+		IrBlock const* pred = &f->blocks.v[f->preds.v[blk->pred_start]];
+		if(pred == blk || pred->count == 0 || f->insts.v[pred->first + pred->count - 1].op != IrOp_Jump){ continue; }
+
+		merged[b] = 1;
+		count += 1;
+		/* One incoming edge, each phi is its only operand. Dead code elimination leaves Nops among
+		   the phis, they do not end the group. */
+		for(u32 v = blk->first; v < blk->first + blk->count; v += 1){
+			IrInst* inst = &f->insts.v[v];
+			if(inst->op == IrOp_Nop){ continue; }
+			if(inst->op != IrOp_Phi){ break; }
+			replace[v] = f->operands.v[inst->a];
+			inst->op = IrOp_Nop;
+		}
+	}
+	if(count > 0){
+		ir_relayout(f, NULL, NULL, replace, merged);
+	}
+	return count;
+}
+
+//// Liveness
+/* Marks `v` live on entry to `block` and to every block between it and the definition of `v`,
+   walking up the predecessors. A block already marked was reached by an earlier walk. */
+static
+void ir_mark_live_in(IrFunction const* f, IrLiveness* live, u32 const* block_of, u32 v, u32 block, u32* stack){
+	u32 word = v / 32;
+	u32 bit = 1u << (v % 32);
+	u32 depth = 0;
+	if(block == block_of[v] || (live->live_in[block * live->words + word] & bit)){ return; }
+	live->live_in[block * live->words + word] |= bit;
+	stack[depth++] = block;
+
+	while(depth > 0){
+		IrBlock const* blk = &f->blocks.v[stack[--depth]];
+		for(u32 p = 0; p < blk->pred_count; p += 1){
+			u32 pred = f->preds.v[blk->pred_start + p];
+			u32* in = &live->live_in[pred * live->words + word];
+			if(pred != block_of[v] && !(*in & bit)){
+				*in |= bit;
+				stack[depth++] = pred;
+			}
+		}
+	}
+}
+
+IrLiveness ir_liveness(IrFunction const* f, Arena* arena){
+	u32 inst_count = (u32)f->insts.len;
+	u32 block_count = (u32)f->blocks.len;
+	IrLiveness live = { .words = max((inst_count + 31) / 32, 1u) };
+	live.live_in = ir_temp(arena, live.words * block_count, 0);
+	live.live_out = ir_temp(arena, live.words * block_count, 0);
+	u32* block_of = ir_temp(arena, inst_count, 0);
+	u32* stack = ir_temp(arena, block_count, 0);
+
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		ensure(blk->count > 0, "Liveness needs a compacted function");
+		for(u32 i = blk->first; i < blk->first + blk->count; i += 1){
+			block_of[i] = b;
+		}
+	}
+
+	/* Every use makes its value live back up to the definition, phis use theirs at the end of
+	   the predecessor */
+	for(u32 i = 0; i < inst_count; i += 1){
+		IrInst* inst = &f->insts.v[i];
+		IrUses uses = ir_uses((IrFunction*)f, inst);
+		for(u32 k = 0; k < uses.len; k += 1){
+			u32 block = inst->op == IrOp_Phi ? f->operands.v[inst->a + inst->b + k] : block_of[i];
+			ir_mark_live_in(f, &live, block_of, uses.v[k], block, stack);
+		}
+	}
+
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		u32* out = &live.live_out[b * live.words];
+		u32 succs[2];
+		u32 succ_count = ir_successors(&f->insts.v[blk->first + blk->count - 1], succs);
+		for(u32 s = 0; s < succ_count; s += 1){
+			IrBlock const* succ = &f->blocks.v[succs[s]];
+			u32 const* in = &live.live_in[succs[s] * live.words];
+			for(u32 w = 0; w < live.words; w += 1){
+				out[w] |= in[w];
+			}
+			for(u32 i = succ->first; i < succ->first + succ->count && f->insts.v[i].op == IrOp_Phi; i += 1){
+				IrInst const* phi = &f->insts.v[i];
+				for(u32 k = 0; k < phi->b; k += 1){
+					if(f->operands.v[phi->a + phi->b + k] == b){
+						u32 v = f->operands.v[phi->a + k];
+						out[v / 32] |= 1u << (v % 32);
+					}
+				}
+			}
+		}
+	}
+	return live;
+}
+
+//// SSA construction
+typedef struct {
+	u32* start; /* Frontier of block `b` is v[start[b] .. start[b + 1]] */
+	u32* v;
+} IrFrontiers;
+
+/* A join block is in the frontier of every block on the way up from each of its predecessors
+   to its immediate dominator. Counted on the first pass, stored on the second. */
+static
+IrFrontiers ir_dominance_frontiers(IrFunction const* f, Arena* arena){
+	u32 block_count = (u32)f->blocks.len;
+	IrBlock const* blocks = f->blocks.v;
+	IrFrontiers df = { .start = ir_temp(arena, block_count + 1, 0) };
+	u32* len = ir_temp(arena, block_count, 0);
+	u32* stamp = ir_temp(arena, block_count, IR_NONE);
+
+	for(int pass = 0; pass < 2; pass += 1){
+		for(u32 j = 0; j < block_count; j += 1){
+			IrBlock const* blk = &blocks[j];
+			if(blk->pred_count < 2 || blk->idom == IR_NONE){ continue; }
+			for(u32 p = 0; p < blk->pred_count; p += 1){
+				u32 runner = f->preds.v[blk->pred_start + p];
+				if(blocks[runner].idom == IR_NONE){ continue; }
+				/* A runner already holding `j` had its dominators walked too */
+				for(; runner != blk->idom && stamp[runner] != j; runner = blocks[runner].idom){
+					stamp[runner] = j;
+					if(pass == 1){
+						df.v[df.start[runner] + len[runner]] = j;
+					}
+					len[runner] += 1;
+				}
+			}
+		}
+
+		if(pass == 0){
+			u32 total = 0;
+			for(u32 x = 0; x < block_count; x += 1){
+				df.start[x] = total;
+				total += len[x];
+				len[x] = 0;
+				stamp[x] = IR_NONE;
+			}
+			df.start[block_count] = total;
+			df.v = ir_temp(arena, total, 0);
+		}
+	}
+	return df;
+}
+
+typedef DynArray(u32) IrIndexList;
+
+static
+void ir_insert_phi(IrFunction* f, u32 block, u32 var, u8 type, u32* phi_head, IrIndexList* phi_next){
+	IrBlock const* blk = &f->blocks.v[block];
+	u32 n = blk->pred_count;
+	u32 start = (u32)f->operands.len;
+	for(u32 k = 0; k < n; k += 1){
+		dyn_push(&f->operands, IR_NONE);
+	}
+	for(u32 k = 0; k < n; k += 1){
+		dyn_push(&f->operands, f->preds.v[blk->pred_start + k]);
+	}
+	u32 offset = f->insts.v[blk->first].offset;
+	dyn_push(&f->insts, ((IrInst){ .op = IrOp_Phi, .type = type, .offset = offset, .a = start, .b = n, .c = var }));
+	dyn_push(phi_next, phi_head[block]);
+	phi_head[block] = (u32)f->insts.len - 1;
+}
+
+/* Stands for reads of `var` on paths that never assign it, kept at the top of the entry block */
+static
+u32 ir_undef(IrFunction* f, u32 var, u8 type, u32* undef, u32* phi_head, IrIndexList* phi_next){
+	if(undef[var] == IR_NONE){
+		dyn_push(&f->insts, ((IrInst){ .op = IrOp_Undef, .type = type }));
+		dyn_push(phi_next, phi_head[0]);
+		undef[var] = (u32)f->insts.len - 1;
+		phi_head[0] = undef[var];
+	}
+	return undef[var];
+}
+
+/* Cytron et al: a variable assigned more than once gets phis on the iterated dominance frontier
+   of the blocks assigning it, then a walk down the dominator tree replaces every read with the
+   definition reaching it. A variable assigned once needs no phi, its definition dominates every
+   read. Phis are left even where the variable is dead, the optimizer drops them. */
+static
+void ir_build_ssa(IrBuilder* b){
+	IrFunction* f = b->fn;
+	Arena* arena = b->arena;
+	u32 block_count = (u32)f->blocks.len;
+	u32 var_count = (u32)b->var_types.len;
+	IrFrontiers df = ir_dominance_frontiers(f, arena);
+
+	/* Blocks assigning each variable, a block is listed once per assignment */
+	u32* def_start = ir_temp(arena, var_count + 1, 0);
+	u32* def_len = ir_temp(arena, var_count, 0);
+	u32* defs = NULL;
+	for(int pass = 0; pass < 2; pass += 1){
+		for(u32 j = 0; j < block_count; j += 1){
+			IrBlock const* blk = &f->blocks.v[j];
+			if(blk->idom == IR_NONE){ continue; }
+			for(u32 v = blk->first; v < blk->first + blk->count; v += 1){
+				if(f->insts.v[v].op != IrOp_SetVar){ continue; }
+				u32 var = f->insts.v[v].a;
+				if(pass == 1){
+					defs[def_start[var] + def_len[var]] = j;
+				}
+				def_len[var] += 1;
+			}
+		}
+		if(pass == 0){
+			u32 total = 0;
+			for(u32 var = 0; var < var_count; var += 1){
+				def_start[var] = total;
+				total += def_len[var];
+				def_len[var] = 0;
+			}
+			def_start[var_count] = total;
+			defs = ir_temp(arena, total, 0);
+		}
+	}
+
+	/* Phis are chained per block until the final layout puts them in front */
+	u32* phi_head = ir_temp(arena, block_count, IR_NONE);
+	IrIndexList phi_next = { .arena = arena };
+	dyn_reserve(&phi_next, f->insts.len);
+	for(isize v = 0; v < f->insts.len; v += 1){
+		dyn_push(&phi_next, IR_NONE);
+	}
+
+	u32* has_phi = ir_temp(arena, block_count, IR_NONE);
+	u32* queued = ir_temp(arena, block_count, IR_NONE);
+	u32* work = ir_temp(arena, block_count, 0);
+	for(u32 var = 0; var < var_count; var += 1){
+		if(def_len[var] < 2){ continue; }
+		u32 work_len = 0;
+		for(u32 d = def_start[var]; d < def_start[var + 1]; d += 1){
+			if(queued[defs[d]] != var){
+				queued[defs[d]] = var;
+				work[work_len++] = defs[d];
+			}
+		}
+		while(work_len > 0){
+			u32 x = work[--work_len];
+			for(u32 k = df.start[x]; k < df.start[x + 1]; k += 1){
+				u32 y = df.v[k];
+				if(has_phi[y] == var){ continue; }
+				has_phi[y] = var;
+				ir_insert_phi(f, y, var, b->var_types.v[var], phi_head, &phi_next);
+				if(queued[y] != var){
+					queued[y] = var;
+					work[work_len++] = y;
+				}
+			}
+		}
+	}
+
+	/* Dominator tree children */
+	u32* child_start = ir_temp(arena, block_count + 1, 0);
+	u32* child_len = ir_temp(arena, block_count, 0);
+	u32* children = ir_temp(arena, block_count, 0);
+	for(u32 j = 1; j < block_count; j += 1){
+		u32 idom = f->blocks.v[j].idom;
+		if(idom != IR_NONE){ child_len[idom] += 1; }
+	}
+	for(u32 j = 0, total = 0; j <= block_count; j += 1){
+		child_start[j] = total;
+		if(j < block_count){
+			total += child_len[j];
+			child_len[j] = 0;
+		}
+	}
+	for(u32 j = 1; j < block_count; j += 1){
+		u32 idom = f->blocks.v[j].idom;
+		if(idom != IR_NONE){
+			children[child_start[idom] + child_len[idom]] = j;
+			child_len[idom] += 1;
+		}
+	}
+
+	/* Renaming: `current` is the reaching definition of each variable, the log restores the
+	   definitions of the enclosing subtree when a block's subtree is done */
+	u32* current = ir_temp(arena, var_count, IR_NONE);
+	u32* undef = ir_temp(arena, var_count, IR_NONE);
+	u32* replace = ir_temp(arena, (u32)f->insts.len + var_count, IR_NONE);
+	u32* log_mark = ir_temp(arena, block_count, 0);
+	IrIndexList log = { .arena = arena };
+	u32* stack = ir_temp(arena, 2 * block_count, 0);
+	u32 depth = 0;
+	stack[depth++] = 0;
+
+	#define IR_REACHING(Var) \
+		(current[Var] != IR_NONE ? current[Var] : ir_undef(f, (Var), b->var_types.v[Var], undef, phi_head, &phi_next))
+	#define IR_DEFINE(Var, Value) \
+		do { u32 var_ = (Var); dyn_push(&log, var_); dyn_push(&log, current[var_]); current[var_] = (Value); } while(0)
+
+	while(depth > 0){
+		u32 top = stack[--depth];
+		u32 j = top >> 1;
+		if(top & 1){
+			while(log.len > log_mark[j]){
+				u32 old = dyn_pop(&log);
+				current[dyn_pop(&log)] = old;
+			}
+			continue;
+		}
+
+		log_mark[j] = (u32)log.len;
+		for(u32 p = phi_head[j]; p != IR_NONE; p = phi_next.v[p]){
+			if(f->insts.v[p].op == IrOp_Phi){
+				IR_DEFINE(f->insts.v[p].c, p);
+			}
+		}
+		IrBlock blk = f->blocks.v[j];
+		for(u32 v = blk.first; v < blk.first + blk.count; v += 1){
+			u32 var = f->insts.v[v].a;
+			if(f->insts.v[v].op == IrOp_GetVar){
+				replace[v] = IR_REACHING(var);
+				f->insts.v[v].op = IrOp_Nop;
+			}
+			else if(f->insts.v[v].op == IrOp_SetVar){
+				IR_DEFINE(var, ir_resolve(replace, f->insts.v[v].b));
+				f->insts.v[v].op = IrOp_Nop;
+			}
+		}
+
+		u32 succ[2];
+		u32 n = blk.count > 0 ? ir_successors(&f->insts.v[blk.first + blk.count - 1], succ) : 0;
+		for(u32 s = 0; s < n; s += 1){
+			for(u32 p = phi_head[succ[s]]; p != IR_NONE; p = phi_next.v[p]){
+				IrInst phi = f->insts.v[p];
+				for(u32 k = 0; k < phi.b; k += 1){
+					if(f->operands.v[phi.a + phi.b + k] == j){
+						f->operands.v[phi.a + k] = IR_REACHING(phi.c);
+						break;
+					}
+				}
+			}
+		}
+
+		stack[depth++] = (j << 1) | 1;
+		for(u32 c = child_start[j]; c < child_start[j + 1]; c += 1){
+			stack[depth++] = children[c] << 1;
+		}
+	}
+	#undef IR_REACHING
+	#undef IR_DEFINE
+
+	ir_relayout(f, phi_head, phi_next.v, replace, NULL);
+}
+
+//// Builder
+IrBuilder ir_builder_create(Checker const* checker, Arena* arena){
+	Ast const* ast = checker->ast;
+	IrBuilder b = {
+		.checker = checker,
+		.filename = checker->filename,
+		.slots = arena_make(arena, u32, max(ast->len, 1u)),
+		.var_types = { .arena = arena },
+		.arena = arena,
+		.max_errors = LEXER_DEFAULT_MAX_ERRORS,
+	};
+	ensure(b.slots != NULL, "Failed to allocate IR builder slots");
+	return b;
+}
+
+void ir_emit_error(IrBuilder* b, IrError type, u32 token, char const* fmt, ...){
+	b->error_count += 1;
+	if(b->error_count > b->max_errors + 1){
+		return;
+	}
+
+	Checker const* c = b->checker;
+	CompilerError* err = arena_make(b->arena, CompilerError, 1);
+	err->stage = CompilerStage_Lower;
+	err->offset = (u64)(c->tokens.v[token].lexeme.v - c->source.v);
+	err->filename = b->filename;
+
+	if(b->error_count > b->max_errors){
+		err->type = IrError_TooManyErrors;
+		err->message = str_format(b->arena, "Too many errors (limit is %d), further errors in this file are not reported", b->max_errors);
+	}
+	else {
+		va_list argp;
+		va_start(argp, fmt);
+		err->type = (u32)type;
+		err->message = str_vformat(b->arena, fmt, argp);
+		va_end(argp);
+	}
+
+	compiler_error_insert(&b->error, &b->error_tail, err);
+}
+
+static
+u32 ir_token(IrBuilder const* b, u32 node){
+	return b->checker->ast->token[node];
+}
+
+static
+String ir_lexeme(IrBuilder const* b, u32 token){
+	return b->checker->tokens.v[token].lexeme;
+}
+
+static
+u32 ir_new_block(IrBuilder* b){
+	dyn_push(&b->fn->blocks, ((IrBlock){ .idom = IR_NONE }));
+	return (u32)b->fn->blocks.len - 1;
+}
+
+/* Blocks are filled one at a time, so each one's instructions end up contiguous */
+static
+void ir_start_block(IrBuilder* b, u32 block){
+	b->fn->blocks.v[block].first = (u32)b->fn->insts.len;
+	b->block = block;
+}
+
+static
+u32 ir_emit(IrBuilder* b, IrOp op, u8 type, u32 x, u32 y, u32 z, u32 node){
+	if(b->block == IR_NONE){
+		/* Code after a terminator goes in a block nothing jumps to, it is dropped with the SSA layout */
+		ir_start_block(b, ir_new_block(b));
+	}
+	Checker const* c = b->checker;
+	u32 offset = (u32)(c->tokens.v[ir_token(b, node)].lexeme.v - c->source.v);
+	IrFunction* f = b->fn;
+	dyn_push(&f->insts, ((IrInst){ .op = op, .type = type, .offset = offset, .a = x, .b = y, .c = z }));
+	f->blocks.v[b->block].count += 1;
+	if(ir_is_terminator(op)){
+		b->block = IR_NONE;
+	}
+	return (u32)f->insts.len - 1;
+}
+
+/* Falls through to `block` unless the current one already ended */
+static
+void ir_jump(IrBuilder* b, u32 block, u32 node){
+	if(b->block != IR_NONE){
+		ir_emit(b, IrOp_Jump, ConstKind_None, block, 0, 0, node);
+	}
+}
+
+static
+u8 ir_value_type(IrBuilder const* b, u32 value){
+	return b->fn->insts.v[value].type;
+}
+
+static
+u32 ir_const(IrBuilder* b, Constant k, u32 node){
+	u64 bits = k.kind == ConstKind_Bool ? (u64)k.value.boolean : (u64)k.value.integer;
+	return ir_emit(b, IrOp_Const, k.kind, (u32)bits, (u32)(bits >> 32), 0, node);
+}
+
+static
+u32 ir_new_var(IrBuilder* b, u8 type){
+	dyn_push(&b->var_types, type);
+	return (u32)b->var_types.len - 1;
+}
+
+/* ConstKind named by a TypeName node, ConstKind_None for AST_NULL or an unknown name */
+static
+u8 ir_declared_type(IrBuilder* b, u32 type_node){
+	if(type_node == AST_NULL){
+		return ConstKind_None;
+	}
+	String name = ir_lexeme(b, ir_token(b, type_node));
+	if(str_equals(name, str_lit("Int"))){ return ConstKind_Int; }
+	if(str_equals(name, str_lit("Real"))){ return ConstKind_Real; }
+	if(str_equals(name, str_lit("Bool"))){ return ConstKind_Bool; }
+	ir_emit_error(b, IrError_Type, ir_token(b, type_node), "Unknown type '%.*s'", str_fmt(name));
+	return ConstKind_None;
+}
+
+static
+u32 ir_symbol_node(IrBuilder const* b, u32 ident){
+	Checker const* c = b->checker;
+	u32 sym = c->resolved[ident];
+	return sym == SYMBOL_NONE ? AST_NULL : c->symbols.v[sym].node;
+}
+
+//// Expressions
+/* Values of expressions that failed to lower are IR_NONE, the error was already reported */
+static
+u32 ir_expr(IrBuilder* b, u32 node);
+
+/* Name of the variable or global declared by `decl` */
+static
+String ir_decl_name(IrBuilder const* b, u32 decl){
+	Ast const* ast = b->checker->ast;
+	u32 token = ast->kind[decl] == AstKind_Let ? ast->token[decl] + 1 : ast->token[decl];
+	return ir_lexeme(b, token);
+}
+
+/* Type of a variable or global, ConstKind_None when it is unknown */
+static
+u8 ir_decl_type(IrBuilder const* b, u32 decl){
+	u32 slot = b->slots[decl];
+	return (slot & IR_GLOBAL_SLOT) ? b->module.global_types[slot & ~IR_GLOBAL_SLOT] : b->var_types.v[slot];
+}
+
+static
+u32 ir_read(IrBuilder* b, u32 decl, u32 node){
+	u8 type = ir_decl_type(b, decl);
+	u32 slot = b->slots[decl];
+	if(slot & IR_GLOBAL_SLOT){
+		if(type == ConstKind_None){
+			String name = ir_decl_name(b, decl);
+			ir_emit_error(b, IrError_Type, ir_token(b, node), "The type of '%.*s' is not known here, declare it with a type", str_fmt(name));
+			return IR_NONE;
+		}
+		return ir_emit(b, IrOp_GetGlobal, type, slot & ~IR_GLOBAL_SLOT, 0, 0, node);
+	}
+	/* Locals without a type were reported at their declaration */
+	return type == ConstKind_None ? IR_NONE : ir_emit(b, IrOp_GetVar, type, slot, 0, 0, node);
+}
+
+static
+void ir_write(IrBuilder* b, u32 decl, u32 value, u32 node){
+	u32 slot = b->slots[decl];
+	if(slot & IR_GLOBAL_SLOT){
+		ir_emit(b, IrOp_SetGlobal, ConstKind_None, slot & ~IR_GLOBAL_SLOT, value, 0, node);
+	}
+	else {
+		ir_emit(b, IrOp_SetVar, ConstKind_None, slot, value, 0, node);
+	}
+}
+
+static
+IrOp ir_binary_op(TokenKind op){
+	switch(op){
+	case TokenKind_Plus: case TokenKind_AssignPlus:     return IrOp_Add;
+	case TokenKind_Minus: case TokenKind_AssignMinus:   return IrOp_Sub;
+	case TokenKind_Star: case TokenKind_AssignStar:     return IrOp_Mul;
+	case TokenKind_Slash: case TokenKind_AssignSlash:   return IrOp_Div;
+	case TokenKind_Modulo: case TokenKind_AssignModulo: return IrOp_Mod;
+	case TokenKind_And: case TokenKind_AssignAnd:       return IrOp_And;
+	case TokenKind_Or: case TokenKind_AssignOr:         return IrOp_Or;
+	case TokenKind_Tilde:      return IrOp_Xor;
+	case TokenKind_ShiftLeft:  return IrOp_Shl;
+	case TokenKind_ShiftRight: return IrOp_Shr;
+	case TokenKind_Equal:      return IrOp_Eq;
+	case TokenKind_NotEqual:   return IrOp_Ne;
+	case TokenKind_Less: case TokenKind_Greater:           return IrOp_Lt;
+	case TokenKind_LessEqual: case TokenKind_GreaterEqual: return IrOp_Le;
+	default: return IrOp__len;
+	}
+}
+
+/* Same operand rules as the interpreter, there are no implicit conversions */
+static
+bool ir_op_accepts(IrOp op, u8 type){
+	switch(op){
+	case IrOp_Add: case IrOp_Sub: case IrOp_Mul: case IrOp_Div: case IrOp_Lt: case IrOp_Le:
+		return type == ConstKind_Int || type == ConstKind_Real;
+	case IrOp_Eq: case IrOp_Ne:
+		return type != ConstKind_None;
+	default:
+		return type == ConstKind_Int;
+	}
+}
+
+/* `lhs op rhs` for arithmetic, bitwise and comparison operators, including compound assignments */
+static
+u32 ir_arith(IrBuilder* b, TokenKind tk, u32 lhs, u32 rhs, u32 node){
+	if(lhs == IR_NONE || rhs == IR_NONE){
+		return IR_NONE;
+	}
+	IrOp op = ir_binary_op(tk);
+	u8 lt = ir_value_type(b, lhs);
+	u8 rt = ir_value_type(b, rhs);
+	ensure(op != IrOp__len, "Unexpected binary operator");
+	if(lt != rt || !ir_op_accepts(op, lt)){
+		String l = ir_type_name(lt);
+		String r = ir_type_name(rt);
+		ir_emit_error(b, IrError_Type, ir_token(b, node), "Invalid operands of types %.*s and %.*s", str_fmt(l), str_fmt(r));
+		return IR_NONE;
+	}
+	if(tk == TokenKind_Greater || tk == TokenKind_GreaterEqual){
+		u32 t = lhs;
+		lhs = rhs;
+		rhs = t;
+	}
+	bool compare = op == IrOp_Eq || op == IrOp_Ne || op == IrOp_Lt || op == IrOp_Le;
+	return ir_emit(b, op, compare ? ConstKind_Bool : lt, lhs, rhs, 0, node);
+}
+
+static
+u32 ir_bool_operand(IrBuilder* b, u32 node, u32 op_node){
+	u32 v = ir_expr(b, node);
+	if(v != IR_NONE && ir_value_type(b, v) != ConstKind_Bool){
+		String op = ir_lexeme(b, ir_token(b, op_node));
+		String type = ir_type_name(ir_value_type(b, v));
+		ir_emit_error(b, IrError_Type, ir_token(b, node), "Operands of '%.*s' must be Bool, found %.*s", str_fmt(op), str_fmt(type));
+		return IR_NONE;
+	}
+	return v;
+}
+
+/* The result is a temporary variable assigned on both paths, SSA construction turns it into a phi */
+static
+u32 ir_logic(IrBuilder* b, u32 node){
+	Ast const* ast = b->checker->ast;
+	bool is_and = b->checker->tokens.v[ir_token(b, node)].kind == TokenKind_LogicAnd;
+	u32 lhs = ir_bool_operand(b, ast->lhs[node], node);
+	if(lhs == IR_NONE){
+		return IR_NONE;
+	}
+	u32 tmp = ir_new_var(b, ConstKind_Bool);
+	ir_emit(b, IrOp_SetVar, ConstKind_None, tmp, lhs, 0, node);
+	u32 rhs_block = ir_new_block(b);
+	u32 join = ir_new_block(b);
+	ir_emit(b, IrOp_Branch, ConstKind_None, lhs, is_and ? rhs_block : join, is_and ? join : rhs_block, node);
+
+	ir_start_block(b, rhs_block);
+	u32 rhs = ir_bool_operand(b, ast->rhs[node], node);
+	if(rhs != IR_NONE){
+		ir_emit(b, IrOp_SetVar, ConstKind_None, tmp, rhs, 0, node);
+	}
+	ir_jump(b, join, node);
+	ir_start_block(b, join);
+	return rhs == IR_NONE ? IR_NONE : ir_emit(b, IrOp_GetVar, ConstKind_Bool, tmp, 0, 0, node);
+}
+
+/* Local or global variable `target` names, AST_NULL if it is something else */
+static
+u32 ir_target_decl(IrBuilder* b, u32 target){
+	Ast const* ast = b->checker->ast;
+	u32 decl = ast->kind[target] == AstKind_Ident ? ir_symbol_node(b, target) : AST_NULL;
+	if(decl == AST_NULL && ast->kind[target] == AstKind_Ident){
+		return AST_NULL; /* Undeclared, reported by the checker */
+	}
+	if(decl == AST_NULL || ast->kind[decl] == AstKind_Fn){
+		ir_emit_error(b, IrError_InvalidTarget, ast->token[target], "Only variables can be assigned to");
+		return AST_NULL;
+	}
+	return decl;
+}
+
+static
+bool ir_check_assign(IrBuilder* b, u32 decl, u32 value, u32 node){
+	u8 type = ir_decl_type(b, decl);
+	if(type == ConstKind_None){
+		return false;
+	}
+	if(ir_value_type(b, value) != type){
+		String name = ir_decl_name(b, decl);
+		String from = ir_type_name(ir_value_type(b, value));
+		String to = ir_type_name(type);
+		ir_emit_error(b, IrError_Type, ir_token(b, node), "Cannot assign %.*s to '%.*s' of type %.*s", str_fmt(from), str_fmt(name), str_fmt(to));
+		return false;
+	}
+	return true;
+}
+
+/* The stored value */
+static
+u32 ir_assign(IrBuilder* b, u32 node){
+	Ast const* ast = b->checker->ast;
+	TokenKind op = b->checker->tokens.v[ast->token[node]].kind;
+	u32 decl = ir_target_decl(b, ast->lhs[node]);
+	if(decl == AST_NULL){
+		return IR_NONE;
+	}
+	if(ir_decl_type(b, decl) == ConstKind_None){
+		/* Reads report the unknown type */
+		ir_read(b, decl, ast->lhs[node]);
+		return IR_NONE;
+	}
+
+	u32 value;
+	if(op == TokenKind_Assign){
+		value = ir_expr(b, ast->rhs[node]);
+	}
+	else {
+		u32 current = ir_read(b, decl, ast->lhs[node]);
+		value = ir_arith(b, op, current, ir_expr(b, ast->rhs[node]), node);
+	}
+	if(value == IR_NONE || !ir_check_assign(b, decl, value, node)){
+		return IR_NONE;
+	}
+	ir_write(b, decl, value, node);
+	return value;
+}
+
+static
+u32 ir_call(IrBuilder* b, u32 node, bool want_value){
+	Ast const* ast = b->checker->ast;
+	u32 callee = ast->lhs[node];
+	u32 args = ast->rhs[node];
+	u32 count = ast->extra[args];
+
+	u32 decl = ast->kind[callee] == AstKind_Ident ? ir_symbol_node(b, callee) : AST_NULL;
+	if(decl == AST_NULL || ast->kind[decl] != AstKind_Fn){
+		if(decl != AST_NULL || ast->kind[callee] != AstKind_Ident){
+			ir_emit_error(b, IrError_NotCallable, ast->token[callee], "Only functions declared with 'fn' can be called");
+		}
+		return IR_NONE;
+	}
+	u32 index = b->slots[decl];
+	IrFunction const* fn = &b->module.functions[index];
+	if(count != fn->param_count){
+		ir_emit_error(b, IrError_ArgumentCount, ast->token[node], "'%.*s' takes %u arguments, %u given", str_fmt(fn->name), fn->param_count, count);
+		return IR_NONE;
+	}
+
+	/* Arguments can contain calls, they are gathered before going to `operands` */
+	u32* values = ir_temp(b->arena, count, 0);
+	bool ok = true;
+	for(u32 i = 0; i < count; i += 1){
+		u32 arg = ast->extra[args + 1 + i];
+		values[i] = ir_expr(b, arg);
+		if(values[i] == IR_NONE){
+			ok = false;
+		}
+		else if(fn->param_types[i] != ConstKind_None && ir_value_type(b, values[i]) != fn->param_types[i]){
+			String want = ir_type_name(fn->param_types[i]);
+			String found = ir_type_name(ir_value_type(b, values[i]));
+			ir_emit_error(b, IrError_Type, ast->token[arg], "Argument %u of '%.*s' must be %.*s, found %.*s",
+				i + 1, str_fmt(fn->name), str_fmt(want), str_fmt(found));
+			ok = false;
+		}
+	}
+	if(!ok){
+		return IR_NONE;
+	}
+
+	u32 start = (u32)b->fn->operands.len;
+	if(count > 0){
+		dyn_append(&b->fn->operands, values, count);
+	}
+	u32 call = ir_emit(b, IrOp_Call, fn->return_type, index, start, count, node);
+	if(want_value && fn->return_type == ConstKind_None){
+		ir_emit_error(b, IrError_Type, ast->token[callee], "'%.*s' does not return a value", str_fmt(fn->name));
+		return IR_NONE;
+	}
+	return call;
+}
+
+static
+u32 ir_expr(IrBuilder* b, u32 node){
+	Checker const* c = b->checker;
+	Ast const* ast = c->ast;
+	if(c->constants[node].kind != ConstKind_None){
+		return ir_const(b, c->constants[node], node);
+	}
+
+	switch((AstKind)ast->kind[node]){
+	case AstKind_Ident: {
+		u32 decl = ir_symbol_node(b, node);
+		if(decl == AST_NULL){
+			return IR_NONE;
+		}
+		if(ast->kind[decl] == AstKind_Fn){
+			ir_emit_error(b, IrError_Unsupported, ast->token[node], "Functions can only be called, not used as values");
+			return IR_NONE;
+		}
+		return ir_read(b, decl, node);
+	}
+
+	case AstKind_Binary: {
+		TokenKind op = c->tokens.v[ast->token[node]].kind;
+		if(op == TokenKind_LogicAnd || op == TokenKind_LogicOr){
+			return ir_logic(b, node);
+		}
+		u32 lhs = ir_expr(b, ast->lhs[node]);
+		u32 rhs = ir_expr(b, ast->rhs[node]);
+		return ir_arith(b, op, lhs, rhs, node);
+	}
+
+	case AstKind_Unary: {
+		u32 operand = ir_expr(b, ast->lhs[node]);
+		if(operand == IR_NONE){
+			return IR_NONE;
+		}
+		u8 type = ir_value_type(b, operand);
+		IrOp op = IrOp_Neg;
+		bool ok = type == ConstKind_Int || type == ConstKind_Real;
+		switch(c->tokens.v[ast->token[node]].kind){
+		case TokenKind_Tilde:    op = IrOp_BitNot; ok = type == ConstKind_Int; break;
+		case TokenKind_LogicNot: op = IrOp_Not; ok = type == ConstKind_Bool; break;
+		default: break;
+		}
+		if(!ok){
+			String name = ir_type_name(type);
+			ir_emit_error(b, IrError_Type, ast->token[node], "Invalid operand of type %.*s", str_fmt(name));
+			return IR_NONE;
+		}
+		return ir_emit(b, op, type, operand, 0, 0, node);
+	}
+
+	case AstKind_Assign:
+		return ir_assign(b, node);
+
+	case AstKind_Call:
+		return ir_call(b, node, true);
+
+	case AstKind_Invalid:
+		return IR_NONE;
+
+	default: {
+		String kind = ast_kind_name(ast->kind[node]);
+		ir_emit_error(b, IrError_Unsupported, ast->token[node], "%.*s expressions cannot be lowered to IR yet", str_fmt(kind));
+		return IR_NONE;
+	}
+	}
+}
+
+//// Statements
+static
+void ir_stmt(IrBuilder* b, u32 node);
+
+static
+u32 ir_condition(IrBuilder* b, u32 node){
+	u32 v = ir_expr(b, node);
+	if(v != IR_NONE && ir_value_type(b, v) != ConstKind_Bool){
+		String type = ir_type_name(ir_value_type(b, v));
+		ir_emit_error(b, IrError_Type, ir_token(b, node), "Condition must be a Bool, found %.*s", str_fmt(type));
+		return IR_NONE;
+	}
+	return v;
+}
+
+/* Declares the variable or global of `let` and stores its initializer */
+static
+void ir_let(IrBuilder* b, u32 node, bool global){
+	Ast const* ast = b->checker->ast;
+	u8 declared = global ? b->module.global_types[b->slots[node] & ~IR_GLOBAL_SLOT] : ir_declared_type(b, ast->lhs[node]);
+	u32 value = ast->rhs[node] != AST_NULL ? ir_expr(b, ast->rhs[node]) : IR_NONE;
+	u8 type = declared != ConstKind_None || value == IR_NONE ? declared : ir_value_type(b, value);
+
+	if(global){
+		b->module.global_types[b->slots[node] & ~IR_GLOBAL_SLOT] = type;
+	}
+	else {
+		b->slots[node] = ir_new_var(b, type);
+	}
+
+	if(ast->rhs[node] == AST_NULL){
+		if(ast->lhs[node] == AST_NULL){
+			String name = ir_decl_name(b, node);
+			ir_emit_error(b, IrError_Type, ast->token[node] + 1, "'%.*s' needs a type or an initializer", str_fmt(name));
+		}
+		else if(!global && type != ConstKind_None){
+			/* Globals start zeroed, locals are zeroed here */
+			ir_write(b, node, ir_const(b, (Constant){ .kind = type }, node), node);
+		}
+	}
+	else if(value != IR_NONE && ir_check_assign(b, node, value, node)){
+		ir_write(b, node, value, node);
+	}
+}
+
+static
+void ir_if(IrBuilder* b, u32 node){
+	Ast const* ast = b->checker->ast;
+	u32 then_branch = ast->extra[ast->rhs[node]];
+	u32 else_branch = ast->extra[ast->rhs[node] + 1];
+
+	u32 cond = ir_condition(b, ast->lhs[node]);
+	u32 then_block = ir_new_block(b);
+	u32 join = ir_new_block(b);
+	u32 else_block = else_branch != AST_NULL ? ir_new_block(b) : join;
+	ir_emit(b, IrOp_Branch, ConstKind_None, cond, then_block, else_block, node);
+
+	ir_start_block(b, then_block);
+	ir_stmt(b, then_branch);
+	ir_jump(b, join, node);
+	if(else_branch != AST_NULL){
+		ir_start_block(b, else_block);
+		ir_stmt(b, else_branch);
+		ir_jump(b, join, node);
+	}
+	ir_start_block(b, join);
+}
+
+static
+void ir_for(IrBuilder* b, u32 node){
+	Ast const* ast = b->checker->ast;
+	IrLoop loop = {
+		.header = ir_new_block(b),
+		.exit = ir_new_block(b),
+		.outer = b->loop,
+	};
+	u32 body = ir_new_block(b);
+	ir_jump(b, loop.header, node);
+
+	ir_start_block(b, loop.header);
+	if(ast->lhs[node] != AST_NULL){
+		u32 cond = ir_condition(b, ast->lhs[node]);
+		ir_emit(b, IrOp_Branch, ConstKind_None, cond, body, loop.exit, node);
+	}
+	else {
+		ir_jump(b, body, node);
+	}
+
+	b->loop = &loop;
+	ir_start_block(b, body);
+	ir_stmt(b, ast->rhs[node]);
+	ir_jump(b, loop.header, node);
+	b->loop = loop.outer;
+	ir_start_block(b, loop.exit);
+}
+
+static
+void ir_return(IrBuilder* b, u32 node){
+	Ast const* ast = b->checker->ast;
+	IrFunction const* f = b->fn;
+	if(ast->lhs[node] == AST_NULL){
+		if(f->return_type != ConstKind_None){
+			String type = ir_type_name(f->return_type);
+			ir_emit_error(b, IrError_Type, ast->token[node], "'%.*s' must return %.*s", str_fmt(f->name), str_fmt(type));
+		}
+		ir_emit(b, IrOp_Return, ConstKind_None, IR_NONE, 0, 0, node);
+		return;
+	}
+
+	u32 value = ir_expr(b, ast->lhs[node]);
+	if(value != IR_NONE && ir_value_type(b, value) != f->return_type){
+		String name = f->name;
+		String found = ir_type_name(ir_value_type(b, value));
+		if(f->return_type == ConstKind_None){
+			ir_emit_error(b, IrError_Type, ast->token[node], "'%.*s' does not return a value, found %.*s", str_fmt(name), str_fmt(found));
+		}
+		else {
+			String want = ir_type_name(f->return_type);
+			ir_emit_error(b, IrError_Type, ast->token[node], "'%.*s' must return %.*s, found %.*s", str_fmt(name), str_fmt(want), str_fmt(found));
+		}
+		value = IR_NONE;
+	}
+	ir_emit(b, IrOp_Return, ConstKind_None, value, 0, 0, node);
+}
+
+static
+void ir_stmt(IrBuilder* b, u32 node){
+	Ast const* ast = b->checker->ast;
+	u32 lhs = ast->lhs[node];
+
+	switch((AstKind)ast->kind[node]){
+	case AstKind_Block:
+		for(u32 i = 0; i < ast->rhs[node]; i += 1){
+			ir_stmt(b, ast->extra[lhs + i]);
+		}
+		break;
+
+	case AstKind_Let:    ir_let(b, node, false); break;
+	case AstKind_Return: ir_return(b, node); break;
+	case AstKind_If:     ir_if(b, node); break;
+	case AstKind_For:    ir_for(b, node); break;
+
+	case AstKind_Break: case AstKind_Continue: {
+		IrLoop* loop = b->loop;
+		bool is_break = ast->kind[node] == AstKind_Break;
+		if(loop == NULL){
+			ir_emit_error(b, IrError_InvalidTarget, ast->token[node], "'%s' outside of a loop", is_break ? "break" : "continue");
+			break;
+		}
+		ir_emit(b, IrOp_Jump, ConstKind_None, is_break ? loop->exit : loop->header, 0, 0, node);
+	} break;
+
+	case AstKind_ExprStmt:
+		if(ast->kind[lhs] == AstKind_Call){
+			ir_call(b, lhs, false);
+		}
+		else {
+			ir_expr(b, lhs);
+		}
+		break;
+
+	case AstKind_DeferredBody:
+		ir_emit_error(b, IrError_Unsupported, ast->token[node], "Function body was not parsed");
+		break;
+
+	default:
+		break;
+	}
+}
+
+static
+void ir_begin_function(IrBuilder* b, IrFunction* f){
+	f->insts = (typeof(f->insts)){ .arena = b->arena };
+	f->blocks = (typeof(f->blocks)){ .arena = b->arena };
+	f->operands = (typeof(f->operands)){ .arena = b->arena };
+	f->preds = (typeof(f->preds)){ .arena = b->arena };
+	b->fn = f;
+	b->var_types.len = 0;
+	b->loop = NULL;
+	ir_start_block(b, ir_new_block(b));
+}
+
+/* Returns from the end of the body and converts the function to SSA */
+static
+void ir_end_function(IrBuilder* b, u32 node){
+	IrFunction* f = b->fn;
+	u32 end = b->block;
+	if(end != IR_NONE){
+		ir_emit(b, IrOp_Return, ConstKind_None, IR_NONE, 0, 0, node);
+	}
+	ir_compute_cfg(f);
+	ir_compute_dominators(f);
+
+	/* Only a reachable end counts, a body ending in an endless loop never gets there */
+	if(f->return_type != ConstKind_None && end != IR_NONE && f->blocks.v[end].idom != IR_NONE){
+		ir_emit_error(b, IrError_MissingReturn, ir_token(b, node), "'%.*s' can reach its end without returning a value", str_fmt(f->name));
+	}
+	ir_build_ssa(b);
+	b->block = IR_NONE;
+}
+
+IrModule ir_build_file(IrBuilder* b, u32 file){
+	Checker const* c = b->checker;
+	Ast const* ast = c->ast;
+	u32 decls = ast->lhs[file];
+	u32 count = ast->rhs[file];
+
+	/* Functions and globals are numbered and typed first so calls and reads can refer to later ones */
+	IrModule* m = &b->module;
+	u32 fn_count = 0;
+	u32 global_count = 0;
+	for(u32 i = 0; i < count; i += 1){
+		u32 decl = ast->extra[decls + i];
+		if(ast->kind[decl] == AstKind_Fn){ b->slots[decl] = fn_count++; }
+		if(ast->kind[decl] == AstKind_Let){ b->slots[decl] = IR_GLOBAL_SLOT | global_count++; }
+	}
+	*m = (IrModule){
+		.functions = arena_make(b->arena, IrFunction, fn_count + 1),
+		.function_count = fn_count + 1,
+		.global_names = arena_make(b->arena, String, max(global_count, 1u)),
+		.global_types = arena_make(b->arena, u8, max(global_count, 1u)),
+		.global_count = global_count,
+		.init = fn_count,
+		.main = IR_NONE,
+	};
+	ensure(m->functions && m->global_names && m->global_types, "Failed to allocate IR module");
+
+	for(u32 i = 0; i < count; i += 1){
+		u32 decl = ast->extra[decls + i];
+		if(ast->kind[decl] == AstKind_Let){
+			u32 g = b->slots[decl] & ~IR_GLOBAL_SLOT;
+			m->global_names[g] = ir_decl_name(b, decl);
+			m->global_types[g] = ir_declared_type(b, ast->lhs[decl]);
+		}
+		if(ast->kind[decl] != AstKind_Fn){ continue; }
+
+		u32 proto = ast->lhs[decl];
+		IrFunction* f = &m->functions[b->slots[decl]];
+		f->name = ir_lexeme(b, ast->token[proto]);
+		f->param_count = ast->rhs[proto];
+		f->param_types = arena_make(b->arena, u8, max(f->param_count, 1u));
+		ensure(f->param_types != NULL, "Failed to allocate IR function");
+		for(u32 p = 0; p < f->param_count; p += 1){
+			f->param_types[p] = ir_declared_type(b, ast->lhs[ast->extra[ast->lhs[proto] + p]]);
+		}
+		f->return_type = ir_declared_type(b, ast->extra[ast->lhs[proto] + f->param_count]);
+		if(str_equals(f->name, str_lit("main"))){
+			m->main = b->slots[decl];
+		}
+	}
+
+	/* Initializers go first: globals declared without a type get it from their initializer */
+	IrFunction* init = &m->functions[m->init];
+	init->name = str_lit("<init>");
+	ir_begin_function(b, init);
+	for(u32 i = 0; i < count; i += 1){
+		u32 let = ast->extra[decls + i];
+		if(ast->kind[let] == AstKind_Let){
+			ir_let(b, let, true);
+		}
+	}
+	ir_end_function(b, file);
+
+	for(u32 i = 0; i < count; i += 1){
+		u32 fn = ast->extra[decls + i];
+		if(ast->kind[fn] != AstKind_Fn){ continue; }
+
+		IrFunction* f = &m->functions[b->slots[fn]];
+		u32 proto = ast->lhs[fn];
+		ir_begin_function(b, f);
+		for(u32 p = 0; p < f->param_count; p += 1){
+			u32 param = ast->extra[ast->lhs[proto] + p];
+			b->slots[param] = ir_new_var(b, f->param_types[p]);
+			if(f->param_types[p] == ConstKind_None){
+				if(ast->lhs[param] == AST_NULL){
+					String name = ir_lexeme(b, ast->token[param]);
+					ir_emit_error(b, IrError_Type, ast->token[param], "Parameter '%.*s' needs a type", str_fmt(name));
+				}
+				continue;
+			}
+			u32 value = ir_emit(b, IrOp_Param, f->param_types[p], p, 0, 0, param);
+			ir_write(b, param, value, param);
+		}
+		ir_stmt(b, ast->rhs[fn]);
+		ir_end_function(b, proto);
+	}
+	return *m;
+}
+
+//// Listing
+static
+String ir_op_name(IrOp op){
+	switch(op){
+	#define X(Name) case IrOp_##Name: return str_lit(#Name);
+	IR_OPS
+	#undef X
+	case IrOp__len: break;
+	}
+	return str_lit("<INVALID OP>");
+}
+
+static
+String ir_dump_function(IrModule const* m, IrFunction const* f, Arena* arena){
+	String params = str_lit("");
+	for(u32 p = 0; p < f->param_count; p += 1){
+		String type = ir_type_name(f->param_types[p]);
+		params = str_format(arena, "%.*s%s%.*s", str_fmt(params), p > 0 ? ", " : "", str_fmt(type));
+	}
+	String out = str_format(arena, "fn %.*s(%.*s)", str_fmt(f->name), str_fmt(params));
+	if(f->return_type != ConstKind_None){
+		String type = ir_type_name(f->return_type);
+		out = str_format(arena, "%.*s -> %.*s", str_fmt(out), str_fmt(type));
+	}
+	out = str_format(arena, "%.*s\n", str_fmt(out));
+
+	for(u32 j = 0; j < f->blocks.len; j += 1){
+		IrBlock const* blk = &f->blocks.v[j];
+		out = str_format(arena, "%.*sb%u", str_fmt(out), j);
+		for(u32 p = 0; p < blk->pred_count; p += 1){
+			out = str_format(arena, "%.*s%s b%u", str_fmt(out), p == 0 ? " <-" : "", f->preds.v[blk->pred_start + p]);
+		}
+		out = str_format(arena, "%.*s:\n", str_fmt(out));
+
+		for(u32 v = blk->first; v < blk->first + blk->count; v += 1){
+			IrInst const* inst = &f->insts.v[v];
+			String name = ir_op_name(inst->op);
+			String operands = str_lit("");
+			switch((IrOp)inst->op){
+			case IrOp_Const:
+				operands = bytecode_format_value(ir_const_value(inst), arena);
+				break;
+			case IrOp_Param:
+				operands = str_format(arena, "%u", inst->a);
+				break;
+			case IrOp_GetGlobal:
+				operands = m->global_names[inst->a];
+				break;
+			case IrOp_SetGlobal:
+				operands = str_format(arena, "%.*s v%u", str_fmt(m->global_names[inst->a]), inst->b);
+				break;
+			case IrOp_Phi:
+				for(u32 k = 0; k < inst->b; k += 1){
+					operands = str_format(arena, "%.*s%s[b%u v%u]", str_fmt(operands), k > 0 ? " " : "",
+						f->operands.v[inst->a + inst->b + k], f->operands.v[inst->a + k]);
+				}
+				break;
+			case IrOp_Call:
+				operands = m->functions[inst->a].name;
+				for(u32 k = 0; k < inst->c; k += 1){
+					operands = str_format(arena, "%.*s v%u", str_fmt(operands), f->operands.v[inst->b + k]);
+				}
+				break;
+			case IrOp_Jump:
+				operands = str_format(arena, "b%u", inst->a);
+				break;
+			case IrOp_Branch:
+				operands = str_format(arena, "v%u b%u b%u", inst->a, inst->b, inst->c);
+				break;
+			case IrOp_Return:
+				if(inst->a != IR_NONE){ operands = str_format(arena, "v%u", inst->a); }
+				break;
+			default: {
+				IrUses uses = ir_uses((IrFunction*)f, (IrInst*)inst);
+				for(u32 k = 0; k < uses.len; k += 1){
+					operands = str_format(arena, "%.*s%sv%u", str_fmt(operands), k > 0 ? " " : "", uses.v[k]);
+				}
+			} break;
+			}
+
+			if(inst->type != ConstKind_None){
+				String type = ir_type_name(inst->type);
+				out = str_format(arena, "%.*s  v%u %.*s = %.*s %.*s\n", str_fmt(out), v, str_fmt(type), str_fmt(name), str_fmt(operands));
+			}
+			else {
+				out = str_format(arena, "%.*s  %.*s %.*s\n", str_fmt(out), str_fmt(name), str_fmt(operands));
+			}
+		}
+	}
+	return out;
+}
+
+String ir_dump(IrModule const* m, Arena* arena){
+	String out = str_lit("");
+	for(u32 i = 0; i < m->function_count; i += 1){
+		String fn = ir_dump_function(m, &m->functions[i], arena);
+		out = str_format(arena, "%.*s%.*s", str_fmt(out), str_fmt(fn));
+	}
+	return out;
+}
@@ -3,6 +3,12 @@
 #include "base/types.h"
 #include "base/memory.h"
 #include "base/string.h"
+#include "base/file.h"
+#include "base/array.h"
+
+#include <stdio.h>
+
+#define KIELO_VERSION "0.1.0"
 
 #ifdef TERM_NO_COLOR
 #define TERM_COLOR_RED   ""
@@ -19,7 +25,9 @@ typedef enum {
 	CompilerStage_Lex,
 	CompilerStage_Parse,
 	CompilerStage_Check,
+	CompilerStage_Lower,
 	CompilerStage_Emmit,
+	CompilerStage_Run,
 
 	CompilerStage__len,
 } CompilerStage;
@@ -35,6 +43,11 @@ struct CompilerError {
 	CompilerError* next;
 };
 
+// Inserts `err` keeping the list ordered by offset, O(1) when errors arrive in order
+void compiler_error_insert(CompilerError** head, CompilerError** tail, CompilerError* err);
+
+void print_compiler_error(FILE* out, CompilerError const* err);
+
 //// Lexer
 #define SPECIAL_TOKENS \
 	X(Unknown, "<Unknown>") \
@@ -113,28 +126,67 @@ typedef enum {
 	TokenKind__len,
 } TokenKind;
 
+// Binary operator precedence, higher binds tighter. Assignment is the only right associative level.
+#define PREC_ASSIGN 1
 
-static struct { String lexeme; TokenKind kind; } keyword_lexemes[] = {
-	#define X(Name, Str) { str_lit(Str), TokenKind_##Name },
-	KEYWORD_TOKENS
-	#undef X
+#define BINARY_OPERATORS \
+	X(Assign, PREC_ASSIGN) \
+	X(AssignPlus, PREC_ASSIGN) \
+	X(AssignMinus, PREC_ASSIGN) \
+	X(AssignStar, PREC_ASSIGN) \
+	X(AssignSlash, PREC_ASSIGN) \
+	X(AssignModulo, PREC_ASSIGN) \
+	X(AssignAnd, PREC_ASSIGN) \
+	X(AssignOr, PREC_ASSIGN) \
+	X(LogicOr, 2) \
+	X(LogicAnd, 3) \
+	X(Equal, 4) \
+	X(NotEqual, 4) \
+	X(Greater, 4) \
+	X(Less, 4) \
+	X(GreaterEqual, 4) \
+	X(LessEqual, 4) \
+	X(Plus, 5) \
+	X(Minus, 5) \
+	X(Or, 5) \
+	X(Tilde, 5) \
+	X(Star, 6) \
+	X(Slash, 6) \
+	X(Modulo, 6) \
+	X(And, 6) \
+	X(ShiftLeft, 6) \
+	X(ShiftRight, 6) \
+
+enum {
+	TokenFlag_Keyword    = 1 << 0,
+	TokenFlag_Binary     = 1 << 1,
+	TokenFlag_Assignment = 1 << 2,
 };
 
-// #undef SPECIAL_TOKENS
-// #undef KEYWORD_TOKENS
-// #undef DELIMITER_TOKENS
-// #undef ALL_TOKENS
+/* Generated from the token X-macros in tokens.c, indexed by TokenKind */
+extern const String token_names[TokenKind__len];
+extern const u8 token_lexeme_len[TokenKind__len]; /* Zero when the lexeme varies */
+extern const u8 token_precedence[TokenKind__len]; /* Zero when not a binary operator */
+extern const u8 token_flags[TokenKind__len];
 
 String token_kind_name(TokenKind k);
 
+// Keyword kind of an identifier lexeme, TokenKind_Identifier if it is not a keyword
+TokenKind token_keyword_kind(String lexeme);
+
 typedef enum {
 	LexerError_None = 0,
 	LexerError_UnknownCodepoint,
 	LexerError_InvalidNumber,
 	LexerError_UnclosedString,
 	LexerError_InvalidBase,
+	LexerError_InvalidEncoding,
+	LexerError_InvalidEscape,
+	LexerError_TooManyErrors,
 } LexerError;
 
+#define LEXER_DEFAULT_MAX_ERRORS 100
+
 typedef struct {
 	String lexeme;
 	u32 kind;
@@ -142,9 +194,11 @@ typedef struct {
 		i64 integer;
 		f64 real;
 		rune codepoint;
+		bool escaped; /* String literal contains escape sequences */
 	} value;
 } Token;
 
+// Always terminated by an EndOfFile token
 typedef struct {
 	Token* v;
 	isize len;
@@ -154,9 +208,13 @@ typedef struct {
 	String source;
 	String filename;
 	isize current;
+	bool validated; /* Source passed `utf8_validate`, runes are decoded without checks */
 
 	Arena* error_arena;
-	CompilerError* error;
+	CompilerError* error; /* Ordered by offset */
+	CompilerError* error_tail;
+	i32 error_count; /* Includes errors past `max_errors` that were not reported */
+	i32 max_errors;
 } Lexer;
 
 Lexer lexer_create(String source, Arena* error_arena);
@@ -164,6 +222,9 @@ Lexer lexer_create(String source, Arena* error_arena);
 str_attribute_format(3,4)
 void lexer_emit_error(Lexer* lex, LexerError type, char const* fmt, ...);
 
+str_attribute_format(4,5)
+void lexer_emit_error_at(Lexer* lex, isize offset, LexerError type, char const* fmt, ...);
+
 UTF8Decoded lexer_advance(Lexer* lex);
 
 bool lexer_match_advance(Lexer* l, rune match);
@@ -182,7 +243,933 @@ Token lexer_consume_decimal(Lexer* lex);
 
 Token lexer_consume_number(Lexer* lex);
 
+Token lexer_consume_string(Lexer* lex);
+
+// Contents of a string literal. Without escapes this is a slice of the source, otherwise
+// the unescaped text is materialized in `arena`.
+String token_string_value(Token token, Arena* arena);
+
 Token lexer_next_token(Lexer* lex);
 
+// Lexes the whole source, dropping whitespace and comments
+TokenArray lexer_tokenize(Lexer* lex, Arena* arena);
+
+/* Compact token, a quarter of the size of Token. The lexeme is recovered through the source
+   and literal values are kept out of line. */
+typedef struct {
+	u32 offset;
+	u32 len  : 24; /* PACKED_TOKEN_LONG when the real length is in the literal table */
+	u32 kind : 8;
+} PackedToken;
+
+static_assert(sizeof(PackedToken) == 8, "PackedToken must stay 8 bytes");
+static_assert(TokenKind__len <= 256, "TokenKind does not fit PackedToken");
+
+#define PACKED_TOKEN_LONG 0xffffffu
+
+typedef struct {
+	u32 token; /* Index of the token, the table is sorted by it */
+	u32 len;   /* Lexeme length of long tokens */
+	union {
+		i64 integer;
+		f64 real;
+		rune codepoint;
+		bool escaped;
+	} value;
+} PackedLiteral;
+
+// Always terminated by an EndOfFile token
+typedef struct {
+	PackedToken* v;
+	u32 len;
+	PackedLiteral* literals; /* Integer, Real and String tokens, and tokens longer than PACKED_TOKEN_LONG */
+	u32 literal_len;
+	String source;
+} PackedTokenArray;
+
+// Same as `lexer_tokenize`, the source must be smaller than 4GiB
+PackedTokenArray lexer_tokenize_packed(Lexer* lex, Arena* arena);
+
+PackedTokenArray token_pack(TokenArray tokens, String source, Arena* arena);
+
+String packed_token_lexeme(PackedTokenArray const* tokens, u32 index);
+
+Token packed_token_unpack(PackedTokenArray const* tokens, u32 index);
+
+TokenArray token_unpack(PackedTokenArray const* tokens, Arena* arena);
+
 //// Parser
+/* What the lhs/rhs fields of each kind hold, used to relocate nodes between ASTs */
+typedef enum {
+	AstField_None = 0,
+	AstField_Node,
+	AstField_Extra, /* Index into `extra` */
+	AstField_Count,
+	AstField_Token,
+} AstField;
+
+/* Node layouts, `extra` is a shared array of u32 used for child lists:
+   File      | -          | lhs: extra start  | rhs: count (declarations)
+   Fn        | `fn`       | lhs: FnProto      | rhs: Block
+   FnProto   | name       | lhs: extra start  | rhs: param count, return type at extra[lhs + rhs]
+   Param     | name       | lhs: type         | -
+   TypeName  | identifier | -                 | -
+   Block     | `{`        | lhs: extra start  | rhs: count (statements)
+   DeferredBody | `{`      | lhs: token of the matching `}`, a body that was skipped
+   Let       | `let`      | lhs: type         | rhs: initializer, the name is the token after `let`
+   Return    | `return`   | lhs: value        | -
+   If        | `if`       | lhs: condition    | rhs: extra start of [then, else]
+   For       | `for`      | lhs: condition    | rhs: Block
+   ExprStmt  | `;`        | lhs: expression   | -
+   Assign    | operator   | lhs: target       | rhs: value
+   Binary    | operator   | lhs: left         | rhs: right
+   Unary     | operator   | lhs: operand      | -
+   Call      | `(`        | lhs: callee       | rhs: extra start of [count, args...]
+   Index     | `[`        | lhs: base         | rhs: index
+   Member    | field name | lhs: base         | -
+   Ident, Integer, Real, String: the token only
+   Optional children are AST_NULL. */
+#define AST_KINDS \
+	X(Invalid, None, None) \
+	X(File, Extra, Count) \
+	X(Fn, Node, Node) \
+	X(FnProto, Extra, Count) \
+	X(Param, Node, None) \
+	X(TypeName, None, None) \
+	X(Block, Extra, Count) \
+	X(DeferredBody, Token, None) \
+	X(Let, Node, Node) \
+	X(Return, Node, None) \
+	X(If, Node, Extra) \
+	X(For, Node, Node) \
+	X(Break, None, None) \
+	X(Continue, None, None) \
+	X(ExprStmt, Node, None) \
+	X(Assign, Node, Node) \
+	X(Binary, Node, Node) \
+	X(Unary, Node, None) \
+	X(Call, Node, Extra) \
+	X(Index, Node, Node) \
+	X(Member, Node, None) \
+	X(Ident, None, None) \
+	X(Integer, None, None) \
+	X(Real, None, None) \
+	X(String, None, None) \
+
+typedef enum {
+	#define X(Name, Lhs, Rhs) AstKind_##Name,
+	AST_KINDS
+	#undef X
+	AstKind__len,
+} AstKind;
+
+String ast_kind_name(AstKind k);
+
+/* Node 0 is reserved so that index 0 can mean "no node" */
+#define AST_NULL ((u32)0)
+
+// Nodes are stored as parallel arrays indexed by node, all owned by one arena
+typedef struct {
+	u8*  kind;
+	u32* token;
+	u32* lhs;
+	u32* rhs;
+	u32 len;
+	u32 cap;
+
+	u32* extra;
+	u32 extra_len;
+	u32 extra_cap;
+
+	Arena* arena;
+} Ast;
+
+Ast ast_create(Arena* arena, u32 node_capacity);
+
+u32 ast_add_node(Ast* ast, AstKind kind, u32 token, u32 lhs, u32 rhs);
+
+// Appends `count` values to `extra`, returns the index of the first one
+u32 ast_add_extra(Ast* ast, u32 const* values, u32 count);
+
+// Copies every node of `src` but AST_NULL to the end of `dst`, node `n` of `src` becomes
+// `n + delta` where delta is the return value. Both must index the same token array.
+u32 ast_append(Ast* dst, Ast const* src);
+
+// S-expression rendering for tests and debugging
+String ast_dump(Ast const* ast, TokenArray tokens, u32 node, Arena* arena);
+
+typedef enum {
+	ParserError_None = 0,
+	ParserError_UnexpectedToken,
+	ParserError_ExpectedExpression,
+	ParserError_TooManyErrors,
+} ParserError;
+
+typedef struct {
+	TokenArray tokens;
+	String source;
+	String filename;
+	u32 current;
+
+	Ast ast;
+
+	/* Children of nodes still being parsed, moved to `ast.extra` once complete */
+	u32* stack;
+	u32 stack_len;
+	u32 stack_cap;
+
+	bool panicking; /* Errors are suppressed until the parser resynchronizes */
+	bool defer_bodies; /* `fn` bodies become DeferredBody nodes instead of being parsed */
+	Arena* error_arena;
+	CompilerError* error; /* Ordered by offset */
+	CompilerError* error_tail;
+	i32 error_count;
+	i32 max_errors;
+} Parser;
+
+Parser parser_create(String source, TokenArray tokens, Arena* arena, Arena* error_arena);
+
+str_attribute_format(3,4)
+void parser_emit_error(Parser* p, ParserError type, char const* fmt, ...);
+
+u32 parser_parse_file(Parser* p);
+
+u32 parser_parse_fn(Parser* p);
+
+// Body of function `fn`. Files parsed with `defer_bodies` only record the token range of each
+// body, it is parsed the first time it is asked for and the Fn node then points to it.
+u32 parser_fn_body(Parser* p, u32 fn);
+
+u32 parser_parse_block(Parser* p);
+
+u32 parser_parse_statement(Parser* p);
+
+u32 parser_parse_expression(Parser* p, i32 min_precedence);
+
+// Token indices of a top-level function and its body braces
+typedef struct {
+	u32 fn;
+	u32 body_begin;
+	u32 body_end;
+} FnSpan;
+
+typedef struct {
+	FnSpan* v;
+	u32 len;
+} FnSpanArray;
+
+// Finds the bodies of top-level functions by matching braces, without parsing anything
+FnSpanArray parser_skim(TokenArray tokens, Arena* arena);
+
+// Same result as `parser_parse_file`, but function bodies are parsed on up to `thread_count`
+// worker threads, each with its own arena, and merged afterwards. Only worth it for large files.
+u32 parser_parse_file_parallel(Parser* p, i32 thread_count);
+
+//// Checker
+/* Identifiers are interned once so the rest of the checker compares and hashes u32 ids */
+typedef struct {
+	String* names;  /* Indexed by id, not copied: they must outlive the table */
+	u32* hashes;    /* Indexed by id */
+	u32 len;
+	u32 cap;
+
+	u32* slots;     /* Open addressing, id + 1 or 0 when empty */
+	u32 slot_mask;
+
+	Arena* arena;
+} InternTable;
+
+InternTable intern_create(Arena* arena, u32 capacity);
+
+u32 intern(InternTable* t, String name);
+
+String intern_name(InternTable const* t, u32 id);
+
+typedef enum {
+	SymbolKind_Fn,
+	SymbolKind_Let,
+	SymbolKind_Param,
+} SymbolKind;
+
+typedef struct {
+	u32 name; /* Interned */
+	u32 node; /* Declaring Fn, Let or Param */
+	u8 kind;
+} Symbol;
+
+#define SYMBOL_NONE ((u32)0xffffffff)
+
+/* Names declared in one block, an open-addressed map from interned name to symbol */
+typedef struct {
+	u32* keys;   /* Name + 1, 0 when empty */
+	u32* values; /* Symbol index */
+	u32 mask;
+	u32 len;
+	ArenaRegion region; /* Releases the map and its growth when the scope closes */
+} Scope;
+
+typedef struct {
+	Symbol* v; /* Every symbol ever declared, outlives the scopes */
+	u32 len;
+	u32 cap;
+
+	Scope* scopes;
+	u32 depth;
+	u32 scope_cap;
+
+	Arena* arena;       /* Symbols and the scope stack */
+	Arena* scope_arena; /* Scope maps only, must not be shared with anything else */
+} SymbolTable;
+
+SymbolTable symbol_table_create(Arena* arena, Arena* scope_arena, u32 symbol_capacity);
+
+void symbol_scope_push(SymbolTable* t);
+
+void symbol_scope_pop(SymbolTable* t);
+
+// Declares `sym` in the innermost scope and returns its index. Returns SYMBOL_NONE and leaves
+// the earlier declaration in `*existing` if the name is already declared in that scope.
+u32 symbol_declare(SymbolTable* t, Symbol sym, u32* existing);
+
+// Innermost symbol visible under `name`, SYMBOL_NONE if there is none
+u32 symbol_lookup(SymbolTable const* t, u32 name);
+
+typedef enum {
+	ConstKind_None = 0,
+	ConstKind_Int,
+	ConstKind_Real,
+	ConstKind_Bool,
+} ConstKind;
+
+typedef struct {
+	u8 kind;
+	union {
+		i64 integer;
+		f64 real;
+		bool boolean;
+	} value;
+} Constant;
+
+typedef enum {
+	ConstFold_Ok = 0,
+	ConstFold_NotConstant, /* Operand kinds the operator does not fold, left for the type checker */
+	ConstFold_Overflow,
+	ConstFold_DivisionByZero,
+	ConstFold_ShiftRange,
+} ConstFoldResult;
+
+// Integers are 64 bit two's complement: arithmetic that does not fit is an error rather than
+// wrapping, shifts take amounts from 0 to 63 and drop the bits shifted out. Reals follow IEEE 754.
+// Comparisons produce Bool constants.
+ConstFoldResult const_fold_binary(TokenKind op, Constant lhs, Constant rhs, Constant* out);
+
+ConstFoldResult const_fold_unary(TokenKind op, Constant operand, Constant* out);
+
+typedef enum {
+	CheckerError_None = 0,
+	CheckerError_Undeclared,
+	CheckerError_Redeclared,
+	CheckerError_ConstantOverflow,
+	CheckerError_DivisionByZero,
+	CheckerError_ShiftRange,
+	CheckerError_TooManyErrors,
+} CheckerError;
+
+typedef struct {
+	Ast const* ast;
+	TokenArray tokens;
+	String source;
+	String filename;
+
+	InternTable names;
+	SymbolTable symbols;
+	u32* resolved; /* Symbol of each Ident node, SYMBOL_NONE for other nodes, indexed by node */
+	Constant* constants; /* Value of each constant expression node, ConstKind_None elsewhere, indexed by node */
+
+	Arena* error_arena;
+	CompilerError* error; /* Ordered by offset */
+	CompilerError* error_tail;
+	i32 error_count;
+	i32 max_errors;
+} Checker;
+
+// `scope_arena` only holds scope maps and is rewound as scopes close, everything the checker
+// produces lives in `arena`
+Checker checker_create(Ast const* ast, TokenArray tokens, String source, Arena* arena, Arena* scope_arena, Arena* error_arena);
+
+str_attribute_format(4,5)
+void checker_emit_error(Checker* c, CheckerError type, u32 token, char const* fmt, ...);
+
+// Resolves every name of the file and folds constant expressions. Functions and globals are visible
+// in the whole file, other names from their declaration to the end of their block. Deferred bodies
+// are not checked.
+void checker_check_file(Checker* c, u32 file);
+
+//// IR
+/* SSA form of a checked file, built for the passes and backends that come after the checker.
+   Every array is dense and indexed by u32: a value is the index of the instruction producing
+   it, a block is a contiguous range of instructions that starts with its phis and ends with its
+   only terminator, and variable length operand lists live in `operands`. Values are typed with
+   ConstKind, instructions without a result have ConstKind_None.
+   Op        | a             | b             | c
+   Const     | low 32 bits   | high 32 bits  | -             of the value, typed by the instruction
+   Param     | index         | -             | -
+   Undef     | -             | -             | -             read of a variable no path has set
+   GetVar    | variable      | -             | -             only while the function is built
+   SetVar    | variable      | value         | -             same
+   GetGlobal | global        | -             | -
+   SetGlobal | global        | value         | -
+   Phi       | operand start | count         | -             `count` values then their predecessors
+   Add..Le   | lhs           | rhs           | -             Int arithmetic is checked as in the interpreter
+   Neg, BitNot, Not | operand | -            | -
+   Call      | function      | operand start | argument count
+   Jump      | block         | -             | -
+   Branch    | condition     | then block    | else block
+   Return    | value or IR_NONE | -          | -
+   Nop       | -             | -             | -             dropped by the next compaction */
+#define IR_OPS \
+	X(Nop) X(Const) X(Param) X(Undef) X(GetVar) X(SetVar) X(GetGlobal) X(SetGlobal) X(Phi) \
+	X(Add) X(Sub) X(Mul) X(Div) X(Mod) X(Shl) X(Shr) X(And) X(Or) X(Xor) \
+	X(Eq) X(Ne) X(Lt) X(Le) \
+	X(Neg) X(BitNot) X(Not) \
+	X(Call) X(Jump) X(Branch) X(Return) \
+
+typedef enum {
+	#define X(Name) IrOp_##Name,
+	IR_OPS
+	#undef X
+	IrOp__len,
+} IrOp;
+
+#define IR_NONE ((u32)0xffffffff)
+
+typedef struct {
+	u8 op;
+	u8 type;    /* ConstKind of the result */
+	u32 offset; /* Source offset of the operation, for runtime errors */
+	union {
+		struct { u32 a, b, c; };
+		u32 args[3];
+	};
+} IrInst;
+
+typedef struct {
+	u32 first;      /* Instructions [first, first + count) */
+	u32 count;
+	u32 pred_start; /* Into `IrFunction.preds` */
+	u32 pred_count;
+	u32 idom;       /* Immediate dominator, the entry block is its own and unreachable blocks have IR_NONE */
+} IrBlock;
+
+typedef struct {
+	String name;
+	u8* param_types;
+	u32 param_count;
+	u8 return_type; /* ConstKind_None when the function returns nothing */
+
+	DynArray(IrInst) insts;
+	DynArray(IrBlock) blocks; /* Block 0 is the entry */
+	DynArray(u32) operands;
+	DynArray(u32) preds;
+} IrFunction;
+
+typedef struct {
+	IrFunction* functions;
+	u32 function_count;
+	String* global_names;
+	u8* global_types;
+	u32 global_count;
+	u32 init; /* Evaluates the initializers of top-level lets in order */
+	u32 main; /* IR_NONE if the file has no `main` */
+} IrModule;
+
+// Values an instruction reads, a slice of its fields or of `operands`
+typedef struct {
+	u32* v;
+	u32 len;
+} IrUses;
+
+IrUses ir_uses(IrFunction* f, IrInst* inst);
+
+// Blocks a terminator goes to, returns how many were written to `out`
+u32 ir_successors(IrInst const* inst, u32 out[2]);
+
+static inline
+bool ir_is_terminator(IrOp op){
+	return op == IrOp_Jump || op == IrOp_Branch || op == IrOp_Return;
+}
+
+Constant ir_const_value(IrInst const* inst);
+
+// Predecessor lists of every block, from the terminators
+void ir_compute_cfg(IrFunction* f);
+
+// Immediate dominators with the Cooper-Harvey-Kennedy iteration over the reverse postorder,
+// the predecessors must be up to date
+void ir_compute_dominators(IrFunction* f);
+
+bool ir_dominates(IrFunction const* f, u32 a, u32 b);
+
+// Lays the reachable blocks out in reverse postorder and drops Nop instructions, values and
+// blocks are renumbered. Predecessors and dominators are recomputed.
+void ir_compact(IrFunction* f);
+
+// Rewrites the function with its reachable blocks in reverse postorder. `phi_head` and `phi_next`
+// chain instructions that go at the start of each block, before the block's own range, and
+// `replace` maps removed values to the value standing for them. Any of them may be NULL.
+void ir_relayout(IrFunction* f, u32 const* phi_head, u32 const* phi_next, u32 const* replace, u8 const* merged);
+
+// Appends every block with a single predecessor that jumps to it to that predecessor, returns
+// how many blocks were merged. The function is compacted as a side effect when any were.
+u32 ir_merge_blocks(IrFunction* f);
+
+// Values live on entry to and on exit from each block of a compacted function, one bitset per
+// block indexed by value. A phi is defined at the start of its block, its operands are used at
+// the end of their predecessors.
+typedef struct {
+	u32 words;    /* Of each bitset */
+	u32* live_in; /* Of block `b`: live_in[b * words .. (b + 1) * words) */
+	u32* live_out;
+} IrLiveness;
+
+IrLiveness ir_liveness(IrFunction const* f, Arena* arena);
+
+static inline
+bool ir_live_has(u32 const* set, u32 value){
+	return (set[value / 32] >> (value % 32)) & 1;
+}
+
+typedef enum {
+	IrError_None = 0,
+	IrError_Unsupported,
+	IrError_NotCallable,
+	IrError_ArgumentCount,
+	IrError_InvalidTarget,
+	IrError_Type,
+	IrError_MissingReturn,
+	IrError_TooManyErrors,
+} IrError;
+
+typedef struct {
+	Checker const* checker;
+	String filename;
+	IrModule module;
+
+	IrFunction* fn;    /* Being built */
+	u32 block;         /* Receives new instructions, IR_NONE after a terminator */
+	u32* slots;        /* Variable, global or function index of each declaration, indexed by node */
+	DynArray(u8) var_types;
+	void* loop;        /* Innermost `IrLoop`, private to ir.c */
+
+	Arena* arena;
+	CompilerError* error; /* Ordered by offset */
+	CompilerError* error_tail;
+	i32 error_count;
+	i32 max_errors;
+} IrBuilder;
+
+// The checker must have run on the file without errors, the module keeps pointers to its names
+IrBuilder ir_builder_create(Checker const* checker, Arena* arena);
+
+str_attribute_format(4,5)
+void ir_emit_error(IrBuilder* b, IrError type, u32 token, char const* fmt, ...);
+
+// Lowers every function and global initializer of the file to SSA. Only `let` variables and
+// parameters that are assigned after their declaration get phis. The module is only usable if
+// `error_count` is 0.
+IrModule ir_build_file(IrBuilder* b, u32 file);
+
+String ir_type_name(u8 type);
+
+// Human readable listing for tests and debugging
+String ir_dump(IrModule const* m, Arena* arena);
+
+//// IR passes
+/* Work on compacted functions and leave them compacted. Each pass is linear in the size of the
+   function. Operations that can fail at runtime are kept unless they are proven not to. */
+
+typedef struct {
+	u32 folded;   /* Values replaced by a constant */
+	u32 branches; /* Conditional branches turned into jumps */
+	u32 removed;  /* Instructions gone, dead or in blocks that can no longer run */
+	u32 merged;   /* Blocks appended to their only predecessor */
+	u32 inlined;  /* Calls replaced by the body of the callee */
+} IrOptStats;
+
+#define IR_DEFAULT_INLINE_BUDGET 40
+
+typedef struct {
+	u32 caller;   /* Function indices */
+	u32 callee;
+	u32 offset;   /* Of the call */
+} IrInlinedCall;
+
+typedef DynArray(IrInlinedCall) IrInlinedCallArray;
+
+typedef struct {
+	u32 inline_budget;           /* Largest callee inlined, in instructions without its parameters */
+	IrInlinedCallArray* inlined; /* Receives every inlined call in the order it was inlined, may be NULL */
+	IrOptStats* function_stats;  /* Of each function, may be NULL */
+} IrOptOptions;
+
+// Wegman-Zadeck sparse conditional constant propagation: values that are constant on every
+// path that can run become constants and branches on them jumps
+void ir_propagate_constants(IrFunction* f, IrOptStats* stats);
+
+// Drops instructions whose values are never used, then merges blocks joined by a jump
+void ir_eliminate_dead_code(IrFunction* f, IrOptStats* stats);
+
+// Both passes above, `removed` counts every instruction they removed
+IrOptStats ir_optimize(IrFunction* f);
+
+// Optimizes every function, callees before their callers: the call graph is walked bottom up by
+// strongly connected components, and calls to functions already done whose size is within the
+// budget are inlined before the caller is optimized. Calls inside a component are recursive and
+// never inlined. `removed` does not count the instructions inlining added.
+IrOptStats ir_optimize_module(IrModule* m, IrOptOptions const* options);
+
+//// Bytecode
+/* Register machine: every instruction is 32 bits, an 8 bit opcode followed by either three 8 bit
+   operands A B C, an 8 bit A and a 16 bit Bx, or a 24 bit jump offset. Registers are relative to
+   the frame of the running function, parameters come first.
+   Op        | Operands | Effect
+   Move      | A B      | r[A] = r[B]
+   LoadK     | A Bx     | r[A] = constants[Bx]
+   LoadI     | A sBx    | r[A] = sBx as Int
+   LoadNil   | A        | r[A] = nil
+   LoadBool  | A B      | r[A] = B != 0
+   GetGlobal | A Bx     | r[A] = globals[Bx]
+   SetGlobal | A Bx     | globals[Bx] = r[A]
+   Add..BitXor, Eq..Le | A B C | r[A] = r[B] op r[C]
+   AddI      | A B sC   | r[A] = r[B] + sC, C is a signed byte
+   Neg, BitNot, Not | A B | r[A] = op r[B]
+   Jmp       | sJ       | pc += sJ
+   JmpFalse, JmpTrue | A sBx | pc += sBx if r[A] is false or true, r[A] must be a Bool
+   Call      | A Bx     | r[A] = functions[Bx](r[A], r[A + 1]...)
+   Ret       | A        | return r[A]
+   RetNil    | -        | return nil
+   Jump offsets are relative to the next instruction. */
+#define BYTECODE_OPS \
+	X(Move) X(LoadK) X(LoadI) X(LoadNil) X(LoadBool) X(GetGlobal) X(SetGlobal) \
+	X(Add) X(Sub) X(Mul) X(Div) X(Mod) X(Shl) X(Shr) X(BitAnd) X(BitOr) X(BitXor) \
+	X(Eq) X(Ne) X(Lt) X(Le) \
+	X(AddI) X(Neg) X(BitNot) X(Not) \
+	X(Jmp) X(JmpFalse) X(JmpTrue) \
+	X(Call) X(Ret) X(RetNil) \
+
+typedef enum {
+	#define X(Name) BcOp_##Name,
+	BYTECODE_OPS
+	#undef X
+	BcOp__len,
+} BcOp;
+
+typedef u32 Instr;
+
+#define INSTR_OP(I)  ((I) & 0xff)
+#define INSTR_A(I)   (((I) >> 8) & 0xff)
+#define INSTR_B(I)   (((I) >> 16) & 0xff)
+#define INSTR_C(I)   ((I) >> 24)
+#define INSTR_BX(I)  ((I) >> 16)
+#define INSTR_SBX(I) ((i32)INSTR_BX(I) - 0x8000)
+#define INSTR_SC(I)  ((i32)(i8)INSTR_C(I))
+#define INSTR_SJ(I)  ((i32)((I) >> 8) - 0x800000)
+
+#define BC_MAX_REGISTERS 255
+#define BC_NO_FUNCTION ((u32)0xffffffff)
+
+/* Runtime values share the representation of folded constants, ConstKind_None is nil */
+typedef Constant Value;
+
+typedef struct {
+	String name;
+	u32 code_start; /* Into `BcProgram.code` */
+	u32 code_len;
+	u8 param_count;
+	u8 register_count;
+} BcFunction;
+
+typedef struct {
+	Instr* code;      /* Every function, one after the other */
+	u32* offsets;     /* Source offset of each instruction */
+	u32 code_len;
+
+	Value* constants;
+	u32 constant_count;
+
+	BcFunction* functions;
+	u32 function_count;
+	u8* global_types; /* ConstKind of each global, it holds the zero of its type until set */
+	u32 global_count;
+	u32 init;         /* Evaluates the initializers of top-level lets in order */
+	u32 main;         /* BC_NO_FUNCTION if the file has no `main` */
+} BcProgram;
+
+typedef enum {
+	EmitterError_None = 0,
+	EmitterError_TooManyRegisters,
+	EmitterError_TooLarge,
+	EmitterError_TooManyErrors,
+} EmitterError;
+
+typedef struct {
+	IrModule const* module;
+	String filename;
+
+	DynArray(Instr) code;
+	DynArray(u32) offsets;
+	DynArray(Value) constants;
+	DynArray(BcFunction) functions;
+
+	Arena* arena;
+	CompilerError* error; /* Ordered by offset */
+	CompilerError* error_tail;
+	i32 error_count;
+	i32 max_errors;
+} Emitter;
+
+// The module must have been built without errors, the program keeps pointers to its names
+Emitter emitter_create(IrModule const* module, String filename, Arena* arena);
+
+str_attribute_format(4,5)
+void emitter_emit_error(Emitter* e, EmitterError type, u32 offset, char const* fmt, ...);
+
+// Translates every function of the module, IR function `i` becomes bytecode function `i`. SSA
+// values get registers from a linear scan over their live intervals and phis become moves on the
+// edges into their block. The program is only usable if `error_count` is 0.
+BcProgram emitter_emit_module(Emitter* e);
+
+// Human readable listing for tests and debugging
+String bytecode_dump(BcProgram const* program, Arena* arena);
+
+String bytecode_format_value(Value v, Arena* arena);
+
+//// Interpreter
+typedef struct {
+	Instr const* pc; /* Where to resume the caller */
+	Value* base;     /* Caller's registers */
+} VmFrame;
+
+typedef struct {
+	BcProgram const* program;
+	Value* globals;
+	Value* stack;
+	u32 stack_len;
+	VmFrame* frames;
+	u32 frame_cap;
+
+	String filename;
+	Arena* error_arena;
+	CompilerError* error; /* Set when a call fails */
+} Vm;
+
+#define VM_DEFAULT_STACK (64 * 1024)
+#define VM_DEFAULT_FRAMES (8 * 1024)
+
+Vm vm_create(BcProgram const* program, u32 stack_len, u32 frame_cap, Arena* arena);
+
+// Runs function `fn` with `args`, false on a runtime error left in `vm->error`
+bool vm_call(Vm* vm, u32 fn, Value const* args, u32 arg_count, Value* result);
+
+// Runs the global initializers then `main`
+bool vm_run_main(Vm* vm, Value* result);
+
+//// Native code
+/* x86-64 machine code for an IR module. Functions follow the System V calling convention, so
+   they can be called from C, and values live in registers picked by a linear scan over SSA live
+   intervals. Code is position independent: calls between functions are resolved when emitting
+   and only references to the data area (globals, then the trap handler and the stack limit) are
+   left as fixups for whoever places the code in memory. */
+
+typedef enum {
+	NativeTrap_Overflow,
+	NativeTrap_DivisionByZero,
+	NativeTrap_ShiftRange,     /* The shift amount is passed along */
+	NativeTrap_StackOverflow,
+} NativeTrapKind;
+
+/* A runtime check that failed calls the trap handler with the index of its `NativeTrap` and a
+   value, as `void handler(u32 trap, i64 value)`. The handler must not return. */
+typedef struct {
+	u32 offset; /* Source offset, as in the interpreter's errors */
+	u8 kind;
+} NativeTrap;
+
+typedef struct {
+	u32 at;          /* Offset of a 32-bit RIP relative displacement in the code */
+	u32 data_offset; /* What it points to, from the start of the data area */
+} NativeFixup;
+
+typedef struct {
+	IrModule const* module;
+	u8* code;
+	u32 code_len;
+	u32* entries;     /* Offset of each function in `code` */
+
+	NativeFixup* fixups;
+	u32 fixup_count;
+	NativeTrap* traps;
+	u32 trap_count;
+
+	u32 data_size;    /* 8 bytes per global, then the two slots below */
+	u32 trap_slot;    /* Address of the trap handler */
+	u32 stack_slot;   /* Lowest stack address calls may go below */
+} NativeProgram;
+
+// The module must have been built without errors
+NativeProgram native_emit_module(IrModule const* m, Arena* arena);
+
+// Patches the fixups of a copy of the code placed at `code_address`, the data area being at
+// `data_address`. Both must be within 2 GB of each other.
+void native_link(NativeProgram const* p, u8* code, u64 code_address, u64 data_address);
+
+// Message of a runtime error, as the interpreter words it
+String native_trap_message(NativeTrapKind kind, i64 value, Arena* arena);
+
+// Writes a static Linux executable that runs the global initializers then `main` and prints its
+// result. Runtime errors are printed like the compiler's own with `filename` and exit with
+// status 1. Returns false with a message in `error` if the program has no usable `main` or the
+// file cannot be written.
+bool native_write_executable(NativeProgram const* p, String filename, char const* path, Arena* arena, String* error);
+
+//// JIT
+/* Runs native code in this process. The code is linked while its pages are read-write and they
+   are flipped to read-execute before the first call, they are never writable and executable at
+   once. Calls switch to a stack owned by the JIT with a guard page under it, so deep recursion
+   is the interpreter's stack overflow error and not a crash. Needs the System V convention. */
+
+#define NATIVE_JIT_DEFAULT_STACK (8 * mem_megabyte)
+
+typedef struct {
+	NativeProgram const* program;
+	u8* pages;        /* Code with the entry and exit stubs, then the data area */
+	isize code_size;  /* Both in whole pages */
+	isize data_size;
+	u8* stack;        /* Lowest page is the guard */
+	isize stack_size;
+	u32 enter;        /* Offsets in `pages` of the stubs */
+	u32 exit;
+
+	String filename;
+	Arena* error_arena;
+	CompilerError* error; /* Set when creating the JIT or a call fails */
+} NativeJit;
+
+// Maps `p`, which must outlive the JIT. On failure `error` is set and the JIT cannot be called.
+NativeJit native_jit_create(NativeProgram const* p, isize stack_size, Arena* arena);
+
+void native_jit_destroy(NativeJit* jit);
+
+// Runs function `fn` with `args`, false on a runtime error left in `jit->error`. Globals keep
+// their values between calls.
+bool native_jit_call(NativeJit* jit, u32 fn, Value const* args, u32 arg_count, Value* result);
+
+// Runs the global initializers then `main`
+bool native_jit_run_main(NativeJit* jit, Value* result);
+
+//// Cache
+/* On-disk cache of tokens and ASTs, one file per source named after a hash of its contents
+   with the compiler version folded in. Entries are position independent: tokens are packed
+   (offsets into the source) and the AST only holds indices, so a hit is a mmap and a hash of
+   the entry, which catches corrupted bodies before their indices are used. */
+
+#define CACHE_MAGIC 0x434f4c4bu /* "KLOC" */
+#define CACHE_FORMAT_VERSION 2
+
+typedef struct {
+	PackedTokenArray tokens;
+	Ast ast; /* Points into the mapping, nodes can be modified but not added */
+	u32 root;
+	FileMapping mapping;
+} CacheEntry;
+
+u64 cache_key(String source);
+
+// Looks up `source` in `dir`. Entries that are missing, truncated or written by another
+// compiler version are misses. `scratch` is only used while loading.
+bool cache_load(String dir, String source, Arena* scratch, CacheEntry* out);
+
+// Only sources that lexed and parsed without errors should be stored, errors are not cached
+bool cache_store(String dir, String source, PackedTokenArray const* tokens, Ast const* ast, u32 root, Arena* scratch);
+
+void cache_release(CacheEntry* entry);
+
+//// Driver
+typedef enum {
+	DriverPhase_Read,
+	DriverPhase_Cache,
+	DriverPhase_Lex,
+	DriverPhase_Parse,
+	DriverPhase_Check,
+
+	DriverPhase__len,
+} DriverPhase;
+
+String driver_phase_name(DriverPhase phase);
+
+typedef struct {
+	String path;
+	String source;
+	TokenArray tokens;
+	Ast ast;
+	u32 root;
+	InternTable names;
+	SymbolTable symbols;
+	u32* resolved; /* See `Checker`, only set when the file parsed without errors */
+	Constant* constants; /* See `Checker`, same condition */
+	CompilerError* errors; /* Ordered by offset */
+	i32 error_count;
+	bool from_cache;
+	CacheEntry cache; /* Backs `ast` when `from_cache` is set */
+	i64 phase_time[DriverPhase__len]; /* Nanoseconds spent in each phase */
+} CompilationUnit;
+
+// Reads, lexes and parses `path` into `arena`. Returns false only if the file cannot be read,
+// compile errors are left in `unit->errors`.
+bool unit_compile(CompilationUnit* unit, String path, String cache_dir, Arena* arena);
+
+void unit_release(CompilationUnit* unit);
+
+typedef struct DriverContext DriverContext;
+
+/* Returns the unit for an absolute or cwd relative path, NULL if it cannot be read */
+typedef CompilationUnit* (*UnitProvider)(DriverContext* ctx, String path);
+
+struct DriverContext {
+	String cwd;       /* Relative paths are resolved against it when set */
+	String cache_dir; /* On-disk cache, empty to disable */
+	bool dump_ast;
+	bool dump_ir;
+	bool dump_bytecode;
+	bool run;         /* Execute `main` of each file that compiled */
+	bool jit;         /* Run native code in process instead of the interpreter */
+	bool optimize;    /* Run the IR passes before the IR is used */
+	bool opt_report;  /* Print what the IR passes did to each function */
+	bool inline_report; /* Print every call the optimizer inlined */
+	i32 inline_budget;  /* 0 for IR_DEFAULT_INLINE_BUDGET, negative to inline nothing */
+	String output;    /* Native executable to write, empty for none */
+	bool time;        /* Print the time spent in each phase */
+	i32 jobs;         /* Worker threads, 0 for one per processor */
+	Arena* scratch;   /* File list and output of one invocation */
+
+	UnitProvider provide_unit; /* Compiles files in parallel when NULL, otherwise called in order on one thread */
+	void* user;
+};
+
+// Runs one compiler invocation, `args` excludes the program name. Directories are searched
+// recursively for `.kl` files, errors are printed ordered by file and offset.
+int driver_run(DriverContext* ctx, int argc, char const** args, FILE* out);
+
+// Entry point, dispatches to `driver_run`, the compile server or its client
+int driver_main(int argc, char const** argv);
+
+//// Compile server
+/* Keeps units in memory between invocations and answers requests on a Unix domain socket,
+   files are watched with inotify and dropped from memory when they change. Linux only. */
+int server_run(char const* socket_path);
+
+// Sends `args` to a running server, the output is allocated in `arena`
+bool server_request(char const* socket_path, String cwd, int argc, char const** args, Arena* arena, String* output, int* status);
 
+// Forwards `args` to a running server, prints its output and returns its exit status
+int client_run(char const* socket_path, int argc, char const** args);
@@ -11,6 +11,40 @@ bool is_alpha(rune c){
 	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 }
 
+enum {
+	IdentClass_Continue = 1 << 0, /* [a-zA-Z0-9_] */
+	IdentClass_Start    = 1 << 1, /* [a-zA-Z_] */
+	IdentClass_Unicode  = 1 << 2, /* Non-ASCII, needs the XID tables */
+};
+
+/* Indexed by byte, keeps the ASCII part of identifiers to one load per character */
+static const u8 lexer_ident_class[256] = {
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 0x00 */
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 0x10 */
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 0x20 */
+	1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0, /* 0x30 */
+	0,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3, /* 0x40 */
+	3,3,3,3,3,3,3,3,3,3,3,0,0,0,0,3, /* 0x50 */
+	0,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3, /* 0x60 */
+	3,3,3,3,3,3,3,3,3,3,3,0,0,0,0,0, /* 0x70 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0x80 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0x90 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0xa0 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0xb0 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0xc0 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0xd0 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0xe0 */
+	4,4,4,4,4,4,4,4,4,4,4,4,4,4,4,4, /* 0xf0 */
+};
+
+static inline
+bool is_identifier_start(rune c){
+	if(c < 0x80){
+		return c >= 0 && (lexer_ident_class[c] & IdentClass_Start) != 0;
+	}
+	return unicode_is_xid_start(c);
+}
+
 static inline
 bool is_decimal(rune c){
 	return (c >= '0' && c <= '9');
@@ -42,44 +76,69 @@ Lexer lexer_create(String source, Arena* error_arena){
 		.current = 0,
 		.error_arena = error_arena,
 		.error = NULL,
+		.max_errors = LEXER_DEFAULT_MAX_ERRORS,
 	};
+
+	/* Validating up front keeps the per rune checks out of the hot loop */
+	isize bad_offset = 0;
+	lex.validated = utf8_validate(source.v, source.len, &bad_offset);
+	if(!lex.validated){
+		lexer_emit_error_at(&lex, bad_offset, LexerError_InvalidEncoding, "Invalid UTF-8 sequence");
+	}
 	return lex;
 }
 
-String token_kind_name(TokenKind k){
-	String s = str_lit("<INVALID TOKEN KIND>");
-	switch(k){
-	#define X(Name, Str) case TokenKind_##Name: s = str_lit(Str); break;
-	ALL_TOKENS
-	#undef X
-	case TokenKind__len: break;
+static
+void lexer_emit_error_v(Lexer* lex, isize offset, LexerError type, char const* fmt, va_list argp){
+	lex->error_count += 1;
+	if(lex->error_count > lex->max_errors + 1){
+		return;
 	}
-	return s;
-}
 
-void lexer_emit_error(Lexer* lex, LexerError type, char const* fmt, ...){
 	CompilerError* err = arena_make(lex->error_arena, CompilerError, 1);
-	err->type = (u32)type;
 	err->stage = CompilerStage_Lex;
-	err->offset = lex->current;
+	err->offset = offset;
 	err->filename = lex->filename;
 
-	/* Format message */ {
-		va_list argp;
-		va_start(argp, fmt);
+	if(lex->error_count > lex->max_errors){
+		err->type = LexerError_TooManyErrors;
+		err->message = str_format(lex->error_arena, "Too many errors (limit is %d), further errors in this file are not reported", lex->max_errors);
+	}
+	else {
+		err->type = (u32)type;
 		err->message = str_vformat(lex->error_arena, fmt, argp);
-		va_end(argp);
 	}
 
-	err->next  = lex->error;
-	lex->error = err;
+	compiler_error_insert(&lex->error, &lex->error_tail, err);
+}
+
+void lexer_emit_error(Lexer* lex, LexerError type, char const* fmt, ...){
+	va_list argp;
+	va_start(argp, fmt);
+	lexer_emit_error_v(lex, lex->current, type, fmt, argp);
+	va_end(argp);
+}
+
+void lexer_emit_error_at(Lexer* lex, isize offset, LexerError type, char const* fmt, ...){
+	va_list argp;
+	va_start(argp, fmt);
+	lexer_emit_error_v(lex, offset, type, fmt, argp);
+	va_end(argp);
+}
+
+static inline
+UTF8Decoded lexer_decode(Lexer const* lex, isize pos){
+	if(lex->validated){
+		return utf8_decode_unchecked(lex->source.v + pos);
+	}
+	return utf8_decode(lex->source.v + pos, lex->source.len - pos);
 }
 
 UTF8Decoded lexer_advance(Lexer* lex){
 	if(lex->current >= lex->source.len){
 		return (UTF8Decoded){0,1};
 	}
-	UTF8Decoded res = utf8_decode(lex->source.v + lex->current, lex->source.len - lex->current);
+	UTF8Decoded res = lexer_decode(lex, lex->current);
 	lex->current += res.len;
 	return res;
 }
@@ -87,9 +146,9 @@ UTF8Decoded lexer_advance(Lexer* lex){
 UTF8Decoded lexer_peek(Lexer* lex, isize delta){
 	UTF8Decoded res = {0, 1};
 	isize pos = lex->current + delta;
-	if(pos < 0 || pos > lex->source.len){ return res; }
+	if(pos < 0 || pos >= lex->source.len){ return res; }
 
-	res = utf8_decode(lex->source.v + pos, lex->source.len - pos);
+	res = lexer_decode(lex, pos);
 	return res;
 }
 
@@ -122,36 +181,34 @@ Token lexer_consume_line_comment(Lexer* lex){
 }
 
 Token lexer_consume_identifier_or_keyword(Lexer* lex){
-	rune first = lex->source.v[lex->current];
+	UTF8Decoded first = lexer_peek(lex, 0);
 	Token token = {0};
-	ensure(is_alpha(first) || first == '_', "Not on part of identifier");
+	ensure(is_identifier_start(first.codepoint), "Not on part of identifier");
 
 	isize start = lex->current;
+	byte const* src = lex->source.v;
+	isize len = lex->source.len;
+	isize pos = start + first.len;
 
-	for(;;) {
-		UTF8Decoded dec = lexer_advance(lex);
-		rune c = dec.codepoint;
-
-		if(!is_alpha(c) && !is_decimal(c) && c != '_'){
-			lex->current -= dec.len;
+	for(;;){
+		while(pos < len && (lexer_ident_class[src[pos]] & IdentClass_Continue)){
+			pos += 1;
+		}
+		if(pos >= len || (lexer_ident_class[src[pos]] & IdentClass_Unicode) == 0){
 			break;
 		}
-	}
-
-	token.lexeme = str_sub(lex->source, start, lex->current);
-	token.kind = TokenKind_Identifier;
-
-	const isize n =  sizeof(keyword_lexemes) / sizeof(keyword_lexemes[0]);
-
-	for(isize i = 0; i < n; i += 1){
-		String kw_lexeme = keyword_lexemes[i].lexeme;
-		TokenKind kw_kind = keyword_lexemes[i].kind;
 
-		if(str_equals(token.lexeme, kw_lexeme)){
-			token.kind = kw_kind;
+		lex->current = pos;
+		UTF8Decoded dec = lexer_peek(lex, 0);
+		if(!unicode_is_xid_continue(dec.codepoint)){
 			break;
 		}
+		pos += dec.len;
 	}
+	lex->current = pos;
+
+	token.lexeme = str_sub(lex->source, start, lex->current);
+	token.kind = token_keyword_kind(token.lexeme);
 	return token;
 }
 
@@ -164,8 +221,7 @@ Token lexer_consume_whitespace(Lexer* lex){
 
 	do {
 		lex->current += 1;
-		if(!is_whitespace(lex->source.v[lex->current])){ break; }
-	} while(!lexer_done(lex));
+	} while(!lexer_done(lex) && is_whitespace(lex->source.v[lex->current]));
 
 	tk.lexeme = str_sub(lex->source, start, lex->current);
 
@@ -178,17 +234,62 @@ rune escape_rune(rune code){
 	case 'r':  return '\r';
 	case 'n':  return '\n';
 	case 't':  return '\t';
+	case '0':  return '\0';
 	case '\'': return '\'';
 	case '"':  return '"';
+	case '\\': return '\\';
 	}
-	return 0;
+	return -1;
 }
 
-#define LEXER_MAX_DIGIT_COUNT 256
+static inline
+bool is_delimiter(byte c){
+	switch(c){
+	case '(': case ')': case '[': case ']': case '{': case '}':
+	case ',': case ';': case ':': case '"':
+	case '+': case '-': case '*': case '/': case '%': case '&': case '|': case '~':
+	case '<': case '>': case '=': case '!':
+		return true;
+	}
+	return is_whitespace(c);
+}
+
+/* Skips the rest of a malformed token up to the next delimiter, the whole span becomes one Unknown token */
+static
+Token lexer_recover(Lexer* lex, isize start){
+	while(!lexer_done(lex) && !is_delimiter(lex->source.v[lex->current])){
+		lex->current += 1;
+	}
+	Token token = {
+		.kind = TokenKind_Unknown,
+		.lexeme = str_sub(lex->source, start, lex->current),
+	};
+	return token;
+}
+
+static inline
+bool is_identifier_char(byte c){
+	return (lexer_ident_class[c] & (IdentClass_Continue | IdentClass_Unicode)) != 0;
+}
+
+/* The character at `pos` quoted for an error message. Past ASCII it is quoted whole with its code
+   point, as unexpected characters are, so the message stays valid UTF-8. */
+static
+String lexer_quote_char(Lexer const* lex, isize pos){
+	UTF8Decoded dec = lexer_decode(lex, pos);
+	byte c = lex->source.v[pos];
+	if(c < 0x80){
+		return str_format(lex->error_arena, "'%c'", c);
+	}
+	if(dec.len == 1){ /* Not a valid sequence, the byte itself cannot be printed */
+		return str_format(lex->error_arena, "byte 0x%02X", c);
+	}
+	return str_format(lex->error_arena, "'%.*s' (U+%04X)", (int)dec.len, (char const*)lex->source.v + pos, (u32)dec.codepoint);
+}
 
 Token lexer_consume_non_decimal_integer(Lexer* lex, int base){
 	Token token = {0};
-	isize start = lex->current;
+	isize start = lex->current - 2; /* Include the base prefix */
 
 	bool (*validation_func)(rune) = NULL;
 
@@ -199,29 +300,29 @@ Token lexer_consume_non_decimal_integer(Lexer* lex, int base){
 	default: ensure(false, "Invalid base"); break;
 	}
 
-	do {
-		char c = lex->source.v[lex->current];
-		lex->current += 1;
+	while(!lexer_done(lex)){
+		byte c = lex->source.v[lex->current];
 
 		if(c == '_' || validation_func(c)){
-			continue;
+			lex->current += 1;
 		}
-		else if(is_whitespace(c)){
-			lex->current -= 1;
-			break;
+		else if(is_identifier_char(c) || c == '.'){
+			lexer_emit_error(lex, LexerError_InvalidNumber, "Invalid digit to base-%d number: %.*s", base, str_fmt(lexer_quote_char(lex, lex->current)));
+			return lexer_recover(lex, start);
 		}
 		else {
-			lexer_emit_error(lex, LexerError_InvalidNumber, "Invalid digit to base-%d number: '%c'\n", base, c);
-			return token;
+			break;
 		}
-	} while(!lexer_done(lex));
+	}
 
-	String lexeme = str_sub(lex->source, start - 2, lex->current);
+	String lexeme = str_sub(lex->source, start, lex->current);
 	i64 val = 0;
 
 	String numeric_part = str_sub(lexeme, 2, lexeme.len);
 	if(!str_parse_i64(numeric_part, base, &val)){
-		lexer_emit_error(lex, LexerError_InvalidNumber, "Invalid numeric literal: '%.*s'", str_fmt(lexeme));
+		lexer_emit_error_at(lex, start, LexerError_InvalidNumber, "Invalid numeric literal: '%.*s'", str_fmt(lexeme));
+		token.kind = TokenKind_Unknown;
+		token.lexeme = lexeme;
 		return token;
 	}
 
@@ -238,76 +339,82 @@ Token lexer_consume_decimal(Lexer* lex){
 	Token token = {0};
 
 	isize start = lex->current;
-	do {
-		char c = lex->source.v[lex->current];
-		lex->current += 1;
+	while(!lexer_done(lex)){
+		byte c = lex->source.v[lex->current];
 
-		if(c == '_' || is_decimal(c)){ continue; }
-
-		if(c == '.'){
-			if(!has_dot){
-				has_dot = true;
-			} else {
-				lexer_emit_error(lex, LexerError_InvalidNumber, "Duplicate decimal point in numeric literal");
-				return token;
+		if(c == '_' || is_decimal(c)){
+			lex->current += 1;
+		}
+		else if(c == '.'){
+			if(has_dot || has_exp){
+				lexer_emit_error(lex, LexerError_InvalidNumber, has_exp ? "Decimal point in exponent of numeric literal" : "Duplicate decimal point in numeric literal");
+				return lexer_recover(lex, start);
 			}
+			has_dot = true;
+			lex->current += 1;
 		}
 		else if(c == 'e' || c == 'E'){
-			if(!has_exp){
-				has_exp = true;
-				lexer_match_advance(lex, '+');
+			if(has_exp){
+				lexer_emit_error(lex, LexerError_InvalidNumber, "Duplicate exponent in numeric literal");
+				return lexer_recover(lex, start);
+			}
+			has_exp = true;
+			lex->current += 1;
+			if(!lexer_match_advance(lex, '+')){
 				lexer_match_advance(lex, '-');
-			} else {
-				lexer_emit_error(lex, LexerError_InvalidNumber, "Duplicate exponent in numeric literal");;
-				return token;
 			}
 		}
+		else if(is_identifier_char(c)){
+			lexer_emit_error(lex, LexerError_InvalidNumber, "Invalid digit in numeric literal: %.*s", str_fmt(lexer_quote_char(lex, lex->current)));
+			return lexer_recover(lex, start);
+		}
 		else {
-			lex->current -= 1;
 			break;
 		}
-	} while(!lexer_done(lex));
+	}
 
 	String lexeme = str_sub(lex->source, start, lex->current);
+	token.lexeme = lexeme;
 
 	if(has_dot || has_exp){
 		f64 val = 0;
+		token.kind = TokenKind_Real;
 		if(!str_parse_f64(lexeme, &val)){
-			lexer_emit_error(lex, LexerError_InvalidNumber, "Invalid numeric literal: '%.*s'", str_fmt(lexeme));
+			lexer_emit_error_at(lex, start, LexerError_InvalidNumber, "Invalid numeric literal: '%.*s'", str_fmt(lexeme));
+			token.kind = TokenKind_Unknown;
 		}
-		token.kind = TokenKind_Real;
 		token.value.real = val;
 	}
 	else {
 		i64 val = 0;
+		token.kind = TokenKind_Integer;
 		if(!str_parse_i64(lexeme, 10, &val)){
-			lexer_emit_error(lex, LexerError_InvalidNumber, "Invalid numeric literal: '%.*s'", str_fmt(lexeme));
+			lexer_emit_error_at(lex, start, LexerError_InvalidNumber, "Integer literal does not fit in 64 bits: '%.*s'", str_fmt(lexeme));
+			token.kind = TokenKind_Unknown;
 		}
-		token.kind = TokenKind_Integer;
 		token.value.integer = val;
 	}
 
-	token.lexeme = lexeme;
-
 	return token;
 }
 
 Token lexer_consume_number(Lexer* lex){
 	rune first = lexer_peek(lex, 0).codepoint;
 	ensure(is_decimal(first), "Not on a number");
-	Token token = {0};
 
 	rune second = lexer_peek(lex, 1).codepoint;
 	int base = 10;
 
-	if(first == '0' && is_alpha(second)){
+	if(first == '0' && is_alpha(second) && second != 'e' && second != 'E'){
 		switch(second){
 		case 'b': case 'B': base = 2; break;
 		case 'o': case 'O': base = 8; break;
 		case 'x': case 'X': base = 16; break;
 		default: {
-			lexer_emit_error(lex, LexerError_InvalidBase, "Invalid base prefix: '%c'\n", second);
-			return token;
+			isize start = lex->current;
+			lex->current += 1;
+			lexer_emit_error(lex, LexerError_InvalidBase, "Invalid base prefix: '%c'", second);
+			return lexer_recover(lex, start);
 		} break;
 		}
 	}
@@ -317,14 +424,131 @@ Token lexer_consume_number(Lexer* lex){
 		return lexer_consume_non_decimal_integer(lex, base);
 	}
 
-	token = lexer_consume_decimal(lex);
-	return token;
+	return lexer_consume_decimal(lex);
+}
+
+#define LEXER_MAX_UNICODE_ESCAPE 6
+
+/* Parses the digits of `\u{...}` starting after the 'u', returns -1 when malformed */
+static
+rune lexer_parse_unicode_escape(String s, isize* pos){
+	isize i = *pos;
+	if(i >= s.len || s.v[i] != '{'){ return -1; }
+	i += 1;
+
+	rune value = 0;
+	isize digits = 0;
+	while(i < s.len && s.v[i] != '}'){
+		rune c = s.v[i];
+		if(!is_hexadecimal(c) || digits >= LEXER_MAX_UNICODE_ESCAPE){ return -1; }
+		rune dig = is_decimal(c) ? (c - '0') : ((c | 0x20) - 'a' + 10);
+		value = (value << 4) | dig;
+		digits += 1;
+		i += 1;
+	}
+	if(i >= s.len || digits == 0){ return -1; }
+
+	*pos = i + 1;
+	if(value > 0x10ffff || (value >= 0xd800 && value <= 0xdfff)){ return -1; }
+	return value;
+}
+
+/* Validates the escape sequence after a backslash, leaving `current` past it */
+static
+void lexer_consume_escape(Lexer* lex){
+	isize escape_start = lex->current - 1;
+	UTF8Decoded dec = lexer_peek(lex, 0);
+	if(lexer_done(lex)){ return; }
+	lex->current += dec.len;
+
+	if(dec.codepoint == 'u'){
+		if(lexer_parse_unicode_escape(lex->source, &lex->current) < 0){
+			lexer_emit_error_at(lex, escape_start, LexerError_InvalidEscape, "Invalid unicode escape, expected '\\u{X}' with up to 6 hex digits");
+		}
+	}
+	else if(escape_rune(dec.codepoint) < 0){
+		String seq = str_sub(lex->source, escape_start, lex->current);
+		lexer_emit_error_at(lex, escape_start, LexerError_InvalidEscape, "Invalid escape sequence: '%.*s'", str_fmt(seq));
+	}
 }
 
 Token lexer_consume_string(Lexer* lex){
-	unimplemented("String");
+	isize start = lex->current - 1;
+	ensure(start >= 0 && lex->source.v[start] == '"', "Not on a string");
+
+	Token token = {
+		.kind = TokenKind_String,
+	};
+
+	/* Jump straight to the next quote or backslash, everything in between is content */
+	for(;;){
+		byte const* rest = lex->source.v + lex->current;
+		isize found = mem_find_byte2(rest, lex->source.len - lex->current, '"', '\\');
+		if(found < 0){
+			lex->current = lex->source.len;
+			lexer_emit_error_at(lex, start, LexerError_UnclosedString, "Unterminated string literal");
+			token.kind = TokenKind_Unknown;
+			break;
+		}
+
+		lex->current += found + 1;
+		if(rest[found] == '"'){
+			break;
+		}
+
+		token.value.escaped = true;
+		lexer_consume_escape(lex);
+	}
+
+	token.lexeme = str_sub(lex->source, start, lex->current);
+	return token;
 }
 
+String token_string_value(Token token, Arena* arena){
+	ensure(token.kind == TokenKind_String && token.lexeme.len >= 2, "Not a string literal");
+	String content = str_sub(token.lexeme, 1, token.lexeme.len - 1);
+	if(!token.value.escaped){
+		return content;
+	}
+
+	/* Escapes never expand, so the literal's length bounds the output */
+	byte* buf = arena_alloc(arena, content.len, 1);
+	if(buf == NULL){ return (String){0}; }
+	isize n = 0;
+
+	for(isize i = 0; i < content.len;){
+		isize found = mem_find_byte2(content.v + i, content.len - i, '\\', '\\');
+		isize chunk = found < 0 ? content.len - i : found;
+		mem_copy_no_overlap(buf + n, content.v + i, chunk);
+		n += chunk;
+		i += chunk + 1;
+		if(found < 0 || i >= content.len){ break; }
+
+		rune r = 0;
+		if(content.v[i] == 'u'){
+			i += 1;
+			r = lexer_parse_unicode_escape(content, &i);
+		} else {
+			r = escape_rune(content.v[i]);
+			i += 1;
+		}
+
+		if(r < 0){
+			continue; /* Already reported while lexing */
+		}
+		UTF8Encoded enc = utf8_encode(r);
+		mem_copy_no_overlap(buf + n, enc.bytes, enc.len);
+		n += enc.len;
+	}
+
+	if(n > 0){
+		arena_resize_in_place(arena, buf, n);
+	}
+	return (String){ .v = buf, .len = n };
+}
+
+#undef LEXER_MAX_UNICODE_ESCAPE
+
 // Lexer helpers to make it cleaner to read
 #define MATCH_NEXT(Char, TType) if(lexer_match_advance(lex, Char)){ token.kind = TokenKind_##TType; break; }
 #define MATCH_DEFAULT(TType)    { token.kind = TokenKind_##TType; break; }
@@ -334,11 +558,15 @@ Token lexer_next_token(Lexer* lex){
 		.kind = TokenKind_Unknown,
 	};
 
+	isize start = lex->current;
 	UTF8Decoded dec = lexer_advance(lex);
 	rune c = dec.codepoint;
 
 	if(c == 0){
+		/* Empty lexeme at the end so EOF still has an offset */
 		token.kind = TokenKind_EndOfFile;
+		token.lexeme = str_sub(lex->source, lex->source.len, lex->source.len);
+		lex->current = lex->source.len;
 		return token;
 	}
 
@@ -442,21 +670,183 @@ Token lexer_next_token(Lexer* lex){
 		} break;
 
 		default: {
-			if(is_alpha(c) || c == '_'){
-				lex->current -= 1;
+			if(is_identifier_start(c)){
+				lex->current -= dec.len;
 				token = lexer_consume_identifier_or_keyword(lex);
 			}
 			else if(is_decimal(c)){
 				lex->current -= 1;
 				token = lexer_consume_number(lex);
 			}
+			else {
+				token.lexeme = str_sub(lex->source, lex->current - dec.len, lex->current);
+				lexer_emit_error_at(lex, lex->current - dec.len, LexerError_UnknownCodepoint, "Unexpected character: '%.*s' (U+%04X)", str_fmt(token.lexeme), (u32)c);
+			}
 		} break;
 	}
 
+	if(token.lexeme.v == NULL){
+		token.lexeme = str_sub(lex->source, start, lex->current);
+	}
 	return token;
 }
 
+typedef DynArray(Token) TokenList;
+
+TokenArray lexer_tokenize(Lexer* lex, Arena* arena){
+	/* Roughly one token per 4 bytes of source, grown on demand */
+	TokenList tokens = { .arena = arena };
+	dyn_reserve(&tokens, max(lex->source.len / 4, (isize)16));
+
+	for(;;){
+		Token tk = lexer_next_token(lex);
+		if(tk.kind == TokenKind_Whitespace || tk.kind == TokenKind_Comment){
+			continue;
+		}
+
+		dyn_push(&tokens, tk);
+		if(tk.kind == TokenKind_EndOfFile){ break; }
+	}
+	return (TokenArray){ .v = tokens.v, .len = tokens.len };
+}
+
+typedef struct {
+	PackedTokenArray out;
+	u32 cap;
+	u32 literal_cap;
+	Arena* arena;
+} TokenPacker;
+
+static
+TokenPacker token_packer_create(String source, isize expected_tokens, Arena* arena){
+	ensure(source.len < (isize)UINT32_MAX, "Source is too large for packed tokens");
+	TokenPacker pk = {
+		.cap = (u32)max(expected_tokens, (isize)16),
+		.literal_cap = (u32)max(expected_tokens / 8, (isize)16),
+		.arena = arena,
+	};
+	pk.out.source = source;
+	pk.out.v = arena_make(arena, PackedToken, pk.cap);
+	pk.out.literals = arena_make(arena, PackedLiteral, pk.literal_cap);
+	ensure(pk.out.v != NULL && pk.out.literals != NULL, "Failed to allocate tokens");
+	return pk;
+}
+
+static inline
+bool token_has_literal(Token const* tk){
+	return tk->kind == TokenKind_Integer || tk->kind == TokenKind_Real || tk->kind == TokenKind_String
+		|| tk->lexeme.len >= (isize)PACKED_TOKEN_LONG;
+}
+
+static
+void token_packer_push(TokenPacker* pk, Token tk){
+	if(pk->out.len == pk->cap){
+		pk->out.v = arena_realloc(pk->arena, pk->out.v, pk->cap * sizeof(PackedToken), pk->cap * 2 * sizeof(PackedToken), alignof(PackedToken));
+		ensure(pk->out.v != NULL, "Failed to allocate tokens");
+		pk->cap *= 2;
+	}
+
+	bool long_token = tk.lexeme.len >= (isize)PACKED_TOKEN_LONG;
+	pk->out.v[pk->out.len] = (PackedToken){
+		.offset = (u32)(tk.lexeme.v - pk->out.source.v),
+		.len = long_token ? PACKED_TOKEN_LONG : (u32)tk.lexeme.len,
+		.kind = (u8)tk.kind,
+	};
+
+	if(token_has_literal(&tk)){
+		if(pk->out.literal_len == pk->literal_cap){
+			pk->out.literals = arena_realloc(pk->arena, pk->out.literals, pk->literal_cap * sizeof(PackedLiteral), pk->literal_cap * 2 * sizeof(PackedLiteral), alignof(PackedLiteral));
+			ensure(pk->out.literals != NULL, "Failed to allocate tokens");
+			pk->literal_cap *= 2;
+		}
+		PackedLiteral* lit = &pk->out.literals[pk->out.literal_len];
+		lit->token = pk->out.len;
+		lit->len = (u32)tk.lexeme.len;
+		mem_copy_no_overlap(&lit->value, &tk.value, sizeof(lit->value));
+		pk->out.literal_len += 1;
+	}
+	pk->out.len += 1;
+}
+
+PackedTokenArray lexer_tokenize_packed(Lexer* lex, Arena* arena){
+	TokenPacker pk = token_packer_create(lex->source, lex->source.len / 4, arena);
+	for(;;){
+		Token tk = lexer_next_token(lex);
+		if(tk.kind == TokenKind_Whitespace || tk.kind == TokenKind_Comment){
+			continue;
+		}
+		token_packer_push(&pk, tk);
+		if(tk.kind == TokenKind_EndOfFile){ break; }
+	}
+	return pk.out;
+}
+
+PackedTokenArray token_pack(TokenArray tokens, String source, Arena* arena){
+	TokenPacker pk = token_packer_create(source, tokens.len, arena);
+	for(isize i = 0; i < tokens.len; i += 1){
+		token_packer_push(&pk, tokens.v[i]);
+	}
+	return pk.out;
+}
+
+static
+PackedLiteral const* packed_token_literal(PackedTokenArray const* tokens, u32 index){
+	u32 lo = 0, hi = tokens->literal_len;
+	while(lo < hi){
+		u32 mid = lo + (hi - lo) / 2;
+		if(tokens->literals[mid].token < index){ lo = mid + 1; } else { hi = mid; }
+	}
+	if(lo < tokens->literal_len && tokens->literals[lo].token == index){
+		return &tokens->literals[lo];
+	}
+	return NULL;
+}
+
+String packed_token_lexeme(PackedTokenArray const* tokens, u32 index){
+	PackedToken tk = tokens->v[index];
+	isize len = tk.len;
+	if(tk.len == PACKED_TOKEN_LONG){
+		len = packed_token_literal(tokens, index)->len;
+	}
+	return str_sub(tokens->source, tk.offset, tk.offset + len);
+}
+
+Token packed_token_unpack(PackedTokenArray const* tokens, u32 index){
+	Token out = {
+		.lexeme = packed_token_lexeme(tokens, index),
+		.kind = tokens->v[index].kind,
+	};
+	PackedLiteral const* lit = packed_token_literal(tokens, index);
+	if(lit != NULL){
+		mem_copy_no_overlap(&out.value, &lit->value, sizeof(out.value));
+	}
+	return out;
+}
+
+TokenArray token_unpack(PackedTokenArray const* tokens, Arena* arena){
+	TokenArray out = {
+		.v = arena_make(arena, Token, max(tokens->len, (u32)1)),
+		.len = tokens->len,
+	};
+	ensure(out.v != NULL, "Failed to allocate tokens");
+
+	u32 lit = 0;
+	for(u32 i = 0; i < tokens->len; i += 1){
+		PackedToken tk = tokens->v[i];
+		Token* t = &out.v[i];
+		t->kind = tk.kind;
+		isize len = tk.len;
+		/* Walk the literal table alongside instead of searching it per token */
+		if(lit < tokens->literal_len && tokens->literals[lit].token == i){
+			len = tokens->literals[lit].len;
+			mem_copy_no_overlap(&t->value, &tokens->literals[lit].value, sizeof(t->value));
+			lit += 1;
+		}
+		t->lexeme = str_sub(tokens->source, tk.offset, tk.offset + len);
+	}
+	return out;
+}
+
 #undef MATCH_NEXT
 #undef MATCH_DEFAULT
 
-#undef LEXER_MAX_DIGIT_COUNT
@@ -3,27 +3,35 @@
 #include "base/string.h"
 #include "base/memory.h"
 #include "kielo.h"
+#include "errors.c"
+#include "tokens.c"
 #include "lexer.c"
+#include "parser.c"
+#include "checker.c"
+#include "ir.c"
+#include "opt.c"
+#include "bytecode.c"
+#include "vm.c"
+#include "native.c"
+#include "cache.c"
+#include "driver.c"
+#include "server.c"
 
-void print_compiler_error(CompilerError const* err){
-	printf(TERM_COLOR_RED "error" TERM_COLOR_RESET " (%.*s:%lld) %.*s\n",
-		str_fmt(err->filename),
-		(long long)err->offset,
-		str_fmt(err->message));
-}
-
-#define mem_GiB (1024ll * 1024ll * 1024ll)
+#include <stdlib.h>
 
-int main(){
-#define BIG_SIZE 64 * mem_GiB
-	return 0;
+int main(int argc, char const** argv){
+#if defined(MEM_ACCOUNTING)
+	atexit(mem_accounting_report);
+#endif
+	return driver_main(argc, argv);
 }
 
 #if 0
 int main(){
 	const isize arena_size = 8 * mem_megabyte;
 	byte* arena_mem = heap_alloc(arena_size, 4096);
-	Arena arena = arena_create(arena_mem, arena_size);
+	Arena arena = arena_create_dynamic(arena_mem, arena_size);
+	arena_set_tag(&arena, "lexer");
 
 	String source = str_lit(
 		"//+-*/%+=-=*=/=%=>><<<><=>=!!=&|~&&&=|||=\n"
@@ -57,9 +65,10 @@ int main(){
 	} while(1);
 
 	for(CompilerError* err = lex.error; err != NULL; err = err->next){
-		print_compiler_error(err);
+		print_compiler_error(stdout, err);
 	}
 
+	arena_destroy(&arena);
 	heap_free(arena_mem);
 }
 #endif
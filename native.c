@@ -0,0 +1,1780 @@
+#include "kielo.h"
+
+//// Encoding
+/* General purpose registers in encoding order */
+enum {
+	X64_RAX, X64_RCX, X64_RDX, X64_RBX, X64_RSP, X64_RBP, X64_RSI, X64_RDI,
+	X64_R8, X64_R9, X64_R10, X64_R11, X64_R12, X64_R13, X64_R14, X64_R15,
+};
+
+/* Added to the Jcc, SETcc and CMOVcc opcodes, flipping the low bit negates a condition */
+typedef enum {
+	X64_O, X64_NO, X64_B, X64_AE, X64_E, X64_NE, X64_BE, X64_A,
+	X64_S, X64_NS, X64_P, X64_NP, X64_L, X64_GE, X64_LE, X64_G,
+} X64Cond;
+
+/* Operation of the two operand ALU opcodes, also the /digit of the immediate forms */
+typedef enum {
+	X64Alu_Add = 0,
+	X64Alu_Or  = 1,
+	X64Alu_And = 4,
+	X64Alu_Sub = 5,
+	X64Alu_Xor = 6,
+	X64Alu_Cmp = 7,
+} X64Alu;
+
+typedef DynArray(u8) X64Code;
+
+enum { X64Rm_Reg, X64Rm_Mem, X64Rm_Rip };
+
+/* Register or memory side of a ModRM byte */
+typedef struct {
+	u8 kind;
+	u8 reg;   /* Register, or base of a memory operand */
+	i32 disp;
+} X64Rm;
+
+static inline
+X64Rm x64_reg(u8 reg){
+	return (X64Rm){ .kind = X64Rm_Reg, .reg = reg };
+}
+
+static inline
+X64Rm x64_mem(u8 base, i32 disp){
+	return (X64Rm){ .kind = X64Rm_Mem, .reg = base, .disp = disp };
+}
+
+/* The displacement is written as 0 and patched once the target is placed */
+static inline
+X64Rm x64_rip(void){
+	return (X64Rm){ .kind = X64Rm_Rip };
+}
+
+static inline
+void x64_byte(X64Code* c, u8 b){
+	dyn_push(c, b);
+}
+
+static
+void x64_u32(X64Code* c, u32 v){
+	dyn_reserve(c, 4);
+	for(i32 i = 0; i < 4; i += 1){
+		c->v[c->len++] = (u8)(v >> (8 * i));
+	}
+}
+
+static
+void x64_u64(X64Code* c, u64 v){
+	x64_u32(c, (u32)v);
+	x64_u32(c, (u32)(v >> 32));
+}
+
+static
+void x64_patch_u32(u8* code, u32 at, u32 v){
+	for(i32 i = 0; i < 4; i += 1){
+		code[at + i] = (u8)(v >> (8 * i));
+	}
+}
+
+/* Points the rel32 at `at` to `target`, both offsets in the same buffer */
+static
+void x64_patch_rel32(X64Code* c, u32 at, u32 target){
+	x64_patch_u32(c->v, at, target - (at + 4));
+}
+
+/* Mandatory prefix (0 for none), REX, opcode and ModRM of `reg` against `rm`. Opcodes are one to
+   three bytes, most significant first. Returns where a RIP displacement was written, 0 for other
+   operands, an instruction using one must end with it. */
+static
+u32 x64_modrm(X64Code* c, u8 prefix, bool wide, u32 opcode, u8 reg, X64Rm rm){
+	if(prefix != 0){
+		x64_byte(c, prefix);
+	}
+	u8 rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm.kind == X64Rm_Rip ? 0 : rm.reg >> 3);
+	if(rex != 0x40){
+		x64_byte(c, rex);
+	}
+	if(opcode > 0xffff){ x64_byte(c, (u8)(opcode >> 16)); }
+	if(opcode > 0xff){ x64_byte(c, (u8)(opcode >> 8)); }
+	x64_byte(c, (u8)opcode);
+
+	u8 r = (reg & 7) << 3;
+	switch(rm.kind){
+	case X64Rm_Reg:
+		x64_byte(c, 0xc0 | r | (rm.reg & 7));
+		return 0;
+	case X64Rm_Rip:
+		x64_byte(c, 0x05 | r);
+		x64_u32(c, 0);
+		return (u32)c->len - 4;
+	default: {
+		/* rbp and r13 have no form without displacement, rsp and r12 need a SIB byte */
+		u8 base = rm.reg & 7;
+		u8 mod = (rm.disp == 0 && base != X64_RBP) ? 0x00 : (rm.disp >= -128 && rm.disp <= 127) ? 0x40 : 0x80;
+		x64_byte(c, mod | r | base);
+		if(base == X64_RSP){ x64_byte(c, 0x24); }
+		if(mod == 0x40){ x64_byte(c, (u8)rm.disp); }
+		if(mod == 0x80){ x64_u32(c, (u32)rm.disp); }
+		return 0;
+	}
+	}
+}
+
+static
+void x64_mov_load(X64Code* c, u8 dst, X64Rm src){
+	if(src.kind == X64Rm_Reg && src.reg == dst){ return; }
+	x64_modrm(c, 0, true, 0x8b, dst, src);
+}
+
+static
+u32 x64_mov_store(X64Code* c, X64Rm dst, u8 src){
+	if(dst.kind == X64Rm_Reg && dst.reg == src){ return 0; }
+	return x64_modrm(c, 0, true, 0x89, src, dst);
+}
+
+// reg = reg op rm
+static
+u32 x64_alu(X64Code* c, X64Alu op, u8 reg, X64Rm rm){
+	return x64_modrm(c, 0, true, (op << 3) | 3, reg, rm);
+}
+
+static
+void x64_alu_imm(X64Code* c, X64Alu op, X64Rm rm, i32 imm){
+	if(imm >= -128 && imm <= 127){
+		x64_modrm(c, 0, true, 0x83, op, rm);
+		x64_byte(c, (u8)imm);
+	}
+	else {
+		x64_modrm(c, 0, true, 0x81, op, rm);
+		x64_u32(c, (u32)imm);
+	}
+}
+
+// Shortest encoding, zero is a xor and clobbers the flags
+static
+void x64_mov_imm(X64Code* c, u8 reg, i64 imm){
+	if(imm == 0){
+		x64_modrm(c, 0, false, 0x31, reg, x64_reg(reg));
+	}
+	else if((u64)imm <= 0xffffffff){
+		if(reg >= 8){ x64_byte(c, 0x41); }
+		x64_byte(c, 0xb8 + (reg & 7));
+		x64_u32(c, (u32)imm);
+	}
+	else if(imm >= INT32_MIN && imm <= INT32_MAX){
+		x64_modrm(c, 0, true, 0xc7, 0, x64_reg(reg));
+		x64_u32(c, (u32)imm);
+	}
+	else {
+		x64_byte(c, 0x48 | (reg >> 3));
+		x64_byte(c, 0xb8 + (reg & 7));
+		x64_u64(c, (u64)imm);
+	}
+}
+
+/* Group 3 by /digit: 2 not, 3 neg, 6 div, 7 idiv */
+static
+void x64_unary(X64Code* c, u8 digit, X64Rm rm){
+	x64_modrm(c, 0, true, 0xf7, digit, rm);
+}
+
+/* Shift by cl, /digit: 4 shl, 7 sar */
+static
+void x64_shift_cl(X64Code* c, u8 digit, X64Rm rm){
+	x64_modrm(c, 0, true, 0xd3, digit, rm);
+}
+
+static
+void x64_imul(X64Code* c, u8 reg, X64Rm rm){
+	x64_modrm(c, 0, true, 0x0faf, reg, rm);
+}
+
+static
+void x64_test(X64Code* c, u8 reg, X64Rm rm){
+	x64_modrm(c, 0, true, 0x85, reg, rm);
+}
+
+static
+u32 x64_lea(X64Code* c, u8 reg, X64Rm rm){
+	return x64_modrm(c, 0, true, 0x8d, reg, rm);
+}
+
+/* Only al, cl, dl and bl, the other byte registers need a REX prefix */
+static
+void x64_setcc(X64Code* c, X64Cond cc, u8 reg){
+	x64_modrm(c, 0, false, 0x0f90 | cc, 0, x64_reg(reg));
+}
+
+static
+void x64_cmov(X64Code* c, X64Cond cc, u8 reg, X64Rm rm){
+	x64_modrm(c, 0, true, 0x0f40 | cc, reg, rm);
+}
+
+// Returns where the rel32 goes
+static
+u32 x64_jcc(X64Code* c, X64Cond cc){
+	x64_byte(c, 0x0f);
+	x64_byte(c, 0x80 | cc);
+	x64_u32(c, 0);
+	return (u32)c->len - 4;
+}
+
+static
+u32 x64_jmp(X64Code* c){
+	x64_byte(c, 0xe9);
+	x64_u32(c, 0);
+	return (u32)c->len - 4;
+}
+
+static
+u32 x64_call(X64Code* c){
+	x64_byte(c, 0xe8);
+	x64_u32(c, 0);
+	return (u32)c->len - 4;
+}
+
+static
+void x64_push(X64Code* c, u8 reg){
+	if(reg >= 8){ x64_byte(c, 0x41); }
+	x64_byte(c, 0x50 + (reg & 7));
+}
+
+static
+void x64_pop(X64Code* c, u8 reg){
+	if(reg >= 8){ x64_byte(c, 0x41); }
+	x64_byte(c, 0x58 + (reg & 7));
+}
+
+static
+void x64_syscall(X64Code* c){
+	x64_byte(c, 0x0f);
+	x64_byte(c, 0x05);
+}
+
+/* Scalar double operations, `reg` is an XMM register */
+enum {
+	X64Sse_Load    = 0xf20f10, /* movsd xmm, m64 */
+	X64Sse_Store   = 0xf20f11, /* movsd m64, xmm */
+	X64Sse_Add     = 0xf20f58,
+	X64Sse_Mul     = 0xf20f59,
+	X64Sse_Sub     = 0xf20f5c,
+	X64Sse_Div     = 0xf20f5e,
+	X64Sse_Ucomi   = 0x660f2e,
+	X64Sse_Xor     = 0x660f57,
+	X64Sse_Copy    = 0x000f28, /* movaps between registers */
+	X64Sse_FromGpr = 0x660f6e, /* movq xmm, r64 */
+	X64Sse_ToGpr   = 0x660f7e, /* movq r64, xmm */
+};
+
+static
+u32 x64_sse(X64Code* c, u32 op, u8 reg, X64Rm rm){
+	bool wide = op == X64Sse_FromGpr || op == X64Sse_ToGpr;
+	return x64_modrm(c, (u8)(op >> 16), wide, op & 0xffff, reg, rm);
+}
+
+//// Locations
+enum {
+	NativeLoc_None,
+	NativeLoc_Gpr,
+	NativeLoc_Xmm,
+	NativeLoc_Stack, /* rbp relative */
+	NativeLoc_Out,   /* rsp relative, outgoing arguments */
+};
+
+typedef struct {
+	u8 kind;
+	u8 reg;
+	i32 disp;
+} NativeLoc;
+
+static inline
+NativeLoc native_gpr(u8 reg){
+	return (NativeLoc){ .kind = NativeLoc_Gpr, .reg = reg };
+}
+
+static inline
+NativeLoc native_xmm(u8 reg){
+	return (NativeLoc){ .kind = NativeLoc_Xmm, .reg = reg };
+}
+
+static inline
+bool native_in_reg(NativeLoc l){
+	return l.kind == NativeLoc_Gpr || l.kind == NativeLoc_Xmm;
+}
+
+static inline
+bool native_same_reg(NativeLoc l, u8 reg){
+	return native_in_reg(l) && l.reg == reg;
+}
+
+static
+X64Rm native_rm(NativeLoc l){
+	switch(l.kind){
+	case NativeLoc_Stack: return x64_mem(X64_RBP, l.disp);
+	case NativeLoc_Out:   return x64_mem(X64_RSP, l.disp);
+	default:              return x64_reg(l.reg);
+	}
+}
+
+/* rax, rcx, rdx and r11 are scratch registers of instruction sequences, so are xmm14 and xmm15.
+   The allocator hands out the rest, caller saved ones first for values that do not live across a
+   call. XMM registers are all caller saved. */
+#define NATIVE_POOL 5
+static u8 const native_caller_saved[NATIVE_POOL] = { X64_RSI, X64_RDI, X64_R8, X64_R9, X64_R10 };
+static u8 const native_callee_saved[NATIVE_POOL] = { X64_RBX, X64_R12, X64_R13, X64_R14, X64_R15 };
+#define NATIVE_XMM_COUNT 14
+#define NATIVE_GPR_SWAP X64_R11
+#define NATIVE_XMM_SWAP 14
+#define NATIVE_XMM_TEMP 15
+
+#define NATIVE_INT_ARGS 6
+static u8 const native_int_args[NATIVE_INT_ARGS] = { X64_RDI, X64_RSI, X64_RDX, X64_RCX, X64_R8, X64_R9 };
+#define NATIVE_REAL_ARGS 8
+
+//// Emitter
+typedef struct {
+	u32 at;
+	u32 target; /* Block, function or trap */
+} NativePatch;
+
+typedef struct {
+	NativeLoc dst;
+	NativeLoc src;
+	bool real;
+} NativeMove;
+
+typedef struct {
+	IrModule const* module;
+	Arena* arena;
+	X64Code code;
+	DynArray(NativeFixup) fixups;
+	DynArray(NativeTrap) traps;
+	DynArray(NativePatch) calls;
+	u32 trap_slot;
+	u32 stack_slot;
+
+	/* Function being emitted */
+	IrFunction const* fn;
+	u32* pos;         /* Of each instruction, 0 is the prologue */
+	u32* block_of;    /* Of each instruction */
+	u32* start;       /* Live interval of each value, inclusive */
+	u32* end;
+	u32* use_count;
+	u8* fused;        /* Comparisons folded into the branch that follows them */
+	NativeLoc* loc;
+	u32* block_code;  /* Code offset of each block */
+	DynArray(NativePatch) jumps;
+	DynArray(NativePatch) stubs; /* Checks jumping to a trap, by trap index */
+	DynArray(NativeMove) moves;
+	u8 saved[NATIVE_POOL];
+	u32 saved_count;
+	u32 slot_count;
+} NativeEmitter;
+
+static inline
+bool native_is_real(NativeEmitter const* e, u32 value){
+	return e->fn->insts.v[value].type == ConstKind_Real;
+}
+
+static inline
+u32 native_block_end(IrFunction const* f, u32 block){
+	return f->blocks.v[block].first + f->blocks.v[block].count - 1;
+}
+
+//// Live intervals
+/* Extends the interval of `v` over every block between its definition and `block`, where it is
+   live on entry. Walks up the predecessors, `stamp` remembers the blocks seen for `v`. */
+static
+void native_live_in(NativeEmitter* e, u32 v, u32 block, u32* stamp, u32* stack){
+	IrFunction const* f = e->fn;
+	u32 def_block = e->block_of[v];
+	u32 depth = 0;
+	if(block == def_block || stamp[block] == v + 1){ return; }
+	stamp[block] = v + 1;
+	stack[depth++] = block;
+
+	while(depth > 0){
+		IrBlock const* blk = &f->blocks.v[stack[--depth]];
+		e->start[v] = min(e->start[v], e->pos[blk->first]);
+		e->end[v] = max(e->end[v], e->pos[blk->first]);
+		for(u32 p = 0; p < blk->pred_count; p += 1){
+			u32 pred = f->preds.v[blk->pred_start + p];
+			e->end[v] = max(e->end[v], e->pos[native_block_end(f, pred)]);
+			if(pred != def_block && stamp[pred] != v + 1){
+				stamp[pred] = v + 1;
+				stack[depth++] = pred;
+			}
+		}
+	}
+}
+
+/* One interval per value, the hull of every position where it is live. Phi operands are used at
+   the end of their predecessor, where the edge's moves happen. */
+static
+void native_intervals(NativeEmitter* e){
+	IrFunction const* f = e->fn;
+	Arena* arena = e->arena;
+	u32 inst_count = (u32)f->insts.len;
+	u32 block_count = (u32)f->blocks.len;
+
+	e->pos = arena_make(arena, u32, inst_count);
+	e->block_of = arena_make(arena, u32, inst_count);
+	e->start = arena_make(arena, u32, inst_count);
+	e->end = arena_make(arena, u32, inst_count);
+	e->use_count = arena_make(arena, u32, inst_count + 1);
+	e->fused = arena_make(arena, u8, inst_count);
+	ensure(e->pos && e->block_of && e->start && e->end && e->use_count && e->fused, "Failed to allocate native code scratch");
+	mem_set(e->use_count, 0, (inst_count + 1) * sizeof(u32));
+	mem_set(e->fused, 0, inst_count);
+
+	u32 next = 1;
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		ensure(blk->count > 0, "Native code needs a compacted function");
+		for(u32 i = blk->first; i < blk->first + blk->count; i += 1){
+			e->pos[i] = next++;
+			e->block_of[i] = b;
+		}
+	}
+
+	/* Phis are all written by the moves of an edge and parameters by the prologue, so they
+	   start together and cannot share a register */
+	for(u32 i = 0; i < inst_count; i += 1){
+		IrInst const* inst = &f->insts.v[i];
+		e->start[i] = inst->op == IrOp_Param ? 0 :
+			inst->op == IrOp_Phi ? e->pos[f->blocks.v[e->block_of[i]].first] : e->pos[i];
+		e->end[i] = e->start[i];
+	}
+
+	/* Use sites grouped by value: block and position */
+	u32 use_total = 0;
+	for(u32 i = 0; i < inst_count; i += 1){
+		IrUses uses = ir_uses((IrFunction*)f, &f->insts.v[i]);
+		for(u32 k = 0; k < uses.len; k += 1){
+			e->use_count[uses.v[k]] += 1;
+		}
+		use_total += uses.len;
+	}
+	u32* site_start = arena_make(arena, u32, inst_count + 1);
+	u32* site_block = arena_make(arena, u32, max(use_total, 1u));
+	u32* site_pos = arena_make(arena, u32, max(use_total, 1u));
+	ensure(site_start && site_block && site_pos, "Failed to allocate native code scratch");
+	u32 total = 0;
+	for(u32 v = 0; v < inst_count; v += 1){
+		site_start[v] = total;
+		total += e->use_count[v];
+	}
+	site_start[inst_count] = total;
+
+	u32* fill = arena_make(arena, u32, max(inst_count, 1u));
+	ensure(fill != NULL, "Failed to allocate native code scratch");
+	mem_copy_no_overlap(fill, site_start, inst_count * sizeof(u32));
+	for(u32 i = 0; i < inst_count; i += 1){
+		IrInst* inst = &f->insts.v[i];
+		IrUses uses = ir_uses((IrFunction*)f, inst);
+		for(u32 k = 0; k < uses.len; k += 1){
+			u32 block = e->block_of[i];
+			if(inst->op == IrOp_Phi){
+				block = f->operands.v[inst->a + inst->b + k];
+			}
+			u32 at = fill[uses.v[k]]++;
+			site_block[at] = block;
+			site_pos[at] = inst->op == IrOp_Phi ? e->pos[native_block_end(f, block)] : e->pos[i];
+		}
+	}
+
+	u32* stamp = arena_make(arena, u32, max(block_count, 1u));
+	u32* stack = arena_make(arena, u32, max(block_count, 1u));
+	ensure(stamp && stack, "Failed to allocate native code scratch");
+	mem_set(stamp, 0, block_count * sizeof(u32));
+	for(u32 v = 0; v < inst_count; v += 1){
+		for(u32 s = site_start[v]; s < site_start[v + 1]; s += 1){
+			e->end[v] = max(e->end[v], site_pos[s]);
+			native_live_in(e, v, site_block[s], stamp, stack);
+		}
+	}
+
+	/* A comparison used only by the branch right after it becomes the branch's flags, its
+	   operands are read by the branch */
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		IrInst const* br = &f->insts.v[blk->first + blk->count - 1];
+		if(br->op != IrOp_Branch || blk->count < 2 || br->a != blk->first + blk->count - 2 || e->use_count[br->a] != 1){
+			continue;
+		}
+		IrInst const* cmp = &f->insts.v[br->a];
+		bool compare = cmp->op == IrOp_Eq || cmp->op == IrOp_Ne || cmp->op == IrOp_Lt || cmp->op == IrOp_Le;
+		if(compare && f->insts.v[cmp->a].type != ConstKind_Real){
+			e->fused[br->a] = 1;
+			u32 at = e->pos[blk->first + blk->count - 1];
+			e->end[cmp->a] = max(e->end[cmp->a], at);
+			e->end[cmp->b] = max(e->end[cmp->b], at);
+		}
+	}
+}
+
+//// Register allocation
+static
+NativeLoc native_new_slot(NativeEmitter* e){
+	/* Numbered for now, turned into frame offsets once the saved registers are known */
+	NativeLoc l = { .kind = NativeLoc_Stack, .disp = (i32)e->slot_count };
+	e->slot_count += 1;
+	return l;
+}
+
+static
+bool native_is_callee_saved(u8 reg){
+	for(u32 i = 0; i < NATIVE_POOL; i += 1){
+		if(native_callee_saved[i] == reg){ return true; }
+	}
+	return false;
+}
+
+/* Linear scan over the intervals in order of their start, values that live across a call get a
+   callee saved register or a stack slot. When registers run out the interval ending last is
+   spilled for its whole lifetime. */
+static
+void native_allocate(NativeEmitter* e){
+	IrFunction const* f = e->fn;
+	Arena* arena = e->arena;
+	u32 inst_count = (u32)f->insts.len;
+	u32 pos_count = inst_count + 2;
+
+	/* calls_before[p] counts the calls at positions below p */
+	u32* calls_before = arena_make(arena, u32, pos_count);
+	u32* order = arena_make(arena, u32, max(inst_count, 1u));
+	e->loc = arena_make(arena, NativeLoc, max(inst_count, 1u));
+	ensure(calls_before && order && e->loc, "Failed to allocate native code scratch");
+	mem_set(calls_before, 0, pos_count * sizeof(u32));
+	for(u32 i = 0; i < inst_count; i += 1){
+		e->loc[i] = (NativeLoc){0};
+		if(f->insts.v[i].op == IrOp_Call){
+			calls_before[e->pos[i] + 1] = 1;
+		}
+	}
+	for(u32 p = 1; p < pos_count; p += 1){
+		calls_before[p] += calls_before[p - 1];
+	}
+
+	/* Parameters start at the prologue, everything else in code order */
+	u32 order_len = 0;
+	for(u32 pass = 0; pass < 2; pass += 1){
+		for(u32 b = 0; b < f->blocks.len; b += 1){
+			IrBlock const* blk = &f->blocks.v[b];
+			for(u32 i = blk->first; i < blk->first + blk->count; i += 1){
+				IrInst const* inst = &f->insts.v[i];
+				if(inst->type == ConstKind_None || e->fused[i] || (inst->op == IrOp_Param) != (pass == 0)){
+					continue;
+				}
+				order[order_len++] = i;
+			}
+		}
+	}
+
+	u32 active[NATIVE_POOL + NATIVE_POOL + NATIVE_XMM_COUNT];
+	u32 active_len = 0;
+	u32 gpr_free = 0;
+	for(u32 i = 0; i < NATIVE_POOL; i += 1){ gpr_free |= 1u << native_caller_saved[i]; }
+	for(u32 i = 0; i < NATIVE_POOL; i += 1){ gpr_free |= 1u << native_callee_saved[i]; }
+	u32 xmm_free = (1u << NATIVE_XMM_COUNT) - 1;
+	u32 used = 0;
+
+	for(u32 o = 0; o < order_len; o += 1){
+		u32 v = order[o];
+		u32 s = e->start[v];
+		for(u32 a = 0; a < active_len;){
+			u32 w = active[a];
+			if(e->end[w] < s){
+				if(e->loc[w].kind == NativeLoc_Gpr){ gpr_free |= 1u << e->loc[w].reg; }
+				else { xmm_free |= 1u << e->loc[w].reg; }
+				active[a] = active[--active_len];
+			}
+			else { a += 1; }
+		}
+
+		bool real = native_is_real(e, v);
+		bool crosses = e->end[v] > s + 1 && calls_before[e->end[v]] - calls_before[s + 1] > 0;
+		NativeLoc l = {0};
+		if(real){
+			if(!crosses && xmm_free != 0){
+				l = native_xmm((u8)bit_ctz32(xmm_free));
+				xmm_free &= ~(1u << l.reg);
+			}
+		}
+		else {
+			if(!crosses){
+				for(u32 i = 0; i < NATIVE_POOL && l.kind == NativeLoc_None; i += 1){
+					if(gpr_free & (1u << native_caller_saved[i])){ l = native_gpr(native_caller_saved[i]); }
+				}
+			}
+			for(u32 i = 0; i < NATIVE_POOL && l.kind == NativeLoc_None; i += 1){
+				if(gpr_free & (1u << native_callee_saved[i])){ l = native_gpr(native_callee_saved[i]); }
+			}
+			if(l.kind != NativeLoc_None){
+				gpr_free &= ~(1u << l.reg);
+			}
+		}
+
+		if(l.kind == NativeLoc_None){
+			/* Take the register of the active interval that ends last if it outlives this one */
+			u32 victim = IR_NONE;
+			for(u32 a = 0; a < active_len; a += 1){
+				u32 w = active[a];
+				bool fits = real ? !crosses && e->loc[w].kind == NativeLoc_Xmm :
+					e->loc[w].kind == NativeLoc_Gpr && (!crosses || native_is_callee_saved(e->loc[w].reg));
+				if(fits && e->end[w] > e->end[v] && (victim == IR_NONE || e->end[w] > e->end[active[victim]])){
+					victim = a;
+				}
+			}
+			if(victim != IR_NONE){
+				u32 w = active[victim];
+				l = e->loc[w];
+				e->loc[w] = native_new_slot(e);
+				active[victim] = v;
+			}
+			else {
+				e->loc[v] = native_new_slot(e);
+				continue;
+			}
+		}
+		else {
+			active[active_len++] = v;
+		}
+		e->loc[v] = l;
+		if(l.kind == NativeLoc_Gpr){ used |= 1u << l.reg; }
+	}
+
+	e->saved_count = 0;
+	for(u32 i = 0; i < NATIVE_POOL; i += 1){
+		if(used & (1u << native_callee_saved[i])){
+			e->saved[e->saved_count++] = native_callee_saved[i];
+		}
+	}
+	for(u32 i = 0; i < inst_count; i += 1){
+		if(e->loc[i].kind == NativeLoc_Stack){
+			e->loc[i].disp = -8 * (i32)(e->saved_count + (u32)e->loc[i].disp + 1);
+		}
+	}
+}
+
+//// Moves
+static
+void native_move(X64Code* c, NativeLoc dst, NativeLoc src, bool real){
+	bool dst_reg = native_in_reg(dst);
+	bool src_reg = native_in_reg(src);
+	if(dst.kind == src.kind && (dst_reg ? dst.reg == src.reg : dst.disp == src.disp)){
+		return;
+	}
+	if(real){
+		if(dst_reg){
+			x64_sse(c, src_reg ? X64Sse_Copy : X64Sse_Load, dst.reg, native_rm(src));
+		}
+		else if(src_reg){
+			x64_sse(c, X64Sse_Store, src.reg, native_rm(dst));
+		}
+		else {
+			x64_sse(c, X64Sse_Load, NATIVE_XMM_TEMP, native_rm(src));
+			x64_sse(c, X64Sse_Store, NATIVE_XMM_TEMP, native_rm(dst));
+		}
+	}
+	else {
+		if(dst_reg){
+			x64_mov_load(c, dst.reg, native_rm(src));
+		}
+		else if(src_reg){
+			x64_mov_store(c, native_rm(dst), src.reg);
+		}
+		else {
+			x64_mov_load(c, X64_RAX, native_rm(src));
+			x64_mov_store(c, native_rm(dst), X64_RAX);
+		}
+	}
+}
+
+static inline
+bool native_loc_equal(NativeLoc a, NativeLoc b){
+	return a.kind == b.kind && (native_in_reg(a) ? a.reg == b.reg : a.disp == b.disp);
+}
+
+/* Performs `e->moves` as if all at once. A move waits while its destination is still to be
+   read, a cycle of waiting moves is broken by copying one source to a swap register. */
+static
+void native_parallel_move(NativeEmitter* e){
+	NativeMove* moves = e->moves.v;
+	u32 count = (u32)e->moves.len;
+	for(u32 i = 0; i < count;){
+		if(native_loc_equal(moves[i].dst, moves[i].src)){
+			moves[i] = moves[--count];
+		}
+		else { i += 1; }
+	}
+
+	while(count > 0){
+		bool progress = false;
+		for(u32 i = 0; i < count;){
+			bool blocked = false;
+			for(u32 j = 0; j < count && !blocked; j += 1){
+				blocked = j != i && native_loc_equal(moves[j].src, moves[i].dst);
+			}
+			if(blocked){
+				i += 1;
+				continue;
+			}
+			native_move(&e->code, moves[i].dst, moves[i].src, moves[i].real);
+			moves[i] = moves[--count];
+			progress = true;
+		}
+		if(!progress){
+			NativeMove m = moves[0];
+			NativeLoc swap = m.real ? native_xmm(NATIVE_XMM_SWAP) : native_gpr(NATIVE_GPR_SWAP);
+			native_move(&e->code, swap, m.src, m.real);
+			for(u32 j = 0; j < count; j += 1){
+				if(native_loc_equal(moves[j].src, m.src)){ moves[j].src = swap; }
+			}
+		}
+	}
+	e->moves.len = 0;
+}
+
+static inline
+void native_add_move(NativeEmitter* e, NativeLoc dst, NativeLoc src, bool real){
+	dyn_push(&e->moves, ((NativeMove){ .dst = dst, .src = src, .real = real }));
+}
+
+//// Instructions
+static
+u32 native_fixup(NativeEmitter* e, u32 at, u32 data_offset){
+	dyn_push(&e->fixups, ((NativeFixup){ .at = at, .data_offset = data_offset }));
+	return at;
+}
+
+/* Jumps to a trap stub when `cc` holds */
+static
+void native_check(NativeEmitter* e, X64Cond cc, NativeTrapKind kind, u32 offset){
+	u32 at = x64_jcc(&e->code, cc);
+	dyn_push(&e->stubs, ((NativePatch){ .at = at, .target = (u32)e->traps.len }));
+	dyn_push(&e->traps, ((NativeTrap){ .offset = offset, .kind = kind }));
+}
+
+static
+void native_jump(NativeEmitter* e, u32 block, u32 next){
+	if(block != next){
+		u32 at = x64_jmp(&e->code);
+		dyn_push(&e->jumps, ((NativePatch){ .at = at, .target = block }));
+	}
+}
+
+static
+void native_jcc(NativeEmitter* e, X64Cond cc, u32 block){
+	u32 at = x64_jcc(&e->code, cc);
+	dyn_push(&e->jumps, ((NativePatch){ .at = at, .target = block }));
+}
+
+// Int or Bool operand in a register, `scratch` if it is in memory
+static
+u8 native_gpr_operand(NativeEmitter* e, NativeLoc l, u8 scratch){
+	if(l.kind == NativeLoc_Gpr){ return l.reg; }
+	x64_mov_load(&e->code, scratch, native_rm(l));
+	return scratch;
+}
+
+static
+void native_materialize(NativeEmitter* e, NativeLoc dst, u8 type, i64 bits){
+	X64Code* c = &e->code;
+	if(type == ConstKind_Real){
+		x64_mov_imm(c, X64_RAX, bits);
+		if(dst.kind == NativeLoc_Xmm){ x64_sse(c, X64Sse_FromGpr, dst.reg, x64_reg(X64_RAX)); }
+		else { x64_mov_store(c, native_rm(dst), X64_RAX); }
+	}
+	else if(dst.kind == NativeLoc_Gpr){
+		x64_mov_imm(c, dst.reg, bits);
+	}
+	else if(bits >= INT32_MIN && bits <= INT32_MAX){
+		x64_modrm(c, 0, true, 0xc7, 0, native_rm(dst));
+		x64_u32(c, (u32)bits);
+	}
+	else {
+		x64_mov_imm(c, X64_RAX, bits);
+		x64_mov_store(c, native_rm(dst), X64_RAX);
+	}
+}
+
+static
+void native_int_arith(NativeEmitter* e, IrInst const* inst, NativeLoc dst, NativeLoc lhs, NativeLoc rhs){
+	X64Code* c = &e->code;
+	X64Rm r = native_rm(rhs);
+	switch(inst->op){
+	case IrOp_Div: case IrOp_Mod: {
+		/* Zero traps first, then -1 is done apart: INT64_MIN / -1 overflows and idiv would fault */
+		x64_mov_load(c, X64_RCX, r);
+		x64_test(c, X64_RCX, x64_reg(X64_RCX));
+		native_check(e, X64_E, NativeTrap_DivisionByZero, inst->offset);
+		x64_mov_load(c, X64_RAX, native_rm(lhs));
+		x64_alu_imm(c, X64Alu_Cmp, x64_reg(X64_RCX), -1);
+		u32 general = x64_jcc(c, X64_NE);
+		if(inst->op == IrOp_Div){
+			x64_unary(c, 3, x64_reg(X64_RAX));
+			native_check(e, X64_O, NativeTrap_Overflow, inst->offset);
+		}
+		else {
+			x64_mov_imm(c, X64_RAX, 0);
+		}
+		u32 done = x64_jmp(c);
+		x64_patch_rel32(c, general, (u32)c->len);
+		x64_byte(c, 0x48); /* cqo */
+		x64_byte(c, 0x99);
+		x64_unary(c, 7, x64_reg(X64_RCX));
+		if(inst->op == IrOp_Mod){
+			x64_mov_load(c, X64_RAX, x64_reg(X64_RDX));
+		}
+		x64_patch_rel32(c, done, (u32)c->len);
+		x64_mov_store(c, native_rm(dst), X64_RAX);
+	} return;
+
+	case IrOp_Shl: case IrOp_Shr:
+		/* Unsigned compare, negative amounts are out of range too. The stub passes rcx along. */
+		x64_mov_load(c, X64_RCX, r);
+		x64_alu_imm(c, X64Alu_Cmp, x64_reg(X64_RCX), 63);
+		native_check(e, X64_A, NativeTrap_ShiftRange, inst->offset);
+		x64_mov_load(c, X64_RAX, native_rm(lhs));
+		x64_shift_cl(c, inst->op == IrOp_Shl ? 4 : 7, x64_reg(X64_RAX));
+		x64_mov_store(c, native_rm(dst), X64_RAX);
+		return;
+
+	case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le: {
+		static X64Cond const cond[] = { [IrOp_Eq] = X64_E, [IrOp_Ne] = X64_NE, [IrOp_Lt] = X64_L, [IrOp_Le] = X64_LE };
+		u8 l = native_gpr_operand(e, lhs, X64_RAX);
+		x64_alu(c, X64Alu_Cmp, l, r);
+		x64_setcc(c, cond[inst->op], X64_RAX);
+		x64_modrm(c, 0, false, 0x0fb6, X64_RAX, x64_reg(X64_RAX)); /* movzx eax, al */
+		x64_mov_store(c, native_rm(dst), X64_RAX);
+	} return;
+
+	default: break;
+	}
+
+	/* Two operand forms, straight into the destination unless it is the right operand */
+	u8 acc = dst.kind == NativeLoc_Gpr && !native_same_reg(rhs, dst.reg) ? dst.reg : X64_RAX;
+	x64_mov_load(c, acc, native_rm(lhs));
+	switch(inst->op){
+	case IrOp_Add: x64_alu(c, X64Alu_Add, acc, r); break;
+	case IrOp_Sub: x64_alu(c, X64Alu_Sub, acc, r); break;
+	case IrOp_Mul: x64_imul(c, acc, r); break;
+	case IrOp_And: x64_alu(c, X64Alu_And, acc, r); break;
+	case IrOp_Or:  x64_alu(c, X64Alu_Or, acc, r); break;
+	case IrOp_Xor: x64_alu(c, X64Alu_Xor, acc, r); break;
+	default: panic("Unexpected Int operation");
+	}
+	if(inst->op == IrOp_Add || inst->op == IrOp_Sub || inst->op == IrOp_Mul){
+		native_check(e, X64_O, NativeTrap_Overflow, inst->offset);
+	}
+	x64_mov_store(c, native_rm(dst), acc);
+}
+
+static
+void native_real_arith(NativeEmitter* e, IrInst const* inst, NativeLoc dst, NativeLoc lhs, NativeLoc rhs){
+	X64Code* c = &e->code;
+	switch(inst->op){
+	case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le: {
+		/* Unordered sets ZF, PF and CF: a < b is tested as b above a so NaN compares false */
+		if(inst->op == IrOp_Lt || inst->op == IrOp_Le){
+			native_move(c, native_xmm(NATIVE_XMM_TEMP), rhs, true);
+			x64_sse(c, X64Sse_Ucomi, NATIVE_XMM_TEMP, native_rm(lhs));
+			x64_setcc(c, inst->op == IrOp_Lt ? X64_A : X64_AE, X64_RAX);
+		}
+		else {
+			bool eq = inst->op == IrOp_Eq;
+			native_move(c, native_xmm(NATIVE_XMM_TEMP), lhs, true);
+			x64_sse(c, X64Sse_Ucomi, NATIVE_XMM_TEMP, native_rm(rhs));
+			x64_setcc(c, eq ? X64_E : X64_NE, X64_RAX);
+			x64_setcc(c, eq ? X64_NP : X64_P, X64_RCX);
+			x64_modrm(c, 0, false, eq ? 0x20 : 0x08, X64_RCX, x64_reg(X64_RAX)); /* and/or al, cl */
+		}
+		x64_modrm(c, 0, false, 0x0fb6, X64_RAX, x64_reg(X64_RAX));
+		x64_mov_store(c, native_rm(dst), X64_RAX);
+	} return;
+
+	default: break;
+	}
+
+	u8 acc = dst.kind == NativeLoc_Xmm && !native_same_reg(rhs, dst.reg) ? dst.reg : NATIVE_XMM_TEMP;
+	native_move(c, native_xmm(acc), lhs, true);
+	u32 op = 0;
+	switch(inst->op){
+	case IrOp_Add: op = X64Sse_Add; break;
+	case IrOp_Sub: op = X64Sse_Sub; break;
+	case IrOp_Mul: op = X64Sse_Mul; break;
+	case IrOp_Div: op = X64Sse_Div; break;
+	default: panic("Unexpected Real operation");
+	}
+	x64_sse(c, op, acc, native_rm(rhs));
+	native_move(c, dst, native_xmm(acc), true);
+}
+
+static
+void native_unary(NativeEmitter* e, IrInst const* inst, NativeLoc dst, NativeLoc operand){
+	X64Code* c = &e->code;
+	if(inst->type == ConstKind_Real){
+		/* Flips the sign bit */
+		native_move(c, native_xmm(NATIVE_XMM_TEMP), operand, true);
+		x64_mov_imm(c, X64_RAX, INT64_MIN);
+		x64_sse(c, X64Sse_FromGpr, NATIVE_XMM_SWAP, x64_reg(X64_RAX));
+		x64_sse(c, X64Sse_Xor, NATIVE_XMM_TEMP, x64_reg(NATIVE_XMM_SWAP));
+		native_move(c, dst, native_xmm(NATIVE_XMM_TEMP), true);
+		return;
+	}
+	u8 acc = dst.kind == NativeLoc_Gpr ? dst.reg : X64_RAX;
+	x64_mov_load(c, acc, native_rm(operand));
+	switch(inst->op){
+	case IrOp_Neg:
+		x64_unary(c, 3, x64_reg(acc));
+		native_check(e, X64_O, NativeTrap_Overflow, inst->offset);
+		break;
+	case IrOp_BitNot:
+		x64_unary(c, 2, x64_reg(acc));
+		break;
+	default:
+		x64_alu_imm(c, X64Alu_Xor, x64_reg(acc), 1);
+		break;
+	}
+	x64_mov_store(c, native_rm(dst), acc);
+}
+
+/* Where the System V convention puts argument `index` of a function with `types`, from the
+   caller's side or from the callee's */
+static
+NativeLoc native_arg_loc(u8 const* types, u32 index, bool outgoing){
+	u32 ints = 0, reals = 0, stack = 0;
+	NativeLoc l = {0};
+	for(u32 k = 0; k <= index; k += 1){
+		if(types[k] == ConstKind_Real && reals < NATIVE_REAL_ARGS){
+			l = native_xmm((u8)reals++);
+		}
+		else if(types[k] != ConstKind_Real && ints < NATIVE_INT_ARGS){
+			l = native_gpr(native_int_args[ints++]);
+		}
+		else {
+			/* Above the return address and the saved rbp on the callee's side */
+			l = outgoing ? (NativeLoc){ .kind = NativeLoc_Out, .disp = 8 * (i32)stack } :
+				(NativeLoc){ .kind = NativeLoc_Stack, .disp = 16 + 8 * (i32)stack };
+			stack += 1;
+		}
+	}
+	return l;
+}
+
+static
+u32 native_stack_args(u8 const* types, u32 count){
+	u32 ints = 0, reals = 0, stack = 0;
+	for(u32 k = 0; k < count; k += 1){
+		if(types[k] == ConstKind_Real){
+			if(reals < NATIVE_REAL_ARGS){ reals += 1; } else { stack += 1; }
+		}
+		else {
+			if(ints < NATIVE_INT_ARGS){ ints += 1; } else { stack += 1; }
+		}
+	}
+	return stack;
+}
+
+static
+void native_call(NativeEmitter* e, u32 value, IrInst const* inst){
+	X64Code* c = &e->code;
+	IrFunction const* f = e->fn;
+	IrFunction const* callee = &e->module->functions[inst->a];
+	u32 const* args = f->operands.v + inst->b;
+
+	x64_alu(c, X64Alu_Cmp, X64_RSP, x64_rip());
+	native_fixup(e, (u32)c->len - 4, e->stack_slot);
+	native_check(e, X64_B, NativeTrap_StackOverflow, inst->offset);
+
+	/* Keeps rsp aligned to 16 at the call */
+	u32 area = (u32)mem_align_forward_size(8 * native_stack_args(callee->param_types, inst->c), 16);
+	if(area > 0){
+		x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RSP), (i32)area);
+	}
+	for(u32 k = 0; k < inst->c; k += 1){
+		NativeLoc to = native_arg_loc(callee->param_types, k, true);
+		bool real = native_is_real(e, args[k]);
+		if(to.kind == NativeLoc_Out){
+			native_move(c, to, e->loc[args[k]], real);
+		}
+		else {
+			native_add_move(e, to, e->loc[args[k]], real);
+		}
+	}
+	native_parallel_move(e);
+
+	u32 at = x64_call(c);
+	dyn_push(&e->calls, ((NativePatch){ .at = at, .target = inst->a }));
+	if(area > 0){
+		x64_alu_imm(c, X64Alu_Add, x64_reg(X64_RSP), (i32)area);
+	}
+	if(inst->type != ConstKind_None){
+		bool real = inst->type == ConstKind_Real;
+		native_move(c, e->loc[value], real ? native_xmm(0) : native_gpr(X64_RAX), real);
+	}
+}
+
+static
+bool native_has_phis(IrFunction const* f, u32 block){
+	return f->insts.v[f->blocks.v[block].first].op == IrOp_Phi;
+}
+
+/* Moves the values `from` passes to the phis of `to` */
+static
+void native_edge_moves(NativeEmitter* e, u32 from, u32 to){
+	IrFunction const* f = e->fn;
+	IrBlock const* blk = &f->blocks.v[to];
+	for(u32 i = blk->first; i < blk->first + blk->count && f->insts.v[i].op == IrOp_Phi; i += 1){
+		IrInst const* phi = &f->insts.v[i];
+		for(u32 k = 0; k < phi->b; k += 1){
+			if(f->operands.v[phi->a + phi->b + k] == from){
+				u32 v = f->operands.v[phi->a + k];
+				native_add_move(e, e->loc[i], e->loc[v], phi->type == ConstKind_Real);
+				break;
+			}
+		}
+	}
+	native_parallel_move(e);
+}
+
+static
+void native_branch(NativeEmitter* e, u32 block, IrInst const* inst){
+	X64Code* c = &e->code;
+	IrFunction const* f = e->fn;
+	u32 next = block + 1;
+	if(inst->b == inst->c){
+		native_edge_moves(e, block, inst->b);
+		native_jump(e, inst->b, next);
+		return;
+	}
+
+	X64Cond cc = X64_NE;
+	if(e->fused[inst->a]){
+		static X64Cond const cond[] = { [IrOp_Eq] = X64_E, [IrOp_Ne] = X64_NE, [IrOp_Lt] = X64_L, [IrOp_Le] = X64_LE };
+		IrInst const* cmp = &f->insts.v[inst->a];
+		u8 l = native_gpr_operand(e, e->loc[cmp->a], X64_RAX);
+		x64_alu(c, X64Alu_Cmp, l, native_rm(e->loc[cmp->b]));
+		cc = cond[cmp->op];
+	}
+	else {
+		NativeLoc l = e->loc[inst->a];
+		if(l.kind == NativeLoc_Gpr){ x64_test(c, l.reg, x64_reg(l.reg)); }
+		else { x64_alu_imm(c, X64Alu_Cmp, native_rm(l), 0); }
+	}
+
+	u32 then_block = inst->b;
+	u32 else_block = inst->c;
+	bool then_moves = native_has_phis(f, then_block);
+	bool else_moves = native_has_phis(f, else_block);
+	if(!then_moves && !else_moves && then_block == next){
+		native_jcc(e, cc ^ 1, else_block);
+	}
+	else if(!then_moves){
+		native_jcc(e, cc, then_block);
+		native_edge_moves(e, block, else_block);
+		native_jump(e, else_block, next);
+	}
+	else if(!else_moves){
+		native_jcc(e, cc ^ 1, else_block);
+		native_edge_moves(e, block, then_block);
+		native_jump(e, then_block, next);
+	}
+	else {
+		u32 other = x64_jcc(c, cc ^ 1);
+		native_edge_moves(e, block, then_block);
+		native_jump(e, then_block, IR_NONE);
+		x64_patch_rel32(c, other, (u32)c->len);
+		native_edge_moves(e, block, else_block);
+		native_jump(e, else_block, next);
+	}
+}
+
+static
+void native_epilogue(NativeEmitter* e){
+	X64Code* c = &e->code;
+	if(e->saved_count > 0){
+		x64_lea(c, X64_RSP, x64_mem(X64_RBP, -8 * (i32)e->saved_count));
+	}
+	else {
+		x64_mov_store(c, x64_reg(X64_RSP), X64_RBP);
+	}
+	for(u32 i = e->saved_count; i > 0; i -= 1){
+		x64_pop(c, e->saved[i - 1]);
+	}
+	x64_pop(c, X64_RBP);
+	x64_byte(c, 0xc3);
+}
+
+static
+void native_emit_function(NativeEmitter* e, IrFunction const* f){
+	X64Code* c = &e->code;
+	e->fn = f;
+	e->jumps.len = 0;
+	e->stubs.len = 0;
+	e->slot_count = 0;
+	native_intervals(e);
+	native_allocate(e);
+
+	/* Prologue, rsp is aligned to 16 after it */
+	x64_push(c, X64_RBP);
+	x64_mov_store(c, x64_reg(X64_RBP), X64_RSP);
+	for(u32 i = 0; i < e->saved_count; i += 1){
+		x64_push(c, e->saved[i]);
+	}
+	u32 frame = 8 * e->slot_count;
+	if((8 * e->saved_count + frame) % 16 != 0){
+		frame += 8;
+	}
+	if(frame > 0){
+		x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RSP), (i32)frame);
+	}
+	for(u32 i = 0; i < f->insts.len; i += 1){
+		IrInst const* inst = &f->insts.v[i];
+		if(inst->op == IrOp_Param){
+			native_add_move(e, e->loc[i], native_arg_loc(f->param_types, inst->a, false), inst->type == ConstKind_Real);
+		}
+	}
+	native_parallel_move(e);
+
+	u32 block_count = (u32)f->blocks.len;
+	e->block_code = arena_make(e->arena, u32, max(block_count, 1u));
+	ensure(e->block_code != NULL, "Failed to allocate native code scratch");
+
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		e->block_code[b] = (u32)c->len;
+		for(u32 i = blk->first; i < blk->first + blk->count; i += 1){
+			IrInst const* inst = &f->insts.v[i];
+			NativeLoc dst = e->loc[i];
+			switch((IrOp)inst->op){
+			case IrOp_Nop: case IrOp_Param: case IrOp_Phi:
+				break;
+
+			case IrOp_Const: {
+				Constant k = ir_const_value(inst);
+				i64 bits = inst->type == ConstKind_Bool ? (i64)k.value.boolean : k.value.integer;
+				native_materialize(e, dst, inst->type, bits);
+			} break;
+
+			case IrOp_Undef:
+				native_materialize(e, dst, inst->type, 0);
+				break;
+
+			case IrOp_GetGlobal:
+				if(inst->type == ConstKind_Real){
+					u8 x = dst.kind == NativeLoc_Xmm ? dst.reg : NATIVE_XMM_TEMP;
+					native_fixup(e, x64_sse(c, X64Sse_Load, x, x64_rip()), 8 * inst->a);
+					native_move(c, dst, native_xmm(x), true);
+				}
+				else {
+					u8 r = dst.kind == NativeLoc_Gpr ? dst.reg : X64_RAX;
+					native_fixup(e, x64_modrm(c, 0, true, 0x8b, r, x64_rip()), 8 * inst->a);
+					x64_mov_store(c, native_rm(dst), r);
+				}
+				break;
+
+			case IrOp_SetGlobal: {
+				NativeLoc v = e->loc[inst->b];
+				if(native_is_real(e, inst->b)){
+					u8 x = v.kind == NativeLoc_Xmm ? v.reg : NATIVE_XMM_TEMP;
+					native_move(c, native_xmm(x), v, true);
+					native_fixup(e, x64_sse(c, X64Sse_Store, x, x64_rip()), 8 * inst->a);
+				}
+				else {
+					u8 r = native_gpr_operand(e, v, X64_RAX);
+					native_fixup(e, x64_modrm(c, 0, true, 0x89, r, x64_rip()), 8 * inst->a);
+				}
+			} break;
+
+			case IrOp_Add: case IrOp_Sub: case IrOp_Mul: case IrOp_Div: case IrOp_Mod:
+			case IrOp_Shl: case IrOp_Shr: case IrOp_And: case IrOp_Or: case IrOp_Xor:
+			case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le:
+				if(e->fused[i]){ break; }
+				if(native_is_real(e, inst->a)){
+					native_real_arith(e, inst, dst, e->loc[inst->a], e->loc[inst->b]);
+				}
+				else {
+					native_int_arith(e, inst, dst, e->loc[inst->a], e->loc[inst->b]);
+				}
+				break;
+
+			case IrOp_Neg: case IrOp_BitNot: case IrOp_Not:
+				native_unary(e, inst, dst, e->loc[inst->a]);
+				break;
+
+			case IrOp_Call:
+				native_call(e, i, inst);
+				break;
+
+			case IrOp_Jump:
+				native_edge_moves(e, b, inst->a);
+				native_jump(e, inst->a, b + 1);
+				break;
+
+			case IrOp_Branch:
+				native_branch(e, b, inst);
+				break;
+
+			case IrOp_Return:
+				if(inst->a != IR_NONE){
+					bool real = native_is_real(e, inst->a);
+					native_move(c, real ? native_xmm(0) : native_gpr(X64_RAX), e->loc[inst->a], real);
+				}
+				native_epilogue(e);
+				break;
+
+			default:
+				panic("Unexpected IR instruction in native code");
+			}
+		}
+	}
+
+	for(u32 j = 0; j < e->jumps.len; j += 1){
+		x64_patch_rel32(c, e->jumps.v[j].at, e->block_code[e->jumps.v[j].target]);
+	}
+
+	/* Trap stubs after the body, out of the way of the hot path */
+	for(u32 s = 0; s < e->stubs.len; s += 1){
+		NativePatch stub = e->stubs.v[s];
+		x64_patch_rel32(c, stub.at, (u32)c->len);
+		x64_mov_imm(c, X64_RDI, stub.target);
+		if(e->traps.v[stub.target].kind == NativeTrap_ShiftRange){
+			x64_mov_load(c, X64_RSI, x64_reg(X64_RCX));
+		}
+		native_fixup(e, x64_modrm(c, 0, false, 0xff, 2, x64_rip()), e->trap_slot); /* call [rip + trap] */
+	}
+}
+
+NativeProgram native_emit_module(IrModule const* m, Arena* arena){
+	NativeEmitter e = {
+		.module = m,
+		.arena = arena,
+		.code = { .arena = arena },
+		.fixups = { .arena = arena },
+		.traps = { .arena = arena },
+		.calls = { .arena = arena },
+		.jumps = { .arena = arena },
+		.stubs = { .arena = arena },
+		.moves = { .arena = arena },
+		.trap_slot = 8 * m->global_count,
+		.stack_slot = 8 * m->global_count + 8,
+	};
+
+	u32* entries = arena_make(arena, u32, max(m->function_count, 1u));
+	ensure(entries != NULL, "Failed to allocate native code");
+	for(u32 f = 0; f < m->function_count; f += 1){
+		/* Entries on 16 bytes, as C compilers place them */
+		while(e.code.len % 16 != 0){ x64_byte(&e.code, 0xcc); }
+		entries[f] = (u32)e.code.len;
+		native_emit_function(&e, &m->functions[f]);
+	}
+	for(u32 i = 0; i < e.calls.len; i += 1){
+		x64_patch_rel32(&e.code, e.calls.v[i].at, entries[e.calls.v[i].target]);
+	}
+
+	return (NativeProgram){
+		.module = m,
+		.code = e.code.v,
+		.code_len = (u32)e.code.len,
+		.entries = entries,
+		.fixups = e.fixups.v,
+		.fixup_count = (u32)e.fixups.len,
+		.traps = e.traps.v,
+		.trap_count = (u32)e.traps.len,
+		.data_size = e.stack_slot + 8,
+		.trap_slot = e.trap_slot,
+		.stack_slot = e.stack_slot,
+	};
+}
+
+static
+void native_link_fixups(NativeFixup const* fixups, u32 count, u8* code, u64 code_address, u64 data_address){
+	for(u32 i = 0; i < count; i += 1){
+		NativeFixup fx = fixups[i];
+		i64 rel = (i64)(data_address + fx.data_offset) - (i64)(code_address + fx.at + 4);
+		ensure(rel >= INT32_MIN && rel <= INT32_MAX, "Data area out of reach of the code");
+		x64_patch_u32(code, fx.at, (u32)(i32)rel);
+	}
+}
+
+void native_link(NativeProgram const* p, u8* code, u64 code_address, u64 data_address){
+	native_link_fixups(p->fixups, p->fixup_count, code, code_address, data_address);
+}
+
+//// Runtime errors
+/* Text before and after the value, only ShiftRange has one */
+static char const* const native_trap_text[][2] = {
+	[NativeTrap_Overflow]       = { "Integer overflow", "" },
+	[NativeTrap_DivisionByZero] = { "Division by zero", "" },
+	[NativeTrap_ShiftRange]     = { "Shift amount ", " is out of range, it must be between 0 and 63" },
+	[NativeTrap_StackOverflow]  = { "Stack overflow", "" },
+};
+
+String native_trap_message(NativeTrapKind kind, i64 value, Arena* arena){
+	char const* const* text = native_trap_text[kind];
+	if(text[1][0] == 0){
+		return str_format(arena, "%s", text[0]);
+	}
+	return str_format(arena, "%s%lld%s", text[0], (long long)value, text[1]);
+}
+
+//// Executables
+/* One read-execute segment with the headers, the program, a small runtime and read-only data,
+   then a zero filled read-write segment for the data area */
+#define NATIVE_ELF_BASE    0x400000u
+#define NATIVE_ELF_HEADERS (64 + 2 * 56)
+#define NATIVE_ELF_PAGE    0x1000u
+
+typedef struct {
+	X64Code text;
+	DynArray(NativePatch) rodata_refs; /* RIP displacements to read-only data, by offset */
+	DynArray(NativePatch) data_refs;   /* Same for the data area */
+} NativeImage;
+
+static
+void native_rodata_ref(NativeImage* img, u32 at, u32 offset){
+	dyn_push(&img->rodata_refs, ((NativePatch){ .at = at, .target = offset }));
+}
+
+static
+void native_data_ref(NativeImage* img, u32 at, u32 offset){
+	dyn_push(&img->data_refs, ((NativePatch){ .at = at, .target = offset }));
+}
+
+/* write(1, rsi, rdx) */
+static
+void native_emit_write(X64Code* c){
+	x64_mov_imm(c, X64_RDI, 1);
+	x64_mov_imm(c, X64_RAX, 1);
+	x64_syscall(c);
+}
+
+/* Prints rdi in decimal, digits are produced backwards into a buffer on the stack */
+static
+u32 native_emit_print_int(X64Code* c){
+	u32 entry = (u32)c->len;
+	x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RSP), 40);
+	x64_mov_load(c, X64_RAX, x64_reg(X64_RDI));
+	x64_lea(c, X64_RSI, x64_mem(X64_RSP, 32));
+	x64_mov_imm(c, X64_RCX, 10);
+	x64_test(c, X64_RAX, x64_reg(X64_RAX));
+	u32 positive = x64_jcc(c, X64_NS);
+	x64_unary(c, 3, x64_reg(X64_RAX)); /* INT64_MIN stays as is, it is divided unsigned */
+	x64_patch_rel32(c, positive, (u32)c->len);
+
+	u32 digit = (u32)c->len;
+	x64_mov_imm(c, X64_RDX, 0);
+	x64_unary(c, 6, x64_reg(X64_RCX));
+	x64_alu_imm(c, X64Alu_Add, x64_reg(X64_RDX), '0');
+	x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RSI), 1);
+	x64_modrm(c, 0, false, 0x88, X64_RDX, x64_mem(X64_RSI, 0)); /* mov [rsi], dl */
+	x64_test(c, X64_RAX, x64_reg(X64_RAX));
+	x64_patch_rel32(c, x64_jcc(c, X64_NE), digit);
+
+	x64_test(c, X64_RDI, x64_reg(X64_RDI));
+	u32 unsigned_ = x64_jcc(c, X64_NS);
+	x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RSI), 1);
+	x64_modrm(c, 0, false, 0xc6, 0, x64_mem(X64_RSI, 0)); /* mov byte [rsi], '-' */
+	x64_byte(c, '-');
+	x64_patch_rel32(c, unsigned_, (u32)c->len);
+
+	x64_lea(c, X64_RDX, x64_mem(X64_RSP, 32));
+	x64_alu(c, X64Alu_Sub, X64_RDX, x64_reg(X64_RSI));
+	native_emit_write(c);
+	x64_alu_imm(c, X64Alu_Add, x64_reg(X64_RSP), 40);
+	x64_byte(c, 0xc3);
+	return entry;
+}
+
+/* Trap handler: edi is the trap, rsi its value. Each trap has a 16 byte entry in the table with
+   the offset and length of the text before the value and of the text after it. */
+static
+u32 native_emit_fail(NativeImage* img, u32 print_int){
+	X64Code* c = &img->text;
+	u32 entry = (u32)c->len;
+	x64_mov_load(c, X64_R12, x64_reg(X64_RSI));
+	x64_modrm(c, 0, false, 0x8b, X64_RBX, x64_reg(X64_RDI)); /* mov ebx, edi */
+	x64_modrm(c, 0, true, 0xc1, 4, x64_reg(X64_RBX));        /* shl rbx, 4 */
+	x64_byte(c, 4);
+	native_rodata_ref(img, x64_lea(c, X64_R13, x64_rip()), 0);
+	x64_alu(c, X64Alu_Add, X64_RBX, x64_reg(X64_R13));
+
+	x64_modrm(c, 0, false, 0x8b, X64_RSI, x64_mem(X64_RBX, 0));
+	x64_alu(c, X64Alu_Add, X64_RSI, x64_reg(X64_R13));
+	x64_modrm(c, 0, false, 0x8b, X64_RDX, x64_mem(X64_RBX, 4));
+	native_emit_write(c);
+
+	x64_modrm(c, 0, false, 0x8b, X64_RDX, x64_mem(X64_RBX, 12));
+	x64_test(c, X64_RDX, x64_reg(X64_RDX));
+	u32 done = x64_jcc(c, X64_E);
+	x64_mov_load(c, X64_RDI, x64_reg(X64_R12));
+	x64_patch_rel32(c, x64_call(c), print_int);
+	x64_modrm(c, 0, false, 0x8b, X64_RSI, x64_mem(X64_RBX, 8));
+	x64_alu(c, X64Alu_Add, X64_RSI, x64_reg(X64_R13));
+	x64_modrm(c, 0, false, 0x8b, X64_RDX, x64_mem(X64_RBX, 12));
+	native_emit_write(c);
+	x64_patch_rel32(c, done, (u32)c->len);
+
+	x64_mov_imm(c, X64_RDI, 1);
+	x64_mov_imm(c, X64_RAX, 231); /* exit_group */
+	x64_syscall(c);
+	return entry;
+}
+
+static
+void native_elf_put(u8* at, u64 v, u32 size){
+	for(u32 i = 0; i < size; i += 1){
+		at[i] = (u8)(v >> (8 * i));
+	}
+}
+
+bool native_write_executable(NativeProgram const* p, String filename, char const* path, Arena* arena, String* error){
+	IrModule const* m = p->module;
+	if(m->main == IR_NONE){
+		*error = str_lit("No 'main' function to run");
+		return false;
+	}
+	IrFunction const* main_fn = &m->functions[m->main];
+	if(main_fn->param_count != 0){
+		*error = str_lit("'main' must not take parameters");
+		return false;
+	}
+	if(main_fn->return_type == ConstKind_Real){
+		*error = str_lit("'main' returns a Real, executables can only print Int and Bool results");
+		return false;
+	}
+
+	/* Read-only data: the trap table, then the texts */
+	X64Code rodata = { .arena = arena };
+	dyn_reserve(&rodata, 16 * p->trap_count);
+	rodata.len = 16 * p->trap_count;
+	for(u32 t = 0; t < p->trap_count; t += 1){
+		char const* const* text = native_trap_text[p->traps[t].kind];
+		bool value = text[1][0] != 0;
+		String head = str_format(arena, TERM_COLOR_RED "error" TERM_COLOR_RESET " (%.*s:%u) %s%s",
+			str_fmt(filename), p->traps[t].offset, text[0], value ? "" : "\n");
+		String tail = value ? str_format(arena, "%s\n", text[1]) : str_lit("");
+		u32 fields[4] = { (u32)rodata.len, (u32)head.len, (u32)(rodata.len + head.len), (u32)tail.len };
+		dyn_append(&rodata, head.v, head.len);
+		if(tail.len > 0){ dyn_append(&rodata, tail.v, tail.len); }
+		for(u32 k = 0; k < 4; k += 1){
+			native_elf_put(rodata.v + 16 * t + 4 * k, fields[k], 4);
+		}
+	}
+	u32 true_text = (u32)rodata.len;
+	dyn_append(&rodata, "true\nfalse\n", 11);
+	u32 false_text = true_text + 5;
+	u32 newline = false_text + 5;
+
+	NativeImage img = {
+		.text = { .arena = arena },
+		.rodata_refs = { .arena = arena },
+		.data_refs = { .arena = arena },
+	};
+	X64Code* c = &img.text;
+	dyn_reserve(c, NATIVE_ELF_HEADERS + p->code_len);
+	mem_set(c->v, 0, NATIVE_ELF_HEADERS);
+	c->len = NATIVE_ELF_HEADERS;
+	dyn_append(c, p->code, p->code_len);
+	u32 code_base = NATIVE_ELF_HEADERS;
+
+	u32 print_int = native_emit_print_int(c);
+	u32 fail = native_emit_fail(&img, print_int);
+
+	/* Entry: the stack limit leaves 64 KB of RLIMIT_STACK, capped at 1 GB, for the runtime */
+	u32 start = (u32)c->len;
+	x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RSP), 16);
+	x64_modrm(c, 0, true, 0xc7, 0, x64_mem(X64_RSP, 0));
+	x64_u32(c, 8 << 20);
+	x64_mov_imm(c, X64_RDI, 3); /* RLIMIT_STACK */
+	x64_mov_load(c, X64_RSI, x64_reg(X64_RSP));
+	x64_mov_imm(c, X64_RAX, 97); /* getrlimit */
+	x64_syscall(c);
+	x64_mov_load(c, X64_RAX, x64_mem(X64_RSP, 0));
+	x64_mov_imm(c, X64_RCX, 1 << 30);
+	x64_alu(c, X64Alu_Cmp, X64_RAX, x64_reg(X64_RCX));
+	x64_cmov(c, X64_A, X64_RAX, x64_reg(X64_RCX));
+	x64_alu_imm(c, X64Alu_Sub, x64_reg(X64_RAX), 64 * 1024);
+	x64_mov_load(c, X64_RDX, x64_reg(X64_RSP));
+	x64_alu(c, X64Alu_Sub, X64_RDX, x64_reg(X64_RAX));
+	native_data_ref(&img, x64_mov_store(c, x64_rip(), X64_RDX), p->stack_slot);
+	x64_patch_rel32(c, x64_lea(c, X64_RAX, x64_rip()), fail);
+	native_data_ref(&img, x64_mov_store(c, x64_rip(), X64_RAX), p->trap_slot);
+
+	x64_patch_rel32(c, x64_call(c), code_base + p->entries[m->init]);
+	x64_patch_rel32(c, x64_call(c), code_base + p->entries[m->main]);
+	if(main_fn->return_type == ConstKind_Int){
+		x64_mov_load(c, X64_RDI, x64_reg(X64_RAX));
+		x64_patch_rel32(c, x64_call(c), print_int);
+		native_rodata_ref(&img, x64_lea(c, X64_RSI, x64_rip()), newline);
+		x64_mov_imm(c, X64_RDX, 1);
+		native_emit_write(c);
+	}
+	else if(main_fn->return_type == ConstKind_Bool){
+		x64_test(c, X64_RAX, x64_reg(X64_RAX));
+		u32 is_false = x64_jcc(c, X64_E);
+		native_rodata_ref(&img, x64_lea(c, X64_RSI, x64_rip()), true_text);
+		x64_mov_imm(c, X64_RDX, 5);
+		u32 write = x64_jmp(c);
+		x64_patch_rel32(c, is_false, (u32)c->len);
+		native_rodata_ref(&img, x64_lea(c, X64_RSI, x64_rip()), false_text);
+		x64_mov_imm(c, X64_RDX, 6);
+		x64_patch_rel32(c, write, (u32)c->len);
+		native_emit_write(c);
+	}
+	x64_mov_imm(c, X64_RDI, 0);
+	x64_mov_imm(c, X64_RAX, 231);
+	x64_syscall(c);
+
+	while(c->len % 8 != 0){ x64_byte(c, 0); }
+	u32 rodata_base = (u32)c->len;
+	dyn_append(c, rodata.v, rodata.len);
+	u32 text_size = (u32)c->len;
+	u64 data_address = (u64)mem_align_forward_size(NATIVE_ELF_BASE + text_size, NATIVE_ELF_PAGE);
+
+	for(u32 i = 0; i < img.rodata_refs.len; i += 1){
+		x64_patch_rel32(c, img.rodata_refs.v[i].at, rodata_base + img.rodata_refs.v[i].target);
+	}
+	for(u32 i = 0; i < img.data_refs.len; i += 1){
+		NativePatch ref = img.data_refs.v[i];
+		x64_patch_u32(c->v, ref.at, (u32)(data_address + ref.target - (NATIVE_ELF_BASE + ref.at + 4)));
+	}
+	native_link(p, c->v + code_base, NATIVE_ELF_BASE + code_base, data_address);
+
+	/* ELF header */
+	u8* h = c->v;
+	mem_copy_no_overlap(h, "\x7f" "ELF\x02\x01\x01", 7);
+	native_elf_put(h + 16, 2, 2);                 /* ET_EXEC */
+	native_elf_put(h + 18, 62, 2);                /* EM_X86_64 */
+	native_elf_put(h + 20, 1, 4);                 /* EV_CURRENT */
+	native_elf_put(h + 24, NATIVE_ELF_BASE + start, 8);
+	native_elf_put(h + 32, 64, 8);                /* Program headers right after */
+	native_elf_put(h + 52, 64, 2);
+	native_elf_put(h + 54, 56, 2);
+	native_elf_put(h + 56, 2, 2);
+	native_elf_put(h + 58, 64, 2);
+
+	/* PT_LOAD segments, the data area has no bytes in the file */
+	struct { u32 flags; u64 offset, address, file_size, mem_size; } segments[2] = {
+		{ 5, 0, NATIVE_ELF_BASE, text_size, text_size },
+		{ 6, 0, data_address, 0, p->data_size },
+	};
+	for(u32 s = 0; s < 2; s += 1){
+		u8* ph = h + 64 + 56 * s;
+		native_elf_put(ph + 0, 1, 4);
+		native_elf_put(ph + 4, segments[s].flags, 4);
+		native_elf_put(ph + 8, segments[s].offset, 8);
+		native_elf_put(ph + 16, segments[s].address, 8);
+		native_elf_put(ph + 24, segments[s].address, 8);
+		native_elf_put(ph + 32, segments[s].file_size, 8);
+		native_elf_put(ph + 40, segments[s].mem_size, 8);
+		native_elf_put(ph + 48, NATIVE_ELF_PAGE, 8);
+	}
+
+	if(!file_write_atomic(path, c->v, c->len) || !file_make_executable(path)){
+		*error = str_format(arena, "Could not write '%s'", path);
+		return false;
+	}
+	return true;
+}
+
+//// JIT
+/* Written by the stubs right after the program's data area */
+typedef struct {
+	u64 saved_rsp; /* Caller's stack, with its callee saved registers pushed */
+	u64 trap;      /* NATIVE_JIT_NO_TRAP unless the call failed */
+	i64 value;
+} NativeJitExit;
+
+#define NATIVE_JIT_NO_TRAP UINT64_MAX
+/* Room left under the stack limit for the trap exit and a frame that is being set up */
+#define NATIVE_JIT_STACK_MARGIN (64 * 1024)
+/* Register arguments, as loaded by the entry stub: integer ones then reals */
+#define NATIVE_JIT_ARG_SLOTS (NATIVE_INT_ARGS + NATIVE_REAL_ARGS)
+
+/* The entry stub is `enter(code, rsp, u64 const args[NATIVE_JIT_ARG_SLOTS])`, as System V sees
+   it. It saves the callee saved registers, switches to `rsp` and calls `code`, which leaves its
+   result in rax or xmm0. The exit stub is the trap handler: it records the trap and unwinds to
+   the caller of `enter` as if the call had returned. */
+typedef i64 (*NativeJitEnterInt)(void const* code, void* rsp, u64 const* args);
+typedef f64 (*NativeJitEnterReal)(void const* code, void* rsp, u64 const* args);
+
+static u8 const native_jit_saved[] = { X64_RBP, X64_RBX, X64_R12, X64_R13, X64_R14, X64_R15 };
+#define NATIVE_JIT_SAVED 6
+
+typedef DynArray(NativeFixup) NativeFixupArray;
+
+static
+u32 native_jit_stubs(X64Code* c, NativeFixupArray* fixups, u32 exit_offset, u32* exit){
+	u32 enter = (u32)c->len;
+	for(u32 i = 0; i < NATIVE_JIT_SAVED; i += 1){
+		x64_push(c, native_jit_saved[i]);
+	}
+	u32 at = x64_mov_store(c, x64_rip(), X64_RSP);
+	dyn_push(fixups, ((NativeFixup){ .at = at, .data_offset = exit_offset + offsetof(NativeJitExit, saved_rsp) }));
+	x64_mov_load(c, X64_RAX, x64_reg(X64_RDI));
+	x64_mov_load(c, NATIVE_GPR_SWAP, x64_reg(X64_RDX));
+	x64_mov_load(c, X64_RSP, x64_reg(X64_RSI));
+	for(u32 k = 0; k < NATIVE_REAL_ARGS; k += 1){
+		x64_sse(c, X64Sse_Load, (u8)k, x64_mem(NATIVE_GPR_SWAP, 8 * (i32)(NATIVE_INT_ARGS + k)));
+	}
+	for(u32 k = 0; k < NATIVE_INT_ARGS; k += 1){
+		x64_mov_load(c, native_int_args[k], x64_mem(NATIVE_GPR_SWAP, 8 * (i32)k));
+	}
+	x64_modrm(c, 0, false, 0xff, 2, x64_reg(X64_RAX)); /* call rax */
+
+	u32 unwind = (u32)c->len;
+	at = x64_modrm(c, 0, true, 0x8b, X64_RSP, x64_rip());
+	dyn_push(fixups, ((NativeFixup){ .at = at, .data_offset = exit_offset + offsetof(NativeJitExit, saved_rsp) }));
+	for(u32 i = NATIVE_JIT_SAVED; i > 0; i -= 1){
+		x64_pop(c, native_jit_saved[i - 1]);
+	}
+	x64_byte(c, 0xc3);
+
+	while(c->len % 16 != 0){ x64_byte(c, 0xcc); }
+	*exit = (u32)c->len;
+	at = x64_mov_store(c, x64_rip(), X64_RDI);
+	dyn_push(fixups, ((NativeFixup){ .at = at, .data_offset = exit_offset + offsetof(NativeJitExit, trap) }));
+	at = x64_mov_store(c, x64_rip(), X64_RSI);
+	dyn_push(fixups, ((NativeFixup){ .at = at, .data_offset = exit_offset + offsetof(NativeJitExit, value) }));
+	x64_patch_rel32(c, x64_jmp(c), unwind);
+	return enter;
+}
+
+static
+void native_jit_fail(NativeJit* jit, u64 offset, String message){
+	CompilerError* err = arena_make(jit->error_arena, CompilerError, 1);
+	err->stage = CompilerStage_Run;
+	err->offset = offset;
+	err->filename = jit->filename;
+	err->message = message;
+	jit->error = err;
+}
+
+NativeJit native_jit_create(NativeProgram const* p, isize stack_size, Arena* arena){
+	NativeJit jit = { .program = p, .error_arena = arena };
+#if !defined(ARCH_X64) || !defined(OS_LINUX)
+	(void)stack_size;
+	native_jit_fail(&jit, 0, str_lit("The JIT needs x86-64 with the System V calling convention"));
+	return jit;
+#else
+	ArenaRegion reg = arena_region_begin(arena);
+	X64Code code = { .arena = arena };
+	NativeFixupArray fixups = { .arena = arena };
+	dyn_append(&code, p->code, p->code_len);
+	while(code.len % 16 != 0){ x64_byte(&code, 0xcc); }
+	u32 exit = 0;
+	u32 enter = native_jit_stubs(&code, &fixups, p->data_size, &exit);
+
+	isize page = mem_page_size();
+	jit.code_size = mem_align_forward_size(code.len, page);
+	jit.data_size = mem_align_forward_size(p->data_size + sizeof(NativeJitExit), page);
+	jit.stack_size = mem_align_forward_size(max(stack_size, page + 2 * NATIVE_JIT_STACK_MARGIN), page);
+	/* Data follows the code in the same mapping, well within reach of RIP relative operands */
+	jit.pages = mem_virtual_alloc(jit.code_size + jit.data_size);
+	jit.stack = mem_virtual_alloc(jit.stack_size);
+	if(jit.pages == NULL || jit.stack == NULL || !mem_virtual_protect(jit.stack, page, MemProtect_None)){
+		arena_region_end(reg);
+		native_jit_destroy(&jit);
+		native_jit_fail(&jit, 0, str_lit("Could not map memory for native code"));
+		return jit;
+	}
+
+	u8* data = jit.pages + jit.code_size;
+	mem_copy_no_overlap(jit.pages, code.v, code.len);
+	native_link(p, jit.pages, (u64)(uintptr)jit.pages, (u64)(uintptr)data);
+	native_link_fixups(fixups.v, (u32)fixups.len, jit.pages, (u64)(uintptr)jit.pages, (u64)(uintptr)data);
+	arena_region_end(reg);
+	if(!mem_virtual_protect(jit.pages, jit.code_size, MemProtect_ReadExecute)){
+		native_jit_destroy(&jit);
+		native_jit_fail(&jit, 0, str_lit("Could not make native code executable"));
+		return jit;
+	}
+
+	u64 handler = (u64)(uintptr)(jit.pages + exit);
+	u64 limit = (u64)(uintptr)(jit.stack + page + NATIVE_JIT_STACK_MARGIN);
+	mem_copy_no_overlap(data + p->trap_slot, &handler, 8);
+	mem_copy_no_overlap(data + p->stack_slot, &limit, 8);
+	jit.enter = enter;
+	jit.exit = exit;
+	return jit;
+#endif
+}
+
+void native_jit_destroy(NativeJit* jit){
+	mem_virtual_free(jit->pages, jit->code_size + jit->data_size);
+	mem_virtual_free(jit->stack, jit->stack_size);
+	jit->pages = NULL;
+	jit->stack = NULL;
+}
+
+bool native_jit_call(NativeJit* jit, u32 fn, Value const* args, u32 arg_count, Value* result){
+	ensure(jit->pages != NULL, "The JIT failed to map its code");
+	NativeProgram const* p = jit->program;
+	IrFunction const* f = &p->module->functions[fn];
+	ensure(arg_count == f->param_count, "Argument count does not match the function");
+
+	/* Register arguments go through the entry stub, the rest are stored where the callee
+	   expects them above its return address */
+	u64 regs[NATIVE_JIT_ARG_SLOTS] = {0};
+	u8* rsp = jit->stack + jit->stack_size - mem_align_forward_size(8 * native_stack_args(f->param_types, arg_count), 16);
+	for(u32 k = 0; k < arg_count; k += 1){
+		u64 bits = args[k].kind == ConstKind_Real ? 0 : (u64)args[k].value.integer;
+		if(args[k].kind == ConstKind_Real){ mem_copy_no_overlap(&bits, &args[k].value.real, 8); }
+		if(args[k].kind == ConstKind_Bool){ bits = args[k].value.boolean; }
+
+		NativeLoc l = native_arg_loc(f->param_types, k, true);
+		if(l.kind == NativeLoc_Xmm){
+			regs[NATIVE_INT_ARGS + l.reg] = bits;
+		}
+		else if(l.kind == NativeLoc_Gpr){
+			u32 slot = 0;
+			while(native_int_args[slot] != l.reg){ slot += 1; }
+			regs[slot] = bits;
+		}
+		else {
+			mem_copy_no_overlap(rsp + l.disp, &bits, 8);
+		}
+	}
+
+	NativeJitExit* exit = (NativeJitExit*)(jit->pages + jit->code_size + p->data_size);
+	exit->trap = NATIVE_JIT_NO_TRAP;
+	void const* code = jit->pages + p->entries[fn];
+	uintptr enter = (uintptr)(jit->pages + jit->enter);
+	Value v = { .kind = f->return_type };
+	if(f->return_type == ConstKind_Real){
+		v.value.real = ((NativeJitEnterReal)enter)(code, rsp, regs);
+	}
+	else {
+		i64 bits = ((NativeJitEnterInt)enter)(code, rsp, regs);
+		if(f->return_type == ConstKind_Bool){ v.value.boolean = bits != 0; }
+		else { v.value.integer = bits; }
+	}
+
+	if(exit->trap != NATIVE_JIT_NO_TRAP){
+		NativeTrap t = p->traps[exit->trap];
+		native_jit_fail(jit, t.offset, native_trap_message(t.kind, exit->value, jit->error_arena));
+		return false;
+	}
+	*result = v;
+	return true;
+}
+
+bool native_jit_run_main(NativeJit* jit, Value* result){
+	IrModule const* m = jit->program->module;
+	Value unused;
+	if(!native_jit_call(jit, m->init, NULL, 0, &unused)){
+		return false;
+	}
+	if(m->main == IR_NONE){
+		native_jit_fail(jit, 0, str_lit("No 'main' function to run"));
+		return false;
+	}
+	if(m->functions[m->main].param_count != 0){
+		native_jit_fail(jit, 0, str_lit("'main' must not take parameters"));
+		return false;
+	}
+	return native_jit_call(jit, m->main, NULL, 0, result);
+}
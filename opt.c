@@ -0,0 +1,624 @@
+#include "kielo.h"
+
+/* Lattice of a value: nothing known yet, one constant, or any value */
+enum {
+	OptLattice_Top,
+	OptLattice_Const,
+	OptLattice_Bottom,
+};
+
+typedef struct {
+	IrFunction* fn;
+	u8* state;        /* OptLattice of each value */
+	u64* bits;        /* Constant of each value in state Const, as in IrInst a and b */
+	u32* block_of;    /* Of each instruction */
+	u8* executable;   /* Of each block */
+
+	/* Users of each value in CSR form */
+	u32* user_start;
+	u32* users;
+
+	u32* work;        /* Values whose state went down, each is pushed at most twice */
+	u32 work_len;
+	u32* blocks;      /* Blocks that became executable */
+	u32 block_len;
+} OptSccp;
+
+static
+Constant opt_constant(u8 type, u64 bits){
+	IrInst inst = { .type = type, .a = (u32)bits, .b = (u32)(bits >> 32) };
+	return ir_const_value(&inst);
+}
+
+static
+u64 opt_bits(Constant k){
+	if(k.kind == ConstKind_Bool){
+		return k.value.boolean;
+	}
+	return (u64)k.value.integer;
+}
+
+static
+TokenKind opt_token(IrOp op){
+	switch(op){
+	case IrOp_Add:    return TokenKind_Plus;
+	case IrOp_Sub:    return TokenKind_Minus;
+	case IrOp_Mul:    return TokenKind_Star;
+	case IrOp_Div:    return TokenKind_Slash;
+	case IrOp_Mod:    return TokenKind_Modulo;
+	case IrOp_Shl:    return TokenKind_ShiftLeft;
+	case IrOp_Shr:    return TokenKind_ShiftRight;
+	case IrOp_And:    return TokenKind_And;
+	case IrOp_Or:     return TokenKind_Or;
+	case IrOp_Xor:    return TokenKind_Tilde;
+	case IrOp_Eq:     return TokenKind_Equal;
+	case IrOp_Ne:     return TokenKind_NotEqual;
+	case IrOp_Lt:     return TokenKind_Less;
+	case IrOp_Le:     return TokenKind_LessEqual;
+	case IrOp_Neg:    return TokenKind_Minus;
+	case IrOp_BitNot: return TokenKind_Tilde;
+	case IrOp_Not:    return TokenKind_LogicNot;
+	default:          return TokenKind_Unknown;
+	}
+}
+
+//// Constant propagation
+/* Lowers `v` to `state` (and `bits`), queueing its users when that changed it */
+static
+void opt_lower(OptSccp* s, u32 v, u8 state, u64 bits){
+	if(s->state[v] == OptLattice_Const && state == OptLattice_Const && s->bits[v] != bits){
+		state = OptLattice_Bottom;
+	}
+	if(state <= s->state[v]){
+		return;
+	}
+	s->state[v] = state;
+	s->bits[v] = bits;
+	s->work[s->work_len++] = v;
+}
+
+/* Whether the edge can run given what is known of the branch ending `from` */
+static
+bool opt_edge_taken(OptSccp const* s, u32 from, u32 to){
+	if(!s->executable[from]){ return false; }
+	IrBlock const* blk = &s->fn->blocks.v[from];
+	IrInst const* term = &s->fn->insts.v[blk->first + blk->count - 1];
+	if(term->op == IrOp_Jump){ return term->a == to; }
+	if(term->op != IrOp_Branch){ return false; }
+	u8 cond = s->state[term->a];
+	if(cond == OptLattice_Const){
+		return (s->bits[term->a] != 0 ? term->b : term->c) == to;
+	}
+	return cond == OptLattice_Bottom && (term->b == to || term->c == to);
+}
+
+static void opt_eval(OptSccp* s, u32 v);
+
+static
+void opt_mark_edge(OptSccp* s, u32 to){
+	if(!s->executable[to]){
+		s->executable[to] = 1;
+		s->blocks[s->block_len++] = to;
+		return;
+	}
+	/* Only the phis can see the new edge */
+	IrBlock const* blk = &s->fn->blocks.v[to];
+	for(u32 v = blk->first; v < blk->first + blk->count && s->fn->insts.v[v].op == IrOp_Phi; v += 1){
+		opt_eval(s, v);
+	}
+}
+
+static
+void opt_eval(OptSccp* s, u32 v){
+	IrFunction* f = s->fn;
+	IrInst const* inst = &f->insts.v[v];
+	u32 block = s->block_of[v];
+
+	switch((IrOp)inst->op){
+	case IrOp_Const:
+		opt_lower(s, v, OptLattice_Const, (u64)inst->a | ((u64)inst->b << 32));
+		break;
+
+	case IrOp_Phi:
+		for(u32 k = 0; k < inst->b; k += 1){
+			u32 value = f->operands.v[inst->a + k];
+			if(opt_edge_taken(s, f->operands.v[inst->a + inst->b + k], block) && s->state[value] != OptLattice_Top){
+				opt_lower(s, v, s->state[value], s->bits[value]);
+			}
+		}
+		break;
+
+	case IrOp_Add: case IrOp_Sub: case IrOp_Mul: case IrOp_Div: case IrOp_Mod:
+	case IrOp_Shl: case IrOp_Shr: case IrOp_And: case IrOp_Or: case IrOp_Xor:
+	case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le:
+	case IrOp_Neg: case IrOp_BitNot: case IrOp_Not: {
+		bool unary = inst->op == IrOp_Neg || inst->op == IrOp_BitNot || inst->op == IrOp_Not;
+		u8 ls = s->state[inst->a];
+		u8 rs = unary ? OptLattice_Const : s->state[inst->b];
+		if(ls == OptLattice_Bottom || rs == OptLattice_Bottom){
+			opt_lower(s, v, OptLattice_Bottom, 0);
+			break;
+		}
+		if(ls == OptLattice_Top || rs == OptLattice_Top){
+			break;
+		}
+		/* Operations that would fail at runtime are left to fail there */
+		u8 operand_type = f->insts.v[inst->a].type;
+		Constant l = opt_constant(operand_type, s->bits[inst->a]);
+		Constant out = {0};
+		ConstFoldResult r = unary ? const_fold_unary(opt_token(inst->op), l, &out) :
+			const_fold_binary(opt_token(inst->op), l, opt_constant(operand_type, s->bits[inst->b]), &out);
+		if(r == ConstFold_Ok){
+			opt_lower(s, v, OptLattice_Const, opt_bits(out));
+		}
+		else {
+			opt_lower(s, v, OptLattice_Bottom, 0);
+		}
+	} break;
+
+	case IrOp_Jump:
+		opt_mark_edge(s, inst->a);
+		break;
+
+	case IrOp_Branch:
+		if(s->state[inst->a] == OptLattice_Bottom){
+			opt_mark_edge(s, inst->b);
+			if(inst->c != inst->b){ opt_mark_edge(s, inst->c); }
+		}
+		else if(s->state[inst->a] == OptLattice_Const){
+			opt_mark_edge(s, s->bits[inst->a] != 0 ? inst->b : inst->c);
+		}
+		break;
+
+	case IrOp_Return: case IrOp_SetGlobal: case IrOp_SetVar: case IrOp_Nop:
+		break;
+
+	default:
+		/* Parameters, globals, calls and reads of unset variables */
+		if(inst->type != ConstKind_None){
+			opt_lower(s, v, OptLattice_Bottom, 0);
+		}
+		break;
+	}
+}
+
+void ir_propagate_constants(IrFunction* f, IrOptStats* stats){
+	Arena* arena = f->insts.arena;
+	u32 inst_count = (u32)f->insts.len;
+	u32 block_count = (u32)f->blocks.len;
+	if(block_count == 0){ return; }
+
+	OptSccp s = {
+		.fn = f,
+		.state = arena_make(arena, u8, max(inst_count, 1u)),
+		.bits = arena_make(arena, u64, max(inst_count, 1u)),
+		.block_of = arena_make(arena, u32, max(inst_count, 1u)),
+		.executable = arena_make(arena, u8, block_count),
+		.user_start = arena_make(arena, u32, inst_count + 1),
+		.blocks = arena_make(arena, u32, block_count),
+	};
+	ensure(s.state && s.bits && s.block_of && s.executable && s.user_start && s.blocks, "Failed to allocate IR scratch");
+
+	u32 use_total = 0;
+	for(u32 b = 0; b < block_count; b += 1){
+		IrBlock const* blk = &f->blocks.v[b];
+		for(u32 v = blk->first; v < blk->first + blk->count; v += 1){
+			s.block_of[v] = b;
+			IrUses uses = ir_uses(f, &f->insts.v[v]);
+			for(u32 k = 0; k < uses.len; k += 1){
+				if(uses.v[k] != IR_NONE){ s.user_start[uses.v[k] + 1] += 1; }
+			}
+			use_total += uses.len;
+		}
+	}
+	for(u32 v = 0; v < inst_count; v += 1){
+		s.user_start[v + 1] += s.user_start[v];
+	}
+	s.users = arena_make(arena, u32, max(use_total, 1u));
+	u32* fill = arena_make(arena, u32, max(inst_count, 1u));
+	s.work = arena_make(arena, u32, 2 * inst_count + 1);
+	ensure(s.users && fill && s.work, "Failed to allocate IR scratch");
+	for(u32 v = 0; v < inst_count; v += 1){
+		IrUses uses = ir_uses(f, &f->insts.v[v]);
+		for(u32 k = 0; k < uses.len; k += 1){
+			u32 u = uses.v[k];
+			if(u != IR_NONE){ s.users[s.user_start[u] + fill[u]++] = v; }
+		}
+	}
+
+	s.executable[0] = 1;
+	s.blocks[s.block_len++] = 0;
+	while(s.block_len > 0 || s.work_len > 0){
+		if(s.block_len > 0){
+			IrBlock const* blk = &f->blocks.v[s.blocks[--s.block_len]];
+			for(u32 v = blk->first; v < blk->first + blk->count; v += 1){
+				opt_eval(&s, v);
+			}
+			continue;
+		}
+		u32 v = s.work[--s.work_len];
+		for(u32 k = s.user_start[v]; k < s.user_start[v + 1]; k += 1){
+			u32 u = s.users[k];
+			if(s.executable[s.block_of[u]]){ opt_eval(&s, u); }
+		}
+	}
+
+	/* Values become constants and branches jumps, blocks that never ran drop out on compaction */
+	for(u32 v = 0; v < inst_count; v += 1){
+		IrInst* inst = &f->insts.v[v];
+		if(!s.executable[s.block_of[v]]){ continue; }
+		if(s.state[v] == OptLattice_Const && inst->op != IrOp_Const){
+			*inst = (IrInst){ .op = IrOp_Const, .type = inst->type, .offset = inst->offset,
+				.a = (u32)s.bits[v], .b = (u32)(s.bits[v] >> 32) };
+			stats->folded += 1;
+		}
+		else if(inst->op == IrOp_Branch && s.state[inst->a] == OptLattice_Const){
+			u32 target = s.bits[inst->a] != 0 ? inst->b : inst->c;
+			*inst = (IrInst){ .op = IrOp_Jump, .type = ConstKind_None, .offset = inst->offset, .a = target };
+			stats->branches += 1;
+		}
+	}
+	ir_compact(f);
+}
+
+//// Dead code
+/* False for instructions that can raise a runtime error or have an effect besides their value */
+static
+bool opt_removable(IrFunction const* f, IrInst const* inst){
+	switch((IrOp)inst->op){
+	case IrOp_Add: case IrOp_Sub: case IrOp_Mul: case IrOp_Neg:
+		return inst->type != ConstKind_Int;
+
+	case IrOp_Div: case IrOp_Mod: case IrOp_Shl: case IrOp_Shr: {
+		if(inst->type != ConstKind_Int){ return true; }
+		IrInst const* rhs = &f->insts.v[inst->b];
+		if(rhs->op != IrOp_Const){ return false; }
+		i64 r = ir_const_value(rhs).value.integer;
+		return inst->op == IrOp_Shl || inst->op == IrOp_Shr ? r >= 0 && r <= 63 : r != 0 && r != -1;
+	}
+
+	case IrOp_Const: case IrOp_Param: case IrOp_Undef: case IrOp_GetGlobal: case IrOp_Phi:
+	case IrOp_And: case IrOp_Or: case IrOp_Xor: case IrOp_Eq: case IrOp_Ne: case IrOp_Lt: case IrOp_Le:
+	case IrOp_BitNot: case IrOp_Not: case IrOp_Nop:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void ir_eliminate_dead_code(IrFunction* f, IrOptStats* stats){
+	Arena* arena = f->insts.arena;
+	u32 inst_count = (u32)f->insts.len;
+	u8* live = arena_make(arena, u8, max(inst_count, 1u));
+	u32* work = arena_make(arena, u32, max(inst_count, 1u));
+	ensure(live != NULL && work != NULL, "Failed to allocate IR scratch");
+
+	u32 work_len = 0;
+	for(u32 v = 0; v < inst_count; v += 1){
+		if(!opt_removable(f, &f->insts.v[v])){
+			live[v] = 1;
+			work[work_len++] = v;
+		}
+	}
+	while(work_len > 0){
+		IrUses uses = ir_uses(f, &f->insts.v[work[--work_len]]);
+		for(u32 k = 0; k < uses.len; k += 1){
+			u32 u = uses.v[k];
+			if(u != IR_NONE && !live[u]){
+				live[u] = 1;
+				work[work_len++] = u;
+			}
+		}
+	}
+
+	u32 dead = 0;
+	for(u32 v = 0; v < inst_count; v += 1){
+		if(!live[v] && f->insts.v[v].op != IrOp_Nop){
+			f->insts.v[v].op = IrOp_Nop;
+			dead += 1;
+		}
+	}
+	/* Merging compacts the function too, Nops only need their own pass when nothing merged */
+	u32 merged = ir_merge_blocks(f);
+	if(merged == 0 && dead > 0){
+		ir_compact(f);
+	}
+	stats->merged += merged;
+}
+
+IrOptStats ir_optimize(IrFunction* f){
+	IrOptStats stats = {0};
+	u32 before = (u32)f->insts.len;
+	ir_propagate_constants(f, &stats);
+	ir_eliminate_dead_code(f, &stats);
+	stats.removed = before - (u32)f->insts.len;
+	return stats;
+}
+
+//// Inlining
+/* Instructions a call to `f` would add, IR_NONE when it cannot be inlined: its entry must have no
+   predecessors to take the caller's edge, and it must return for the caller to continue */
+static
+u32 opt_inline_cost(IrFunction const* f){
+	if(f->blocks.len == 0 || f->blocks.v[0].pred_count > 0){
+		return IR_NONE;
+	}
+	u32 cost = 0;
+	bool returns = false;
+	for(isize v = 0; v < f->insts.len; v += 1){
+		cost += f->insts.v[v].op != IrOp_Param;
+		returns |= f->insts.v[v].op == IrOp_Return;
+	}
+	return returns ? cost : IR_NONE;
+}
+
+/* Value of the callee standing for `u` in the caller, parameters are the call's arguments */
+static inline
+u32 opt_inline_value(IrFunction const* f, IrFunction const* g, u32 arg_start, u32 base, u32 u){
+	if(u == IR_NONE){ return IR_NONE; }
+	IrInst const* inst = &g->insts.v[u];
+	return inst->op == IrOp_Param ? f->operands.v[arg_start + inst->a] : base + u;
+}
+
+/* Calls the budget allows in function `caller`, to callees of an earlier component */
+static inline
+bool opt_inline_site(u32 caller, IrInst const* inst, u32 const* component, u32 const* cost, u32 budget){
+	return inst->op == IrOp_Call && component[inst->a] != component[caller] && cost[inst->a] <= budget;
+}
+
+/* Splits the block of each call at the call, which becomes a jump to a copy of the callee's blocks.
+   Their returns jump to the rest of the block, which starts with a phi of the returned values
+   standing for the call. Everything is appended and laid out once at the end. */
+static
+u32 opt_inline_calls(IrModule* m, u32 caller, u32 const* component, u32 const* cost, IrOptOptions const* options){
+	IrFunction* f = &m->functions[caller];
+	Arena* arena = f->insts.arena;
+	u32 inst_count = (u32)f->insts.len;
+	u32 block_count = (u32)f->blocks.len;
+
+	u32 sites = 0;
+	u32 new_insts = 0;
+	u32 new_blocks = 0;
+	for(u32 v = 0; v < inst_count; v += 1){
+		IrInst const* inst = &f->insts.v[v];
+		if(opt_inline_site(caller, inst, component, cost, options->inline_budget)){
+			IrFunction const* g = &m->functions[inst->a];
+			sites += 1;
+			new_insts += (u32)g->insts.len + 1;
+			new_blocks += (u32)g->blocks.len + 1;
+		}
+	}
+	if(sites == 0){
+		return 0;
+	}
+
+	dyn_reserve(&f->insts, inst_count + new_insts);
+	dyn_reserve(&f->blocks, block_count + new_blocks);
+	u32* replace = ir_temp(arena, inst_count + new_insts, IR_NONE);
+	u32* phi_next = ir_temp(arena, inst_count + new_insts, IR_NONE);
+	u32* phi_head = ir_temp(arena, block_count + new_blocks, IR_NONE);
+	DynArray(u32) returns = { .arena = arena };
+
+	for(u32 b = 0; b < block_count; b += 1){
+		u32 first = f->blocks.v[b].first;
+		u32 end = first + f->blocks.v[b].count;
+		u32 tail = b; /* Block holding what follows the last inlined call */
+		for(u32 v = first; v < end; v += 1){
+			IrInst call = f->insts.v[v];
+			if(!opt_inline_site(caller, &call, component, cost, options->inline_budget)){ continue; }
+			IrFunction const* g = &m->functions[call.a];
+			u32 base = (u32)f->insts.len;
+			u32 block_base = (u32)f->blocks.len;
+			u32 rest = block_base + (u32)g->blocks.len;
+			returns.len = 0;
+
+			#define OPT_VALUE(U) opt_inline_value(f, g, call.b, base, (U))
+			for(u32 j = 0; j < (u32)g->blocks.len; j += 1){
+				IrBlock const* gb = &g->blocks.v[j];
+				for(u32 u = gb->first; u < gb->first + gb->count; u += 1){
+					IrInst inst = g->insts.v[u];
+					switch((IrOp)inst.op){
+					case IrOp_Param:
+						inst.op = IrOp_Nop;
+						break;
+
+					case IrOp_Phi: {
+						u32 start = (u32)f->operands.len;
+						for(u32 k = 0; k < inst.b; k += 1){
+							dyn_push(&f->operands, OPT_VALUE(g->operands.v[inst.a + k]));
+						}
+						for(u32 k = 0; k < inst.b; k += 1){
+							dyn_push(&f->operands, block_base + g->operands.v[inst.a + inst.b + k]);
+						}
+						inst.a = start;
+					} break;
+
+					case IrOp_Call: {
+						u32 start = (u32)f->operands.len;
+						for(u32 k = 0; k < inst.c; k += 1){
+							dyn_push(&f->operands, OPT_VALUE(g->operands.v[inst.b + k]));
+						}
+						inst.b = start;
+					} break;
+
+					case IrOp_Jump:
+						inst.a += block_base;
+						break;
+
+					case IrOp_Branch:
+						inst.a = OPT_VALUE(inst.a);
+						inst.b += block_base;
+						inst.c += block_base;
+						break;
+
+					case IrOp_Return:
+						if(inst.a != IR_NONE){
+							dyn_push(&returns, OPT_VALUE(inst.a));
+							dyn_push(&returns, block_base + j);
+						}
+						inst = (IrInst){ .op = IrOp_Jump, .type = ConstKind_None, .offset = inst.offset, .a = rest };
+						break;
+
+					default: {
+						IrUses uses = ir_uses(f, &inst);
+						for(u32 k = 0; k < uses.len; k += 1){
+							uses.v[k] = OPT_VALUE(uses.v[k]);
+						}
+					} break;
+					}
+					dyn_push(&f->insts, inst);
+				}
+				dyn_push(&f->blocks, ((IrBlock){ .first = base + gb->first, .count = gb->count, .idom = IR_NONE }));
+			}
+			#undef OPT_VALUE
+
+			/* The call's value: the only one returned, or a phi of them at the start of the rest */
+			u32 n = (u32)returns.len / 2;
+			if(n == 1){
+				replace[v] = returns.v[0];
+			}
+			else if(n > 1){
+				u32 start = (u32)f->operands.len;
+				for(u32 k = 0; k < n; k += 1){ dyn_push(&f->operands, returns.v[2 * k]); }
+				for(u32 k = 0; k < n; k += 1){ dyn_push(&f->operands, returns.v[2 * k + 1]); }
+				u32 phi = (u32)f->insts.len;
+				dyn_push(&f->insts, ((IrInst){ .op = IrOp_Phi, .type = call.type, .offset = call.offset, .a = start, .b = n }));
+				phi_head[rest] = phi;
+				replace[v] = phi;
+			}
+
+			f->blocks.v[tail].count = v + 1 - f->blocks.v[tail].first;
+			f->insts.v[v] = (IrInst){ .op = IrOp_Jump, .type = ConstKind_None, .offset = call.offset, .a = block_base };
+			dyn_push(&f->blocks, ((IrBlock){ .first = v + 1, .count = end - v - 1, .idom = IR_NONE }));
+			tail = rest;
+
+			if(options->inlined != NULL){
+				dyn_push(options->inlined, ((IrInlinedCall){ .caller = caller, .callee = call.a, .offset = call.offset }));
+			}
+		}
+
+		/* The successors' phis now come from the last piece of the block */
+		if(tail == b){ continue; }
+		IrBlock const* blk = &f->blocks.v[tail];
+		u32 succ[2];
+		u32 n = ir_successors(&f->insts.v[blk->first + blk->count - 1], succ);
+		for(u32 k = 0; k < n; k += 1){
+			IrBlock const* to = &f->blocks.v[succ[k]];
+			for(u32 p = to->first; p < to->first + to->count && f->insts.v[p].op == IrOp_Phi; p += 1){
+				IrInst const* phi = &f->insts.v[p];
+				for(u32 j = 0; j < phi->b; j += 1){
+					u32* pred = &f->operands.v[phi->a + phi->b + j];
+					if(*pred == b){ *pred = tail; }
+				}
+			}
+		}
+	}
+
+	ir_relayout(f, phi_head, phi_next, replace, NULL);
+	return sites;
+}
+
+static
+void opt_add_stats(IrOptStats* total, IrOptStats s){
+	total->folded += s.folded;
+	total->branches += s.branches;
+	total->removed += s.removed;
+	total->merged += s.merged;
+	total->inlined += s.inlined;
+}
+
+IrOptStats ir_optimize_module(IrModule* m, IrOptOptions const* options){
+	IrOptOptions none = {0};
+	if(options == NULL){
+		options = &none;
+	}
+	u32 n = m->function_count;
+	Arena* arena = n > 0 ? m->functions[0].insts.arena : NULL;
+	IrOptStats total = {0};
+	if(n == 0){
+		return total;
+	}
+
+	/* Call graph in CSR form */
+	u32* edge_start = ir_temp(arena, n + 1, 0);
+	for(u32 i = 0; i < n; i += 1){
+		IrFunction const* f = &m->functions[i];
+		for(isize v = 0; v < f->insts.len; v += 1){
+			edge_start[i + 1] += f->insts.v[v].op == IrOp_Call;
+		}
+		edge_start[i + 1] += edge_start[i];
+	}
+	u32* edges = ir_temp(arena, edge_start[n], 0);
+	for(u32 i = 0; i < n; i += 1){
+		IrFunction const* f = &m->functions[i];
+		u32 e = edge_start[i];
+		for(isize v = 0; v < f->insts.len; v += 1){
+			if(f->insts.v[v].op == IrOp_Call){ edges[e++] = f->insts.v[v].a; }
+		}
+	}
+
+	/* Tarjan's algorithm without recursion, components come out callees first */
+	u32* index = ir_temp(arena, n, IR_NONE);
+	u32* low = ir_temp(arena, n, 0);
+	u32* component = ir_temp(arena, n, IR_NONE);
+	u32* next_edge = ir_temp(arena, n, 0);
+	u32* path = ir_temp(arena, n, 0);   /* Functions being visited, innermost last */
+	u32* stack = ir_temp(arena, n, 0);  /* Functions not yet assigned to a component */
+	u32* order = ir_temp(arena, n, 0);  /* Functions by component */
+	u32* cost = ir_temp(arena, n, IR_NONE);
+	u32 counter = 0, path_len = 0, stack_len = 0, order_len = 0, component_count = 0;
+
+	for(u32 root = 0; root < n; root += 1){
+		if(index[root] != IR_NONE){ continue; }
+		index[root] = low[root] = counter++;
+		next_edge[root] = edge_start[root];
+		path[path_len++] = root;
+		stack[stack_len++] = root;
+		while(path_len > 0){
+			u32 fn = path[path_len - 1];
+			if(next_edge[fn] < edge_start[fn + 1]){
+				u32 callee = edges[next_edge[fn]++];
+				if(index[callee] == IR_NONE){
+					index[callee] = low[callee] = counter++;
+					next_edge[callee] = edge_start[callee];
+					path[path_len++] = callee;
+					stack[stack_len++] = callee;
+				}
+				else if(component[callee] == IR_NONE){
+					low[fn] = min(low[fn], index[callee]);
+				}
+				continue;
+			}
+			path_len -= 1;
+			if(path_len > 0){
+				u32 parent = path[path_len - 1];
+				low[parent] = min(low[parent], low[fn]);
+			}
+			if(low[fn] == index[fn]){
+				u32 member;
+				do {
+					member = stack[--stack_len];
+					component[member] = component_count;
+					order[order_len++] = member;
+				} while(member != fn);
+				component_count += 1;
+			}
+		}
+	}
+
+	/* Every callee outside the caller's component is final by the time the caller is reached */
+	for(u32 i = 0; i < n; i += 1){
+		u32 fn = order[i];
+		IrFunction* f = &m->functions[fn];
+		u32 inlined = options->inline_budget > 0 ? opt_inline_calls(m, fn, component, cost, options) : 0;
+		IrOptStats s = ir_optimize(f);
+		s.inlined = inlined;
+		cost[fn] = opt_inline_cost(f);
+		if(options->function_stats != NULL){
+			options->function_stats[fn] = s;
+		}
+		opt_add_stats(&total, s);
+	}
+	return total;
+}
@@ -0,0 +1,964 @@
+#include "kielo.h"
+#include "base/thread.h"
+
+String ast_kind_name(AstKind k){
+	String s = str_lit("<INVALID AST KIND>");
+	switch(k){
+	#define X(Name, Lhs, Rhs) case AstKind_##Name: s = str_lit(#Name); break;
+	AST_KINDS
+	#undef X
+	case AstKind__len: break;
+	}
+	return s;
+}
+
+//// AST storage
+static const struct { u8 lhs; u8 rhs; } ast_layout[AstKind__len] = {
+	#define X(Name, Lhs, Rhs) [AstKind_##Name] = { AstField_##Lhs, AstField_##Rhs },
+	AST_KINDS
+	#undef X
+};
+
+Ast ast_create(Arena* arena, u32 node_capacity){
+	node_capacity = max(node_capacity, (u32)16);
+	Ast ast = {
+		.kind  = arena_make(arena, u8, node_capacity),
+		.token = arena_make(arena, u32, node_capacity),
+		.lhs   = arena_make(arena, u32, node_capacity),
+		.rhs   = arena_make(arena, u32, node_capacity),
+		.cap = node_capacity,
+		.extra = arena_make(arena, u32, node_capacity),
+		.extra_cap = node_capacity,
+		.arena = arena,
+	};
+	ensure(ast.kind && ast.token && ast.lhs && ast.rhs && ast.extra, "Failed to allocate AST");
+
+	ast_add_node(&ast, AstKind_Invalid, 0, AST_NULL, AST_NULL); /* AST_NULL */
+	return ast;
+}
+
+static
+void ast_reserve(Ast* ast, u32 capacity){
+	if(capacity <= ast->cap){ return; }
+	ensure(ast->arena != NULL, "AST is read-only");
+	u32 new_cap = max(ast->cap * 2, capacity);
+	ast->kind  = arena_realloc(ast->arena, ast->kind,  ast->cap * sizeof(u8),  new_cap * sizeof(u8),  alignof(u8));
+	ast->token = arena_realloc(ast->arena, ast->token, ast->cap * sizeof(u32), new_cap * sizeof(u32), alignof(u32));
+	ast->lhs   = arena_realloc(ast->arena, ast->lhs,   ast->cap * sizeof(u32), new_cap * sizeof(u32), alignof(u32));
+	ast->rhs   = arena_realloc(ast->arena, ast->rhs,   ast->cap * sizeof(u32), new_cap * sizeof(u32), alignof(u32));
+	ensure(ast->kind && ast->token && ast->lhs && ast->rhs, "Failed to allocate AST");
+	ast->cap = new_cap;
+}
+
+u32 ast_add_node(Ast* ast, AstKind kind, u32 token, u32 lhs, u32 rhs){
+	if(ast->len == ast->cap){
+		ast_reserve(ast, ast->len + 1);
+	}
+	u32 n = ast->len;
+	ast->kind[n]  = (u8)kind;
+	ast->token[n] = token;
+	ast->lhs[n]   = lhs;
+	ast->rhs[n]   = rhs;
+	ast->len += 1;
+	return n;
+}
+
+u32 ast_add_extra(Ast* ast, u32 const* values, u32 count){
+	if(ast->extra_len + count > ast->extra_cap){
+		u32 new_cap = max(ast->extra_cap * 2, ast->extra_len + count);
+		ast->extra = arena_realloc(ast->arena, ast->extra, ast->extra_cap * sizeof(u32), new_cap * sizeof(u32), alignof(u32));
+		ensure(ast->extra != NULL, "Failed to allocate AST");
+		ast->extra_cap = new_cap;
+	}
+	u32 start = ast->extra_len;
+	mem_copy_no_overlap(ast->extra + start, values, count * sizeof(u32));
+	ast->extra_len += count;
+	return start;
+}
+
+/* Range of `extra` holding child nodes, counts stored in `extra` are not part of it */
+static
+void ast_child_list(Ast const* ast, u32 node, u32* start, u32* count){
+	u32 lhs = ast->lhs[node];
+	u32 rhs = ast->rhs[node];
+	switch((AstKind)ast->kind[node]){
+	case AstKind_File: case AstKind_Block:
+		*start = lhs; *count = rhs;
+		break;
+	case AstKind_FnProto: /* Parameters and the return type */
+		*start = lhs; *count = rhs + 1;
+		break;
+	case AstKind_If:
+		*start = rhs; *count = 2;
+		break;
+	case AstKind_Call:
+		*start = rhs + 1; *count = ast->extra[rhs];
+		break;
+	default:
+		*start = 0; *count = 0;
+		break;
+	}
+}
+
+static inline
+u32 ast_relocate(u32 value, AstField field, u32 delta, u32 extra_delta){
+	switch(field){
+	case AstField_Node:  return value == AST_NULL ? AST_NULL : value + delta;
+	case AstField_Extra: return value + extra_delta;
+	default:             return value;
+	}
+}
+
+u32 ast_append(Ast* dst, Ast const* src){
+	u32 delta = dst->len - 1;
+	u32 extra_delta = dst->extra_len;
+	u32 first = dst->len;
+	u32 n = src->len - 1;
+
+	ast_reserve(dst, dst->len + n);
+	mem_copy_no_overlap(dst->kind  + first, src->kind  + 1, n * sizeof(u8));
+	mem_copy_no_overlap(dst->token + first, src->token + 1, n * sizeof(u32));
+	mem_copy_no_overlap(dst->lhs   + first, src->lhs   + 1, n * sizeof(u32));
+	mem_copy_no_overlap(dst->rhs   + first, src->rhs   + 1, n * sizeof(u32));
+	dst->len += n;
+	ast_add_extra(dst, src->extra, src->extra_len);
+
+	for(u32 i = first; i < dst->len; i += 1){
+		AstKind k = dst->kind[i];
+		dst->lhs[i] = ast_relocate(dst->lhs[i], ast_layout[k].lhs, delta, extra_delta);
+		dst->rhs[i] = ast_relocate(dst->rhs[i], ast_layout[k].rhs, delta, extra_delta);
+
+		u32 start = 0, count = 0;
+		ast_child_list(dst, i, &start, &count);
+		for(u32 c = start; c < start + count; c += 1){
+			dst->extra[c] = ast_relocate(dst->extra[c], AstField_Node, delta, extra_delta);
+		}
+	}
+	return delta;
+}
+
+//// Parser state
+static
+Parser parser_create_ex(String source, TokenArray tokens, u32 node_capacity, Arena* arena, Arena* error_arena){
+	ensure(tokens.len > 0 && tokens.v[tokens.len - 1].kind == TokenKind_EndOfFile, "Token array must end with EOF");
+
+	Parser p = {
+		.tokens = tokens,
+		.source = source,
+		.current = 0,
+		.ast = ast_create(arena, node_capacity),
+		.stack = arena_make(arena, u32, 64),
+		.stack_cap = 64,
+		.error_arena = error_arena,
+		.max_errors = LEXER_DEFAULT_MAX_ERRORS,
+	};
+	ensure(p.stack != NULL, "Failed to allocate parser stack");
+	return p;
+}
+
+Parser parser_create(String source, TokenArray tokens, Arena* arena, Arena* error_arena){
+	/* Most tokens end up owning one node */
+	return parser_create_ex(source, tokens, (u32)tokens.len + 2, arena, error_arena);
+}
+
+static inline
+TokenKind parser_kind(Parser const* p){
+	return p->tokens.v[p->current].kind;
+}
+
+/* Returns the index of the consumed token, EOF is never consumed */
+static inline
+u32 parser_advance(Parser* p){
+	u32 i = p->current;
+	if(p->tokens.v[i].kind != TokenKind_EndOfFile){
+		p->current += 1;
+	}
+	return i;
+}
+
+static inline
+bool parser_match(Parser* p, TokenKind k){
+	if(parser_kind(p) == k){
+		parser_advance(p);
+		return true;
+	}
+	return false;
+}
+
+static inline
+isize parser_token_offset(Parser const* p, u32 token){
+	return p->tokens.v[token].lexeme.v - p->source.v;
+}
+
+/* Lexeme for error messages, EOF has none */
+static inline
+String parser_token_text(Parser const* p, u32 token){
+	Token const* tk = &p->tokens.v[token];
+	return tk->kind == TokenKind_EndOfFile ? token_kind_name(tk->kind) : tk->lexeme;
+}
+
+static
+void parser_emit_error_v(Parser* p, ParserError type, char const* fmt, va_list argp){
+	/* Only the first error until the parser resynchronizes, the rest are usually noise */
+	if(p->panicking){
+		return;
+	}
+	p->panicking = true;
+
+	p->error_count += 1;
+	if(p->error_count > p->max_errors + 1){
+		return;
+	}
+
+	CompilerError* err = arena_make(p->error_arena, CompilerError, 1);
+	err->stage = CompilerStage_Parse;
+	err->offset = parser_token_offset(p, p->current);
+	err->filename = p->filename;
+
+	if(p->error_count > p->max_errors){
+		err->type = ParserError_TooManyErrors;
+		err->message = str_format(p->error_arena, "Too many errors (limit is %d), further errors in this file are not reported", p->max_errors);
+	}
+	else {
+		err->type = (u32)type;
+		err->message = str_vformat(p->error_arena, fmt, argp);
+	}
+
+	compiler_error_insert(&p->error, &p->error_tail, err);
+}
+
+void parser_emit_error(Parser* p, ParserError type, char const* fmt, ...){
+	va_list argp;
+	va_start(argp, fmt);
+	parser_emit_error_v(p, type, fmt, argp);
+	va_end(argp);
+}
+
+/* Consumes a token of kind `k`, otherwise reports it and leaves the current token in place */
+static
+u32 parser_expect(Parser* p, TokenKind k){
+	if(parser_kind(p) == k){
+		return parser_advance(p);
+	}
+	String found = parser_token_text(p, p->current);
+	parser_emit_error(p, ParserError_UnexpectedToken, "Expected '%.*s', found '%.*s'", str_fmt(token_kind_name(k)), str_fmt(found));
+	return p->current;
+}
+
+static
+void parser_push(Parser* p, u32 node){
+	if(p->stack_len == p->stack_cap){
+		u32 new_cap = p->stack_cap * 2;
+		p->stack = arena_realloc(p->ast.arena, p->stack, p->stack_cap * sizeof(u32), new_cap * sizeof(u32), alignof(u32));
+		ensure(p->stack != NULL, "Failed to allocate parser stack");
+		p->stack_cap = new_cap;
+	}
+	p->stack[p->stack_len] = node;
+	p->stack_len += 1;
+}
+
+/* Moves the nodes pushed since `base` into `extra` */
+static
+u32 parser_pop_list(Parser* p, u32 base){
+	u32 start = ast_add_extra(&p->ast, p->stack + base, p->stack_len - base);
+	p->stack_len = base;
+	return start;
+}
+
+static inline
+bool parser_at_statement_start(Parser const* p){
+	switch(parser_kind(p)){
+	case TokenKind_Let: case TokenKind_Fn: case TokenKind_Return: case TokenKind_If:
+	case TokenKind_For: case TokenKind_Break: case TokenKind_Continue: case TokenKind_CurlyOpen:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Panic mode recovery: skips to just past the next ';', or up to a '}' or a statement keyword */
+static
+void parser_synchronize(Parser* p){
+	if(!p->panicking){ return; }
+	p->panicking = false;
+
+	/* The broken statement still reached its terminator */
+	if(p->current > 0 && p->tokens.v[p->current - 1].kind == TokenKind_Semicolon){
+		return;
+	}
+
+	for(;;){
+		TokenKind k = parser_kind(p);
+		if(k == TokenKind_EndOfFile || k == TokenKind_CurlyClose || parser_at_statement_start(p)){
+			return;
+		}
+		parser_advance(p);
+		if(k == TokenKind_Semicolon){
+			return;
+		}
+	}
+}
+
+//// Expressions
+static
+u32 parser_parse_primary(Parser* p){
+	switch(parser_kind(p)){
+	case TokenKind_Identifier:
+		return ast_add_node(&p->ast, AstKind_Ident, parser_advance(p), AST_NULL, AST_NULL);
+	case TokenKind_Integer:
+		return ast_add_node(&p->ast, AstKind_Integer, parser_advance(p), AST_NULL, AST_NULL);
+	case TokenKind_Real:
+		return ast_add_node(&p->ast, AstKind_Real, parser_advance(p), AST_NULL, AST_NULL);
+	case TokenKind_String:
+		return ast_add_node(&p->ast, AstKind_String, parser_advance(p), AST_NULL, AST_NULL);
+
+	case TokenKind_ParenOpen: {
+		parser_advance(p);
+		u32 inner = parser_parse_expression(p, 0);
+		parser_expect(p, TokenKind_ParenClose);
+		return inner;
+	}
+
+	default: {
+		String found = parser_token_text(p, p->current);
+		parser_emit_error(p, ParserError_ExpectedExpression, "Expected expression, found '%.*s'", str_fmt(found));
+		return ast_add_node(&p->ast, AstKind_Invalid, p->current, AST_NULL, AST_NULL);
+	}
+	}
+}
+
+static
+u32 parser_parse_postfix(Parser* p){
+	u32 node = parser_parse_primary(p);
+	for(;;){
+		switch(parser_kind(p)){
+		case TokenKind_ParenOpen: {
+			u32 paren = parser_advance(p);
+			u32 base = p->stack_len;
+			while(parser_kind(p) != TokenKind_ParenClose && parser_kind(p) != TokenKind_EndOfFile){
+				parser_push(p, parser_parse_expression(p, 0));
+				if(!parser_match(p, TokenKind_Comma)){ break; }
+			}
+			parser_expect(p, TokenKind_ParenClose);
+
+			u32 count = p->stack_len - base;
+			u32 args = ast_add_extra(&p->ast, &count, 1);
+			parser_pop_list(p, base);
+			node = ast_add_node(&p->ast, AstKind_Call, paren, node, args);
+		} break;
+
+		case TokenKind_SquareOpen: {
+			u32 square = parser_advance(p);
+			u32 index = parser_parse_expression(p, 0);
+			parser_expect(p, TokenKind_SquareClose);
+			node = ast_add_node(&p->ast, AstKind_Index, square, node, index);
+		} break;
+
+		case TokenKind_Dot: {
+			parser_advance(p);
+			u32 field = parser_expect(p, TokenKind_Identifier);
+			node = ast_add_node(&p->ast, AstKind_Member, field, node, AST_NULL);
+		} break;
+
+		default:
+			return node;
+		}
+	}
+}
+
+static
+u32 parser_parse_unary(Parser* p){
+	switch(parser_kind(p)){
+	case TokenKind_Minus: case TokenKind_LogicNot: case TokenKind_Tilde: {
+		u32 op = parser_advance(p);
+		u32 operand = parser_parse_unary(p);
+		return ast_add_node(&p->ast, AstKind_Unary, op, operand, AST_NULL);
+	}
+	default:
+		return parser_parse_postfix(p);
+	}
+}
+
+u32 parser_parse_expression(Parser* p, i32 min_precedence){
+	u32 lhs = parser_parse_unary(p);
+	for(;;){
+		TokenKind k = parser_kind(p);
+		i32 prec = token_precedence[k];
+		if(prec == 0 || prec < min_precedence){
+			break;
+		}
+		u32 op = parser_advance(p);
+		bool assign = (token_flags[k] & TokenFlag_Assignment) != 0;
+		u32 rhs = parser_parse_expression(p, assign ? prec : prec + 1);
+		lhs = ast_add_node(&p->ast, assign ? AstKind_Assign : AstKind_Binary, op, lhs, rhs);
+	}
+	return lhs;
+}
+
+//// Statements
+static
+u32 parser_parse_type(Parser* p){
+	if(parser_kind(p) == TokenKind_Identifier){
+		return ast_add_node(&p->ast, AstKind_TypeName, parser_advance(p), AST_NULL, AST_NULL);
+	}
+	parser_expect(p, TokenKind_Identifier);
+	return ast_add_node(&p->ast, AstKind_Invalid, p->current, AST_NULL, AST_NULL);
+}
+
+static
+u32 parser_parse_let(Parser* p){
+	u32 let = parser_advance(p);
+	parser_expect(p, TokenKind_Identifier);
+
+	u32 type = AST_NULL;
+	if(parser_match(p, TokenKind_Colon)){
+		type = parser_parse_type(p);
+	}
+	u32 init = AST_NULL;
+	if(parser_match(p, TokenKind_Assign)){
+		init = parser_parse_expression(p, 0);
+	}
+	parser_expect(p, TokenKind_Semicolon);
+	return ast_add_node(&p->ast, AstKind_Let, let, type, init);
+}
+
+static
+u32 parser_parse_if(Parser* p){
+	u32 tk = parser_advance(p);
+	u32 branches[2] = {0};
+	u32 cond = parser_parse_expression(p, 0);
+	branches[0] = parser_parse_block(p);
+	if(parser_match(p, TokenKind_Else)){
+		branches[1] = parser_kind(p) == TokenKind_If ? parser_parse_if(p) : parser_parse_block(p);
+	}
+	return ast_add_node(&p->ast, AstKind_If, tk, cond, ast_add_extra(&p->ast, branches, 2));
+}
+
+u32 parser_parse_statement(Parser* p){
+	switch(parser_kind(p)){
+	case TokenKind_Let:
+		return parser_parse_let(p);
+
+	case TokenKind_Return: {
+		u32 ret = parser_advance(p);
+		u32 value = AST_NULL;
+		if(parser_kind(p) != TokenKind_Semicolon){
+			value = parser_parse_expression(p, 0);
+		}
+		parser_expect(p, TokenKind_Semicolon);
+		return ast_add_node(&p->ast, AstKind_Return, ret, value, AST_NULL);
+	}
+
+	case TokenKind_If:
+		return parser_parse_if(p);
+
+	case TokenKind_For: {
+		u32 tk = parser_advance(p);
+		u32 cond = AST_NULL;
+		if(parser_kind(p) != TokenKind_CurlyOpen){
+			cond = parser_parse_expression(p, 0);
+		}
+		u32 body = parser_parse_block(p);
+		return ast_add_node(&p->ast, AstKind_For, tk, cond, body);
+	}
+
+	case TokenKind_Break: case TokenKind_Continue: {
+		AstKind kind = parser_kind(p) == TokenKind_Break ? AstKind_Break : AstKind_Continue;
+		u32 tk = parser_advance(p);
+		parser_expect(p, TokenKind_Semicolon);
+		return ast_add_node(&p->ast, kind, tk, AST_NULL, AST_NULL);
+	}
+
+	case TokenKind_CurlyOpen:
+		return parser_parse_block(p);
+
+	default: {
+		u32 expr = parser_parse_expression(p, 0);
+		u32 semi = parser_expect(p, TokenKind_Semicolon);
+		return ast_add_node(&p->ast, AstKind_ExprStmt, semi, expr, AST_NULL);
+	}
+	}
+}
+
+u32 parser_parse_block(Parser* p){
+	u32 curly = parser_expect(p, TokenKind_CurlyOpen);
+	if(p->tokens.v[curly].kind != TokenKind_CurlyOpen){
+		return ast_add_node(&p->ast, AstKind_Invalid, curly, AST_NULL, AST_NULL);
+	}
+
+	u32 base = p->stack_len;
+	while(parser_kind(p) != TokenKind_CurlyClose && parser_kind(p) != TokenKind_EndOfFile){
+		u32 start = p->current;
+		parser_push(p, parser_parse_statement(p));
+		parser_synchronize(p);
+		if(p->current == start){
+			parser_advance(p); /* Always make progress */
+		}
+	}
+	parser_expect(p, TokenKind_CurlyClose);
+
+	u32 count = p->stack_len - base;
+	u32 start = parser_pop_list(p, base);
+	return ast_add_node(&p->ast, AstKind_Block, curly, start, count);
+}
+
+/* Skips a brace balanced body, unterminated bodies are parsed right away so they report their errors */
+static
+u32 parser_defer_body(Parser* p){
+	u32 curly = parser_advance(p);
+	u32 depth = 1;
+	while(parser_kind(p) != TokenKind_EndOfFile){
+		TokenKind k = parser_kind(p);
+		depth += (k == TokenKind_CurlyOpen);
+		depth -= (k == TokenKind_CurlyClose);
+		u32 tk = parser_advance(p);
+		if(depth == 0){
+			return ast_add_node(&p->ast, AstKind_DeferredBody, curly, tk, AST_NULL);
+		}
+	}
+	p->current = curly;
+	return parser_parse_block(p);
+}
+
+u32 parser_parse_fn(Parser* p){
+	u32 fn = parser_advance(p);
+	u32 name = parser_expect(p, TokenKind_Identifier);
+
+	parser_expect(p, TokenKind_ParenOpen);
+	u32 base = p->stack_len;
+	while(parser_kind(p) == TokenKind_Identifier){
+		u32 param = parser_advance(p);
+		parser_expect(p, TokenKind_Colon);
+		parser_push(p, ast_add_node(&p->ast, AstKind_Param, param, parser_parse_type(p), AST_NULL));
+		if(!parser_match(p, TokenKind_Comma)){ break; }
+	}
+	parser_expect(p, TokenKind_ParenClose);
+
+	u32 ret = AST_NULL;
+	if(parser_match(p, TokenKind_RightArrow)){
+		ret = parser_parse_type(p);
+	}
+	parser_push(p, ret);
+
+	u32 count = p->stack_len - base - 1;
+	u32 proto = ast_add_node(&p->ast, AstKind_FnProto, name, parser_pop_list(p, base), count);
+	u32 body = (p->defer_bodies && parser_kind(p) == TokenKind_CurlyOpen) ? parser_defer_body(p) : parser_parse_block(p);
+	return ast_add_node(&p->ast, AstKind_Fn, fn, proto, body);
+}
+
+u32 parser_parse_file(Parser* p){
+	u32 base = p->stack_len;
+	while(parser_kind(p) != TokenKind_EndOfFile){
+		switch(parser_kind(p)){
+		case TokenKind_Fn:
+			p->panicking = false;
+			parser_push(p, parser_parse_fn(p));
+			break;
+		case TokenKind_Let:
+			p->panicking = false;
+			parser_push(p, parser_parse_let(p));
+			break;
+		default: {
+			String found = parser_token_text(p, p->current);
+			parser_emit_error(p, ParserError_UnexpectedToken, "Expected declaration, found '%.*s'", str_fmt(found));
+			/* Skip to the next declaration */
+			while(parser_kind(p) != TokenKind_EndOfFile && parser_kind(p) != TokenKind_Fn && parser_kind(p) != TokenKind_Let){
+				parser_advance(p);
+			}
+		} break;
+		}
+	}
+
+	u32 count = p->stack_len - base;
+	return ast_add_node(&p->ast, AstKind_File, 0, parser_pop_list(p, base), count);
+}
+
+u32 parser_fn_body(Parser* p, u32 fn){
+	ensure(p->ast.kind[fn] == AstKind_Fn, "Not a function");
+	u32 body = p->ast.rhs[fn];
+	if(p->ast.kind[body] != AstKind_DeferredBody){
+		return body;
+	}
+
+	u32 saved = p->current;
+	p->current = p->ast.token[body];
+	p->panicking = false;
+	body = parser_parse_block(p);
+	p->panicking = false;
+	p->current = saved;
+
+	p->ast.rhs[fn] = body;
+	return body;
+}
+
+//// Parallel parsing
+typedef DynArray(FnSpan) FnSpanList;
+
+FnSpanArray parser_skim(TokenArray tokens, Arena* arena){
+	FnSpanList spans = { .arena = arena };
+	dyn_reserve(&spans, 64);
+
+	FnSpan span = {0};
+	bool pending = false;
+	u32 depth = 0;
+	for(u32 i = 0; i < (u32)tokens.len; i += 1){
+		switch(tokens.v[i].kind){
+		case TokenKind_Fn:
+			if(depth == 0){
+				span.fn = i;
+				pending = true;
+			}
+			break;
+
+		case TokenKind_CurlyOpen:
+			if(depth == 0 && pending){
+				span.body_begin = i;
+			}
+			depth += 1;
+			break;
+
+		case TokenKind_CurlyClose:
+			if(depth == 0){ break; }
+			depth -= 1;
+			if(depth == 0 && pending){
+				span.body_end = i;
+				pending = false;
+				dyn_push(&spans, span);
+			}
+			break;
+
+		default: break;
+		}
+	}
+	return (FnSpanArray){ .v = spans.v, .len = (u32)spans.len };
+}
+
+typedef struct {
+	Parser parser; /* Written by the worker */
+	TokenArray tokens;
+	String source;
+	String filename;
+	FnSpan const* spans;
+	u32 span_count;
+	u32* roots; /* Body of each span, in the worker's AST until merged */
+	u32 token_count;
+	Arena arena;
+	byte* arena_mem;
+} ParseJob;
+
+static
+void parser_run_job(void* arg){
+	ParseJob* job = arg;
+	job->parser = parser_create_ex(job->source, job->tokens, job->token_count + 2, &job->arena, &job->arena);
+	Parser* w = &job->parser;
+	w->filename = job->filename;
+
+	for(u32 i = 0; i < job->span_count; i += 1){
+		w->current = job->spans[i].body_begin;
+		w->panicking = false;
+		job->roots[i] = parser_parse_block(w);
+	}
+}
+
+static inline
+u32 fn_span_size(FnSpan s){
+	return s.body_end - s.body_begin + 1;
+}
+
+/* Index of the span whose body starts at `curly`, -1 if none */
+static
+i64 fn_span_find(FnSpanArray spans, u32 curly){
+	u32 lo = 0, hi = spans.len;
+	while(lo < hi){
+		u32 mid = lo + (hi - lo) / 2;
+		if(spans.v[mid].body_begin < curly){ lo = mid + 1; } else { hi = mid; }
+	}
+	return (lo < spans.len && spans.v[lo].body_begin == curly) ? (i64)lo : -1;
+}
+
+/* Copies the errors that fall inside a used span, bodies the declaration pass rejected are ignored */
+static
+void parser_merge_errors(Parser* p, Parser const* w, FnSpanArray spans, bool const* used){
+	u32 span = 0;
+	for(CompilerError const* err = w->error; err != NULL; err = err->next){
+		while(span < spans.len && parser_token_offset(p, spans.v[span].body_end) < (isize)err->offset){
+			span += 1;
+		}
+		if(span == spans.len || !used[span] || parser_token_offset(p, spans.v[span].body_begin) > (isize)err->offset){
+			continue;
+		}
+
+		CompilerError* copy = arena_make(p->error_arena, CompilerError, 1);
+		*copy = *err;
+		copy->message = str_format(p->error_arena, "%.*s", str_fmt(err->message));
+		compiler_error_insert(&p->error, &p->error_tail, copy);
+		p->error_count += 1;
+	}
+}
+
+u32 parser_parse_file_parallel(Parser* p, i32 thread_count){
+	Arena* arena = p->ast.arena;
+	FnSpanArray spans = parser_skim(p->tokens, arena);
+	if(thread_count <= 1 || spans.len == 0){
+		return parser_parse_file(p);
+	}
+	u32 job_count = min((u32)thread_count, spans.len);
+
+	u64 total = 0;
+	for(u32 i = 0; i < spans.len; i += 1){
+		total += fn_span_size(spans.v[i]);
+	}
+
+	/* Contiguous runs of spans with about the same number of tokens each */
+	ParseJob* jobs = arena_make(arena, ParseJob, job_count);
+	Thread** threads = arena_make(arena, Thread*, job_count);
+	u32* roots = arena_make(arena, u32, spans.len);
+	bool* used = arena_make(arena, bool, spans.len);
+	ensure(jobs && threads && roots && used, "Failed to allocate parse jobs");
+
+	u32 first = 0;
+	u64 acc = 0;
+	for(u32 j = 0; j < job_count; j += 1){
+		u64 target = (total * (j + 1)) / job_count;
+		u32 last = first;
+		u32 limit = spans.len - (job_count - j - 1); /* Leave at least one span per remaining job */
+		while(last < limit && (last == first || acc < target || j + 1 == job_count)){
+			acc += fn_span_size(spans.v[last]);
+			last += 1;
+		}
+
+		ParseJob* job = &jobs[j];
+		job->tokens = p->tokens;
+		job->source = p->source;
+		job->filename = p->filename;
+		job->spans = spans.v + first;
+		job->span_count = last - first;
+		job->roots = roots + first;
+		for(u32 i = first; i < last; i += 1){
+			job->token_count += fn_span_size(spans.v[i]);
+		}
+
+		isize arena_size = mem_align_forward_size((isize)job->token_count * 32 + 64 * mem_kilobyte, 4096);
+		job->arena_mem = heap_alloc(arena_size, 4096);
+		job->arena = arena_create_dynamic(job->arena_mem, arena_size);
+		arena_set_tag(&job->arena, "parser worker");
+
+		threads[j] = thread_create(parser_run_job, job);
+		first = last;
+	}
+
+	/* Declarations and signatures are parsed here while the workers take the bodies */
+	p->defer_bodies = true;
+	u32 file = parser_parse_file(p);
+	p->defer_bodies = false;
+
+	for(u32 j = 0; j < job_count; j += 1){
+		thread_join(threads[j]);
+		thread_destroy(threads[j]);
+	}
+
+	for(u32 j = 0; j < job_count; j += 1){
+		ParseJob* job = &jobs[j];
+		u32 delta = ast_append(&p->ast, &job->parser.ast);
+		for(u32 i = 0; i < job->span_count; i += 1){
+			job->roots[i] += delta;
+		}
+	}
+
+	u32 decls = p->ast.lhs[file];
+	u32 decl_count = p->ast.rhs[file];
+	for(u32 d = decls; d < decls + decl_count; d += 1){
+		u32 fn = p->ast.extra[d];
+		u32 body = p->ast.rhs[fn];
+		if(p->ast.kind[fn] != AstKind_Fn || p->ast.kind[body] != AstKind_DeferredBody){
+			continue;
+		}
+
+		u32 curly = p->ast.token[body];
+		i64 span = fn_span_find(spans, curly);
+		if(span >= 0){
+			p->ast.rhs[fn] = roots[span];
+			used[span] = true;
+		}
+		else {
+			/* The skim disagreed with the declaration pass, parse the body here */
+			parser_fn_body(p, fn);
+		}
+	}
+
+	for(u32 j = 0; j < job_count; j += 1){
+		parser_merge_errors(p, &jobs[j].parser, spans, used);
+		arena_destroy(&jobs[j].arena);
+		heap_free(jobs[j].arena_mem);
+	}
+	return file;
+}
+
+//// Debug output
+typedef struct {
+	Arena* arena;
+	byte* v;
+	isize len;
+	isize cap;
+} AstWriter;
+
+static
+void ast_write(AstWriter* w, String s){
+	if(w->len + s.len > w->cap){
+		isize new_cap = max(w->cap * 2, w->len + s.len);
+		w->v = arena_realloc(w->arena, w->v, w->cap, new_cap, 1);
+		ensure(w->v != NULL, "Failed to allocate AST dump");
+		w->cap = new_cap;
+	}
+	mem_copy_no_overlap(w->v + w->len, s.v, s.len);
+	w->len += s.len;
+}
+
+static
+void ast_write_node(AstWriter* w, Ast const* ast, TokenArray tokens, u32 node);
+
+static
+void ast_write_list(AstWriter* w, Ast const* ast, TokenArray tokens, u32 start, u32 count){
+	for(u32 i = 0; i < count; i += 1){
+		ast_write(w, str_lit(" "));
+		ast_write_node(w, ast, tokens, ast->extra[start + i]);
+	}
+}
+
+static
+void ast_write_node(AstWriter* w, Ast const* ast, TokenArray tokens, u32 node){
+	if(node == AST_NULL){
+		ast_write(w, str_lit("_"));
+		return;
+	}
+
+	String lexeme = tokens.v[ast->token[node]].lexeme;
+	u32 lhs = ast->lhs[node];
+	u32 rhs = ast->rhs[node];
+
+	#define CHILD(N) { ast_write(w, str_lit(" ")); ast_write_node(w, ast, tokens, (N)); }
+
+	switch((AstKind)ast->kind[node]){
+	case AstKind_Ident: case AstKind_Integer: case AstKind_Real: case AstKind_String: case AstKind_TypeName:
+		ast_write(w, lexeme);
+		return;
+	case AstKind_Break: case AstKind_Continue:
+		ast_write(w, lexeme);
+		return;
+	case AstKind_Invalid:
+		ast_write(w, str_lit("<invalid>"));
+		return;
+	case AstKind_DeferredBody:
+		ast_write(w, str_lit("{...}"));
+		return;
+	case AstKind_ExprStmt:
+		ast_write_node(w, ast, tokens, lhs);
+		return;
+	default: break;
+	}
+
+	ast_write(w, str_lit("("));
+	switch((AstKind)ast->kind[node]){
+	case AstKind_File:
+		ast_write(w, str_lit("file"));
+		ast_write_list(w, ast, tokens, lhs, rhs);
+		break;
+
+	case AstKind_Fn: {
+		u32 proto = lhs;
+		u32 params = ast->lhs[proto];
+		u32 count = ast->rhs[proto];
+		ast_write(w, str_lit("fn "));
+		ast_write(w, tokens.v[ast->token[proto]].lexeme);
+		ast_write(w, str_lit(" ("));
+		for(u32 i = 0; i < count; i += 1){
+			u32 param = ast->extra[params + i];
+			ast_write(w, i > 0 ? str_lit(" (") : str_lit("("));
+			ast_write(w, tokens.v[ast->token[param]].lexeme);
+			CHILD(ast->lhs[param]);
+			ast_write(w, str_lit(")"));
+		}
+		ast_write(w, str_lit(")"));
+		CHILD(ast->extra[params + count]);
+		CHILD(rhs);
+	} break;
+
+	case AstKind_Block:
+		ast_write(w, str_lit("block"));
+		ast_write_list(w, ast, tokens, lhs, rhs);
+		break;
+
+	case AstKind_Let:
+		ast_write(w, str_lit("let "));
+		ast_write(w, tokens.v[ast->token[node] + 1].lexeme);
+		CHILD(lhs);
+		CHILD(rhs);
+		break;
+
+	case AstKind_Return:
+		ast_write(w, str_lit("return"));
+		if(lhs != AST_NULL){ CHILD(lhs); }
+		break;
+
+	case AstKind_If:
+		ast_write(w, str_lit("if"));
+		CHILD(lhs);
+		CHILD(ast->extra[rhs]);
+		if(ast->extra[rhs + 1] != AST_NULL){ CHILD(ast->extra[rhs + 1]); }
+		break;
+
+	case AstKind_For:
+		ast_write(w, str_lit("for"));
+		CHILD(lhs);
+		CHILD(rhs);
+		break;
+
+	case AstKind_Assign: case AstKind_Binary:
+		ast_write(w, lexeme);
+		CHILD(lhs);
+		CHILD(rhs);
+		break;
+
+	case AstKind_Unary:
+		ast_write(w, lexeme);
+		CHILD(lhs);
+		break;
+
+	case AstKind_Call:
+		ast_write(w, str_lit("call"));
+		CHILD(lhs);
+		ast_write_list(w, ast, tokens, rhs + 1, ast->extra[rhs]);
+		break;
+
+	case AstKind_Index:
+		ast_write(w, str_lit("index"));
+		CHILD(lhs);
+		CHILD(rhs);
+		break;
+
+	case AstKind_Member:
+		ast_write(w, str_lit("."));
+		CHILD(lhs);
+		ast_write(w, str_lit(" "));
+		ast_write(w, lexeme);
+		break;
+
+	default:
+		ast_write(w, ast_kind_name(ast->kind[node]));
+		break;
+	}
+	ast_write(w, str_lit(")"));
+
+	#undef CHILD
+}
+
+String ast_dump(Ast const* ast, TokenArray tokens, u32 node, Arena* arena){
+	AstWriter w = {
+		.arena = arena,
+		.v = arena_alloc(arena, 256, 1),
+		.cap = 256,
+	};
+	ensure(w.v != NULL, "Failed to allocate AST dump");
+	ast_write_node(&w, ast, tokens, node);
+	return (String){ .v = w.v, .len = w.len };
+}
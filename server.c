@@ -0,0 +1,432 @@
+#include "kielo.h"
+#include "base/hash.h"
+
+#if defined(OS_LINUX)
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define SERVER_MAGIC 0x5652534bu /* "KSRV" */
+#define SERVER_MAX_MESSAGE (256 * mem_megabyte)
+#define SERVER_FILE_ARENA_SIZE (1 * mem_megabyte)
+#define SERVER_IO_TIMEOUT_MS 1000 /* A client that stops sending or reading is dropped after this */
+
+/* Request:  magic, payload size, then cwd and the arguments, each as u32 length and bytes
+   Response: magic, exit status, output size, then the output */
+
+typedef struct {
+	String path; /* Owned by `arena` */
+	u64 path_hash;
+	i32 watch;
+	bool valid;
+	CompilationUnit unit;
+	Arena arena;
+	byte* arena_mem;
+} ServerFile;
+
+typedef struct {
+	ServerFile** files; /* Each allocated once, units handed to the driver point into them */
+	i32 file_count;
+	i32 file_cap;
+	int inotify_fd;
+	i64 hits;
+	i64 misses;
+	i64 invalidations;
+} ServerState;
+
+static
+void server_file_drop(ServerFile* f){
+	if(!f->valid){ return; }
+	unit_release(&f->unit);
+	arena_destroy(&f->arena);
+	heap_free(f->arena_mem);
+	*f = (ServerFile){ .watch = -1 };
+}
+
+/* Drops every unit whose file changed since it was compiled */
+static
+void server_drain_events(ServerState* st){
+	_Alignas(struct inotify_event) byte buf[4096];
+	for(;;){
+		ssize_t n = read(st->inotify_fd, buf, sizeof(buf));
+		if(n <= 0){ break; }
+
+		for(ssize_t off = 0; off < n;){
+			struct inotify_event const* ev = (struct inotify_event const*)(buf + off);
+			off += sizeof(struct inotify_event) + ev->len;
+
+			bool dropped = false;
+			for(i32 i = 0; i < st->file_count; i += 1){
+				ServerFile* f = st->files[i];
+				if(f->valid && f->watch == ev->wd){
+					server_file_drop(f);
+					st->invalidations += 1;
+					dropped = true;
+				}
+			}
+			if(dropped && !(ev->mask & IN_IGNORED)){
+				inotify_rm_watch(st->inotify_fd, ev->wd);
+			}
+		}
+	}
+}
+
+/* Entries never move: a unit points into its file's arena, and the driver holds on to the units
+   of every file in the request while more are added */
+static
+ServerFile* server_new_file(ServerState* st){
+	for(i32 i = 0; i < st->file_count; i += 1){
+		if(!st->files[i]->valid){ return st->files[i]; }
+	}
+	if(st->file_count == st->file_cap){
+		i32 new_cap = max(st->file_cap * 2, 16);
+		ServerFile** files = heap_alloc(new_cap * sizeof(ServerFile*), alignof(ServerFile*));
+		if(st->files != NULL){
+			mem_copy_no_overlap(files, st->files, st->file_count * sizeof(ServerFile*));
+			heap_free(st->files);
+		}
+		st->files = files;
+		st->file_cap = new_cap;
+	}
+	ServerFile* f = heap_alloc(sizeof(ServerFile), alignof(ServerFile));
+	*f = (ServerFile){ .watch = -1 };
+	st->files[st->file_count] = f;
+	st->file_count += 1;
+	return f;
+}
+
+static
+CompilationUnit* server_provide_unit(DriverContext* ctx, String path){
+	ServerState* st = ctx->user;
+	u64 hash = hash_bytes(path.v, path.len, 0);
+	for(i32 i = 0; i < st->file_count; i += 1){
+		ServerFile* f = st->files[i];
+		if(f->valid && f->path_hash == hash && str_equals(f->path, path)){
+			st->hits += 1;
+			return &f->unit;
+		}
+	}
+
+	st->misses += 1;
+	ServerFile* f = server_new_file(st);
+	f->arena_mem = heap_alloc(SERVER_FILE_ARENA_SIZE, 4096);
+	f->arena = arena_create_dynamic(f->arena_mem, SERVER_FILE_ARENA_SIZE);
+	arena_set_tag(&f->arena, "server file");
+	f->path = str_format(&f->arena, "%.*s", str_fmt(path));
+	f->path_hash = hash;
+	f->valid = true;
+
+	/* Watch before reading so a write in between is not missed */
+	f->watch = inotify_add_watch(st->inotify_fd, (char const*)f->path.v,
+		IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+
+	if(f->watch < 0 || !unit_compile(&f->unit, f->path, ctx->cache_dir, &f->arena)){
+		if(f->watch >= 0){
+			inotify_rm_watch(st->inotify_fd, f->watch);
+		}
+		server_file_drop(f);
+		/* Unreadable files are reported by the driver, but not remembered */
+		return NULL;
+	}
+	return &f->unit;
+}
+
+static
+bool server_send_all(int fd, void const* data, isize size){
+	byte const* p = data;
+	while(size > 0){
+		ssize_t n = send(fd, p, (size_t)size, MSG_NOSIGNAL);
+		if(n < 0 && errno == EINTR){ continue; }
+		if(n <= 0){ return false; }
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+static
+bool server_recv_all(int fd, void* data, isize size){
+	byte* p = data;
+	while(size > 0){
+		ssize_t n = recv(fd, p, (size_t)size, 0);
+		if(n < 0 && errno == EINTR){ continue; }
+		if(n <= 0){ return false; }
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+/* Reads a u32 length prefixed string out of `msg`, NUL terminated in place of the next prefix */
+static
+bool server_read_string(byte* msg, isize size, isize* cursor, Arena* arena, char const** out){
+	u32 len = 0;
+	if(*cursor + 4 > size){ return false; }
+	mem_copy_no_overlap(&len, msg + *cursor, 4);
+	*cursor += 4;
+	if((isize)len > size - *cursor){ return false; }
+
+	char* s = arena_alloc(arena, (isize)len + 1, 1);
+	if(s == NULL){ return false; }
+	mem_copy_no_overlap(s, msg + *cursor, len);
+	s[len] = 0;
+	*cursor += len;
+	*out = s;
+	return true;
+}
+
+/* Returns false when the server should stop */
+static
+bool server_handle(ServerState* st, int conn, Arena* scratch){
+	u32 header[2] = {0};
+	if(!server_recv_all(conn, header, sizeof(header)) || header[0] != SERVER_MAGIC || header[1] > SERVER_MAX_MESSAGE){
+		return true;
+	}
+
+	byte* msg = arena_alloc(scratch, max((isize)header[1], (isize)1), 8);
+	if(msg == NULL || !server_recv_all(conn, msg, header[1])){
+		return true;
+	}
+
+	isize cursor = 0;
+	char const* cwd = NULL;
+	u32 argc = 0;
+	bool ok = server_read_string(msg, header[1], &cursor, scratch, &cwd) && cursor + 4 <= (isize)header[1];
+	if(ok){
+		mem_copy_no_overlap(&argc, msg + cursor, 4);
+		cursor += 4;
+	}
+	char const** args = ok ? arena_make(scratch, char const*, max(argc, 1u)) : NULL;
+	ok = ok && args != NULL;
+	for(u32 i = 0; ok && i < argc; i += 1){
+		ok = server_read_string(msg, header[1], &cursor, scratch, &args[i]);
+	}
+	if(!ok){ return true; }
+
+	char* output = NULL;
+	size_t output_len = 0;
+	FILE* out = open_memstream(&output, &output_len);
+	if(out == NULL){ return true; }
+
+	int status = 0;
+	bool keep_running = true;
+	if(argc == 1 && __builtin_strcmp(args[0], "--shutdown") == 0){
+		fprintf(out, "Server stopped\n");
+		keep_running = false;
+	}
+	else if(argc == 1 && __builtin_strcmp(args[0], "--stats") == 0){
+		server_drain_events(st);
+		i32 live = 0;
+		for(i32 i = 0; i < st->file_count; i += 1){ live += st->files[i]->valid; }
+		fprintf(out, "files: %d hits: %lld misses: %lld invalidations: %lld\n",
+			live, (long long)st->hits, (long long)st->misses, (long long)st->invalidations);
+	}
+	else {
+		/* Changes are picked up once per request, dropping a unit in the middle of one would free
+		   what the driver already holds */
+		server_drain_events(st);
+		DriverContext ctx = {
+			.cwd = { .v = (byte const*)cwd, .len = (isize)__builtin_strlen(cwd) },
+			.scratch = scratch,
+			.provide_unit = server_provide_unit,
+			.user = st,
+		};
+		status = driver_run(&ctx, (int)argc, args, out);
+	}
+	fclose(out);
+
+	u32 response[3] = { SERVER_MAGIC, (u32)status, (u32)output_len };
+	if(server_send_all(conn, response, sizeof(response))){
+		server_send_all(conn, output, (isize)output_len);
+	}
+	free(output);
+	return keep_running;
+}
+
+static
+bool server_address(char const* socket_path, struct sockaddr_un* addr){
+	*addr = (struct sockaddr_un){ .sun_family = AF_UNIX };
+	isize len = (isize)__builtin_strlen(socket_path);
+	if(len == 0 || len >= (isize)sizeof(addr->sun_path)){
+		return false;
+	}
+	mem_copy_no_overlap(addr->sun_path, socket_path, len + 1);
+	return true;
+}
+
+int server_run(char const* socket_path){
+	struct sockaddr_un addr;
+	if(!server_address(socket_path, &addr)){
+		printf("Invalid socket path '%s'\n", socket_path);
+		return 2;
+	}
+
+	int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	unlink(socket_path); /* Left behind by a server that did not shut down cleanly */
+	if(listen_fd < 0 || bind(listen_fd, (struct sockaddr const*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 16) != 0){
+		printf("Could not listen on '%s'\n", socket_path);
+		if(listen_fd >= 0){ close(listen_fd); }
+		return 2;
+	}
+
+	ServerState st = {
+		.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC),
+	};
+	ensure(st.inotify_fd >= 0, "Failed to initialize inotify");
+
+	/* Warm across requests, reset after each one */
+	isize scratch_size = 64 * mem_megabyte;
+	byte* scratch_mem = heap_alloc(scratch_size, 4096);
+	Arena scratch = arena_create_dynamic(scratch_mem, scratch_size);
+	arena_set_tag(&scratch, "server scratch");
+
+	for(bool running = true; running;){
+		struct pollfd fds[2] = {
+			{ .fd = listen_fd, .events = POLLIN },
+			{ .fd = st.inotify_fd, .events = POLLIN },
+		};
+		if(poll(fds, 2, -1) < 0){
+			if(errno == EINTR){ continue; }
+			break;
+		}
+
+		if(fds[1].revents & POLLIN){
+			server_drain_events(&st);
+		}
+		if(fds[0].revents & POLLIN){
+			int conn = accept(listen_fd, NULL, NULL);
+			if(conn < 0){ continue; }
+			/* Requests are served one at a time, a stalled client must not hold up the others */
+			struct timeval timeout = { .tv_sec = SERVER_IO_TIMEOUT_MS / 1000, .tv_usec = (SERVER_IO_TIMEOUT_MS % 1000) * 1000 };
+			setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			setsockopt(conn, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+			running = server_handle(&st, conn, &scratch);
+			close(conn);
+			arena_reset(&scratch);
+		}
+	}
+
+	for(i32 i = 0; i < st.file_count; i += 1){
+		server_file_drop(st.files[i]);
+		heap_free(st.files[i]);
+	}
+	heap_free(st.files);
+	arena_destroy(&scratch);
+	heap_free(scratch_mem);
+	close(st.inotify_fd);
+	close(listen_fd);
+	unlink(socket_path);
+	return 0;
+}
+
+bool server_request(char const* socket_path, String cwd, int argc, char const** args, Arena* arena, String* output, int* status){
+	struct sockaddr_un addr;
+	if(!server_address(socket_path, &addr)){ return false; }
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd < 0){ return false; }
+	if(connect(fd, (struct sockaddr const*)&addr, sizeof(addr)) != 0){
+		close(fd);
+		return false;
+	}
+
+	isize size = 4 + cwd.len + 4;
+	for(int i = 0; i < argc; i += 1){
+		size += 4 + (isize)__builtin_strlen(args[i]);
+	}
+
+	ArenaRegion reg = arena_region_begin(arena);
+	byte* msg = arena_alloc(arena, 8 + size, 8);
+	bool ok = msg != NULL && size <= SERVER_MAX_MESSAGE;
+	if(ok){
+		u32 header[2] = { SERVER_MAGIC, (u32)size };
+		mem_copy_no_overlap(msg, header, 8);
+		isize cursor = 8;
+
+		u32 len = (u32)cwd.len;
+		mem_copy_no_overlap(msg + cursor, &len, 4);
+		mem_copy_no_overlap(msg + cursor + 4, cwd.v, cwd.len);
+		cursor += 4 + cwd.len;
+
+		u32 count = (u32)argc;
+		mem_copy_no_overlap(msg + cursor, &count, 4);
+		cursor += 4;
+		for(int i = 0; i < argc; i += 1){
+			len = (u32)__builtin_strlen(args[i]);
+			mem_copy_no_overlap(msg + cursor, &len, 4);
+			mem_copy_no_overlap(msg + cursor + 4, args[i], len);
+			cursor += 4 + len;
+		}
+		ok = server_send_all(fd, msg, cursor);
+	}
+	arena_region_end(reg);
+
+	u32 response[3] = {0};
+	ok = ok && server_recv_all(fd, response, sizeof(response)) && response[0] == SERVER_MAGIC;
+	byte* out = ok ? arena_alloc(arena, (isize)response[2] + 1, 1) : NULL;
+	ok = ok && out != NULL && server_recv_all(fd, out, response[2]);
+	close(fd);
+
+	if(ok){
+		*output = (String){ .v = out, .len = response[2] };
+		*status = (int)response[1];
+	}
+	return ok;
+}
+
+int client_run(char const* socket_path, int argc, char const** args){
+	char cwd[4096];
+	if(getcwd(cwd, sizeof(cwd)) == NULL){
+		printf("Could not get the working directory\n");
+		return 2;
+	}
+
+	isize arena_size = 1 * mem_megabyte;
+	byte* arena_mem = heap_alloc(arena_size, 4096);
+	Arena arena = arena_create_dynamic(arena_mem, arena_size);
+
+	String output = {0};
+	int status = 2;
+	String cwd_str = { .v = (byte const*)cwd, .len = (isize)__builtin_strlen(cwd) };
+	if(server_request(socket_path, cwd_str, argc, args, &arena, &output, &status)){
+		fwrite(output.v, 1, output.len, stdout);
+	}
+	else {
+		printf("Could not reach a compile server at '%s'\n", socket_path);
+	}
+
+	arena_destroy(&arena);
+	heap_free(arena_mem);
+	return status;
+}
+
+#undef SERVER_MAGIC
+#undef SERVER_MAX_MESSAGE
+#undef SERVER_FILE_ARENA_SIZE
+
+#else
+
+int server_run(char const* socket_path){
+	(void)socket_path;
+	printf("The compile server is only available on Linux\n");
+	return 2;
+}
+
+bool server_request(char const* socket_path, String cwd, int argc, char const** args, Arena* arena, String* output, int* status){
+	(void)socket_path; (void)cwd; (void)argc; (void)args; (void)arena; (void)output; (void)status;
+	return false;
+}
+
+int client_run(char const* socket_path, int argc, char const** args){
+	(void)socket_path; (void)argc; (void)args;
+	printf("The compile server is only available on Linux\n");
+	return 2;
+}
+
+#endif
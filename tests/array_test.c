@@ -0,0 +1,70 @@
+#include "testing.h"
+#include "base/array.h"
+
+typedef DynArray(u32) TestU32List;
+
+bool test_array(){
+	TEST_BEGIN("Arrays");
+	static byte arena_mem[256 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* The last allocation of the arena grows in place */ {
+		TestU32List list = { .arena = &arena };
+		dyn_push(&list, 1);
+		u32* first = list.v;
+		bool ok = true;
+		for(u32 i = 2; i <= 5000; i += 1){
+			dyn_push(&list, i);
+		}
+		for(u32 i = 0; i < 5000; i += 1){
+			ok = ok && list.v[i] == i + 1;
+		}
+		TEST(ok && list.len == 5000 && list.cap >= 5000 && list.v == first);
+		TEST(dyn_pop(&list) == 5000 && list.len == 4999);
+
+		u32 more[] = { 7, 8, 9 };
+		dyn_append(&list, more, 3);
+		TEST(list.len == 5002 && list.v[4999] == 7 && list.v[5001] == 9);
+	}
+
+	/* Otherwise it moves and keeps its contents */ {
+		TestU32List a = { .arena = &arena };
+		TestU32List b = { .arena = &arena };
+		bool ok = true;
+		for(u32 i = 0; i < 1000; i += 1){
+			dyn_push(&a, i);
+			dyn_push(&b, i * 2);
+		}
+		for(u32 i = 0; i < 1000; i += 1){
+			ok = ok && a.v[i] == i && b.v[i] == i * 2;
+		}
+		TEST(ok);
+	}
+
+	/* Segmented elements never move */ {
+		SegArray s = seg_array_make(u64, 5, &arena);
+		TEST(s.first_shift == 3);
+		u64* first = seg_array_push(&s);
+		*first = 100;
+		bool ok = true;
+		for(u64 i = 1; i < 3000; i += 1){
+			u64* p = seg_array_push(&s);
+			ok = ok && *p == 0;
+			*p = i + 100;
+		}
+		for(isize i = 0; i < s.len; i += 1){
+			ok = ok && *seg_at(&s, u64, i) == (u64)i + 100;
+		}
+		TEST(ok && seg_at(&s, u64, 0) == first && s.len == 3000);
+		TEST(s.segment_count == 9 && s.cap == 8 * 511);
+
+		u64* flat = seg_array_flatten(&s, &arena);
+		ok = true;
+		for(isize i = 0; i < s.len; i += 1){
+			ok = ok && flat[i] == (u64)i + 100;
+		}
+		TEST(ok);
+	}
+
+	TEST_END;
+}
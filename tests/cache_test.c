@@ -0,0 +1,89 @@
+#include "testing.h"
+#include <stdio.h>
+
+#define TEST_CACHE_DIR "kielo_test_cache"
+
+bool test_cache(){
+	TEST_BEGIN("Cache");
+	static byte arena_mem[256 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+	String dir = str_lit(TEST_CACHE_DIR);
+
+	/* Hashing */ {
+		byte buf[100];
+		for(int i = 0; i < 100; i += 1){ buf[i] = (byte)i; }
+		TEST(hash_bytes(buf, 100, 0) == hash_bytes(buf, 100, 0));
+		TEST(hash_bytes(buf, 100, 0) != hash_bytes(buf, 100, 1));
+		TEST(hash_bytes(buf, 99, 0) != hash_bytes(buf, 100, 0));
+		bool distinct = true;
+		for(int len = 0; len < 40; len += 1){
+			distinct = distinct && hash_bytes(buf, len, 0) != hash_bytes(buf, len + 1, 0);
+		}
+		TEST(distinct);
+		u64 a = hash_bytes(buf, 64, 0);
+		buf[40] ^= 1;
+		TEST(a != hash_bytes(buf, 64, 0));
+	}
+
+	String source = str_lit("fn add(a: Int, b: Int) -> Int { return a + b * 2; }\nlet s = \"x\\ty\";\n");
+	Lexer lex = lexer_create(source, &arena);
+	PackedTokenArray packed = lexer_tokenize_packed(&lex, &arena);
+	TokenArray tokens = token_unpack(&packed, &arena);
+	Parser p = parser_create(source, tokens, &arena, &arena);
+	u32 file = parser_parse_file(&p);
+	String expected = ast_dump(&p.ast, tokens, file, &arena);
+
+	CacheEntry entry;
+	TEST(!cache_load(dir, source, &arena, &entry));
+	TEST(cache_store(dir, source, &packed, &p.ast, file, &arena));
+
+	/* Hit */ {
+		TEST(cache_load(dir, source, &arena, &entry));
+		TEST(entry.tokens.len == packed.len && entry.tokens.literal_len == packed.literal_len);
+		TokenArray cached = token_unpack(&entry.tokens, &arena);
+		TEST(str_equals(ast_dump(&entry.ast, cached, entry.root, &arena), expected));
+		TEST(str_equals(token_string_value(cached.v[cached.len - 3], &arena), str_lit("x\ty")));
+
+		/* The mapping is private, writes stay in memory */
+		entry.ast.rhs[entry.root] = 0;
+		cache_release(&entry);
+		TEST(cache_load(dir, source, &arena, &entry));
+		TEST(str_equals(ast_dump(&entry.ast, cached, entry.root, &arena), expected));
+		cache_release(&entry);
+	}
+
+	/* A different source with the same length misses */ {
+		String other = str_lit("fn add(a: Int, b: Int) -> Int { return a - b * 2; }\nlet s = \"x\\ty\";\n");
+		TEST(other.len == source.len && !cache_load(dir, other, &arena, &entry));
+	}
+
+	/* A valid header over a corrupted body misses, its indices are never used */ {
+		char const* path = (char const*)str_format(&arena, TEST_CACHE_DIR "/%016llx.klc", (unsigned long long)cache_key(source)).v;
+		byte* buf = arena_make(&arena, byte, 64 * 1024);
+		FILE* f = fopen(path, "rb");
+		isize size = f != NULL ? (isize)fread(buf, 1, 64 * 1024, f) : 0;
+		if(f != NULL){ fclose(f); }
+		TEST(size > 0);
+
+		TEST(cache_load(dir, source, &arena, &entry));
+		isize lhs = (isize)((byte const*)entry.ast.lhs - entry.mapping.data);
+		cache_release(&entry);
+		u32 bad = 0x7fffffff;
+		mem_copy_no_overlap(buf + lhs, &bad, sizeof(bad));
+		TEST(file_write_atomic(path, buf, size));
+		TEST(!cache_load(dir, source, &arena, &entry));
+		TEST(cache_store(dir, source, &packed, &p.ast, file, &arena));
+	}
+
+	/* Truncated entries miss */ {
+		char const* path = (char const*)str_format(&arena, TEST_CACHE_DIR "/%016llx.klc", (unsigned long long)cache_key(source)).v;
+		TEST(file_write_atomic(path, "KLOC", 4));
+		TEST(!cache_load(dir, source, &arena, &entry));
+		remove(path);
+	}
+
+	remove(TEST_CACHE_DIR);
+	TEST_END;
+}
+
+#undef TEST_CACHE_DIR
@@ -0,0 +1,192 @@
+#include "testing.h"
+
+typedef struct {
+	Checker checker;
+	String errors; /* "offset:message;" for each error */
+} CheckResult;
+
+static
+CheckResult check_source(String source, Arena* arena, Arena* scope_arena){
+	Lexer lex = lexer_create(source, arena);
+	TokenArray tokens = lexer_tokenize(&lex, arena);
+	Parser p = parser_create(source, tokens, arena, arena);
+	u32 file = parser_parse_file(&p);
+	ensure(p.error_count == 0, "Checker tests need valid syntax");
+
+	/* The checker keeps a pointer to the tree */
+	Ast* ast = arena_make(arena, Ast, 1);
+	*ast = p.ast;
+	CheckResult r = { .checker = checker_create(ast, tokens, source, arena, scope_arena, arena) };
+	checker_check_file(&r.checker, file);
+
+	r.errors = str_lit("");
+	for(CompilerError* err = r.checker.error; err != NULL; err = err->next){
+		r.errors = str_format(arena, "%.*s%llu:%.*s;", str_fmt(r.errors), (unsigned long long)err->offset, str_fmt(err->message));
+	}
+	return r;
+}
+
+/* Node declaring the symbol the identifier at `offset` resolved to, 0 if unresolved */
+static
+u32 check_resolved_decl(Checker const* c, isize offset){
+	for(u32 n = 0; n < c->ast->len; n += 1){
+		if(c->ast->kind[n] == AstKind_Ident && c->tokens.v[c->ast->token[n]].lexeme.v - c->source.v == offset){
+			u32 sym = c->resolved[n];
+			return sym == SYMBOL_NONE ? 0 : c->symbols.v[sym].node;
+		}
+	}
+	return 0;
+}
+
+bool test_checker(){
+	TEST_BEGIN("Checker");
+	static byte arena_mem[256 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+	byte scope_mem[256];
+	Arena scope_arena = arena_create_dynamic(scope_mem, sizeof(scope_mem));
+
+	/* Regions release chained blocks too */ {
+		ArenaRegion outer = arena_region_begin(&scope_arena);
+		arena_alloc(&scope_arena, 200, 8);
+		isize offset = scope_arena.offset;
+		for(int round = 0; round < 3; round += 1){
+			ArenaRegion reg = arena_region_begin(&scope_arena);
+			for(int i = 0; i < 40; i += 1){ arena_alloc(&scope_arena, 100, 8); }
+			arena_region_end(reg);
+		}
+		i32 blocks = 0;
+		for(Arena* b = scope_arena.next; b != NULL; b = b->next){
+			blocks += 1;
+			TEST(b->offset == 0);
+		}
+		TEST(blocks > 0 && scope_arena.current == NULL && scope_arena.offset == offset);
+
+		/* Rewinding into a chained block keeps what was allocated before the region */
+		u32* kept = arena_make(&scope_arena, u32, 100);
+		kept[99] = 7;
+		ArenaRegion reg = arena_region_begin(&scope_arena);
+		arena_alloc(&scope_arena, 4000, 8);
+		arena_region_end(reg);
+		TEST(arena_resize_in_place(&scope_arena, kept, 800) && kept[99] == 7);
+		arena_region_end(outer);
+	}
+
+	/* Interning */ {
+		InternTable t = intern_create(&arena, 4);
+		u32 a = intern(&t, str_lit("alpha"));
+		u32 b = intern(&t, str_lit("beta"));
+		TEST(a != b && intern(&t, str_lit("alpha")) == a);
+
+		bool stable = true;
+		for(int i = 0; i < 200; i += 1){
+			String name = str_format(&arena, "name_%d", i);
+			stable = stable && intern(&t, name) == (u32)i + 2;
+		}
+		TEST(stable && t.len == 202);
+		TEST(intern(&t, str_lit("beta")) == b && str_equals(intern_name(&t, 150), str_lit("name_148")));
+	}
+
+	/* Scopes */ {
+		SymbolTable t = symbol_table_create(&arena, &scope_arena, 4);
+		u32 existing = SYMBOL_NONE;
+		symbol_scope_push(&t);
+		u32 x = symbol_declare(&t, (Symbol){ .name = 1, .node = 10 }, &existing);
+		TEST(symbol_declare(&t, (Symbol){ .name = 1, .node = 11 }, &existing) == SYMBOL_NONE && existing == x);
+
+		symbol_scope_push(&t);
+		u32 shadow = symbol_declare(&t, (Symbol){ .name = 1, .node = 12 }, &existing);
+		bool declared = true;
+		for(u32 name = 100; name < 400; name += 1){
+			declared = declared && symbol_declare(&t, (Symbol){ .name = name, .node = name }, &existing) != SYMBOL_NONE;
+		}
+		TEST(declared && symbol_lookup(&t, 1) == shadow && t.v[symbol_lookup(&t, 399)].node == 399);
+
+		symbol_scope_pop(&t);
+		TEST(symbol_lookup(&t, 1) == x && symbol_lookup(&t, 399) == SYMBOL_NONE);
+		symbol_scope_pop(&t);
+		TEST(symbol_lookup(&t, 1) == SYMBOL_NONE && t.len == 302);
+		TEST(scope_arena.offset == 0 && scope_arena.current == NULL);
+
+		/* Deep nesting grows the scope stack */
+		for(int i = 0; i < 100; i += 1){ symbol_scope_push(&t); }
+		symbol_declare(&t, (Symbol){ .name = 5, .node = 5 }, &existing);
+		TEST(t.v[symbol_lookup(&t, 5)].node == 5);
+		for(int i = 0; i < 100; i += 1){ symbol_scope_pop(&t); }
+		TEST(t.depth == 0 && scope_arena.offset == 0);
+	}
+
+	/* Resolution */ {
+		CheckResult r = check_source(str_lit(
+			"let g = f(1);\n"
+			"fn f(a: Int) -> Int {\n"
+			"	let a = a + g;\n"
+			"	{ let a = 2; a = a; }\n"
+			"	return a;\n"
+			"}\n"), &arena, &scope_arena);
+		TEST(r.checker.error == NULL);
+
+		Checker* c = &r.checker;
+		Ast const* ast = c->ast;
+		u32 f = ast->extra[ast->lhs[ast->len - 1] + 1];
+		u32 body = ast->rhs[f];
+		u32 outer_a = ast->extra[ast->lhs[body]];
+		u32 param = ast->extra[ast->lhs[ast->lhs[f]]];
+		TEST(check_resolved_decl(c, 8) == f);         /* f(1) */
+		TEST(check_resolved_decl(c, 45) == param);    /* a + g */
+		TEST(check_resolved_decl(c, 83) == outer_a);  /* return a */
+		TEST(ast->kind[check_resolved_decl(c, 70)] == AstKind_Let && check_resolved_decl(c, 70) != outer_a);
+	}
+
+	/* Errors */ {
+		CheckResult r = check_source(str_lit(
+			"fn f(a: Int, a: Int) { let x = y; let x = 1; }\n"
+			"fn f() { for x { } g(z.len); }\n"), &arena, &scope_arena);
+		TEST(str_equals(r.errors, str_lit(
+			"13:'a' is already declared in this scope;"
+			"31:Undeclared name 'y';"
+			"38:'x' is already declared in this scope;"
+			"50:'f' is already declared in this scope;"
+			"60:Undeclared name 'x';"
+			"66:Undeclared name 'g';"
+			"68:Undeclared name 'z';")));
+		TEST(r.checker.error_count == 7 && scope_arena.offset == 0);
+	}
+
+	/* Constant folding */ {
+		CheckResult r = check_source(str_lit(
+			"let a = 0x1000 * 64 + 16;\n"
+			"let b = (1 << 62) * 2;\n"
+			"let c = 7 / (3 - 3);\n"
+			"let d = 1 << 64;\n"
+			"let e = 1.5 * 2.0 < 3.5;\n"
+			"let f = -(1 << 63);\n"
+			"let g = 10 % -3 + a;\n"
+			"let h = 1 + 2.0 == 3.0;\n"
+			"let i = -9223372036854775807 - 1 == 1 << 63;\n"), &arena, &scope_arena);
+		TEST(str_equals(r.errors, str_lit(
+			"44:Integer overflow in constant expression;"
+			"59:Division by zero in constant expression;"
+			"80:Shift amount 64 is out of range, it must be between 0 and 63;"
+			"120:Integer overflow in constant expression;")));
+
+		Checker* c = &r.checker;
+		Ast const* ast = c->ast;
+		u32 decls = ast->lhs[ast->len - 1];
+		Constant k[9];
+		for(u32 i = 0; i < 9; i += 1){
+			k[i] = c->constants[ast->rhs[ast->extra[decls + i]]];
+		}
+		TEST(k[0].kind == ConstKind_Int && k[0].value.integer == 0x1000 * 64 + 16);
+		TEST(k[1].kind == ConstKind_None && k[2].kind == ConstKind_None && k[3].kind == ConstKind_None);
+		TEST(k[4].kind == ConstKind_Bool && k[4].value.boolean && k[5].kind == ConstKind_None);
+
+		/* Folding stops at names and mixed kinds, constant operands below them keep their value */
+		u32 g = ast->rhs[ast->extra[decls + 6]];
+		Constant rem = c->constants[ast->lhs[g]];
+		TEST(k[6].kind == ConstKind_None && rem.kind == ConstKind_Int && rem.value.integer == 1);
+		TEST(k[7].kind == ConstKind_None && k[8].kind == ConstKind_Bool && k[8].value.boolean);
+	}
+
+	arena_destroy(&scope_arena);
+	TEST_END;
+}
@@ -0,0 +1,139 @@
+#include "testing.h"
+#include <stdio.h>
+
+#define TEST_DRIVER_DIR "kielo_test_driver"
+
+static
+bool test_driver_write(char const* path, char const* source){
+	FILE* f = fopen(path, "wb");
+	if(f == NULL){ return false; }
+	fputs(source, f);
+	fclose(f);
+	return true;
+}
+
+/* Runs the driver without a working directory, so paths stay as given */
+static
+String test_driver_run(Arena* arena, int argc, char const** args, int* status){
+	FILE* out = tmpfile();
+	if(out == NULL){ return (String){0}; }
+
+	DriverContext ctx = { .scratch = arena };
+	*status = driver_run(&ctx, argc, args, out);
+
+	long len = ftell(out);
+	char* buf = arena_alloc(arena, len + 1, 1);
+	rewind(out);
+	isize n = buf != NULL ? (isize)fread(buf, 1, (size_t)len, out) : 0;
+	fclose(out);
+	return (String){ .v = (byte const*)buf, .len = n };
+}
+
+bool test_driver(){
+	TEST_BEGIN("Driver");
+	static byte arena_mem[4 * 1024 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	TEST(file_make_dir(TEST_DRIVER_DIR) && file_make_dir(TEST_DRIVER_DIR "/sub"));
+	TEST(test_driver_write(TEST_DRIVER_DIR "/b.kl", "fn f() { let = 1; }\nfn g( {}\n"));
+	TEST(test_driver_write(TEST_DRIVER_DIR "/sub/a.kl", "fn h( {}\n"));
+	TEST(test_driver_write(TEST_DRIVER_DIR "/a.kl", "fn ok() -> Int { return 1; }\n"));
+	TEST(test_driver_write(TEST_DRIVER_DIR "/notes.txt", "fn (\n"));
+
+	String expected = str_lit(
+		TERM_COLOR_RED "error" TERM_COLOR_RESET " (" TEST_DRIVER_DIR "/b.kl:13) Expected 'Id', found '='\n"
+		TERM_COLOR_RED "error" TERM_COLOR_RESET " (" TEST_DRIVER_DIR "/b.kl:26) Expected ')', found '{'\n"
+		TERM_COLOR_RED "error" TERM_COLOR_RESET " (" TEST_DRIVER_DIR "/sub/a.kl:6) Expected ')', found '{'\n");
+
+	/* Errors are ordered by file then offset, whatever the thread count */ {
+		int status = 0;
+		char const* serial[] = { "-j", "1", TEST_DRIVER_DIR };
+		String out = test_driver_run(&arena, 3, serial, &status);
+		TEST(status == 1 && str_equals(out, expected));
+
+		char const* parallel[] = { "--jobs", "4", TEST_DRIVER_DIR };
+		for(int i = 0; i < 8; i += 1){
+			out = test_driver_run(&arena, 3, parallel, &status);
+			TEST(status == 1 && str_equals(out, expected));
+		}
+	}
+
+	/* Files given one by one are sorted the same way */ {
+		int status = 0;
+		char const* args[] = { TEST_DRIVER_DIR "/sub/a.kl", "-j", "3", TEST_DRIVER_DIR "/a.kl", TEST_DRIVER_DIR "/b.kl" };
+		String out = test_driver_run(&arena, 5, args, &status);
+		TEST(status == 1 && str_equals(out, expected));
+	}
+
+	/* Success, missing files and bad options */ {
+		int status = -1;
+		char const* ok[] = { "--dump-ast", TEST_DRIVER_DIR "/a.kl" };
+		String out = test_driver_run(&arena, 2, ok, &status);
+		TEST(status == 0 && str_equals(out, str_lit("(file (fn ok () Int (block (return 1))))\n")));
+
+		char const* missing[] = { TEST_DRIVER_DIR "/missing.kl" };
+		out = test_driver_run(&arena, 1, missing, &status);
+		TEST(status == 1 && str_ends_with(out, str_lit("could not read '" TEST_DRIVER_DIR "/missing.kl'\n")));
+
+		char const* bad[] = { "-j", "0", TEST_DRIVER_DIR };
+		test_driver_run(&arena, 3, bad, &status);
+		TEST(status == 2);
+	}
+
+	/* Running */ {
+		TEST(test_driver_write(TEST_DRIVER_DIR "/run.kl", "fn main() -> Int { let x = 6; return x * 7; }\n"));
+		int status = -1;
+		char const* args[] = { "--run", TEST_DRIVER_DIR "/run.kl" };
+		String out = test_driver_run(&arena, 2, args, &status);
+		TEST(status == 0 && str_equals(out, str_lit("42\n")));
+
+		/* Type errors stop the interpreter before it runs */
+		TEST(test_driver_write(TEST_DRIVER_DIR "/bad.kl", "fn main() -> Int { return 1 == 1; }\n"));
+		char const* bad_args[] = { "--run", TEST_DRIVER_DIR "/bad.kl" };
+		out = test_driver_run(&arena, 2, bad_args, &status);
+		TEST(status == 1 && str_ends_with(out, str_lit("bad.kl:19) 'main' must return Int, found Bool\n")));
+		remove(TEST_DRIVER_DIR "/bad.kl");
+#if defined(OS_LINUX) && defined(ARCH_X64)
+		char const* jit_args[] = { "--run", "--jit", TEST_DRIVER_DIR "/run.kl" };
+		out = test_driver_run(&arena, 3, jit_args, &status);
+		TEST(status == 0 && str_equals(out, str_lit("42\n")));
+
+		char const* report_args[] = { "--run", "--jit", "--opt-report", TEST_DRIVER_DIR "/run.kl" };
+		out = test_driver_run(&arena, 4, report_args, &status);
+		TEST(status == 0 && str_ends_with(out, str_lit("run.kl: 'main' removed 2 instructions (1 folded, 0 branches, 0 blocks merged, 0 calls inlined)\n42\n")));
+
+		TEST(test_driver_write(TEST_DRIVER_DIR "/run.kl", "fn sq(x: Int) -> Int { return x * x; }\nfn main() -> Int { return sq(6) + sq(2) + 2; }\n"));
+		char const* inline_args[] = { "--run", "--jit", "--inline-report", TEST_DRIVER_DIR "/run.kl" };
+		out = test_driver_run(&arena, 4, inline_args, &status);
+		TEST(status == 0 && str_ends_with(out, str_lit("run.kl:67: inlined 'sq' into 'main'\n" TEST_DRIVER_DIR "/run.kl:75: inlined 'sq' into 'main'\n42\n")));
+		char const* no_inline_args[] = { "--run", "--jit", "--inline-budget", "0", "--inline-report", TEST_DRIVER_DIR "/run.kl" };
+		out = test_driver_run(&arena, 6, no_inline_args, &status);
+		TEST(status == 0 && str_equals(out, str_lit("42\n")));
+
+		TEST(test_driver_write(TEST_DRIVER_DIR "/run.kl", "fn main() -> Int { let z = 0; return 1 / z; }\n"));
+		out = test_driver_run(&arena, 3, jit_args, &status);
+		TEST(status == 1 && str_ends_with(out, str_lit("run.kl:39) Division by zero\n")));
+		out = test_driver_run(&arena, 4, report_args, &status);
+		TEST(status == 1 && str_ends_with(out, str_lit("run.kl:39) Division by zero\n")));
+#endif
+		remove(TEST_DRIVER_DIR "/run.kl");
+	}
+
+	/* Timing */ {
+		int status = -1;
+		char const* args[] = { "--time", TEST_DRIVER_DIR "/a.kl" };
+		String out = test_driver_run(&arena, 2, args, &status);
+		TEST(status == 0 && str_starts_with(out, str_lit("read ")));
+		TEST(str_ends_with(out, str_lit("(1 files, 1 threads)\n")));
+	}
+
+	remove(TEST_DRIVER_DIR "/sub/a.kl");
+	remove(TEST_DRIVER_DIR "/sub");
+	remove(TEST_DRIVER_DIR "/a.kl");
+	remove(TEST_DRIVER_DIR "/b.kl");
+	remove(TEST_DRIVER_DIR "/notes.txt");
+	remove(TEST_DRIVER_DIR);
+	TEST_END;
+}
+
+#undef TEST_DRIVER_DIR
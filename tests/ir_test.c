@@ -0,0 +1,188 @@
+#include "testing.h"
+
+/* "offset:message;" for each error in the list */
+static
+String ir_test_errors(Arena* arena, CompilerError const* errors){
+	String out = str_lit("");
+	for(CompilerError const* err = errors; err != NULL; err = err->next){
+		out = str_format(arena, "%.*s%llu:%.*s;", str_fmt(out), (unsigned long long)err->offset, str_fmt(err->message));
+	}
+	return out;
+}
+
+/* Checker or lowering errors, empty when the module was built */
+static
+String ir_test_build(Arena* arena, String source, IrModule* module){
+	Lexer lex = lexer_create(source, arena);
+	TokenArray tokens = lexer_tokenize(&lex, arena);
+	Parser p = parser_create(source, tokens, arena, arena);
+	u32 file = parser_parse_file(&p);
+	ensure(p.error_count == 0, "IR tests need valid syntax");
+
+	byte scope_mem[1024];
+	Arena scope_arena = arena_create_dynamic(scope_mem, sizeof(scope_mem));
+	Ast* ast = arena_make(arena, Ast, 1);
+	*ast = p.ast;
+	Checker* c = arena_make(arena, Checker, 1);
+	*c = checker_create(ast, tokens, source, arena, &scope_arena, arena);
+	checker_check_file(c, file);
+	arena_destroy(&scope_arena);
+	*module = (IrModule){ .main = IR_NONE };
+	if(c->error_count > 0){
+		return ir_test_errors(arena, c->error);
+	}
+
+	IrBuilder b = ir_builder_create(c, arena);
+	*module = ir_build_file(&b, file);
+	return ir_test_errors(arena, b.error);
+}
+
+static
+u32 ir_test_count(IrFunction const* f, IrOp op){
+	u32 n = 0;
+	for(isize v = 0; v < f->insts.len; v += 1){
+		n += f->insts.v[v].op == op;
+	}
+	return n;
+}
+
+/* Appends a block ending in `term` to a function built by hand */
+static
+void ir_test_block(IrFunction* f, IrInst term){
+	dyn_push(&f->blocks, ((IrBlock){ .first = (u32)f->insts.len, .count = 1 }));
+	dyn_push(&f->insts, term);
+}
+
+bool test_ir(){
+	TEST_BEGIN("IR");
+	static byte arena_mem[1024 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Loops and reassigned variables */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn sum(n: Int) -> Int {\n"
+			"	let s = 0;\n"
+			"	for n > 0 { s += n; n -= 1; }\n"
+			"	return s;\n"
+			"}\n"), &m);
+		TEST(errors.len == 0 && m.function_count == 2 && m.main == IR_NONE);
+		TEST(str_equals(ir_dump(&m, &arena), str_lit(
+			"fn sum(Int) -> Int\n"
+			"b0:\n"
+			"  v0 Int = Param 0\n"
+			"  v1 Int = Const 0\n"
+			"  Jump b1\n"
+			"b1 <- b0 b2:\n"
+			"  v3 Int = Phi [b0 v1] [b2 v8]\n"
+			"  v4 Int = Phi [b0 v0] [b2 v10]\n"
+			"  v5 Int = Const 0\n"
+			"  v6 Bool = Lt v5 v4\n"
+			"  Branch v6 b2 b3\n"
+			"b2 <- b1:\n"
+			"  v8 Int = Add v3 v4\n"
+			"  v9 Int = Const 1\n"
+			"  v10 Int = Sub v4 v9\n"
+			"  Jump b1\n"
+			"b3 <- b1:\n"
+			"  Return v3\n"
+			"fn <init>()\n"
+			"b0:\n"
+			"  Return \n")));
+
+		IrFunction const* f = &m.functions[0];
+		TEST(f->blocks.v[2].idom == 1 && f->blocks.v[3].idom == 1 && ir_dominates(f, 1, 2) && !ir_dominates(f, 2, 3));
+	}
+
+	/* Only variables assigned after their declaration get phis */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"let scale: Int;\n"
+			"fn f(a: Int) -> Bool {\n"
+			"	let b = a * scale;\n"
+			"	let c = b + 1;\n"
+			"	if c > 3 { c = 0; } else { let d = c; }\n"
+			"	return b > c && c >= 0 || a == 1;\n"
+			"}\n"
+			"fn main() -> Int { if f(2) { return 1; } return 0; }\n"), &m);
+		IrFunction const* f = &m.functions[0];
+		TEST(errors.len == 0 && m.main == 1 && m.global_types[0] == ConstKind_Int);
+		/* `c` at the join, then the result of each short circuit */
+		TEST(ir_test_count(f, IrOp_Phi) == 3 && ir_test_count(f, IrOp_GetVar) == 0 && ir_test_count(f, IrOp_Undef) == 0);
+		TEST(f->insts.v[f->blocks.v[3].first].op == IrOp_Phi && f->insts.v[f->blocks.v[3].first].type == ConstKind_Int);
+	}
+
+	/* Code after a terminator is dropped, reads no path assigns are undefined */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn f(n: Int) -> Int {\n"
+			"	for n < 10 {\n"
+			"		let t = 1;\n"
+			"		if n == 5 { t = 2; }\n"
+			"		n += t;\n"
+			"		continue;\n"
+			"		n = 0;\n"
+			"	}\n"
+			"	return n;\n"
+			"	n = 1;\n"
+			"}\n"), &m);
+		IrFunction const* f = &m.functions[0];
+		TEST(errors.len == 0 && f->blocks.len == 6 && ir_test_count(f, IrOp_Undef) == 1);
+		for(isize j = 0; j < f->blocks.len; j += 1){
+			IrBlock const* blk = &f->blocks.v[j];
+			TEST(blk->idom != IR_NONE && ir_is_terminator(f->insts.v[blk->first + blk->count - 1].op));
+		}
+	}
+
+	/* Dominators of an irreducible graph: 0 -> 1, 2; 1 -> 2, 3; 2 -> 1; 4 is unreachable */ {
+		IrFunction f = {
+			.insts = { .arena = &arena },
+			.blocks = { .arena = &arena },
+			.operands = { .arena = &arena },
+			.preds = { .arena = &arena },
+		};
+		ir_test_block(&f, (IrInst){ .op = IrOp_Branch, .b = 1, .c = 2 });
+		ir_test_block(&f, (IrInst){ .op = IrOp_Branch, .b = 2, .c = 3 });
+		ir_test_block(&f, (IrInst){ .op = IrOp_Jump, .a = 1 });
+		ir_test_block(&f, (IrInst){ .op = IrOp_Return, .a = IR_NONE });
+		ir_test_block(&f, (IrInst){ .op = IrOp_Jump, .a = 3 });
+		ir_compute_cfg(&f);
+		ir_compute_dominators(&f);
+		TEST(f.blocks.v[1].idom == 0 && f.blocks.v[2].idom == 0 && f.blocks.v[3].idom == 1 && f.blocks.v[4].idom == IR_NONE);
+		TEST(f.blocks.v[3].pred_count == 2 && !ir_dominates(&f, 4, 3));
+
+		ir_compact(&f);
+		TEST(f.blocks.len == 4 && f.insts.len == 4 && f.blocks.v[0].idom == 0);
+	}
+
+	/* Type errors */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"let g = h;\n"
+			"let h = 1.5;\n"
+			"fn f(x: Int, y: Num) -> Int {\n"
+			"	let r = x + 1.0;\n"
+			"	x = 2.0;\n"
+			"	if x { }\n"
+			"	let u;\n"
+			"	f(1.0, 2);\n"
+			"	let v = p();\n"
+			"	return 1 < 2;\n"
+			"}\n"
+			"fn p() { }\n"
+			"fn q() -> Int { if 1 < 2 { return 1; } }\n"), &m);
+		TEST(str_equals(errors, str_lit(
+			"8:The type of 'h' is not known here, declare it with a type;"
+			"40:Unknown type 'Num';"
+			"65:Invalid operands of types Int and Real;"
+			"75:Cannot assign Real to 'x' of type Int;"
+			"86:Condition must be a Bool, found Int;"
+			"97:'u' needs a type or an initializer;"
+			"103:Argument 1 of 'f' must be Int, found Real;"
+			"121:'p' does not return a value;"
+			"127:'f' must return Int, found Bool;"
+			"157:'q' can reach its end without returning a value;")));
+	}
+
+	TEST_END;
+}
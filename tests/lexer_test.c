@@ -1,8 +1,258 @@
 #include "testing.h"
 
+/* Lexes `source` skipping whitespace, returns the number of tokens written to `out` */
+static
+isize lex_kinds(String source, Arena* arena, Token* out, isize max_count){
+	Lexer lex = lexer_create(source, arena);
+	isize n = 0;
+	for(;;){
+		Token tk = lexer_next_token(&lex);
+		if(tk.kind == TokenKind_Whitespace){ continue; }
+		if(n < max_count){ out[n] = tk; }
+		n += 1;
+		if(tk.kind == TokenKind_EndOfFile){ break; }
+	}
+	return n;
+}
+
 bool test_lexer(){
 	TEST_BEGIN("Lexer");
+	byte arena_mem[16 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+	Token tokens[32];
+
+	/* Keywords, identifiers and operators */ {
+		isize n = lex_kinds(str_lit("let x_1 = foo >= 0x1f;"), &arena, tokens, 32);
+		TEST(n == 8);
+		TEST(tokens[0].kind == TokenKind_Let);
+		TEST(tokens[1].kind == TokenKind_Identifier && str_equals(tokens[1].lexeme, str_lit("x_1")));
+		TEST(tokens[2].kind == TokenKind_Assign);
+		TEST(tokens[4].kind == TokenKind_GreaterEqual);
+		TEST(tokens[5].kind == TokenKind_Integer && tokens[5].value.integer == 0x1f);
+		TEST(tokens[6].kind == TokenKind_Semicolon);
+	}
+
+	/* Unicode identifiers */ {
+		isize n = lex_kinds(str_lit("let äiti = 日本語_2 + ñandú;"), &arena, tokens, 32);
+		TEST(n == 8);
+		TEST(tokens[1].kind == TokenKind_Identifier && str_equals(tokens[1].lexeme, str_lit("äiti")));
+		TEST(tokens[3].kind == TokenKind_Identifier && str_equals(tokens[3].lexeme, str_lit("日本語_2")));
+		TEST(tokens[5].kind == TokenKind_Identifier && str_equals(tokens[5].lexeme, str_lit("ñandú")));
+	}
+
+	/* Combining marks continue an identifier but cannot start one, symbols are not identifiers */ {
+		isize n = lex_kinds(str_lit("é ́ 🦊"), &arena, tokens, 32);
+		TEST(n == 4);
+		TEST(tokens[0].kind == TokenKind_Identifier && tokens[0].lexeme.len == 3);
+		TEST(tokens[1].kind == TokenKind_Unknown);
+		TEST(tokens[2].kind == TokenKind_Unknown);
+	}
+
+	/* Token tables */ {
+		TEST(str_equals(token_kind_name(TokenKind_ShiftLeft), str_lit("<<")) && token_lexeme_len[TokenKind_ShiftLeft] == 2);
+		TEST(str_equals(token_kind_name(TokenKind__len), str_lit("<INVALID TOKEN KIND>")));
+		TEST(token_lexeme_len[TokenKind_Continue] == 8 && token_lexeme_len[TokenKind_Identifier] == 0);
+		TEST(token_flags[TokenKind_Return] == TokenFlag_Keyword);
+		TEST(token_flags[TokenKind_AssignOr] == (TokenFlag_Binary | TokenFlag_Assignment));
+		TEST(token_precedence[TokenKind_Star] > token_precedence[TokenKind_Plus] && token_precedence[TokenKind_Dot] == 0);
+		TEST(token_keyword_kind(str_lit("else")) == TokenKind_Else && token_keyword_kind(str_lit("elsewhere")) == TokenKind_Identifier);
+	}
+
+	/* XID tables */ {
+		TEST(unicode_is_xid_start('a') && !unicode_is_xid_start('1') && unicode_is_xid_continue('1'));
+		TEST(unicode_is_xid_start(0x3b1) && unicode_is_xid_start(0x65e5));
+		TEST(!unicode_is_xid_start(0x301) && unicode_is_xid_continue(0x301));
+		TEST(!unicode_is_xid_continue(0x1f98a));
+		TEST(unicode_is_xid_continue(0xe0100) && !unicode_is_xid_start(0xe0100));
+	}
+
+	/* Numbers */ {
+		isize n = lex_kinds(str_lit("1_000 0b101 0o17 3.5 1e-3"), &arena, tokens, 32);
+		TEST(n == 6);
+		TEST(tokens[0].value.integer == 1000);
+		TEST(tokens[1].value.integer == 5);
+		TEST(tokens[2].value.integer == 15);
+		TEST(tokens[3].kind == TokenKind_Real && tokens[3].value.real == 3.5);
+		TEST(tokens[4].kind == TokenKind_Real && tokens[4].value.real == 1e-3);
+	}
+
+	/* Invalid encodings are reported once, up front */ {
+		Lexer lex = lexer_create(str_lit("let a\xff = 1;"), &arena);
+		TEST(!lex.validated);
+		TEST(lex.error != NULL && lex.error->offset == 5 && lex.error->type == LexerError_InvalidEncoding);
+	}
+
+	TEST_END;
+}
+
+bool test_lexer_strings(){
+	TEST_BEGIN("Lexer strings");
+	byte arena_mem[16 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+	Token tokens[16];
+
+	/* Plain literals are slices of the source */ {
+		String source = str_lit("let s = \"hello, wörld\";");
+		isize n = lex_kinds(source, &arena, tokens, 16);
+		TEST(n == 6);
+		TEST(tokens[3].kind == TokenKind_String && !tokens[3].value.escaped);
+		TEST(str_equals(tokens[3].lexeme, str_lit("\"hello, wörld\"")));
+
+		isize before = arena.offset;
+		String value = token_string_value(tokens[3], &arena);
+		TEST(str_equals(value, str_lit("hello, wörld")));
+		TEST(value.v == source.v + 9 && arena.offset == before);
+	}
+
+	/* Escapes are materialized on demand */ {
+		isize n = lex_kinds(str_lit("\"a\\\"b\\n\\u{1F98A}\\u{e4}\\\\\" x"), &arena, tokens, 16);
+		TEST(n == 3);
+		TEST(tokens[0].kind == TokenKind_String && tokens[0].value.escaped);
+		TEST(tokens[1].kind == TokenKind_Identifier);
+		TEST(str_equals(token_string_value(tokens[0], &arena), str_lit("a\"b\n🦊ä\\")));
+	}
+
+	/* Long literals cross SIMD blocks, including multiple lines */ {
+		String source = str_lit("\"0123456789abcdef0123456789abcdef\n0123456789abcdef\\t0123456789\"");
+		isize n = lex_kinds(source, &arena, tokens, 16);
+		TEST(n == 2 && tokens[0].lexeme.len == source.len);
+		TEST(token_string_value(tokens[0], &arena).len == source.len - 3);
+	}
+
+	/* Errors */ {
+		Lexer lex = lexer_create(str_lit("\"bad \\q escape\" \"unterminated"), &arena);
+		Token a = lexer_next_token(&lex);
+		lexer_next_token(&lex);
+		Token b = lexer_next_token(&lex);
+		TEST(a.kind == TokenKind_String);
+		TEST(b.kind == TokenKind_Unknown && lexer_next_token(&lex).kind == TokenKind_EndOfFile);
+		TEST(lex.error != NULL && lex.error->type == LexerError_InvalidEscape && lex.error->offset == 5);
+		TEST(lex.error->next != NULL && lex.error->next->type == LexerError_UnclosedString && lex.error->next->offset == 16);
+
+		lex = lexer_create(str_lit("\"\\u{110000}\" \"\\u{d800}\" \"\\u{}\""), &arena);
+		for(int i = 0; i < 6; i += 1){ lexer_next_token(&lex); }
+		isize errors = 0;
+		for(CompilerError* err = lex.error; err != NULL; err = err->next){ errors += 1; }
+		TEST(errors == 3);
+	}
+
+	TEST_END;
+}
+
+bool test_lexer_recovery(){
+	TEST_BEGIN("Lexer recovery");
+	byte arena_mem[32 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+	Token tokens[32];
+
+	/* Bad literals become a single Unknown token and lexing resumes at the next delimiter */ {
+		isize n = lex_kinds(str_lit("f(0x1fg2, 0b102) + 1.2.3; 12ab 0z9"), &arena, tokens, 32);
+		TEST(n == 12);
+		TEST(tokens[2].kind == TokenKind_Unknown && str_equals(tokens[2].lexeme, str_lit("0x1fg2")));
+		TEST(tokens[3].kind == TokenKind_Comma);
+		TEST(tokens[4].kind == TokenKind_Unknown && str_equals(tokens[4].lexeme, str_lit("0b102")));
+		TEST(tokens[5].kind == TokenKind_ParenClose);
+		TEST(tokens[7].kind == TokenKind_Unknown && str_equals(tokens[7].lexeme, str_lit("1.2.3")));
+		TEST(tokens[8].kind == TokenKind_Semicolon);
+		TEST(tokens[9].kind == TokenKind_Unknown && str_equals(tokens[9].lexeme, str_lit("12ab")));
+		TEST(tokens[10].kind == TokenKind_Unknown && str_equals(tokens[10].lexeme, str_lit("0z9")));
+	}
+
+	/* Errors come out ordered by offset, including the up front encoding check */ {
+		Lexer lex = lexer_create(str_lit("0x 1e5e3 $ \xff"), &arena);
+		while(lexer_next_token(&lex).kind != TokenKind_EndOfFile){}
+		isize last = -1;
+		isize count = 0;
+		bool ordered = true;
+		for(CompilerError* err = lex.error; err != NULL; err = err->next){
+			ordered = ordered && (isize)err->offset >= last;
+			last = err->offset;
+			count += 1;
+		}
+		TEST(ordered && count == 5);
+		TEST(lex.error->type == LexerError_InvalidNumber && lex.error->offset == 0);
+	}
+
+	/* A bad digit is quoted whole, the message stays valid UTF-8 */ {
+		char const* sources[] = { "0b12", "0b1\xc3\xa9", "12\xc3\xa9", "0o7\xc3" };
+		char const* messages[] = {
+			"Invalid digit to base-2 number: '2'",
+			"Invalid digit to base-2 number: '\xc3\xa9' (U+00E9)",
+			"Invalid digit in numeric literal: '\xc3\xa9' (U+00E9)",
+			"Invalid digit to base-8 number: byte 0xC3",
+		};
+		for(u32 i = 0; i < sizeof(sources) / sizeof(sources[0]); i += 1){
+			Lexer lex = lexer_create(str_format(&arena, "%s", sources[i]), &arena);
+			while(lexer_next_token(&lex).kind != TokenKind_EndOfFile){}
+			CompilerError* err = lex.error;
+			while(err != NULL && err->type != LexerError_InvalidNumber){ err = err->next; }
+			if(!TEST(err != NULL)){ continue; }
+			if(!TEST(str_equals(err->message, str_format(&arena, "%s", messages[i])))){
+				printf("  got %.*s\n", str_fmt(err->message));
+			}
+			TEST(utf8_validate(err->message.v, err->message.len, NULL));
+		}
+	}
+
+	/* Literal values */ {
+		i64 v = 0;
+		TEST(str_parse_i64(str_lit("9223372036854775807"), 10, &v) && v == INT64_MAX);
+		TEST(!str_parse_i64(str_lit("9223372036854775808"), 10, &v));
+		TEST(str_parse_i64(str_lit("-9223372036854775808"), 10, &v) && v == INT64_MIN);
+		TEST(str_parse_i64(str_lit("ffff_ffff_ffff_ffff"), 16, &v) && v == -1);
+		TEST(!str_parse_i64(str_lit("1_0000_0000_0000_0000"), 16, &v));
+		TEST(!str_parse_i64(str_lit("12a"), 10, &v));
+		TEST(lex_kinds(str_lit("0e5"), &arena, tokens, 32) == 2 && tokens[0].kind == TokenKind_Real);
+	}
+
+	/* Errors per file are capped */ {
+		Lexer lex = lexer_create(str_lit("$ $ $ $ $ $ $ $ $ $"), &arena);
+		lex.max_errors = 3;
+		while(lexer_next_token(&lex).kind != TokenKind_EndOfFile){}
+		isize count = 0;
+		for(CompilerError* err = lex.error; err != NULL; err = err->next){ count += 1; }
+		TEST(count == 4 && lex.error_tail->type == LexerError_TooManyErrors);
+		TEST(lex.error_count == 10);
+	}
+
 	TEST_END;
 }
 
+bool test_lexer_packed(){
+	TEST_BEGIN("Lexer packed tokens");
+	byte arena_mem[32 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
 
+	String source = str_lit("fn f() { let s = \"a\\tb\"; return 0x10 + 2.5 * x; } // done");
+
+	Lexer lex = lexer_create(source, &arena);
+	TokenArray tokens = lexer_tokenize(&lex, &arena);
+	Lexer lex2 = lexer_create(source, &arena);
+	PackedTokenArray packed = lexer_tokenize_packed(&lex2, &arena);
+
+	TEST(sizeof(PackedToken) == 8);
+	TEST((isize)packed.len == tokens.len);
+	TEST(packed.literal_len == 3);
+
+	bool same = true;
+	for(u32 i = 0; i < packed.len; i += 1){
+		Token a = tokens.v[i];
+		Token b = packed_token_unpack(&packed, i);
+		same = same && a.kind == b.kind && a.lexeme.v == b.lexeme.v && a.lexeme.len == b.lexeme.len
+			&& mem_compare(&a.value, &b.value, sizeof(a.value)) == 0;
+	}
+	TEST(same);
+
+	TEST(packed.v[packed.len - 1].kind == TokenKind_EndOfFile && packed.v[packed.len - 1].offset == source.len);
+	TEST(str_equals(packed_token_lexeme(&packed, 1), str_lit("f")));
+
+	Token s = packed_token_unpack(&packed, 8);
+	TEST(s.kind == TokenKind_String && s.value.escaped);
+	TEST(str_equals(token_string_value(s, &arena), str_lit("a\tb")));
+	TEST(packed_token_unpack(&packed, 11).value.integer == 0x10);
+
+	PackedTokenArray repacked = token_pack(tokens, source, &arena);
+	TEST(repacked.len == packed.len && mem_compare(repacked.v, packed.v, packed.len * sizeof(PackedToken)) == 0);
+
+	TEST_END;
+}
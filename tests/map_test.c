@@ -0,0 +1,102 @@
+#include "testing.h"
+#include "base/map.h"
+
+/* Few distinct homes and control bytes, so runs get long, wrap around and collide on h2 */
+static
+u64 map_test_bad_hash(void const* key){
+	u64 k = *(u64 const*)key;
+	return ((k % 5) << 7) | (k % 3);
+}
+
+static
+bool map_test_equal_u64(void const* a, void const* b){
+	return *(u64 const*)a == *(u64 const*)b;
+}
+
+/* Random inserts and removals checked against a plain array indexed by key */
+static
+bool map_test_against_reference(HashMap* m, u32 rounds){
+	enum { KEYS = 300 };
+	bool present[KEYS] = {0};
+	u32 values[KEYS] = {0};
+	u64 rng = 0x9e3779b97f4a7c15ull;
+	bool ok = true;
+
+	for(u32 r = 0; r < rounds && ok; r += 1){
+		rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+		u64 key = rng % KEYS;
+		if((rng >> 32) % 3 == 0){
+			ok = map_remove(m, &key) == present[key];
+			present[key] = false;
+		}
+		else {
+			bool inserted = false;
+			u32* v = map_put(m, &key, &inserted);
+			ok = inserted == !present[key] && (inserted ? *v == 0 : *v == values[key]);
+			*v = r;
+			values[key] = r;
+			present[key] = true;
+		}
+	}
+
+	isize count = 0;
+	for(u64 key = 0; key < KEYS && ok; key += 1){
+		u32* v = map_get(m, &key);
+		ok = present[key] ? (v != NULL && *v == values[key]) : v == NULL;
+		count += present[key];
+	}
+	isize iterated = 0;
+	for(isize slot = map_next(m, -1); slot >= 0; slot = map_next(m, slot)){
+		iterated += 1;
+	}
+	return ok && count == m->len && iterated == m->len;
+}
+
+bool test_map(){
+	TEST_BEGIN("Hash map");
+	static byte arena_mem[256 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Heap backed, growing from the minimum size */ {
+		HashMap m = map_make(u64, u32, 0, NULL);
+		TEST(m.cap == MAP_GROUP_WIDTH);
+		TEST(map_test_against_reference(&m, 20000));
+		TEST(m.cap > MAP_GROUP_WIDTH && m.len * 4 <= m.cap * 3);
+		map_destroy(&m);
+	}
+
+	/* Colliding hashes exercise the backward shift across the end of the table */ {
+		HashMap m = map_make(u64, u32, 0, &arena);
+		m.hash = map_test_bad_hash;
+		m.equal = map_test_equal_u64;
+		TEST(map_test_against_reference(&m, 20000));
+
+		/* Removing everything leaves only empty control bytes, there are no tombstones */
+		for(u64 key = 0; key < 300; key += 1){ map_remove(&m, &key); }
+		bool empty = m.len == 0;
+		for(isize i = 0; i < m.cap + MAP_GROUP_WIDTH; i += 1){
+			empty = empty && m.ctrl[i] == 0x80;
+		}
+		TEST(empty && map_next(&m, -1) == -1);
+	}
+
+	/* String keys */ {
+		HashMap m = map_make(String, i32, 8, &arena);
+		m.hash = map_hash_string;
+		m.equal = map_equal_string;
+		String names[] = { str_lit("count"), str_lit("index"), str_lit("buffer_len"), str_lit("x") };
+		for(i32 i = 0; i < 4; i += 1){
+			*(i32*)map_put(&m, &names[i], NULL) = i + 1;
+		}
+		String lookup = str_format(&arena, "%s", "buffer_len"); /* Same bytes, different pointer */
+		i32* v = map_get(&m, &lookup);
+		TEST(v != NULL && *v == 3);
+		String missing = str_lit("buffer");
+		TEST(map_get(&m, &missing) == NULL && m.len == 4);
+
+		map_clear(&m);
+		TEST(m.len == 0 && map_get(&m, &lookup) == NULL);
+	}
+
+	TEST_END;
+}
@@ -0,0 +1,244 @@
+#include "testing.h"
+#include <stdio.h>
+
+#define TEST_NATIVE_EXE "./kielo_test_native"
+
+static
+IrModule native_test_lower(Arena* arena, String source){
+	IrModule m = {0};
+	String errors = ir_test_build(arena, source, &m);
+	ensure(errors.len == 0, "Native code tests need programs that lower to IR");
+	return m;
+}
+
+#if defined(OS_LINUX) && defined(ARCH_X64)
+/* What the executable prints */
+static
+String native_test_run(Arena* arena, String source){
+	IrModule m = native_test_lower(arena, source);
+	NativeProgram p = native_emit_module(&m, arena);
+	String error = {0};
+	if(!native_write_executable(&p, str_lit("t.kl"), TEST_NATIVE_EXE, arena, &error)){
+		return error;
+	}
+	FILE* pipe = popen(TEST_NATIVE_EXE, "r");
+	if(pipe == NULL){
+		return str_lit("<could not run>");
+	}
+	byte buf[1024];
+	isize len = (isize)fread(buf, 1, sizeof(buf), pipe);
+	int status = pclose(pipe);
+	return str_format(arena, "%.*s[%d]", (int)len, (char const*)buf, WEXITSTATUS(status));
+}
+
+/* Result of `main` run in process, in the interpreter's format */
+static
+String native_test_jit(Arena* arena, String source, bool optimize){
+	IrModule* m = arena_make(arena, IrModule, 1);
+	*m = native_test_lower(arena, source);
+	if(optimize){
+		ir_optimize_module(m, &(IrOptOptions){ .inline_budget = IR_DEFAULT_INLINE_BUDGET });
+	}
+	NativeProgram* p = arena_make(arena, NativeProgram, 1);
+	*p = native_emit_module(m, arena);
+	NativeJit jit = native_jit_create(p, 256 * 1024, arena);
+	Value result = {0};
+	bool ok = jit.error == NULL && native_jit_run_main(&jit, &result);
+	native_jit_destroy(&jit);
+	if(!ok){
+		return str_format(arena, "%llu:%.*s;", (unsigned long long)jit.error->offset, str_fmt(jit.error->message));
+	}
+	return bytecode_format_value(result, arena);
+}
+
+/* The interpreter's "offset:message;" or result, as the executable prints it */
+static
+String native_test_expected(Arena* arena, String vm){
+	if(vm.len > 0 && vm.v[vm.len - 1] == ';'){
+		isize colon = 0;
+		while(vm.v[colon] != ':'){ colon += 1; }
+		return str_format(arena, TERM_COLOR_RED "error" TERM_COLOR_RESET " (t.kl:%.*s) %.*s\n[1]",
+			(int)colon, (char const*)vm.v, (int)(vm.len - colon - 2), (char const*)vm.v + colon + 1);
+	}
+	return str_format(arena, "%.*s\n[0]", str_fmt(vm));
+}
+#endif
+
+bool test_native(){
+	TEST_BEGIN("Native code");
+	static byte arena_mem[4 * 1024 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Base registers that need a SIB byte or a displacement */ {
+		X64Code c = { .arena = &arena };
+		x64_mov_load(&c, X64_RAX, x64_mem(X64_R12, 0));
+		x64_mov_load(&c, X64_RAX, x64_mem(X64_R13, 0));
+		x64_mov_store(&c, x64_mem(X64_RSP, 8), X64_R11);
+		x64_sse(&c, X64Sse_Load, 9, x64_mem(X64_RBP, -16));
+		x64_sse(&c, X64Sse_FromGpr, 1, x64_reg(X64_R10));
+		u8 const expected[] = {
+			0x49, 0x8b, 0x04, 0x24,
+			0x49, 0x8b, 0x45, 0x00,
+			0x4c, 0x89, 0x5c, 0x24, 0x08,
+			0xf2, 0x44, 0x0f, 0x10, 0x4d, 0xf0,
+			0x66, 0x49, 0x0f, 0x6e, 0xca,
+		};
+		TEST(c.len == sizeof(expected) && mem_compare(c.v, expected, sizeof(expected)) == 0);
+	}
+
+	/* Layout */ {
+		IrModule m = native_test_lower(&arena, str_lit(
+			"let a = 1;\nlet b = 2.0;\n"
+			"fn f(x: Int) -> Int { return x / a; }\n"
+			"fn main() -> Int { return f(4) + 1; }\n"));
+		NativeProgram p = native_emit_module(&m, &arena);
+		TEST(p.data_size == 32 && p.trap_slot == 16 && p.stack_slot == 24);
+		bool aligned = true;
+		for(u32 f = 0; f < m.function_count; f += 1){
+			aligned = aligned && p.entries[f] % 16 == 0 && p.entries[f] < p.code_len;
+		}
+		TEST(aligned);
+		/* Division by zero and Int64 minimum by -1 in `f`, the stack check and the addition in `main` */
+		TEST(p.trap_count == 4
+			&& p.traps[0].kind == NativeTrap_DivisionByZero && p.traps[1].kind == NativeTrap_Overflow
+			&& p.traps[2].kind == NativeTrap_StackOverflow && p.traps[3].kind == NativeTrap_Overflow);
+		TEST(str_equals(native_trap_message(NativeTrap_ShiftRange, -3, &arena),
+			str_lit("Shift amount -3 is out of range, it must be between 0 and 63")));
+	}
+
+#if defined(OS_LINUX) && defined(ARCH_X64)
+	/* Executables and the JIT agree with the interpreter */ {
+		String prelude = str_lit(
+			"let counter = 0;\n"
+			"let scale = 2.5;\n"
+			"fn bump(n: Int) { counter += n; }\n"
+			"fn fib(n: Int) -> Int { if n < 2 { return n; } return fib(n - 1) + fib(n - 2); }\n"
+			"fn down(n: Int) -> Int { return down(n + 1) + 1; }\n"
+			/* Phis that trade places every iteration */
+			"fn rot(n: Int) -> Int {\n"
+			"	let a = 1; let b = 2; let c = 3; let i = 0;\n"
+			"	for i < n { let t = a; a = b; b = c; c = t; i += 1; }\n"
+			"	return a * 100 + b * 10 + c;\n"
+			"}\n"
+			/* Arguments past the registers go on the stack */
+			"fn many(a: Int, b: Int, c: Int, d: Int, e: Int, f: Int, g: Int, h: Int, x: Real, y: Real,\n"
+			"	z: Real, w: Real, p: Real, q: Real, r: Real, s: Real, t: Real, u: Real) -> Int {\n"
+			"	let sum = x + y * 2.0 + z * 3.0 + w * 4.0 + p * 5.0 + q * 6.0 + r * 7.0 + s * 8.0 + t * 9.0 + u * 10.0;\n"
+			"	if sum > 100.0 { return a - b + c * d - e + f * g - h; }\n"
+			"	return a + b + c + d + e + f + g + h;\n"
+			"}\n"
+			/* More values live across a call than there are callee saved registers */
+			"fn pressure(n: Int, x: Real) -> Real {\n"
+			"	let a = n + 1; let b = n + 2; let c = n + 3; let d = n + 4; let e = n + 5; let f = n + 6;\n"
+			"	let g = n + 7; let h = n + 8; let y = x * 2.0; let z = x + 1.0;\n"
+			"	bump(fib(5));\n"
+			"	let r = a + b * 2 + c * 3 + d * 4 + e * 5 + f * 6 + g * 7 + h * 8 + counter;\n"
+			"	if r > 100 { return y * z; }\n"
+			"	return y - z;\n"
+			"}\n"
+			"fn reals(x: Real) -> Int {\n"
+			"	let nan = 0.0 / 0.0; let r = 0;\n"
+			"	if nan < 1.0 { r += 1; } if nan <= 1.0 { r += 2; } if nan == nan { r += 4; } if nan != nan { r += 8; }\n"
+			"	if x * scale > 3.0 { r += 16; } if -x < 0.0 { r += 32; } if x == 1.5 { r += 64; } if 2.0 >= x { r += 128; }\n"
+			"	return r;\n"
+			"}\n"
+			"fn logic(x: Int) -> Bool { return x > 3 && x < 10 || x == -1 || !(x != 42); }\n"
+			/* Traps in code inlined by the optimized runs report the callee's offset */
+			"fn ratio(a: Int, b: Int) -> Int { return a / b; }\n");
+		char const* mains[] = {
+			"fn main() -> Int { return fib(20) + rot(7); }",
+			"fn main() -> Int { return many(1, 2, 3, 4, 5, 6, 7, 8, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0); }",
+			"fn main() -> Int { return many(1, 2, 3, 4, 5, 6, 7, 8, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0); }",
+			"fn main() -> Bool { return pressure(3, 1.5) == 7.5 && pressure(-9, 1.5) == -1.5; }",
+			"fn main() -> Int { bump(3); return reals(1.5) * 1000 + reals(3.0) + counter; }",
+			"fn main() -> Int { let a = -7; let b = 2; let m = -1; return (a / b) * 1000 + (a % b) * 100 + (a / m) * 10 + a % m + (a >> 1) * 100000 + (a << 3) * 10000000 + ~a; }",
+			"fn main() -> Int { let n = 0; let i = -3; for i < 50 { if logic(i) { n += 1; } i += 1; } return n; }",
+			"fn main() -> Bool { return logic(11); }",
+			"fn main() -> Int { return -9223372036854775807 - 1; }",
+			"fn main() -> Int { let a = 1 << 62; return a * 4; }",
+			"fn main() -> Int { let z = 0; return 5 % z; }",
+			"fn main() -> Int { let m = -9223372036854775807 - 1; let n = -1; return m / n; }",
+			"fn main() -> Int { let s = 70; return 1 << s; }",
+			"fn main() -> Int { let s = -1; return 1 >> s; }",
+			"fn main() -> Int { return down(1); }",
+			"fn main() -> Int { let s = 0; let i = 3; for i > -1 { s += ratio(12, i); i -= 1; } return s; }",
+			"fn main() -> Int { let x = 1; x = x + (x = 5); return x; }",
+			"fn main() -> Int { let x = 1; let y = x + (x = 5) * 0; return y; }",
+			"fn main() -> Int { let x = 1; x = 2; x += (x = 5); return x * 10 + rot(x); }",
+			"fn main() -> Bool { let x = 1; return x > (x = 5) - 10 && x == 5; }",
+			"let early: Int = late + 1;\nlet late: Int = 2;\nfn main() -> Int { return early * 10 + late; }",
+			"fn pick(a: Int, b: Int, c: Int) -> Int { return a * 100 + b * 10 + c; }\n"
+				"fn main() -> Int { let a = 1; let b = 2; let c = 3; let i = 0; for i < 4 { let t = pick(c, a, b); a = b; b = c; c = t % 10; i += 1; } return pick(b, c, a) + a; }",
+			"fn second(a: Int, b: Int) -> Int { return b; }\nfn main() -> Int { return second(fib(3), 7) + fib(second(0, 4)); }",
+			"fn main() -> Bool { let x = 259; let y = 3; return x == y; }",
+		};
+		for(u32 i = 0; i < sizeof(mains) / sizeof(mains[0]); i += 1){
+			ArenaRegion reg = arena_region_begin(&arena);
+			String source = str_format(&arena, "%.*s%s\n", str_fmt(prelude), mains[i]);
+			String vm = vm_test_run(&arena, source, NULL, false);
+			String expected = native_test_expected(&arena, vm);
+			String got = native_test_run(&arena, source);
+			if(!TEST(str_equals(got, expected))){
+				printf("  %s\n  expected %.*s\n  got      %.*s\n", mains[i], str_fmt(expected), str_fmt(got));
+			}
+			String vm_opt = vm_test_run(&arena, source, NULL, true);
+			if(!TEST(str_equals(vm_opt, vm))){
+				printf("  %s (interpreted, optimized)\n  expected %.*s\n  got      %.*s\n", mains[i], str_fmt(vm), str_fmt(vm_opt));
+			}
+			for(int optimize = 0; optimize < 2; optimize += 1){
+				String jit = native_test_jit(&arena, source, optimize);
+				if(!TEST(str_equals(jit, vm))){
+					printf("  %s%s\n  expected %.*s\n  got      %.*s\n", mains[i], optimize ? " (optimized)" : "", str_fmt(vm), str_fmt(jit));
+				}
+			}
+			arena_region_end(reg);
+		}
+	}
+
+	/* `main` without a result prints nothing, there must be one */ {
+		TEST(str_equals(native_test_run(&arena, str_lit("let g = 1.5;\nfn main() { g = g * 2.0; }\n")), str_lit("[0]")));
+		TEST(str_equals(native_test_run(&arena, str_lit("fn f() -> Int { return 1; }\n")), str_lit("No 'main' function to run")));
+		TEST(str_equals(native_test_run(&arena, str_lit("fn main() -> Real { return 1.0; }\n")),
+			str_lit("'main' returns a Real, executables can only print Int and Bool results")));
+	}
+	remove(TEST_NATIVE_EXE);
+
+	/* Calls from C with stack arguments, globals persist and a trap leaves the JIT usable */ {
+		IrModule m = native_test_lower(&arena, str_lit(
+			"let total = 0.5;\n"
+			"fn add(a: Int, b: Int, c: Int, d: Int, e: Int, f: Int, g: Int, x: Real, on: Bool) -> Real {\n"
+			"	if on { total += x; }\n"
+			"	if a + b + c + d + e + f - g == 20 { return total; }\n"
+			"	return -1.0;\n"
+			"}\n"
+			"fn inverse(n: Int) -> Int { return 100 / n; }\n"
+			"fn deep(n: Int) -> Int { return deep(n + 1); }\n"));
+		NativeProgram p = native_emit_module(&m, &arena);
+		NativeJit jit = native_jit_create(&p, NATIVE_JIT_DEFAULT_STACK, &arena);
+		TEST(jit.error == NULL);
+
+		Value args[9] = {
+			{ ConstKind_Int, { .integer = 1 } }, { ConstKind_Int, { .integer = 2 } }, { ConstKind_Int, { .integer = 3 } },
+			{ ConstKind_Int, { .integer = 4 } }, { ConstKind_Int, { .integer = 5 } }, { ConstKind_Int, { .integer = 6 } },
+			{ ConstKind_Int, { .integer = 1 } }, { ConstKind_Real, { .real = 2.0 } }, { ConstKind_Bool, { .boolean = true } },
+		};
+		Value result = {0};
+		Value unused;
+		TEST(native_jit_call(&jit, m.init, NULL, 0, &unused));
+		TEST(native_jit_call(&jit, 0, args, 9, &result) && result.kind == ConstKind_Real && result.value.real == 2.5);
+		args[8].value.boolean = false;
+		TEST(native_jit_call(&jit, 0, args, 9, &result) && result.value.real == 2.5);
+
+		Value zero = { ConstKind_Int, { .integer = 0 } };
+		TEST(!native_jit_call(&jit, 1, &zero, 1, &result) && str_equals(jit.error->message, str_lit("Division by zero")));
+		TEST(!native_jit_call(&jit, 2, &zero, 1, &result) && str_equals(jit.error->message, str_lit("Stack overflow")));
+		Value four = { ConstKind_Int, { .integer = 4 } };
+		TEST(native_jit_call(&jit, 1, &four, 1, &result) && result.value.integer == 25);
+		native_jit_destroy(&jit);
+	}
+#endif
+
+	TEST_END;
+}
+
+#undef TEST_NATIVE_EXE
@@ -0,0 +1,156 @@
+#include "testing.h"
+
+bool test_opt(){
+	TEST_BEGIN("IR passes");
+	static byte arena_mem[1024 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* A constant condition folds the branch, the dead side and the join go away */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn f(x: Int) -> Int {\n"
+			"	let mode = 2;\n"
+			"	let scale = mode * 3;\n"
+			"	if mode == 2 { return x * scale; }\n"
+			"	return x / 7;\n"
+			"}\n"), &m);
+		IrOptStats stats = ir_optimize(&m.functions[0]);
+		TEST(errors.len == 0);
+		TEST(str_equals(ir_dump(&m, &arena), str_lit(
+			"fn f(Int) -> Int\n"
+			"b0:\n"
+			"  v0 Int = Param 0\n"
+			"  v1 Int = Const 6\n"
+			"  v2 Int = Mul v0 v1\n"
+			"  Return v2\n"
+			"fn <init>()\n"
+			"b0:\n"
+			"  Return \n")));
+		TEST(stats.folded == 2 && stats.branches == 1 && stats.merged == 1 && stats.removed == 8);
+	}
+
+	/* A phi whose incoming values agree on every executable edge is a constant */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn f(n: Int) -> Int {\n"
+			"	let flag = 1;\n"
+			"	let i = 0;\n"
+			"	for i < n {\n"
+			"		if flag == 1 { i += 1; } else { flag = 0; }\n"
+			"		let unused = i & 3;\n"
+			"	}\n"
+			"	return flag;\n"
+			"}\n"), &m);
+		IrFunction* f = &m.functions[0];
+		ir_optimize(f);
+		TEST(errors.len == 0 && ir_test_count(f, IrOp_Phi) == 1 && ir_test_count(f, IrOp_And) == 0 && ir_test_count(f, IrOp_Eq) == 0);
+		IrInst ret = f->insts.v[f->insts.len - 1];
+		TEST(ret.op == IrOp_Return && f->insts.v[ret.a].op == IrOp_Const && f->insts.v[ret.a].a == 1);
+	}
+
+	/* Operations that can trap stay even when their result is unused or known to fail */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"let g = 0;\n"
+			"fn f(x: Int) -> Int {\n"
+			"	let z = 0;\n"
+			"	let a = x / z;\n"
+			"	let b = x + 1;\n"
+			"	let c = x / 4;\n"
+			"	let s = 70;\n"
+			"	let d = 1 << s;\n"
+			"	g = 5;\n"
+			"	return 0;\n"
+			"}\n"), &m);
+		IrFunction* f = &m.functions[0];
+		ir_optimize(f);
+		TEST(errors.len == 0 && ir_test_count(f, IrOp_Div) == 1 && ir_test_count(f, IrOp_Add) == 1 && ir_test_count(f, IrOp_Shl) == 1);
+		TEST(ir_test_count(f, IrOp_SetGlobal) == 1);
+	}
+
+	/* Whole modules, calls keep their arguments alive */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn id(x: Int) -> Int { return x; }\n"
+			"fn main() -> Int { let t = 3 > 2; if t { return id(4 + 5); } return 0; }\n"), &m);
+		IrOptStats stats = ir_optimize_module(&m, NULL);
+		IrFunction* f = &m.functions[1];
+		TEST(errors.len == 0 && stats.branches == 1 && f->blocks.len == 1 && ir_test_count(f, IrOp_Call) == 1);
+		TEST(ir_test_count(f, IrOp_Const) == 1 && ir_test_count(f, IrOp_Add) == 0);
+	}
+
+	/* Small callees are inlined bottom up, a callee with several returns leaves a phi */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn sq(x: Int) -> Int { return x * x; }\n"
+			"fn clamp(x: Int, hi: Int) -> Int { if x > hi { return hi; } return sq(x); }\n"
+			"fn main() -> Int { let s = 0; let i = 0; for i < 10 { s += clamp(i, 50); i += 1; } return s; }\n"), &m);
+		IrInlinedCallArray inlined = { .arena = &arena };
+		IrOptStats per_function[4];
+		IrOptStats stats = ir_optimize_module(&m, &(IrOptOptions){
+			.inline_budget = IR_DEFAULT_INLINE_BUDGET, .inlined = &inlined, .function_stats = per_function });
+		IrFunction* f = &m.functions[2];
+		TEST(errors.len == 0 && stats.inlined == 2 && per_function[1].inlined == 1 && per_function[2].inlined == 1);
+		TEST(inlined.len == 2 && inlined.v[0].caller == 1 && inlined.v[0].callee == 0 && inlined.v[0].offset == 108);
+		TEST(inlined.v[1].caller == 2 && inlined.v[1].callee == 1 && inlined.v[1].offset == 179);
+		TEST(ir_test_count(f, IrOp_Call) == 0 && ir_test_count(f, IrOp_Mul) == 1 && ir_test_count(f, IrOp_Phi) == 3);
+	}
+
+	/* Recursive calls stay, callers outside the cycle may still inline one level of it */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn fact(n: Int) -> Int { if n < 2 { return 1; } return n * fact(n - 1); }\n"
+			"fn even(n: Int) -> Bool { if n == 0 { return 1 == 1; } return odd(n - 1); }\n"
+			"fn odd(n: Int) -> Bool { if n == 0 { return 1 == 0; } return even(n - 1); }\n"
+			"fn main() -> Bool { return even(fact(3)); }\n"), &m);
+		IrOptStats per_function[5];
+		ir_optimize_module(&m, &(IrOptOptions){ .inline_budget = IR_DEFAULT_INLINE_BUDGET, .function_stats = per_function });
+		TEST(errors.len == 0 && per_function[0].inlined == 0 && per_function[1].inlined == 0 && per_function[2].inlined == 0);
+		TEST(ir_test_count(&m.functions[0], IrOp_Call) == 1 && ir_test_count(&m.functions[1], IrOp_Call) == 1);
+		TEST(per_function[3].inlined == 2 && ir_test_count(&m.functions[3], IrOp_Call) == 2);
+	}
+
+	/* Callees over the budget are called */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn f(a: Int, b: Int) -> Int { let c = a * b + a; return c * c - b; }\n"
+			"fn main() -> Int { return f(1, 2) + f(3, 4); }\n"), &m);
+		IrOptStats stats = ir_optimize_module(&m, &(IrOptOptions){ .inline_budget = 4 });
+		TEST(errors.len == 0 && stats.inlined == 0 && ir_test_count(&m.functions[1], IrOp_Call) == 2);
+		stats = ir_optimize_module(&m, &(IrOptOptions){ .inline_budget = 5 });
+		TEST(stats.inlined == 2 && ir_test_count(&m.functions[1], IrOp_Call) == 0);
+	}
+
+	/* Merging a block skips the phis dead code elimination left as Nops, a live phi after them
+	   must still take its only operand */ {
+		IrModule m;
+		String errors = ir_test_build(&arena, str_lit(
+			"fn main() -> Int { let x = 6; if x > 1 { let i = 0; for i < 1 { i += 1; x = 100; } } return x; }\n"), &m);
+		ir_optimize_module(&m, NULL);
+		IrFunction* f = &m.functions[0];
+		bool edges_ok = true;
+		for(u32 b = 0; b < f->blocks.len; b += 1){
+			IrBlock const* blk = &f->blocks.v[b];
+			for(u32 v = blk->first; v < blk->first + blk->count && f->insts.v[v].op == IrOp_Phi; v += 1){
+				IrInst const* phi = &f->insts.v[v];
+				for(u32 k = 0; k < phi->b; k += 1){
+					u32 from = f->operands.v[phi->a + phi->b + k];
+					bool is_pred = false;
+					for(u32 p = 0; p < blk->pred_count; p += 1){
+						is_pred = is_pred || f->preds.v[blk->pred_start + p] == from;
+					}
+					edges_ok = edges_ok && is_pred;
+				}
+			}
+		}
+		TEST(errors.len == 0 && edges_ok);
+
+		Emitter e = emitter_create(&m, str_lit("test.kl"), &arena);
+		BcProgram program = emitter_emit_module(&e);
+		Vm vm = vm_create(&program, 256, 16, &arena);
+		Value result = {0};
+		TEST(e.error_count == 0 && vm_run_main(&vm, &result) && result.value.integer == 100);
+	}
+
+	TEST_END;
+}
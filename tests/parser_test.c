@@ -0,0 +1,209 @@
+#include "testing.h"
+
+typedef struct {
+	String dump;
+	Parser parser;
+} ParseResult;
+
+static
+ParseResult parse_source(String source, Arena* arena){
+	Lexer lex = lexer_create(source, arena);
+	TokenArray tokens = lexer_tokenize(&lex, arena);
+	Parser p = parser_create(source, tokens, arena, arena);
+	u32 file = parser_parse_file(&p);
+	return (ParseResult){ .dump = ast_dump(&p.ast, tokens, file, arena), .parser = p };
+}
+
+/* Parses `expr` as the initializer of a top-level `let` and dumps only the expression */
+static
+String parse_expr(char const* expr, Arena* arena){
+	String source = str_format(arena, "let x = %s;", expr);
+	ParseResult r = parse_source(source, arena);
+	Parser* p = &r.parser;
+	u32 file = p->ast.len - 1;
+	u32 let = p->ast.extra[p->ast.lhs[file]];
+	return ast_dump(&p->ast, p->tokens, p->ast.rhs[let], arena);
+}
+
+bool test_parser(){
+	TEST_BEGIN("Parser");
+	byte arena_mem[64 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Precedence and associativity */ {
+		TEST(str_equals(parse_expr("1 + 2 * 3", &arena), str_lit("(+ 1 (* 2 3))")));
+		TEST(str_equals(parse_expr("1 - 2 - 3", &arena), str_lit("(- (- 1 2) 3)")));
+		TEST(str_equals(parse_expr("(1 - 2) * 3", &arena), str_lit("(* (- 1 2) 3)")));
+		TEST(str_equals(parse_expr("a < b && c || d", &arena), str_lit("(|| (&& (< a b) c) d)")));
+		TEST(str_equals(parse_expr("a << 1 + b", &arena), str_lit("(+ (<< a 1) b)")));
+		TEST(str_equals(parse_expr("a = b += c", &arena), str_lit("(= a (+= b c))")));
+		TEST(str_equals(parse_expr("-a * !b", &arena), str_lit("(* (- a) (! b))")));
+	}
+
+	/* Postfix */ {
+		TEST(str_equals(parse_expr("f(1, g(2))[0].len", &arena), str_lit("(. (index (call f 1 (call g 2)) 0) len)")));
+		TEST(str_equals(parse_expr("f()", &arena), str_lit("(call f)")));
+		TEST(str_equals(parse_expr("\"hi\" == 1.5", &arena), str_lit("(== \"hi\" 1.5)")));
+	}
+
+	/* Declarations and statements */ {
+		ParseResult r = parse_source(str_lit(
+			"let g: Int = 1;\n"
+			"fn add(a: Int, b: Int) -> Int { return a + b; }\n"
+			"fn main() {\n"
+			"	let i = 0;\n"
+			"	for i < 10 { i += 1; if i == 5 { break; } else if i == 6 { continue; } else { f(i); } }\n"
+			"	for { return; }\n"
+			"}\n"), &arena);
+		TEST(r.parser.error == NULL);
+		TEST(str_equals(r.dump, str_lit(
+			"(file (let g Int 1)"
+			" (fn add ((a Int) (b Int)) Int (block (return (+ a b))))"
+			" (fn main () _ (block (let i _ 0)"
+			" (for (< i 10) (block (+= i 1) (if (== i 5) (block break) (if (== i 6) (block continue) (block (call f i))))))"
+			" (for _ (block (return))))))")));
+	}
+
+	/* Node storage */ {
+		ParseResult r = parse_source(str_lit("fn f() { let a = 1 + 2; }"), &arena);
+		Ast* ast = &r.parser.ast;
+		TEST(ast->kind[AST_NULL] == AstKind_Invalid);
+		TEST(ast->kind[ast->len - 1] == AstKind_File);
+		TEST(str_equals(ast_kind_name(AstKind_Binary), str_lit("Binary")));
+	}
+
+	/* Recovery reports one error per broken statement and keeps parsing */ {
+		ParseResult r = parse_source(str_lit(
+			"fn main() {\n"
+			"	let a = ;\n"
+			"	let b = (1 + 2;\n"
+			"	b = 3;\n"
+			"}\n"
+			"fn other() { return 1 }\n"), &arena);
+		Parser* p = &r.parser;
+		TEST(p->error_count == 3);
+		TEST(p->error != NULL && p->error->type == ParserError_ExpectedExpression && p->error->offset == 21);
+		TEST(p->error->next != NULL && p->error->next->type == ParserError_UnexpectedToken);
+		TEST(str_equals(r.dump, str_lit(
+			"(file (fn main () _ (block (let a _ <invalid>) (let b _ (+ 1 2)) (= b 3)))"
+			" (fn other () _ (block (return 1))))")));
+	}
+
+	/* Garbage at the top level is skipped up to the next declaration */ {
+		ParseResult r = parse_source(str_lit("1 2 3 fn f() {} ) let x = 1;"), &arena);
+		TEST(r.parser.error_count == 2);
+		TEST(str_equals(r.dump, str_lit("(file (fn f () _ (block)) (let x _ 1))")));
+	}
+
+	/* Unterminated input does not hang */ {
+		ParseResult r = parse_source(str_lit("fn f( { let x = (1 + "), &arena);
+		TEST(r.parser.error_count > 0);
+	}
+
+	TEST_END;
+}
+
+static
+String parse_dump_parallel(String source, i32 thread_count, Arena* arena, Parser* out){
+	Lexer lex = lexer_create(source, arena);
+	TokenArray tokens = lexer_tokenize(&lex, arena);
+	*out = parser_create(source, tokens, arena, arena);
+	u32 file = parser_parse_file_parallel(out, thread_count);
+	return ast_dump(&out->ast, tokens, file, arena);
+}
+
+/* Renders the error list so sequential and parallel runs can be compared */
+static
+String parse_errors(Parser const* p, Arena* arena){
+	String s = str_lit("");
+	for(CompilerError* err = p->error; err != NULL; err = err->next){
+		s = str_format(arena, "%.*s%llu:%u ", str_fmt(s), (unsigned long long)err->offset, err->type);
+	}
+	return s;
+}
+
+bool test_parser_parallel(){
+	TEST_BEGIN("Parser parallel");
+	static byte arena_mem[512 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Skim */ {
+		Lexer lex = lexer_create(str_lit("let a = 1; fn f() { if a { } } fn g() -> Int { return { 1 }; }"), &arena);
+		TokenArray tokens = lexer_tokenize(&lex, &arena);
+		FnSpanArray spans = parser_skim(tokens, &arena);
+		TEST(spans.len == 2);
+		TEST(spans.v[0].fn == 5 && spans.v[0].body_begin == 9 && spans.v[0].body_end == 14);
+		TEST(tokens.v[spans.v[1].body_begin].kind == TokenKind_CurlyOpen && spans.v[1].body_end == (u32)tokens.len - 2);
+	}
+
+	String source = str_lit(
+		"let g = 1;\n"
+		"fn a(x: Int) -> Int { return x * 2 + g; }\n"
+		"fn b() { for i < 10 { i += a(i); if i { break; } } }\n"
+		"fn broken() { let = 1; f(; }\n"
+		"fn c() { { { } } }\n"
+		"fn d() x { return 1; }\n"
+		"let h = a(2);\n"
+		"fn e(s: Str) { print(s[0].len); }\n");
+
+	Parser seq;
+	String expected = parse_dump_parallel(source, 1, &arena, &seq);
+	String expected_errors = parse_errors(&seq, &arena);
+	TEST(seq.error_count == 3);
+
+	/* Same tree and errors regardless of the thread count */
+	for(i32 threads = 2; threads <= 8; threads *= 2){
+		Parser par;
+		String got = parse_dump_parallel(source, threads, &arena, &par);
+		TEST(str_equals(got, expected));
+		TEST(str_equals(parse_errors(&par, &arena), expected_errors));
+		TEST(par.error_count == seq.error_count);
+	}
+
+	/* Unterminated bodies are left to the declaration pass */ {
+		Parser par;
+		String got = parse_dump_parallel(str_lit("fn a() { } fn b() { let x = 1;"), 4, &arena, &par);
+		TEST(str_equals(got, str_lit("(file (fn a () _ (block)) (fn b () _ (block (let x _ 1))))")));
+		TEST(par.error_count == 1);
+	}
+
+	TEST_END;
+}
+
+bool test_parser_lazy(){
+	TEST_BEGIN("Parser lazy");
+	byte arena_mem[64 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	String source = str_lit(
+		"fn a(x: Int) -> Int { return x + 1; }\n"
+		"let g = a(1);\n"
+		"fn b() { let = 2; }\n");
+	Lexer lex = lexer_create(source, &arena);
+	TokenArray tokens = lexer_tokenize(&lex, &arena);
+
+	Parser p = parser_create(source, tokens, &arena, &arena);
+	p.defer_bodies = true;
+	u32 file = parser_parse_file(&p);
+
+	/* Only signatures are parsed, body errors wait until the body is asked for */
+	TEST(str_equals(ast_dump(&p.ast, tokens, file, &arena), str_lit("(file (fn a ((x Int)) Int {...}) (let g _ (call a 1)) (fn b () _ {...}))")));
+	TEST(p.error == NULL);
+
+	u32 fn_a = p.ast.extra[p.ast.lhs[file]];
+	u32 deferred = p.ast.rhs[fn_a];
+	TEST(p.ast.kind[deferred] == AstKind_DeferredBody);
+	TEST(tokens.v[p.ast.token[deferred]].kind == TokenKind_CurlyOpen && tokens.v[p.ast.lhs[deferred]].kind == TokenKind_CurlyClose);
+
+	u32 body = parser_fn_body(&p, fn_a);
+	TEST(p.ast.kind[body] == AstKind_Block && p.ast.rhs[fn_a] == body);
+	TEST(parser_fn_body(&p, fn_a) == body);
+	TEST(str_equals(ast_dump(&p.ast, tokens, body, &arena), str_lit("(block (return (+ x 1)))")));
+
+	u32 fn_b = p.ast.extra[p.ast.lhs[file] + 2];
+	parser_fn_body(&p, fn_b);
+	TEST(p.error_count == 1 && p.error != NULL && p.error->offset == 65);
+	TEST(str_equals(ast_dump(&p.ast, tokens, file, &arena), str_lit("(file (fn a ((x Int)) Int (block (return (+ x 1)))) (let g _ (call a 1)) (fn b () _ (block (let = _ 2))))")));
+
+	TEST_END;
+}
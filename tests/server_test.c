@@ -0,0 +1,154 @@
+#include "testing.h"
+#include "base/thread.h"
+#include <stdio.h>
+
+#if defined(OS_LINUX)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define TEST_SERVER_SOCKET "kielo_test.sock"
+#define TEST_SERVER_FILE "kielo_server_test.kl"
+#define TEST_SERVER_DIR "kielo_server_test_dir"
+
+static
+void test_server_thread(void* arg){
+	*(int*)arg = server_run(TEST_SERVER_SOCKET);
+}
+
+static
+bool test_server_call(Arena* arena, char const* arg, String* output, int* status){
+	char cwd[4096];
+	if(getcwd(cwd, sizeof(cwd)) == NULL){ return false; }
+	String cwd_str = { .v = (byte const*)cwd, .len = (isize)__builtin_strlen(cwd) };
+
+	char const* args[] = { arg };
+	/* The server may not be listening yet */
+	for(int attempt = 0; attempt < 2000; attempt += 1){
+		if(server_request(TEST_SERVER_SOCKET, cwd_str, 1, args, arena, output, status)){
+			return true;
+		}
+		usleep(1000);
+	}
+	return false;
+}
+
+static
+bool test_server_write(char const* source){
+	FILE* f = fopen(TEST_SERVER_FILE, "wb");
+	if(f == NULL){ return false; }
+	fputs(source, f);
+	fclose(f);
+	return true;
+}
+
+bool test_server(){
+	TEST_BEGIN("Compile server");
+	static byte arena_mem[256 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	String out = {0};
+	int status = -1;
+	TEST(test_server_write("fn f() { let = 1; }\n"));
+
+	int server_status = -1;
+	Thread* server = thread_create(test_server_thread, &server_status);
+
+	/* Cold compile */ {
+		TEST(test_server_call(&arena, TEST_SERVER_FILE, &out, &status));
+		TEST(status == 1 && str_starts_with(out, str_lit(TERM_COLOR_RED "error")));
+		String first = out;
+
+		TEST(test_server_call(&arena, TEST_SERVER_FILE, &out, &status));
+		TEST(status == 1 && str_equals(out, first));
+		TEST(test_server_call(&arena, "--stats", &out, &status));
+		TEST(str_equals(out, str_lit("files: 1 hits: 1 misses: 1 invalidations: 0\n")));
+	}
+
+	/* Writing the file drops the unit */ {
+		TEST(test_server_write("fn f() -> Int { return 1; }\n"));
+		TEST(test_server_call(&arena, TEST_SERVER_FILE, &out, &status));
+		TEST(status == 0 && out.len == 0);
+		TEST(test_server_call(&arena, "--stats", &out, &status));
+		TEST(str_equals(out, str_lit("files: 1 hits: 1 misses: 2 invalidations: 1\n")));
+	}
+
+	/* So does replacing it through a rename */ {
+		char const* source = "fn f( { }\n";
+		TEST(file_write_atomic(TEST_SERVER_FILE, source, (isize)__builtin_strlen(source)));
+		TEST(test_server_call(&arena, TEST_SERVER_FILE, &out, &status));
+		TEST(status == 1 && out.len > 0);
+		TEST(test_server_call(&arena, "--stats", &out, &status));
+		TEST(str_equals(out, str_lit("files: 1 hits: 1 misses: 3 invalidations: 2\n")));
+	}
+
+	/* Missing files are reported and not kept */ {
+		TEST(test_server_call(&arena, "kielo_server_missing.kl", &out, &status));
+		TEST(status == 1 && out.len > 0);
+		TEST(test_server_call(&arena, "--stats", &out, &status));
+		TEST(str_equals(out, str_lit("files: 1 hits: 1 misses: 4 invalidations: 2\n")));
+	}
+
+	/* A client that stalls halfway through its request is dropped, the next one is served */ {
+		struct sockaddr_un addr;
+		int stalled = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		TEST(server_address(TEST_SERVER_SOCKET, &addr) && stalled >= 0);
+		TEST(connect(stalled, (struct sockaddr const*)&addr, sizeof(addr)) == 0);
+		u32 magic = 0x5652534bu; /* Start of a request header, the size never comes */
+		TEST(send(stalled, &magic, sizeof(magic), 0) == sizeof(magic));
+		TEST(test_server_call(&arena, "--stats", &out, &status));
+		TEST(status == 0 && str_starts_with(out, str_lit("files: 1 ")));
+		close(stalled);
+	}
+
+	/* One request adding more files than fit in the first table, the earlier units must stay put */ {
+		TEST(mkdir(TEST_SERVER_DIR, 0755) == 0 || errno == EEXIST);
+		for(int i = 0; i < 40; i += 1){
+			char path[64];
+			snprintf(path, sizeof(path), TEST_SERVER_DIR "/f%02d.kl", i);
+			FILE* f = fopen(path, "wb");
+			if(!TEST(f != NULL)){ break; }
+			fprintf(f, "fn f%d() -> Int { return %d + ; }\n", i, i);
+			fclose(f);
+		}
+		TEST(test_server_call(&arena, TEST_SERVER_DIR, &out, &status));
+		TEST(status == 1);
+		for(int i = 0; i < 40; i += 1){
+			String path = str_format(&arena, TEST_SERVER_DIR "/f%02d.kl:", i);
+			isize found = 0;
+			for(isize at = 0; at + path.len <= out.len; at += 1){
+				found += mem_compare(out.v + at, path.v, path.len) == 0;
+			}
+			TEST(found == 1);
+		}
+		TEST(test_server_call(&arena, "--stats", &out, &status));
+		TEST(str_equals(out, str_lit("files: 41 hits: 1 misses: 44 invalidations: 2\n")));
+	}
+
+	TEST(test_server_call(&arena, "--shutdown", &out, &status));
+	TEST(status == 0 && str_equals(out, str_lit("Server stopped\n")));
+	thread_join(server);
+	TEST(server_status == 0);
+	TEST(access(TEST_SERVER_SOCKET, F_OK) != 0);
+
+	remove(TEST_SERVER_FILE);
+	for(int i = 0; i < 40; i += 1){
+		char path[64];
+		snprintf(path, sizeof(path), TEST_SERVER_DIR "/f%02d.kl", i);
+		remove(path);
+	}
+	rmdir(TEST_SERVER_DIR);
+	TEST_END;
+}
+
+#undef TEST_SERVER_SOCKET
+#undef TEST_SERVER_FILE
+#undef TEST_SERVER_DIR
+
+#else
+
+bool test_server(){
+	return true;
+}
+
+#endif
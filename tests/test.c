@@ -1,10 +1,57 @@
+#include "base/types.h"
+#include "base/memory.h"
+#include "base/string.h"
+#include "kielo.h"
+#include "errors.c"
+#include "tokens.c"
+#include "lexer.c"
+#include "parser.c"
+#include "checker.c"
+#include "ir.c"
+#include "opt.c"
+#include "bytecode.c"
+#include "vm.c"
+#include "native.c"
+#include "cache.c"
+#include "driver.c"
+#include "server.c"
+
 #include "testing.h"
+#include "utf8_test.c"
+#include "map_test.c"
+#include "array_test.c"
 #include "lexer_test.c"
+#include "parser_test.c"
+#include "checker_test.c"
+#include "ir_test.c"
+#include "opt_test.c"
+#include "vm_test.c"
+#include "native_test.c"
+#include "cache_test.c"
+#include "driver_test.c"
+#include "server_test.c"
 
 int main(){
 	bool ok = true
+		&& test_utf8()
+		&& test_utf8_transcoding()
+		&& test_map()
+		&& test_array()
 		&& test_lexer()
+		&& test_lexer_strings()
+		&& test_lexer_recovery()
+		&& test_lexer_packed()
+		&& test_parser()
+		&& test_parser_parallel()
+		&& test_parser_lazy()
+		&& test_checker()
+		&& test_ir()
+		&& test_opt()
+		&& test_vm()
+		&& test_native()
+		&& test_cache()
+		&& test_driver()
+		&& test_server()
 	;
 	return !ok;
 }
-
@@ -12,7 +12,7 @@ bool test_predicate_ex(struct TestCase* t, bool predicate, char const* msg, char
 	t->total += 1;
 	if(!predicate){
 		t->failed += 1;
-		printf("(%s:%d) Test failure: %s", filename, line, msg);
+		printf("(%s:%d) Test failure: %s\n", filename, line, msg);
 	}
 	return predicate;
 }
@@ -26,6 +26,6 @@ void test_display(struct TestCase t){
 
 #define TEST(Pred) test_predicate_ex(&_test, (Pred), #Pred, __FILE__, __LINE__)
 
-#define TEST_END test_display(_test); return _test.failed;
+#define TEST_END test_display(_test); return _test.failed == 0;
 
 
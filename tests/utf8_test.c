@@ -0,0 +1,127 @@
+#include "testing.h"
+
+static
+isize utf8_reference_validate(byte const* buf, isize n){
+	for(isize i = 0; i < n;){
+		UTF8Decoded dec = utf8_decode(buf + i, n - i);
+		if(dec.codepoint == 0xfffd && dec.len == 1){
+			return i;
+		}
+		i += dec.len;
+	}
+	return -1;
+}
+
+static
+bool utf8_validate_matches_reference(byte const* buf, isize n){
+	isize offset = 0;
+	bool ok = utf8_validate(buf, n, &offset);
+	isize expected = utf8_reference_validate(buf, n);
+	return ok ? expected == -1 : expected == offset;
+}
+
+bool test_utf8(){
+	TEST_BEGIN("UTF-8");
+
+	/* Decoding rejects overlong, surrogate and out of range sequences */ {
+		TEST(utf8_decode((byte const*)"\xc0\x80", 2).len == 1);
+		TEST(utf8_decode((byte const*)"\xe0\x80\x80", 3).codepoint == 0xfffd);
+		TEST(utf8_decode((byte const*)"\xf0\x80\x80\x80", 4).codepoint == 0xfffd);
+		TEST(utf8_decode((byte const*)"\xed\xa0\x80", 3).codepoint == 0xfffd);
+		TEST(utf8_decode((byte const*)"\xf4\x90\x80\x80", 4).codepoint == 0xfffd);
+		TEST(utf8_decode((byte const*)"\xf4\x8f\xbf\xbf", 4).codepoint == 0x10ffff);
+		TEST(utf8_decode((byte const*)"\xc3\xa4", 2).codepoint == 0xe4);
+		TEST(utf8_decode_unchecked((byte const*)"\xf0\x9f\xa6\x8a").codepoint == 0x1f98a);
+	}
+
+	/* Short inputs */ {
+		isize offset = 0;
+		TEST(utf8_validate((byte const*)"", 0, &offset));
+		TEST(utf8_validate((byte const*)"hello, wörld", 13, &offset));
+		TEST(!utf8_validate((byte const*)"ab\xff", 3, &offset) && offset == 2);
+		TEST(!utf8_validate((byte const*)"abc\xe2\x82", 5, &offset) && offset == 3);
+	}
+
+	/* Errors at every position of a long buffer, crossing SIMD block boundaries */ {
+		byte buf[300];
+		String text = str_lit("ascii äö 日本 🦊 ");
+		for(isize i = 0; i < (isize)sizeof(buf); i += 1){
+			buf[i] = text.v[i % text.len];
+		}
+		isize valid_len = ((isize)sizeof(buf) / text.len) * text.len;
+		TEST(utf8_validate(buf, valid_len, NULL));
+
+		static const char* bad_sequences[] = { "\x80", "\xc0\xaf", "\xe0\x9f\xbf", "\xed\xbf\xbf", "\xf4\x90\x80\x80", "\xf8", "\xe2\x28" };
+		bool all_match = true;
+		for(isize s = 0; s < (isize)(sizeof(bad_sequences) / sizeof(bad_sequences[0])); s += 1){
+			isize seq_len = (isize)__builtin_strlen(bad_sequences[s]);
+			for(isize pos = 0; pos + seq_len <= valid_len; pos += 1){
+				byte copy[300];
+				mem_copy(copy, buf, sizeof(buf));
+				mem_copy(copy + pos, bad_sequences[s], seq_len);
+				all_match = all_match && utf8_validate_matches_reference(copy, valid_len);
+			}
+		}
+		TEST(all_match);
+	}
+
+	/* Random bytes agree with the per rune decoder */ {
+		u64 state = 0x2545f4914f6cdd1dull;
+		byte buf[257];
+		bool all_match = true;
+		for(int round = 0; round < 2000; round += 1){
+			for(isize i = 0; i < (isize)sizeof(buf); i += 1){
+				state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+				/* Mostly ASCII with occasional high bytes so some rounds are valid */
+				buf[i] = (state % 16 == 0) ? (byte)(state >> 24) : (byte)('a' + state % 26);
+			}
+			all_match = all_match && utf8_validate_matches_reference(buf, sizeof(buf));
+		}
+		TEST(all_match);
+	}
+
+	TEST_END;
+}
+
+bool test_utf8_transcoding(){
+	TEST_BEGIN("UTF-8 transcoding");
+	byte arena_mem[8192];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Mixed ASCII blocks and multi byte runes */ {
+		String s = str_lit("plain ascii text, longer than a block! äö 日本 🦊 end");
+		UTF32String u32 = utf8_to_utf32(&arena, s);
+		UTF16String u16 = utf8_to_utf16(&arena, s);
+
+		isize runes = 0;
+		bool same_runes = true;
+		for(isize i = 0; i < s.len; runes += 1){
+			UTF8Decoded dec = utf8_decode(s.v + i, s.len - i);
+			same_runes = same_runes && runes < u32.len && u32.v[runes] == dec.codepoint;
+			i += dec.len;
+		}
+
+		TEST(same_runes && u32.len == runes);
+		TEST(utf8_count_runes(s) == runes);
+		TEST(u16.len == runes + 1);
+		TEST(utf8_count_utf16(s) == u16.len);
+		TEST(u16.v[u16.len - 6] == 0xd83e && u16.v[u16.len - 5] == 0xdd8a);
+		TEST(u16.v[0] == 'p' && u16.v[39] == 0xe4);
+	}
+
+	/* Columns for an editor, the fox counts as two UTF-16 units */ {
+		String line = str_lit("let 🦊 = äiti;");
+		isize offset = 11; /* Byte offset of 'ä' */
+		TEST(line.v[offset] == 0xc3);
+		TEST(utf8_count_utf16(str_sub(line, 0, offset)) == 9);
+		TEST(utf8_count_runes(str_sub(line, 0, offset)) == 8);
+	}
+
+	/* Invalid bytes are replaced */ {
+		String s = str_lit("a\xff" "b");
+		UTF32String u32 = utf8_to_utf32(&arena, s);
+		TEST(u32.len == 3 && u32.v[1] == 0xfffd);
+	}
+
+	TEST_END;
+}
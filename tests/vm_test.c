@@ -0,0 +1,267 @@
+#include "testing.h"
+
+/* Result of `main` as text, or "offset:message;" for each compile or runtime error, with the IR
+   passes run first if `optimize` */
+static
+String vm_test_run(Arena* arena, String source, BcProgram* program_out, bool optimize){
+	/* Bytecode is emitted from the IR, whose lowering does the type checks */
+	IrModule* m = arena_make(arena, IrModule, 1);
+	String out = ir_test_build(arena, source, m);
+	BcProgram program = {0};
+	if(out.len == 0){
+		if(optimize){
+			ir_optimize_module(m, &(IrOptOptions){ .inline_budget = IR_DEFAULT_INLINE_BUDGET });
+		}
+		Emitter e = emitter_create(m, str_lit("test.kl"), arena);
+		program = emitter_emit_module(&e);
+		out = ir_test_errors(arena, e.error);
+	}
+	if(program_out != NULL){
+		*program_out = program;
+	}
+	if(out.len > 0){
+		return out;
+	}
+
+	Vm vm = vm_create(&program, 4096, 256, arena);
+	Value result = {0};
+	if(!vm_run_main(&vm, &result)){
+		return str_format(arena, "%llu:%.*s;", (unsigned long long)vm.error->offset, str_fmt(vm.error->message));
+	}
+	return bytecode_format_value(result, arena);
+}
+
+bool test_vm(){
+	TEST_BEGIN("Interpreter");
+	static byte arena_mem[2 * 1024 * 1024];
+	Arena arena = arena_create_buffer(arena_mem, sizeof(arena_mem));
+
+	/* Calls, loops and globals */ {
+		String source = str_lit(
+			"let limit = 0x1000 * 64 + 16;\n"
+			"let counter = 0;\n"
+			"fn bump(n: Int) { counter += n; }\n"
+			"fn fib(n: Int) -> Int {\n"
+			"	if n < 2 { return n; }\n"
+			"	return fib(n - 1) + fib(n - 2);\n"
+			"}\n"
+			"fn main() -> Int {\n"
+			"	let sum = 0;\n"
+			"	let i = 0;\n"
+			"	for i < 10 {\n"
+			"		i += 1;\n"
+			"		if i % 2 == 0 { continue; }\n"
+			"		sum += i;\n"
+			"	}\n"
+			"	bump(2); bump(3);\n"
+			"	return fib(20) + sum + limit + counter;\n"
+			"}\n");
+		BcProgram program = {0};
+		TEST(str_equals(vm_test_run(&arena, source, &program, false), str_lit("268955")));
+		TEST(program.function_count == 4 && program.global_count == 2 && program.main == 2);
+
+		/* The folded initializer is a single constant load */
+		BcFunction init = program.functions[program.init];
+		TEST(INSTR_OP(program.code[init.code_start]) == BcOp_LoadK && program.constants[0].value.integer == 0x1000 * 64 + 16);
+	}
+
+	/* The IR passes shorten what the interpreter runs */ {
+		String source = str_lit(
+			"fn main() -> Int {\n"
+			"	let scale = 4;\n"
+			"	let sum = 0;\n"
+			"	let i = 0;\n"
+			"	for i < 10 {\n"
+			"		if scale * 2 > 5 { sum += i * scale; } else { sum -= 1; }\n"
+			"		i += 1;\n"
+			"	}\n"
+			"	return sum;\n"
+			"}\n");
+		BcProgram plain = {0}, optimized = {0};
+		TEST(str_equals(vm_test_run(&arena, source, &plain, false), str_lit("180")));
+		TEST(str_equals(vm_test_run(&arena, source, &optimized, true), str_lit("180")));
+		TEST(optimized.functions[optimized.main].code_len < plain.functions[plain.main].code_len);
+	}
+
+	/* Inlined calls leave the interpreter's bytecode, recursive ones stay */ {
+		String source = str_lit(
+			"fn clamp(x: Int, lo: Int, hi: Int) -> Int {\n"
+			"	if x < lo { return lo; }\n"
+			"	if x > hi { return hi; }\n"
+			"	return x;\n"
+			"}\n"
+			"fn fact(n: Int) -> Int { if n < 2 { return 1; } return n * fact(n - 1); }\n"
+			"fn main() -> Int {\n"
+			"	let sum = 0;\n"
+			"	let i = 0;\n"
+			"	for i < 20 { sum += clamp(i, 5, 15); i += 1; }\n"
+			"	return sum * 1000 + fact(5);\n"
+			"}\n");
+		for(int optimize = 0; optimize < 2; optimize += 1){
+			BcProgram program = {0};
+			TEST(str_equals(vm_test_run(&arena, source, &program, optimize), str_lit("195120")));
+			BcFunction f = program.functions[program.main];
+			u32 calls = 0;
+			for(u32 i = f.code_start; i < f.code_start + f.code_len; i += 1){
+				calls += INSTR_OP(program.code[i]) == BcOp_Call;
+			}
+			TEST(calls == (optimize ? 1u : 2u));
+		}
+	}
+
+	/* Nested loops, break and short circuits */ {
+		String source = str_lit(
+			"fn check(x: Int) -> Bool { return 10 / x == 1; }\n"
+			"fn main() -> Int {\n"
+			"	let primes = 0;\n"
+			"	let n = 2;\n"
+			"	for n < 100 {\n"
+			"		let d = 2;\n"
+			"		let prime = 1;\n"
+			"		for d * d <= n {\n"
+			"			if n % d == 0 { prime = 0; break; }\n"
+			"			d += 1;\n"
+			"		}\n"
+			"		primes += prime;\n"
+			"		n += 1;\n"
+			"	}\n"
+			"	let zero = 0;\n"
+			"	if zero != 0 && check(zero) || !(zero == 0 || check(zero)) { return -1; }\n"
+			"	return primes;\n"
+			"}\n");
+		TEST(str_equals(vm_test_run(&arena, source, NULL, false), str_lit("25")));
+	}
+
+	/* Reals, booleans and assignments reading their target */ {
+		String source = str_lit(
+			"fn half(x: Real) -> Real { return x / 2.0; }\n"
+			"fn main() -> Bool {\n"
+			"	let a = 3.0;\n"
+			"	a = half(a) * a;\n"
+			"	let b = 1;\n"
+			"	let c = b + 1 == 2 && b < 5;\n"
+			"	c = c && b != 0;\n"
+			"	return a == 4.5 && c;\n"
+			"}\n");
+		TEST(str_equals(vm_test_run(&arena, source, NULL, false), str_lit("true")));
+	}
+
+	/* Operands are read left to right, before the right side assigns them */ {
+		TEST(str_equals(vm_test_run(&arena, str_lit("fn main() -> Int { let x = 1; x = x + (x = 5); return x; }\n"), NULL, false), str_lit("6")));
+		TEST(str_equals(vm_test_run(&arena, str_lit("fn main() -> Int { let x = 1; let y = x + (x = 5) * 0; return y; }\n"), NULL, false), str_lit("1")));
+		TEST(str_equals(vm_test_run(&arena, str_lit("fn main() -> Int { let x = 1; x = 2; x += (x = 5); return x; }\n"), NULL, false), str_lit("7")));
+		TEST(str_equals(vm_test_run(&arena, str_lit("fn main() -> Bool { let x = 1; return x > (x = 5) - 10; }\n"), NULL, false), str_lit("true")));
+	}
+
+	/* Runtime errors point at the failing operation */ {
+		String overflow = str_lit("fn sq(x: Int) -> Int { return x * x; }\nfn main() -> Int { return sq(1 << 40); }\n");
+		TEST(str_equals(vm_test_run(&arena, overflow, NULL, false), str_lit("32:Integer overflow;")));
+
+		String division = str_lit("fn main() -> Int { let z = 0; return 1 / z; }\n");
+		TEST(str_equals(vm_test_run(&arena, division, NULL, false), str_lit("39:Division by zero;")));
+
+		String recursion = str_lit("fn r(n: Int) -> Int { return r(n + 1); }\nfn main() -> Int { return r(0); }\n");
+		TEST(str_equals(vm_test_run(&arena, recursion, NULL, false), str_lit("30:Stack overflow;")));
+
+		String no_main = str_lit("fn f() { }\n");
+		TEST(str_equals(vm_test_run(&arena, no_main, NULL, false), str_lit("0:No 'main' function to run;")));
+	}
+
+	/* Registers: values trading places around calls, results written over a dead operand */ {
+		String swaps = str_lit(
+			"fn pick(a: Int, b: Int, c: Int) -> Int { return a * 100 + b * 10 + c; }\n"
+			"fn main() -> Int {\n"
+			"	let a = 1; let b = 2; let c = 3; let i = 0;\n"
+			"	for i < 4 { let t = pick(c, a, b); a = b; b = c; c = t % 10; i += 1; }\n"
+			"	return pick(b, c, a) + a;\n"
+			"}\n");
+		TEST(str_equals(vm_test_run(&arena, swaps, NULL, false), str_lit("236")));
+		TEST(str_equals(vm_test_run(&arena, str_lit("fn main() -> Bool { let x = 259; let y = 3; return x == y; }\n"), NULL, false), str_lit("false")));
+	}
+
+	/* Globals hold the zero of their type until their initializer runs, as in native code */ {
+		String source = str_lit(
+			"let early: Int = late + 1;\n"
+			"let flag: Bool = !set;\n"
+			"let late: Int = 2;\n"
+			"let set: Bool = 1 == 1;\n"
+			"fn main() -> Int { if flag { return early * 10 + late; } return -1; }\n");
+		TEST(str_equals(vm_test_run(&arena, source, NULL, false), str_lit("12")));
+	}
+
+	/* Every value live at once needs its own register */ {
+		static char text[16 * 1024];
+		for(u32 count = 200; count <= 300; count += 100){
+			int len = snprintf(text, sizeof(text), "fn main() -> Int {\n\tlet p = 1;\n");
+			u32 offset = 0; /* Of the first constant past the frame, too large for an immediate */
+			for(u32 i = 0; i < count; i += 1){
+				if(i == 254){ offset = (u32)len + (u32)snprintf(NULL, 0, "\tlet v%u = p + ", i); }
+				len += snprintf(text + len, sizeof(text) - (size_t)len, "\tlet v%u = p + %u;\n", i, i);
+			}
+			len += snprintf(text + len, sizeof(text) - (size_t)len, "\treturn v0");
+			for(u32 i = 1; i < count; i += 1){
+				len += snprintf(text + len, sizeof(text) - (size_t)len, " + v%u", i);
+			}
+			len += snprintf(text + len, sizeof(text) - (size_t)len, ";\n}\n");
+
+			ArenaRegion reg = arena_region_begin(&arena);
+			String got = vm_test_run(&arena, str_format(&arena, "%s", text), NULL, false);
+			if(count == 200){
+				TEST(str_equals(got, str_lit("20100")));
+			}
+			else {
+				/* `p` and 254 of the sums fill the frame */
+				TEST(str_equals(got, str_format(&arena, "%u:Function needs more than 255 registers;", offset)));
+			}
+			arena_region_end(reg);
+		}
+	}
+
+	/* Type errors are found before anything runs, the same way for every back end */ {
+		char const* sources[] = {
+			"fn main() -> Real { return 1 + 2.0; }\n",
+			"fn main() { if 1 { } }\n",
+			"fn main() -> Int { return 1 == 1; }\n",
+			"fn f(x: Int) -> Int { if x > 0 { return 1; } }\nfn main() -> Int { return f(0); }\n",
+			"fn main() -> Int { let x; return x; }\n",
+			"fn g() { }\nfn main() -> Int { let v = g(); return 1; }\n",
+			"let a = b + 1;\nlet b = 2;\nfn main() -> Int { return a; }\n",
+		};
+		char const* errors[] = {
+			"29:Invalid operands of types Int and Real;",
+			"15:Condition must be a Bool, found Int;",
+			"19:'main' must return Int, found Bool;",
+			"3:'f' can reach its end without returning a value;",
+			"23:'x' needs a type or an initializer;",
+			"38:'g' does not return a value;",
+			"8:The type of 'b' is not known here, declare it with a type;52:The type of 'a' is not known here, declare it with a type;",
+		};
+		for(u32 i = 0; i < sizeof(sources) / sizeof(sources[0]); i += 1){
+			String got = vm_test_run(&arena, str_format(&arena, "%s", sources[i]), NULL, false);
+			if(!TEST(str_equals(got, str_format(&arena, "%s", errors[i])))){
+				printf("  %s  got %.*s\n", sources[i], str_fmt(got));
+			}
+		}
+	}
+
+	/* What the lowering rejects */ {
+		String source = str_lit(
+			"let g = 1;\n"
+			"fn f(a: Int) { }\n"
+			"fn main() {\n"
+			"	g();\n"
+			"	f();\n"
+			"	let s = \"text\";\n"
+			"	f = 2;\n"
+			"	break;\n"
+			"}\n");
+		TEST(str_equals(vm_test_run(&arena, source, NULL, false), str_lit(
+			"41:Only functions declared with 'fn' can be called;"
+			"48:'f' takes 1 arguments, 0 given;"
+			"61:String expressions cannot be lowered to IR yet;"
+			"70:Only variables can be assigned to;"
+			"78:'break' outside of a loop;")));
+	}
+
+	TEST_END;
+}
@@ -0,0 +1,54 @@
+#include "kielo.h"
+
+/* Token tables, only this translation unit defines them */
+
+const String token_names[TokenKind__len] = {
+	#define X(Name, Str) [TokenKind_##Name] = str_lit(Str),
+	ALL_TOKENS
+	#undef X
+};
+
+const u8 token_lexeme_len[TokenKind__len] = {
+	#define X(Name, Str) [TokenKind_##Name] = sizeof(Str) - 1,
+	DELIMITER_TOKENS
+	KEYWORD_TOKENS
+	#undef X
+};
+
+const u8 token_precedence[TokenKind__len] = {
+	#define X(Name, Prec) [TokenKind_##Name] = Prec,
+	BINARY_OPERATORS
+	#undef X
+};
+
+const u8 token_flags[TokenKind__len] = {
+	#define X(Name, Prec) [TokenKind_##Name] = TokenFlag_Binary | ((Prec) == PREC_ASSIGN ? TokenFlag_Assignment : 0),
+	BINARY_OPERATORS
+	#undef X
+	#define X(Name, Str) [TokenKind_##Name] = TokenFlag_Keyword,
+	KEYWORD_TOKENS
+	#undef X
+};
+
+static const TokenKind token_keywords[] = {
+	#define X(Name, Str) TokenKind_##Name,
+	KEYWORD_TOKENS
+	#undef X
+};
+
+String token_kind_name(TokenKind k){
+	if((u32)k >= TokenKind__len){
+		return str_lit("<INVALID TOKEN KIND>");
+	}
+	return token_names[k];
+}
+
+TokenKind token_keyword_kind(String lexeme){
+	for(isize i = 0; i < (isize)(sizeof(token_keywords) / sizeof(token_keywords[0])); i += 1){
+		TokenKind k = token_keywords[i];
+		if(token_lexeme_len[k] == lexeme.len && mem_compare(token_names[k].v, lexeme.v, lexeme.len) == 0){
+			return k;
+		}
+	}
+	return TokenKind_Identifier;
+}
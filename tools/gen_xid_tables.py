@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# Generates base/xid_tables.h, the XID_Start/XID_Continue lookup tables used by the lexer.
+#
+# Python's identifier rules are XID_Start/XID_Continue (plus '_'), so its Unicode
+# database is the source of truth. Run from the repository root:
+#     python3 tools/gen_xid_tables.py > base/xid_tables.h
+import sys
+import unicodedata
+
+BLOCK_SHIFT = 8
+BLOCK_SIZE = 1 << BLOCK_SHIFT
+
+def is_start(c):
+    return c != 0x5f and chr(c).isidentifier()
+
+def is_continue(c):
+    return ('a' + chr(c)).isidentifier()
+
+def main():
+    flags = [(1 if is_start(c) else 0) | (2 if is_continue(c) else 0) for c in range(0x110000)]
+
+    # Past the last XID_Start rune only a few continue ranges remain (variation selectors),
+    # those are kept as a range list so the two-level table stays small.
+    limit = max(c for c in range(0x110000) if flags[c] & 1)
+    limit = (limit + BLOCK_SIZE) & ~(BLOCK_SIZE - 1)
+
+    tail_ranges = []
+    c = limit
+    while c < 0x110000:
+        if flags[c]:
+            begin = c
+            while c < 0x110000 and flags[c] == flags[begin]:
+                c += 1
+            assert flags[begin] == 2
+            tail_ranges.append((begin, c - 1))
+        else:
+            c += 1
+
+    blocks = {}
+    index = []
+    for b in range(limit >> BLOCK_SHIFT):
+        bits = bytearray(BLOCK_SIZE // 4)
+        for i in range(BLOCK_SIZE):
+            bits[i >> 2] |= flags[(b << BLOCK_SHIFT) + i] << ((i & 3) * 2)
+        key = bytes(bits)
+        if key not in blocks:
+            blocks[key] = len(blocks)
+        index.append(blocks[key])
+    assert len(blocks) <= 256
+
+    out = sys.stdout
+    out.write("/* Generated by tools/gen_xid_tables.py from Unicode %s, do not edit */\n" % unicodedata.unidata_version)
+    out.write("#pragma once\n#include \"types.h\"\n\n")
+    out.write("/* Two bits per rune: 1 = XID_Start, 2 = XID_Continue */\n")
+    out.write("#define XID_BLOCK_SHIFT %d\n" % BLOCK_SHIFT)
+    out.write("#define XID_TABLE_LIMIT 0x%x\n\n" % limit)
+
+    out.write("static const u8 xid_index[%d] = {\n" % len(index))
+    for i in range(0, len(index), 24):
+        out.write("\t" + ",".join("%d" % v for v in index[i:i + 24]) + ",\n")
+    out.write("};\n\n")
+
+    out.write("static const u8 xid_blocks[%d][%d] = {\n" % (len(blocks), BLOCK_SIZE // 4))
+    for key in sorted(blocks, key=blocks.get):
+        out.write("\t{" + ",".join("0x%02x" % v for v in key) + "},\n")
+    out.write("};\n\n")
+
+    out.write("/* XID_Continue only ranges past XID_TABLE_LIMIT */\n")
+    out.write("static const struct { rune lo, hi; } xid_continue_tail[%d] = {\n" % len(tail_ranges))
+    for lo, hi in tail_ranges:
+        out.write("\t{ 0x%x, 0x%x },\n" % (lo, hi))
+    out.write("};\n")
+
+if __name__ == "__main__":
+    main()
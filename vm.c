@@ -0,0 +1,449 @@
+#include "kielo.h"
+
+Vm vm_create(BcProgram const* program, u32 stack_len, u32 frame_cap, Arena* arena){
+	Vm vm = {
+		.program = program,
+		.globals = arena_make(arena, Value, max(program->global_count, 1u)),
+		.stack = arena_make(arena, Value, stack_len),
+		.stack_len = stack_len,
+		.frames = arena_make(arena, VmFrame, frame_cap),
+		.frame_cap = frame_cap,
+		.error_arena = arena,
+	};
+	ensure(vm.globals != NULL && vm.stack != NULL && vm.frames != NULL, "Failed to allocate interpreter");
+	/* Zero of each type, as the data area of native code starts */
+	for(u32 g = 0; g < program->global_count; g += 1){
+		vm.globals[g].kind = program->global_types[g];
+	}
+	return vm;
+}
+
+static
+char const* vm_kind_name(u8 kind){
+	switch(kind){
+	case ConstKind_Int:  return "Int";
+	case ConstKind_Real: return "Real";
+	case ConstKind_Bool: return "Bool";
+	default: return "nil";
+	}
+}
+
+/* `at` is the instruction that failed */
+str_attribute_format(3,4)
+static
+bool vm_fail(Vm* vm, u32 at, char const* fmt, ...){
+	CompilerError* err = arena_make(vm->error_arena, CompilerError, 1);
+	err->stage = CompilerStage_Run;
+	err->offset = at < vm->program->code_len ? vm->program->offsets[at] : 0;
+	err->filename = vm->filename;
+
+	va_list argp;
+	va_start(argp, fmt);
+	err->message = str_vformat(vm->error_arena, fmt, argp);
+	va_end(argp);
+
+	vm->error = err;
+	return false;
+}
+
+/* True when the result does not fit */
+static inline
+bool vm_add_overflow(i64 a, i64 b, i64* out){
+#if defined(COMPILER_MSVC)
+	*out = (i64)((u64)a + (u64)b);
+	return (b > 0 && *out < a) || (b < 0 && *out > a);
+#else
+	return __builtin_add_overflow(a, b, out);
+#endif
+}
+
+static inline
+bool vm_sub_overflow(i64 a, i64 b, i64* out){
+#if defined(COMPILER_MSVC)
+	*out = (i64)((u64)a - (u64)b);
+	return (b > 0 && *out > a) || (b < 0 && *out < a);
+#else
+	return __builtin_sub_overflow(a, b, out);
+#endif
+}
+
+static inline
+bool vm_mul_overflow(i64 a, i64 b, i64* out){
+#if defined(COMPILER_MSVC)
+	Constant k;
+	if(const_fold_binary(TokenKind_Star, (Constant){ .kind = ConstKind_Int, .value.integer = a },
+		(Constant){ .kind = ConstKind_Int, .value.integer = b }, &k) != ConstFold_Ok){
+		return true;
+	}
+	*out = k.value.integer;
+	return false;
+#else
+	return __builtin_mul_overflow(a, b, out);
+#endif
+}
+
+/* Threaded dispatch jumps straight from one handler to the next through a label table, compilers
+   without computed goto get a switch in a loop */
+#if defined(COMPILER_MSVC)
+	#define VM_DISPATCH()     for(;;){ i = *pc++; switch(INSTR_OP(i)){
+	#define VM_DISPATCH_END() default: panic("Invalid opcode"); } }
+	#define VM_CASE(Op)       case BcOp_##Op:
+	#define VM_NEXT()         continue
+#else
+	#define VM_DISPATCH()     VM_NEXT();
+	#define VM_DISPATCH_END()
+	#define VM_CASE(Op)       op_##Op:
+	#define VM_NEXT()         do { i = *pc++; goto *labels[INSTR_OP(i)]; } while(0)
+#endif
+
+#define VM_RA (&base[INSTR_A(i)])
+#define VM_RB (&base[INSTR_B(i)])
+#define VM_RC (&base[INSTR_C(i)])
+
+/* The callee's first register is the caller's call register */
+#define VM_RETURN(V) \
+	do { \
+		Value ret_ = (V); \
+		if(depth == 0){ \
+			*result = ret_; \
+			return true; \
+		} \
+		base[0] = ret_; \
+		depth -= 1; \
+		pc = frames[depth].pc; \
+		base = frames[depth].base; \
+	} while(0)
+
+/* The value is computed before anything is written, the result register may be an operand's */
+#define VM_SET_INT(R, V)  do { i64 v_ = (V); Value* r_ = (R); r_->kind = ConstKind_Int; r_->value.integer = v_; } while(0)
+#define VM_SET_REAL(R, V) do { f64 v_ = (V); Value* r_ = (R); r_->kind = ConstKind_Real; r_->value.real = v_; } while(0)
+#define VM_SET_BOOL(R, V) do { bool v_ = (V); Value* r_ = (R); r_->kind = ConstKind_Bool; r_->value.boolean = v_; } while(0)
+
+/* Int and Real operands, Int results are checked for overflow */
+#define VM_ARITH(Op, Overflow, RealOp) \
+	VM_CASE(Op){ \
+		Value const* rb = VM_RB; \
+		Value const* rc = VM_RC; \
+		if(rb->kind == ConstKind_Int && rc->kind == ConstKind_Int){ \
+			i64 v; \
+			if(Overflow(rb->value.integer, rc->value.integer, &v)){ goto overflow; } \
+			VM_SET_INT(VM_RA, v); \
+		} \
+		else if(rb->kind == ConstKind_Real && rc->kind == ConstKind_Real){ \
+			VM_SET_REAL(VM_RA, rb->value.real RealOp rc->value.real); \
+		} \
+		else { goto operand_error; } \
+		VM_NEXT(); \
+	}
+
+#define VM_BITWISE(Op, IntOp) \
+	VM_CASE(Op){ \
+		Value const* rb = VM_RB; \
+		Value const* rc = VM_RC; \
+		if(rb->kind != ConstKind_Int || rc->kind != ConstKind_Int){ goto operand_error; } \
+		VM_SET_INT(VM_RA, rb->value.integer IntOp rc->value.integer); \
+		VM_NEXT(); \
+	}
+
+#define VM_ORDER(Op, CmpOp) \
+	VM_CASE(Op){ \
+		Value const* rb = VM_RB; \
+		Value const* rc = VM_RC; \
+		if(rb->kind == ConstKind_Int && rc->kind == ConstKind_Int){ \
+			VM_SET_BOOL(VM_RA, rb->value.integer CmpOp rc->value.integer); \
+		} \
+		else if(rb->kind == ConstKind_Real && rc->kind == ConstKind_Real){ \
+			VM_SET_BOOL(VM_RA, rb->value.real CmpOp rc->value.real); \
+		} \
+		else { goto operand_error; } \
+		VM_NEXT(); \
+	}
+
+static
+bool vm_equal(Value a, Value b){
+	switch(a.kind){
+	case ConstKind_Int:  return a.value.integer == b.value.integer;
+	case ConstKind_Real: return a.value.real == b.value.real;
+	case ConstKind_Bool: return a.value.boolean == b.value.boolean;
+	default: return true;
+	}
+}
+
+bool vm_call(Vm* vm, u32 fn, Value const* args, u32 arg_count, Value* result){
+	BcProgram const* program = vm->program;
+	ensure(fn < program->function_count && arg_count == program->functions[fn].param_count, "Invalid call");
+
+	Instr const* code = program->code;
+	BcFunction const* functions = program->functions;
+	Value const* constants = program->constants;
+	Value* globals = vm->globals;
+	VmFrame* frames = vm->frames;
+	Value* stack_end = vm->stack + vm->stack_len;
+	u32 depth = 0;
+
+	Value* base = vm->stack;
+	if(functions[fn].register_count > vm->stack_len){
+		return vm_fail(vm, functions[fn].code_start, "Stack overflow");
+	}
+	for(u32 a = 0; a < arg_count; a += 1){
+		base[a] = args[a];
+	}
+	Instr const* pc = code + functions[fn].code_start;
+	Instr i = 0;
+	vm->error = NULL;
+
+#if !defined(COMPILER_MSVC)
+	static void* const labels[BcOp__len] = {
+		#define X(Name) [BcOp_##Name] = &&op_##Name,
+		BYTECODE_OPS
+		#undef X
+	};
+#endif
+
+	VM_DISPATCH()
+
+	VM_CASE(Move){
+		*VM_RA = *VM_RB;
+		VM_NEXT();
+	}
+
+	VM_CASE(LoadK){
+		*VM_RA = constants[INSTR_BX(i)];
+		VM_NEXT();
+	}
+
+	VM_CASE(LoadI){
+		VM_SET_INT(VM_RA, INSTR_SBX(i));
+		VM_NEXT();
+	}
+
+	VM_CASE(LoadNil){
+		*VM_RA = (Value){0};
+		VM_NEXT();
+	}
+
+	VM_CASE(LoadBool){
+		VM_SET_BOOL(VM_RA, INSTR_B(i) != 0);
+		VM_NEXT();
+	}
+
+	VM_CASE(GetGlobal){
+		*VM_RA = globals[INSTR_BX(i)];
+		VM_NEXT();
+	}
+
+	VM_CASE(SetGlobal){
+		globals[INSTR_BX(i)] = *VM_RA;
+		VM_NEXT();
+	}
+
+	VM_ARITH(Add, vm_add_overflow, +)
+	VM_ARITH(Sub, vm_sub_overflow, -)
+	VM_ARITH(Mul, vm_mul_overflow, *)
+
+	VM_CASE(Div){
+		Value const* rb = VM_RB;
+		Value const* rc = VM_RC;
+		if(rb->kind == ConstKind_Int && rc->kind == ConstKind_Int){
+			i64 l = rb->value.integer;
+			i64 r = rc->value.integer;
+			if(r == 0){ goto division_by_zero; }
+			if(r == -1){
+				if(l == INT64_MIN){ goto overflow; }
+				VM_SET_INT(VM_RA, -l);
+			}
+			else {
+				VM_SET_INT(VM_RA, l / r);
+			}
+		}
+		else if(rb->kind == ConstKind_Real && rc->kind == ConstKind_Real){
+			VM_SET_REAL(VM_RA, rb->value.real / rc->value.real);
+		}
+		else { goto operand_error; }
+		VM_NEXT();
+	}
+
+	VM_CASE(Mod){
+		Value const* rb = VM_RB;
+		Value const* rc = VM_RC;
+		if(rb->kind != ConstKind_Int || rc->kind != ConstKind_Int){ goto operand_error; }
+		i64 r = rc->value.integer;
+		if(r == 0){ goto division_by_zero; }
+		/* INT64_MIN % -1 traps on x86 */
+		VM_SET_INT(VM_RA, r == -1 ? 0 : rb->value.integer % r);
+		VM_NEXT();
+	}
+
+	VM_CASE(Shl){
+		Value const* rb = VM_RB;
+		Value const* rc = VM_RC;
+		if(rb->kind != ConstKind_Int || rc->kind != ConstKind_Int){ goto operand_error; }
+		if((u64)rc->value.integer > 63){ goto shift_range; }
+		VM_SET_INT(VM_RA, (i64)((u64)rb->value.integer << rc->value.integer));
+		VM_NEXT();
+	}
+
+	VM_CASE(Shr){
+		Value const* rb = VM_RB;
+		Value const* rc = VM_RC;
+		if(rb->kind != ConstKind_Int || rc->kind != ConstKind_Int){ goto operand_error; }
+		if((u64)rc->value.integer > 63){ goto shift_range; }
+		VM_SET_INT(VM_RA, rb->value.integer >> rc->value.integer);
+		VM_NEXT();
+	}
+
+	VM_BITWISE(BitAnd, &)
+	VM_BITWISE(BitOr, |)
+	VM_BITWISE(BitXor, ^)
+
+	VM_CASE(Eq){
+		Value const* rb = VM_RB;
+		Value const* rc = VM_RC;
+		if(rb->kind != rc->kind){ goto operand_error; }
+		VM_SET_BOOL(VM_RA, vm_equal(*rb, *rc));
+		VM_NEXT();
+	}
+
+	VM_CASE(Ne){
+		Value const* rb = VM_RB;
+		Value const* rc = VM_RC;
+		if(rb->kind != rc->kind){ goto operand_error; }
+		VM_SET_BOOL(VM_RA, !vm_equal(*rb, *rc));
+		VM_NEXT();
+	}
+
+	VM_ORDER(Lt, <)
+	VM_ORDER(Le, <=)
+
+	VM_CASE(AddI){
+		Value const* rb = VM_RB;
+		if(rb->kind != ConstKind_Int){ goto operand_error; }
+		i64 v;
+		if(vm_add_overflow(rb->value.integer, INSTR_SC(i), &v)){ goto overflow; }
+		VM_SET_INT(VM_RA, v);
+		VM_NEXT();
+	}
+
+	VM_CASE(Neg){
+		Value const* rb = VM_RB;
+		if(rb->kind == ConstKind_Int){
+			if(rb->value.integer == INT64_MIN){ goto overflow; }
+			VM_SET_INT(VM_RA, -rb->value.integer);
+		}
+		else if(rb->kind == ConstKind_Real){
+			VM_SET_REAL(VM_RA, -rb->value.real);
+		}
+		else { goto operand_error; }
+		VM_NEXT();
+	}
+
+	VM_CASE(BitNot){
+		Value const* rb = VM_RB;
+		if(rb->kind != ConstKind_Int){ goto operand_error; }
+		VM_SET_INT(VM_RA, ~rb->value.integer);
+		VM_NEXT();
+	}
+
+	VM_CASE(Not){
+		Value const* rb = VM_RB;
+		if(rb->kind != ConstKind_Bool){ goto operand_error; }
+		VM_SET_BOOL(VM_RA, !rb->value.boolean);
+		VM_NEXT();
+	}
+
+	VM_CASE(Jmp){
+		pc += INSTR_SJ(i);
+		VM_NEXT();
+	}
+
+	VM_CASE(JmpFalse){
+		Value const* ra = VM_RA;
+		if(ra->kind != ConstKind_Bool){ goto condition_error; }
+		if(!ra->value.boolean){ pc += INSTR_SBX(i); }
+		VM_NEXT();
+	}
+
+	VM_CASE(JmpTrue){
+		Value const* ra = VM_RA;
+		if(ra->kind != ConstKind_Bool){ goto condition_error; }
+		if(ra->value.boolean){ pc += INSTR_SBX(i); }
+		VM_NEXT();
+	}
+
+	VM_CASE(Call){
+		/* The arguments already sit at the bottom of the callee's registers */
+		BcFunction const* callee = &functions[INSTR_BX(i)];
+		Value* callee_base = base + INSTR_A(i);
+		if(depth == vm->frame_cap || callee_base + callee->register_count > stack_end){
+			goto stack_overflow;
+		}
+		frames[depth] = (VmFrame){ .pc = pc, .base = base };
+		depth += 1;
+		base = callee_base;
+		pc = code + callee->code_start;
+		VM_NEXT();
+	}
+
+	VM_CASE(Ret){
+		VM_RETURN(*VM_RA);
+		VM_NEXT();
+	}
+
+	VM_CASE(RetNil){
+		VM_RETURN((Value){0});
+		VM_NEXT();
+	}
+
+	VM_DISPATCH_END()
+
+	/* Errors, `pc` is past the failing instruction */
+	u32 at;
+overflow:
+	return vm_fail(vm, (u32)(pc - code - 1), "Integer overflow");
+division_by_zero:
+	return vm_fail(vm, (u32)(pc - code - 1), "Division by zero");
+shift_range:
+	at = (u32)(pc - code - 1);
+	return vm_fail(vm, at, "Shift amount %lld is out of range, it must be between 0 and 63", (long long)VM_RC->value.integer);
+stack_overflow:
+	return vm_fail(vm, (u32)(pc - code - 1), "Stack overflow");
+condition_error:
+	return vm_fail(vm, (u32)(pc - code - 1), "Condition must be a Bool, found %s", vm_kind_name(VM_RA->kind));
+operand_error:
+	at = (u32)(pc - code - 1);
+	if(INSTR_OP(i) == BcOp_AddI || INSTR_OP(i) == BcOp_Neg || INSTR_OP(i) == BcOp_BitNot || INSTR_OP(i) == BcOp_Not){
+		return vm_fail(vm, at, "Invalid operand of type %s", vm_kind_name(VM_RB->kind));
+	}
+	return vm_fail(vm, at, "Invalid operands of types %s and %s", vm_kind_name(VM_RB->kind), vm_kind_name(VM_RC->kind));
+}
+
+bool vm_run_main(Vm* vm, Value* result){
+	BcProgram const* program = vm->program;
+	Value unused;
+	if(!vm_call(vm, program->init, NULL, 0, &unused)){
+		return false;
+	}
+	if(program->main == BC_NO_FUNCTION){
+		return vm_fail(vm, program->code_len, "No 'main' function to run");
+	}
+	BcFunction const* main_fn = &program->functions[program->main];
+	if(main_fn->param_count != 0){
+		return vm_fail(vm, main_fn->code_start, "'main' must not take parameters");
+	}
+	return vm_call(vm, program->main, NULL, 0, result);
+}
+
+#undef VM_DISPATCH
+#undef VM_DISPATCH_END
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_RA
+#undef VM_RB
+#undef VM_RC
+#undef VM_RETURN
+#undef VM_SET_INT
+#undef VM_SET_REAL
+#undef VM_SET_BOOL
+#undef VM_ARITH
+#undef VM_BITWISE
+#undef VM_ORDER